@@ -78,6 +78,10 @@ CommandLineHandler::CommandLineHandler()
     m_disable_autosave.set_description("disable automatic saving of rendered images");
     parser().add_option_handler(&m_disable_autosave);
 
+    m_asynchronous_logging.add_name("--asynchronous-logging");
+    m_asynchronous_logging.set_description("send renderer messages to the log from a background thread");
+    parser().add_option_handler(&m_asynchronous_logging);
+
     m_threads.add_name("--threads");
     m_threads.add_name("-t");
     m_threads.set_description("set the number of rendering threads");
@@ -96,6 +100,10 @@ CommandLineHandler::CommandLineHandler()
     m_continuous_saving.set_description("write each tile to disk as soon as it is rendered");
     parser().add_option_handler(&m_continuous_saving);
 
+    m_multilayer_output.add_name("--multilayer-output");
+    m_multilayer_output.set_description("write the main image and the AOV images as the layers of a single OpenEXR file");
+    parser().add_option_handler(&m_multilayer_output);
+
     m_resolution.add_name("--resolution");
     m_resolution.add_name("-r");
     m_resolution.set_description("set the resolution of the rendered image");
@@ -162,6 +170,12 @@ CommandLineHandler::CommandLineHandler()
     m_dump_input_metadata.add_name("--dump-input-metadata");
     m_dump_input_metadata.set_description("dump the input metadata of all known entities to stderr (as xml)");
     parser().add_option_handler(&m_dump_input_metadata);
+
+    m_profiling_report.add_name("--profiling-report");
+    m_profiling_report.set_description("profile project loading, scene preparation and rendering, and write a report to a file (as json)");
+    m_profiling_report.set_syntax("filename");
+    m_profiling_report.set_exact_value_count(1);
+    parser().add_option_handler(&m_profiling_report);
 }
 
 void CommandLineHandler::print_program_usage(
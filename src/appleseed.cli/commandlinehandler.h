@@ -63,11 +63,13 @@ class CommandLineHandler
     foundation::FlagOptionHandler                   m_display_output;
 #endif
     foundation::FlagOptionHandler                   m_disable_autosave;
+    foundation::FlagOptionHandler                   m_asynchronous_logging;
 
     // Aliases for rendering options.
     foundation::ValueOptionHandler<int>             m_threads;
     foundation::ValueOptionHandler<std::string>     m_output;
     foundation::FlagOptionHandler                   m_continuous_saving;
+    foundation::FlagOptionHandler                   m_multilayer_output;
     foundation::ValueOptionHandler<int>             m_resolution;
     foundation::ValueOptionHandler<int>             m_window;
     foundation::ValueOptionHandler<int>             m_samples;
@@ -84,6 +86,7 @@ class CommandLineHandler
     foundation::FlagOptionHandler                   m_verbose_unit_tests;
     foundation::FlagOptionHandler                   m_benchmark_mode;
     foundation::FlagOptionHandler                   m_dump_input_metadata;
+    foundation::ValueOptionHandler<std::string>     m_profiling_report;
 
     // Constructor.
     CommandLineHandler();
@@ -46,6 +46,7 @@
 #include "renderer/api/environmentshader.h"
 #include "renderer/api/frame.h"
 #include "renderer/api/light.h"
+#include "renderer/api/log.h"
 #include "renderer/api/material.h"
 #include "renderer/api/project.h"
 #include "renderer/api/rendering.h"
@@ -630,8 +631,34 @@ namespace
         return value == "progressive";        
     }
     
+    void enable_profiling()
+    {
+        global_profiler().set_thread_name("main");
+        global_profiler().set_enabled(true);
+    }
+
+    void write_profiling_report()
+    {
+        const string& file_path = g_cl.m_profiling_report.values()[0];
+
+        if (global_profiler().write_json(file_path.c_str()))
+            LOG_INFO(g_logger, "wrote profiling report to %s.", file_path.c_str());
+        else LOG_ERROR(g_logger, "failed to write profiling report to %s: i/o error.", file_path.c_str());
+    }
+
     void render(const string& project_filename)
     {
+        // Multilayer output files are always OpenEXR files.
+        if (g_cl.m_output.is_set() && g_cl.m_multilayer_output.is_set() &&
+            lower_case(filesystem::path(g_cl.m_output.values()[0]).extension().string()) != ".exr")
+        {
+            LOG_ERROR(
+                g_logger,
+                "--multilayer-output requires an OpenEXR output file, %s is not one.",
+                g_cl.m_output.values()[0].c_str());
+            return;
+        }
+
         // Load the project.
         auto_release_ptr<Project> project = load_project(project_filename);
         if (project.get() == 0)
@@ -707,6 +734,15 @@ namespace
             "rendering finished in %s.",
             pretty_time(seconds, 3).c_str());
 
+        // Start writing the multilayer output file in the background while the frame is archived.
+        auto_ptr<AsyncFrameWriter> frame_writer;
+        if (g_cl.m_output.is_set() && !g_cl.m_continuous_saving.is_set() && g_cl.m_multilayer_output.is_set())
+        {
+            LOG_INFO(g_logger, "writing frame to disk...");
+            frame_writer.reset(new AsyncFrameWriter());
+            frame_writer->write(*project->get_frame(), g_cl.m_output.values()[0].c_str());
+        }
+
         // Archive the frame to disk.
         char* archive_path = 0;
         if (params.get_optional<bool>("autosave", true))
@@ -726,9 +762,14 @@ namespace
         // Write the frame to disk.
         if (g_cl.m_output.is_set() && !g_cl.m_continuous_saving.is_set())
         {
-            LOG_INFO(g_logger, "writing frame to disk...");
-            project->get_frame()->write_main_image(g_cl.m_output.values()[0].c_str());
-            project->get_frame()->write_aov_images(g_cl.m_output.values()[0].c_str());
+            if (frame_writer.get())
+                frame_writer->wait();
+            else
+            {
+                LOG_INFO(g_logger, "writing frame to disk...");
+                project->get_frame()->write_main_image(g_cl.m_output.values()[0].c_str());
+                project->get_frame()->write_aov_images(g_cl.m_output.values()[0].c_str());
+            }
         }
 
 #if defined __APPLE__ || defined _WIN32
@@ -836,6 +877,9 @@ int main(int argc, const char* argv[])
     // Configure the renderer's global logger.
     configure_renderer_logger();
 
+    if (g_cl.m_asynchronous_logging.is_set())
+        global_logger().set_asynchronous();
+
     bool success = true;
 
     // Run unit tests.
@@ -855,10 +899,19 @@ int main(int argc, const char* argv[])
     {
         const string project_filename = g_cl.m_filenames.values().front();
 
+        if (g_cl.m_profiling_report.is_set())
+            enable_profiling();
+
         if (g_cl.m_benchmark_mode.is_set())
             benchmark_render(project_filename);
         else render(project_filename);
+
+        if (g_cl.m_profiling_report.is_set())
+            write_profiling_report();
     }
 
+    // Send pending renderer messages while our log target is still alive.
+    global_logger().set_asynchronous(false);
+
     return success ? 0 : 1;
 }
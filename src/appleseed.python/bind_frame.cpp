@@ -92,5 +92,6 @@ void bind_frame()
         .def("clear_main_image", &Frame::clear_main_image)
         .def("write_main_image", &Frame::write_main_image)
         .def("write_aov_images", &Frame::write_aov_images)
+        .def("write_main_and_aov_images", &Frame::write_main_and_aov_images)
         .def("archive", detail::archive_frame);
 }
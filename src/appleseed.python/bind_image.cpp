@@ -30,6 +30,9 @@
 // Has to be first, to avoid redefinition warnings.
 #include "bind_auto_release_ptr.h"
 
+// appleseed.python headers.
+#include "buffer_utils.h"
+
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/aov/tilestack.h"
@@ -40,6 +43,7 @@
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/otherwise.h"
 
 // Standard headers.
 #include <algorithm>
@@ -65,24 +69,103 @@ namespace detail
 
     void copy_tile_data_to_py_array(const Tile& tile, bpy::object& buffer)
     {
-        void* array = 0;
-        Py_ssize_t len;
+        const PythonBufferView view(buffer, true);
+        view.check_size(tile.get_size());
 
-        const int success = PyObject_AsWriteBuffer(buffer.ptr(), &array, &len);
+        std::copy(
+            tile.get_storage(),
+            tile.get_storage() + tile.get_size(),
+            reinterpret_cast<uint8*>(view.data()));
+    }
 
-        if (success != 0)
-            bpy::throw_error_already_set();
+    //
+    // Buffer protocol implementation for tiles.
+    //
+    // Exposes the pixel storage of a tile as a writable 3D array of shape
+    // (height, width, channel count) without copying it, so that numpy.asarray(tile)
+    // or memoryview(tile) give direct access to the pixels.
+    //
 
-        if (static_cast<size_t>(len) < tile.get_size())
+    const char* get_buffer_format(const PixelFormat pixel_format)
+    {
+        switch (pixel_format)
         {
-            PyErr_SetString(PyExc_IndexError, "Buffer size is smaller than data size");
-            bpy::throw_error_already_set();
+          case PixelFormatUInt8:  return "B";
+          case PixelFormatUInt16: return "H";
+          case PixelFormatUInt32: return "I";
+#if PY_MAJOR_VERSION < 3
+          // Python 2's struct module has no half format: expose the raw 16-bit values.
+          case PixelFormatHalf:   return "H";
+#else
+          case PixelFormatHalf:   return "e";
+#endif
+          case PixelFormatFloat:  return "f";
+          case PixelFormatDouble: return "d";
+          assert_otherwise;
         }
 
-        std::copy(
-            tile.get_storage(),
-            tile.get_storage() + tile.get_size(),
-            reinterpret_cast<uint8*>(array));
+        // Keep the compiler happy.
+        return 0;
+    }
+
+    int tile_get_buffer(PyObject* self, Py_buffer* view, int flags)
+    {
+        bpy::extract<Tile&> ex(self);
+
+        if (!ex.check())
+        {
+            PyErr_SetString(PyExc_BufferError, "Object is not a tile");
+            view->obj = 0;
+            return -1;
+        }
+
+        const Tile& tile = ex();
+        const Py_ssize_t channel_size = static_cast<Py_ssize_t>(Pixel::size(tile.get_pixel_format()));
+
+        // Shape and strides are stored together and released in tile_release_buffer().
+        Py_ssize_t* shape_and_strides = new Py_ssize_t[6];
+        shape_and_strides[0] = static_cast<Py_ssize_t>(tile.get_height());
+        shape_and_strides[1] = static_cast<Py_ssize_t>(tile.get_width());
+        shape_and_strides[2] = static_cast<Py_ssize_t>(tile.get_channel_count());
+        shape_and_strides[5] = channel_size;
+        shape_and_strides[4] = shape_and_strides[5] * shape_and_strides[2];
+        shape_and_strides[3] = shape_and_strides[4] * shape_and_strides[1];
+
+        view->buf = tile.get_storage();
+        view->obj = self;
+        view->len = static_cast<Py_ssize_t>(tile.get_size());
+        view->readonly = 0;
+        view->itemsize = channel_size;
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(get_buffer_format(tile.get_pixel_format())) : 0;
+        view->ndim = 3;
+        view->shape = (flags & PyBUF_ND) ? shape_and_strides : 0;
+        view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? shape_and_strides + 3 : 0;
+        view->suboffsets = 0;
+        view->internal = shape_and_strides;
+
+        // Keep the tile alive as long as the view exists.
+        Py_INCREF(self);
+
+        return 0;
+    }
+
+    void tile_release_buffer(PyObject* self, Py_buffer* view)
+    {
+        delete [] static_cast<Py_ssize_t*>(view->internal);
+        view->internal = 0;
+    }
+
+    void enable_tile_buffer_protocol(const bpy::object& tile_class)
+    {
+        PyHeapTypeObject* type = reinterpret_cast<PyHeapTypeObject*>(tile_class.ptr());
+
+        type->as_buffer.bf_getbuffer = tile_get_buffer;
+        type->as_buffer.bf_releasebuffer = tile_release_buffer;
+        type->ht_type.tp_as_buffer = &type->as_buffer;
+
+#if PY_MAJOR_VERSION < 3
+        type->ht_type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
     }
 
     Image* copy_image(const Image* source)
@@ -131,16 +214,19 @@ void bind_image()
         .def("get_tile_width", &CanvasProperties::get_tile_width)
         .def("get_tile_height", &CanvasProperties::get_tile_height);
 
-    bpy::class_<Tile, boost::noncopyable>("Tile", bpy::init<size_t, size_t, size_t, PixelFormat>())
-        .def("__copy__", detail::copy_tile, bpy::return_value_policy<bpy::manage_new_object>())
-        .def("__deepcopy__", detail::deepcopy_tile, bpy::return_value_policy<bpy::manage_new_object>())
-        .def("get_pixel_format", &Tile::get_pixel_format)
-        .def("get_width", &Tile::get_width)
-        .def("get_height", &Tile::get_height)
-        .def("get_channel_count", &Tile::get_channel_count)
-        .def("get_pixel_count", &Tile::get_pixel_count)
-        .def("get_size", &Tile::get_size)
-        .def("copy_data_to", detail::copy_tile_data_to_py_array);   // todo: maybe this needs a better name
+    const bpy::object tile_class =
+        bpy::class_<Tile, boost::noncopyable>("Tile", bpy::init<size_t, size_t, size_t, PixelFormat>())
+            .def("__copy__", detail::copy_tile, bpy::return_value_policy<bpy::manage_new_object>())
+            .def("__deepcopy__", detail::deepcopy_tile, bpy::return_value_policy<bpy::manage_new_object>())
+            .def("get_pixel_format", &Tile::get_pixel_format)
+            .def("get_width", &Tile::get_width)
+            .def("get_height", &Tile::get_height)
+            .def("get_channel_count", &Tile::get_channel_count)
+            .def("get_pixel_count", &Tile::get_pixel_count)
+            .def("get_size", &Tile::get_size)
+            .def("copy_data_to", detail::copy_tile_data_to_py_array);   // todo: maybe this needs a better name
+
+    detail::enable_tile_buffer_protocol(tile_class);
 
     const Tile& (Image::*image_get_tile)(const size_t, const size_t) const = &Image::tile;
 
@@ -150,9 +236,11 @@ void bind_image()
         .def("properties", &Image::properties, bpy::return_value_policy<bpy::reference_existing_object>())
         .def("tile", image_get_tile, bpy::return_value_policy<bpy::reference_existing_object>());
 
+    const Image& (ImageStack::*image_stack_get_image)(const size_t) const = &ImageStack::get_image;
+
     bpy::class_<ImageStack, boost::noncopyable>("ImageStack", bpy::no_init)
         .def("empty", &ImageStack::empty)
         .def("size", &ImageStack::size)
         .def("get_name", detail::image_stack_get_name)
-        .def("get_image", &ImageStack::get_image, bpy::return_value_policy<bpy::reference_existing_object>());
+        .def("get_image", image_stack_get_image, bpy::return_value_policy<bpy::reference_existing_object>());
 }
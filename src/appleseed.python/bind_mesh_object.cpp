@@ -32,12 +32,14 @@
 
 // appleseed.python headers.
 #include "bind_typed_entity_containers.h"
+#include "buffer_utils.h"
 #include "dict2dict.h"
 
 // appleseed.renderer headers.
 #include "renderer/api/object.h"
 
 // appleseed.foundation headers.
+#include "foundation/platform/types.h"
 #include "foundation/utility/autoreleaseptr.h"
 #include "foundation/utility/searchpaths.h"
 
@@ -98,6 +100,219 @@ namespace detail
         return py_objects;
     }
 
+    //
+    // Bulk access to mesh data.
+    //
+    // Vertices, vertex normals and vertex poses are exchanged as contiguous arrays of
+    // float32 triplets, texture coordinates as arrays of float32 pairs and triangles
+    // as arrays of 10 uint32 (v0, v1, v2, n0, n1, n2, a0, a1, a2, pa) per triangle.
+    // Any object supporting the buffer protocol with a matching element type can be
+    // used (NumPy arrays, array.array...); a TypeError is raised otherwise, and a
+    // ValueError if the number of values is not a multiple of the tuple size.
+    // Bulk setters return the index of the first inserted element.
+    //
+
+    const size_t TriangleFieldCount = 10;
+
+    size_t push_vertex_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, false, PythonBufferView::ElementTypeFloat32);
+        const size_t count = view.get_element_count(3 * sizeof(GScalar));
+        const GScalar* values = reinterpret_cast<const GScalar*>(view.data());
+
+        const size_t first = object->get_vertex_count();
+        object->reserve_vertices(first + count);
+
+        for (size_t i = 0; i < count; ++i, values += 3)
+            object->push_vertex(GVector3(values[0], values[1], values[2]));
+
+        return first;
+    }
+
+    size_t push_vertex_normal_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, false, PythonBufferView::ElementTypeFloat32);
+        const size_t count = view.get_element_count(3 * sizeof(GScalar));
+        const GScalar* values = reinterpret_cast<const GScalar*>(view.data());
+
+        const size_t first = object->get_vertex_normal_count();
+        object->reserve_vertex_normals(first + count);
+
+        for (size_t i = 0; i < count; ++i, values += 3)
+            object->push_vertex_normal(GVector3(values[0], values[1], values[2]));
+
+        return first;
+    }
+
+    size_t push_tex_coords_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, false, PythonBufferView::ElementTypeFloat32);
+        const size_t count = view.get_element_count(2 * sizeof(GScalar));
+        const GScalar* values = reinterpret_cast<const GScalar*>(view.data());
+
+        const size_t first = object->get_tex_coords_count();
+        object->reserve_tex_coords(first + count);
+
+        for (size_t i = 0; i < count; ++i, values += 2)
+            object->push_tex_coords(GVector2(values[0], values[1]));
+
+        return first;
+    }
+
+    size_t push_triangle_buffer(MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, false, PythonBufferView::ElementTypeUInt32);
+        const size_t count = view.get_element_count(TriangleFieldCount * sizeof(uint32));
+        const uint32* values = reinterpret_cast<const uint32*>(view.data());
+
+        const size_t first = object->get_triangle_count();
+        object->reserve_triangles(first + count);
+
+        for (size_t i = 0; i < count; ++i, values += TriangleFieldCount)
+        {
+            Triangle triangle;
+            triangle.m_v0 = values[0];
+            triangle.m_v1 = values[1];
+            triangle.m_v2 = values[2];
+            triangle.m_n0 = values[3];
+            triangle.m_n1 = values[4];
+            triangle.m_n2 = values[5];
+            triangle.m_a0 = values[6];
+            triangle.m_a1 = values[7];
+            triangle.m_a2 = values[8];
+            triangle.m_pa = values[9];
+            object->push_triangle(triangle);
+        }
+
+        return first;
+    }
+
+    void set_vertex_pose_buffer(
+        MeshObject*         object,
+        const size_t        motion_segment_index,
+        const bpy::object&  buffer)
+    {
+        if (motion_segment_index >= object->get_motion_segment_count())
+        {
+            PyErr_SetString(PyExc_IndexError, "Motion segment index out of range");
+            bpy::throw_error_already_set();
+        }
+
+        const PythonBufferView view(buffer, false, PythonBufferView::ElementTypeFloat32);
+        const size_t vertex_count = object->get_vertex_count();
+
+        if (view.get_element_count(3 * sizeof(GScalar)) != vertex_count)
+        {
+            PyErr_SetString(PyExc_ValueError, "Buffer size does not match the number of vertices");
+            bpy::throw_error_already_set();
+        }
+
+        const GScalar* values = reinterpret_cast<const GScalar*>(view.data());
+
+        for (size_t i = 0; i < vertex_count; ++i, values += 3)
+            object->set_vertex_pose(i, motion_segment_index, GVector3(values[0], values[1], values[2]));
+    }
+
+    void copy_vertices_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, true, PythonBufferView::ElementTypeFloat32);
+        const size_t count = object->get_vertex_count();
+        view.check_size(count * 3 * sizeof(GScalar));
+
+        GScalar* values = reinterpret_cast<GScalar*>(view.data());
+
+        for (size_t i = 0; i < count; ++i, values += 3)
+        {
+            const GVector3& v = object->get_vertex(i);
+            values[0] = v[0];
+            values[1] = v[1];
+            values[2] = v[2];
+        }
+    }
+
+    void copy_vertex_normals_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, true, PythonBufferView::ElementTypeFloat32);
+        const size_t count = object->get_vertex_normal_count();
+        view.check_size(count * 3 * sizeof(GScalar));
+
+        GScalar* values = reinterpret_cast<GScalar*>(view.data());
+
+        for (size_t i = 0; i < count; ++i, values += 3)
+        {
+            const GVector3 n = object->get_vertex_normal(i);
+            values[0] = n[0];
+            values[1] = n[1];
+            values[2] = n[2];
+        }
+    }
+
+    void copy_tex_coords_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, true, PythonBufferView::ElementTypeFloat32);
+        const size_t count = object->get_tex_coords_count();
+        view.check_size(count * 2 * sizeof(GScalar));
+
+        GScalar* values = reinterpret_cast<GScalar*>(view.data());
+
+        for (size_t i = 0; i < count; ++i, values += 2)
+        {
+            const GVector2 uv = object->get_tex_coords(i);
+            values[0] = uv[0];
+            values[1] = uv[1];
+        }
+    }
+
+    void copy_triangles_to(const MeshObject* object, const bpy::object& buffer)
+    {
+        const PythonBufferView view(buffer, true, PythonBufferView::ElementTypeUInt32);
+        const size_t count = object->get_triangle_count();
+        view.check_size(count * TriangleFieldCount * sizeof(uint32));
+
+        uint32* values = reinterpret_cast<uint32*>(view.data());
+
+        for (size_t i = 0; i < count; ++i, values += TriangleFieldCount)
+        {
+            const Triangle& triangle = object->get_triangle(i);
+            values[0] = triangle.m_v0;
+            values[1] = triangle.m_v1;
+            values[2] = triangle.m_v2;
+            values[3] = triangle.m_n0;
+            values[4] = triangle.m_n1;
+            values[5] = triangle.m_n2;
+            values[6] = triangle.m_a0;
+            values[7] = triangle.m_a1;
+            values[8] = triangle.m_a2;
+            values[9] = triangle.m_pa;
+        }
+    }
+
+    void copy_vertex_poses_to(
+        const MeshObject*   object,
+        const size_t        motion_segment_index,
+        const bpy::object&  buffer)
+    {
+        if (motion_segment_index >= object->get_motion_segment_count())
+        {
+            PyErr_SetString(PyExc_IndexError, "Motion segment index out of range");
+            bpy::throw_error_already_set();
+        }
+
+        const PythonBufferView view(buffer, true, PythonBufferView::ElementTypeFloat32);
+        const size_t count = object->get_vertex_count();
+        view.check_size(count * 3 * sizeof(GScalar));
+
+        GScalar* values = reinterpret_cast<GScalar*>(view.data());
+
+        for (size_t i = 0; i < count; ++i, values += 3)
+        {
+            const GVector3 v = object->get_vertex_pose(i, motion_segment_index);
+            values[0] = v[0];
+            values[1] = v[1];
+            values[2] = v[2];
+        }
+    }
+
     bool write_mesh_object(
         const MeshObject*   object,
         const std::string&  object_name,
@@ -135,26 +350,37 @@ void bind_mesh_object()
         .def("push_vertex", &MeshObject::push_vertex)
         .def("get_vertex_count", &MeshObject::get_vertex_count)
         .def("get_vertex", &MeshObject::get_vertex, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("push_vertex_buffer", detail::push_vertex_buffer)
+        .def("copy_vertices_to", detail::copy_vertices_to)
 
         .def("reserve_vertex_normals", &MeshObject::reserve_vertex_normals)
         .def("push_vertex_normal", &MeshObject::push_vertex_normal)
         .def("get_vertex_normal_count", &MeshObject::get_vertex_normal_count)
-        .def("get_vertex_normal", &MeshObject::get_vertex_normal, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("get_vertex_normal", &MeshObject::get_vertex_normal)
+        .def("push_vertex_normal_buffer", detail::push_vertex_normal_buffer)
+        .def("copy_vertex_normals_to", detail::copy_vertex_normals_to)
 
+        .def("reserve_tex_coords", &MeshObject::reserve_tex_coords)
         .def("push_tex_coords", &MeshObject::push_tex_coords)
         .def("get_tex_coords_count", &MeshObject::get_tex_coords_count)
         .def("get_tex_coords", &MeshObject::get_tex_coords)
+        .def("push_tex_coords_buffer", detail::push_tex_coords_buffer)
+        .def("copy_tex_coords_to", detail::copy_tex_coords_to)
 
         .def("reserve_triangles", &MeshObject::reserve_triangles)
         .def("push_triangle", &MeshObject::push_triangle)
         .def("get_triangle_count", &MeshObject::get_triangle_count)
         .def("get_triangle", &MeshObject::get_triangle, bpy::return_value_policy<bpy::reference_existing_object>())
+        .def("push_triangle_buffer", detail::push_triangle_buffer)
+        .def("copy_triangles_to", detail::copy_triangles_to)
 
         .def("set_motion_segment_count", &MeshObject::set_motion_segment_count)
         .def("get_motion_segment_count", &MeshObject::get_motion_segment_count)
 
         .def("set_vertex_pose", &MeshObject::set_vertex_pose)
         .def("get_vertex_pose", &MeshObject::get_vertex_pose)
+        .def("set_vertex_pose_buffer", detail::set_vertex_pose_buffer)
+        .def("copy_vertex_poses_to", detail::copy_vertex_poses_to)
         .def("clear_vertex_poses", &MeshObject::clear_vertex_poses);
 
     boost::python::implicitly_convertible<auto_release_ptr<MeshObject>, auto_release_ptr<Object> >();
@@ -0,0 +1,220 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "buffer_utils.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstring>
+#include <string>
+
+namespace bpy = boost::python;
+using namespace foundation;
+
+namespace
+{
+    bool is_little_endian()
+    {
+        const uint16 one = 1;
+        return *reinterpret_cast<const uint8*>(&one) == 1;
+    }
+
+    // Check a struct module style format string (as in "f", "=f" or "<I").
+    bool has_element_type(
+        const Py_buffer&                        buffer,
+        const PythonBufferView::ElementType     element_type)
+    {
+        const char* format = buffer.format ? buffer.format : "B";
+
+        switch (*format)
+        {
+          case '@':
+          case '=':
+            ++format;
+            break;
+
+          case '<':
+            if (!is_little_endian())
+                return false;
+            ++format;
+            break;
+
+          case '>':
+          case '!':
+            if (is_little_endian())
+                return false;
+            ++format;
+            break;
+        }
+
+        if (std::strlen(format) != 1 || buffer.itemsize != 4)
+            return false;
+
+        switch (element_type)
+        {
+          case PythonBufferView::ElementTypeFloat32:
+            return *format == 'f';
+
+          case PythonBufferView::ElementTypeUInt32:
+            // NumPy uses 'L' for uint32 on platforms where unsigned long is 32-bit.
+            return *format == 'I' || *format == 'L';
+
+          default:
+            return true;
+        }
+    }
+
+#if PY_MAJOR_VERSION < 3
+
+    // Check the element type of an object implementing the old buffer protocol
+    // through its typecode and itemsize attributes, as exposed by array.array.
+    bool has_element_type(
+        const bpy::object&                      obj,
+        const PythonBufferView::ElementType     element_type)
+    {
+        if (!PyObject_HasAttrString(obj.ptr(), "typecode") ||
+            !PyObject_HasAttrString(obj.ptr(), "itemsize"))
+            return false;
+
+        const bpy::extract<std::string> typecode(obj.attr("typecode"));
+        const bpy::extract<int> itemsize(obj.attr("itemsize"));
+
+        if (!typecode.check() || !itemsize.check() || itemsize() != 4)
+            return false;
+
+        switch (element_type)
+        {
+          case PythonBufferView::ElementTypeFloat32:
+            return typecode() == "f";
+
+          case PythonBufferView::ElementTypeUInt32:
+            return typecode() == "I" || typecode() == "L";
+
+          default:
+            return true;
+        }
+    }
+
+#endif
+
+    const char* get_element_type_error(const PythonBufferView::ElementType element_type)
+    {
+        return element_type == PythonBufferView::ElementTypeFloat32
+            ? "Buffer must contain float32 values"
+            : "Buffer must contain uint32 values";
+    }
+}
+
+PythonBufferView::PythonBufferView(
+    const bpy::object&  obj,
+    const bool          writable,
+    const ElementType   element_type)
+  : m_release_buffer(false)
+{
+#if PY_MAJOR_VERSION < 3
+    if (!PyObject_CheckBuffer(obj.ptr()))
+    {
+        // Fall back to the old buffer protocol.
+        std::memset(&m_buffer, 0, sizeof(m_buffer));
+
+        const int result =
+            writable
+                ? PyObject_AsWriteBuffer(obj.ptr(), &m_buffer.buf, &m_buffer.len)
+                : PyObject_AsReadBuffer(obj.ptr(), const_cast<const void**>(&m_buffer.buf), &m_buffer.len);
+
+        if (result != 0)
+            bpy::throw_error_already_set();
+
+        if (element_type != ElementTypeAny && !has_element_type(obj, element_type))
+        {
+            PyErr_SetString(PyExc_TypeError, get_element_type_error(element_type));
+            bpy::throw_error_already_set();
+        }
+
+        return;
+    }
+#endif
+
+    int flags = writable ? PyBUF_WRITABLE : PyBUF_SIMPLE;
+
+    // Without PyBUF_STRIDES, PyBUF_ND only accepts C-contiguous buffers.
+    if (element_type != ElementTypeAny)
+        flags |= PyBUF_FORMAT | PyBUF_ND;
+
+    if (PyObject_GetBuffer(obj.ptr(), &m_buffer, flags) != 0)
+        bpy::throw_error_already_set();
+
+    m_release_buffer = true;
+
+    if (element_type != ElementTypeAny && !has_element_type(m_buffer, element_type))
+    {
+        PyBuffer_Release(&m_buffer);
+        m_release_buffer = false;
+        PyErr_SetString(PyExc_TypeError, get_element_type_error(element_type));
+        bpy::throw_error_already_set();
+    }
+}
+
+PythonBufferView::~PythonBufferView()
+{
+    if (m_release_buffer)
+        PyBuffer_Release(&m_buffer);
+}
+
+void* PythonBufferView::data() const
+{
+    return m_buffer.buf;
+}
+
+size_t PythonBufferView::size() const
+{
+    return static_cast<size_t>(m_buffer.len);
+}
+
+size_t PythonBufferView::get_element_count(const size_t element_size) const
+{
+    if (size() % element_size != 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "Buffer size is not a multiple of the element size");
+        bpy::throw_error_already_set();
+    }
+
+    return size() / element_size;
+}
+
+void PythonBufferView::check_size(const size_t required_size) const
+{
+    if (size() < required_size)
+    {
+        PyErr_SetString(PyExc_IndexError, "Buffer size is smaller than data size");
+        bpy::throw_error_already_set();
+    }
+}
@@ -0,0 +1,83 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_PYTHON_BUFFER_UTILS_H
+#define APPLESEED_PYTHON_BUFFER_UTILS_H
+
+// Has to be first, to avoid redefinition warnings.
+#include "boost/python/detail/wrap_python.hpp"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/python.h"
+
+// Standard headers.
+#include <cstddef>
+
+// A view onto the memory of a Python object supporting the buffer protocol
+// (bytes, bytearray, NumPy arrays...). The memory must be C-contiguous.
+// A Python exception is raised if the object does not expose such a buffer.
+//
+// With Python 2, objects that only implement the old buffer protocol (such as
+// array.array) are also accepted; their element type is then checked using their
+// typecode and itemsize attributes.
+class PythonBufferView
+  : public foundation::NonCopyable
+{
+  public:
+    // Type of the elements of the buffer. Unless ElementTypeAny is requested,
+    // a Python TypeError is raised if the buffer holds elements of another type.
+    enum ElementType
+    {
+        ElementTypeAny,             // raw memory, element type is not checked
+        ElementTypeFloat32,
+        ElementTypeUInt32
+    };
+
+    PythonBufferView(
+        const boost::python::object&    obj,
+        const bool                      writable,
+        const ElementType               element_type = ElementTypeAny);
+    ~PythonBufferView();
+
+    void* data() const;
+    size_t size() const;
+
+    // Return the number of elements of a given size in the buffer. A Python exception
+    // is raised if the size of the buffer is not a multiple of the element size.
+    size_t get_element_count(const size_t element_size) const;
+
+    // Raise a Python exception if the buffer is smaller than a given size.
+    void check_size(const size_t required_size) const;
+
+  private:
+    Py_buffer   m_buffer;
+    bool        m_release_buffer;   // false if the view was obtained through the old buffer protocol
+};
+
+#endif  // !APPLESEED_PYTHON_BUFFER_UTILS_H
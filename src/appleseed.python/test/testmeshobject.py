@@ -0,0 +1,81 @@
+#
+# This source file is part of appleseed.
+# Visit http://appleseedhq.net/ for additional information and resources.
+#
+# This software is released under the MIT license.
+#
+# Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+#
+# These tests are run by CTest (appleseed-python-unit-tests) after appleseed.python was
+# built and copied to the sandbox. To run them by hand, from sandbox/bin/<configuration>:
+#
+#   python -m unittest discover -s <appleseed>/src/appleseed.python/test -p "test*.py"
+#
+
+import appleseed as asr
+import array
+import unittest
+
+class TestMeshObjectBuffers(unittest.TestCase):
+
+    def setUp(self):
+        self.mesh = asr.MeshObject("mesh", {})
+
+    def test_push_vertex_buffer_given_float32_triplets_appends_vertices(self):
+        first = self.mesh.push_vertex_buffer(array.array('f', [1.0, 2.0, 3.0, 4.0, 5.0, 6.0]))
+
+        self.assertEqual(first, 0)
+        self.assertEqual(self.mesh.get_vertex_count(), 2)
+
+        vertices = array.array('f', [0.0] * 6)
+        self.mesh.copy_vertices_to(vertices)
+        self.assertEqual(list(vertices), [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+
+    def test_push_vertex_buffer_given_float64_values_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            self.mesh.push_vertex_buffer(array.array('d', [1.0, 2.0, 3.0]))
+
+        self.assertEqual(self.mesh.get_vertex_count(), 0)
+
+    def test_push_vertex_buffer_given_raw_bytes_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            self.mesh.push_vertex_buffer(bytearray(12))
+
+    def test_push_vertex_buffer_given_incomplete_triplet_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            self.mesh.push_vertex_buffer(array.array('f', [1.0, 2.0, 3.0, 4.0]))
+
+        self.assertEqual(self.mesh.get_vertex_count(), 0)
+
+    def test_push_triangle_buffer_given_signed_integers_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            self.mesh.push_triangle_buffer(array.array('i', [0] * 10))
+
+    def test_copy_vertices_to_given_float64_buffer_raises_type_error(self):
+        self.mesh.push_vertex_buffer(array.array('f', [1.0, 2.0, 3.0]))
+
+        with self.assertRaises(TypeError):
+            self.mesh.copy_vertices_to(array.array('d', [0.0] * 3))
+
+if __name__ == '__main__':
+    unittest.main()
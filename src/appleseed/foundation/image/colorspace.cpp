@@ -30,6 +30,9 @@
 // Interface header.
 #include "colorspace.h"
 
+// Standard headers.
+#include <cassert>
+
 namespace foundation
 {
 
@@ -1441,6 +1444,175 @@ const Spectrum31f RGBToSpectrumGreenIlluminance(RGBToSpectrumGreenIlluminanceTab
 const Spectrum31f RGBToSpectrumBlueIlluminance(RGBToSpectrumBlueIlluminanceTab);
 
 
+//
+// Linear RGB <-> sRGB transformations implementation.
+//
+
+float SRGBUInt8ToLinearRGBTable[256];
+float SRGBUInt16ToLinearRGBTable[65536];
+
+namespace
+{
+    struct InitializeSRGBToLinearRGBTables
+    {
+        InitializeSRGBToLinearRGBTables()
+        {
+            for (size_t i = 0; i < 256; ++i)
+            {
+                SRGBUInt8ToLinearRGBTable[i] =
+                    static_cast<float>(srgb_to_linear_rgb(static_cast<double>(i) / 255.0));
+            }
+
+            for (size_t i = 0; i < 65536; ++i)
+            {
+                SRGBUInt16ToLinearRGBTable[i] =
+                    static_cast<float>(srgb_to_linear_rgb(static_cast<double>(i) / 65535.0));
+            }
+        }
+    };
+
+    InitializeSRGBToLinearRGBTables initialize_srgb_to_linear_rgb_tables;
+
+    template <typename T>
+    void convert_srgb_to_linear_rgb(
+        const T*            input,
+        float*              output,
+        const size_t        pixel_count,
+        const size_t        channel_count,
+        const float         table[],
+        const float         rcp_max_value)
+    {
+        if (channel_count <= 3)
+        {
+            const size_t value_count = pixel_count * channel_count;
+
+            for (size_t i = 0; i < value_count; ++i)
+                output[i] = table[input[i]];
+        }
+        else
+        {
+            for (size_t i = 0; i < pixel_count; ++i)
+            {
+                output[0] = table[input[0]];
+                output[1] = table[input[1]];
+                output[2] = table[input[2]];
+
+                for (size_t c = 3; c < channel_count; ++c)
+                    output[c] = static_cast<float>(input[c]) * rcp_max_value;
+
+                input += channel_count;
+                output += channel_count;
+            }
+        }
+    }
+}
+
+void convert_srgb_to_linear_rgb(
+    const uint8*        input,
+    float*              output,
+    const size_t        pixel_count,
+    const size_t        channel_count)
+{
+    convert_srgb_to_linear_rgb(
+        input,
+        output,
+        pixel_count,
+        channel_count,
+        SRGBUInt8ToLinearRGBTable,
+        1.0f / 255.0f);
+}
+
+void convert_srgb_to_linear_rgb(
+    const uint16*       input,
+    float*              output,
+    const size_t        pixel_count,
+    const size_t        channel_count)
+{
+    convert_srgb_to_linear_rgb(
+        input,
+        output,
+        pixel_count,
+        channel_count,
+        SRGBUInt16ToLinearRGBTable,
+        1.0f / 65535.0f);
+}
+
+void convert_srgb_to_linear_rgb(
+    float*              pixels,
+    const size_t        pixel_count,
+    const size_t        channel_count)
+{
+    if (channel_count <= 3)
+    {
+        // All values are color components.
+        const size_t value_count = pixel_count * channel_count;
+
+        for (size_t i = 0; i < value_count; ++i)
+            pixels[i] = srgb_to_linear_rgb(pixels[i]);
+
+        return;
+    }
+
+    for (size_t i = 0; i < pixel_count; ++i)
+    {
+        float* p = &pixels[i * channel_count];
+        p[0] = srgb_to_linear_rgb(p[0]);
+        p[1] = srgb_to_linear_rgb(p[1]);
+        p[2] = srgb_to_linear_rgb(p[2]);
+    }
+}
+
+
+//
+// Linear RGB <-> CIE XYZ transformations implementation.
+//
+
+void convert_ciexyz_to_linear_rgb(
+    float*              pixels,
+    const size_t        pixel_count,
+    const size_t        channel_count)
+{
+    assert(channel_count >= 3);
+
+#ifdef APPLESEED_USE_SSE
+    if (channel_count == 4)
+    {
+        // Columns of the CIE XYZ to linear RGB matrix.
+        const __m128 cx = _mm_set_ps(0.0f,  0.055648f, -0.969256f,  3.240479f);
+        const __m128 cy = _mm_set_ps(0.0f, -0.204043f,  1.875991f, -1.537150f);
+        const __m128 cz = _mm_set_ps(0.0f,  1.057311f,  0.041556f, -0.498535f);
+        const __m128 rgb_mask = _mm_castsi128_ps(_mm_set_epi32(0, ~0, ~0, ~0));
+        const __m128 zero = _mm_setzero_ps();
+
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            float* p = &pixels[i * 4];
+            const __m128 xyza = _mm_loadu_ps(p);
+
+            __m128 rgba = _mm_mul_ps(cx, _mm_shuffle_ps(xyza, xyza, _MM_SHUFFLE(0, 0, 0, 0)));
+            rgba = _mm_add_ps(rgba, _mm_mul_ps(cy, _mm_shuffle_ps(xyza, xyza, _MM_SHUFFLE(1, 1, 1, 1))));
+            rgba = _mm_add_ps(rgba, _mm_mul_ps(cz, _mm_shuffle_ps(xyza, xyza, _MM_SHUFFLE(2, 2, 2, 2))));
+            rgba = _mm_max_ps(rgba, zero);
+            rgba = _mm_or_ps(_mm_and_ps(rgb_mask, rgba), _mm_andnot_ps(rgb_mask, xyza));
+
+            _mm_storeu_ps(p, rgba);
+        }
+
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < pixel_count; ++i)
+    {
+        float* p = &pixels[i * channel_count];
+        const Color3f linear_rgb = ciexyz_to_linear_rgb(Color3f(p[0], p[1], p[2]));
+        p[0] = linear_rgb[0];
+        p[1] = linear_rgb[1];
+        p[2] = linear_rgb[2];
+    }
+}
+
+
 //
 // Lighting conditions class implementation.
 //
@@ -40,6 +40,7 @@
 #ifdef APPLESEED_USE_SSE
 #include "foundation/platform/sse.h"
 #endif
+#include "foundation/platform/types.h"
 #include "foundation/utility/otherwise.h"
 
 // appleseed.main headers.
@@ -295,6 +296,50 @@ inline __m128 fast_linear_rgb_to_srgb(const __m128 linear_rgb);
 Color3f fast_linear_rgb_to_srgb(const Color3f& linear_rgb);
 Color3f fast_srgb_to_linear_rgb(const Color3f& srgb);
 
+// Convert an 8-bit or 16-bit sRGB-encoded color component to a linear RGB value in [0, 1]
+// using a lookup table.
+float srgb_uint8_to_linear_rgb(const uint8 c);
+float srgb_uint16_to_linear_rgb(const uint16 c);
+
+// Lookup tables used by the functions above.
+DLLSYMBOL extern float SRGBUInt8ToLinearRGBTable[256];
+DLLSYMBOL extern float SRGBUInt16ToLinearRGBTable[65536];
+
+
+//
+// Bulk conversion of arrays of pixels to the linear RGB color space.
+//
+// Only the first three channels of each pixel are converted. Additional channels
+// (typically alpha) are left untouched, or simply normalized to [0, 1] when converting
+// from integer formats. Conversions of floating-point pixels are done in place; CIE XYZ
+// conversions use SSE when available. Input and output arrays need not be aligned.
+//
+
+// Convert 8-bit or 16-bit sRGB pixels to floating-point linear RGB pixels.
+DLLSYMBOL void convert_srgb_to_linear_rgb(
+    const uint8*        input,
+    float*              output,
+    const size_t        pixel_count,
+    const size_t        channel_count);
+DLLSYMBOL void convert_srgb_to_linear_rgb(
+    const uint16*       input,
+    float*              output,
+    const size_t        pixel_count,
+    const size_t        channel_count);
+
+// Convert floating-point sRGB pixels to linear RGB, in place.
+// Uses the exact sRGB transfer function.
+DLLSYMBOL void convert_srgb_to_linear_rgb(
+    float*              pixels,
+    const size_t        pixel_count,
+    const size_t        channel_count);
+
+// Convert floating-point CIE XYZ pixels to linear RGB, in place.
+DLLSYMBOL void convert_ciexyz_to_linear_rgb(
+    float*              pixels,
+    const size_t        pixel_count,
+    const size_t        channel_count);
+
 
 //
 // Compute the relative luminance of a linear RGB triplet as defined
@@ -714,6 +759,16 @@ inline Color3f fast_srgb_to_linear_rgb(const Color3f& srgb)
         fast_srgb_to_linear_rgb(srgb[2]));
 }
 
+inline float srgb_uint8_to_linear_rgb(const uint8 c)
+{
+    return SRGBUInt8ToLinearRGBTable[c];
+}
+
+inline float srgb_uint16_to_linear_rgb(const uint16 c)
+{
+    return SRGBUInt16ToLinearRGBTable[c];
+}
+
 
 //
 // Relative luminance function implementation.
@@ -39,6 +39,7 @@
 // OpenEXR headers.
 #include "OpenEXR/ImfStandardAttributes.h"
 #include "OpenEXR/ImfStringAttribute.h"
+#include "OpenEXR/ImfTestFile.h"
 #include "OpenEXR/ImfThreading.h"
 
 // Standard headers.
@@ -67,6 +68,11 @@ void initialize_openexr()
     static OpenEXRInitializer initializer;
 }
 
+bool is_tiled_openexr_file(const char* filename)
+{
+    return isTiledOpenExrFile(filename);
+}
+
 void add_attributes(
     const ImageAttributes&  image_attributes,
     Header&                 header)
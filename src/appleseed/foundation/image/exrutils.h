@@ -42,6 +42,9 @@ namespace foundation
 // Configure the OpenEXR library on first use.
 void initialize_openexr();
 
+// Return true if a given file is a tiled OpenEXR file.
+bool is_tiled_openexr_file(const char* filename);
+
 // Add image attributes to an OpenEXR Header object.
 void add_attributes(
     const ImageAttributes&  image_attributes,
@@ -0,0 +1,271 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "multilayerexrimagefilewriter.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/exceptionunsupportedimageformat.h"
+#include "foundation/image/exrutils.h"
+#include "foundation/image/icanvas.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+
+// OpenEXR headers.
+#include "OpenEXR/IexBaseExc.h"
+#include "OpenEXR/ImfChannelList.h"
+#include "OpenEXR/ImfFrameBuffer.h"
+#include "OpenEXR/ImfHeader.h"
+#include "OpenEXR/ImfPixelType.h"
+#include "OpenEXR/ImfTileDescription.h"
+#include "OpenEXR/ImfTiledOutputFile.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Iex;
+using namespace Imf;
+using namespace std;
+
+namespace foundation
+{
+
+//
+// MultiLayerEXRImageFileWriter class implementation.
+//
+
+namespace
+{
+    const char* ChannelName[] = { "R", "G", "B", "A" };
+
+    PixelType get_pixel_type(const PixelFormat pixel_format)
+    {
+        switch (pixel_format)
+        {
+          case PixelFormatUInt32: return UINT;
+          case PixelFormatHalf: return HALF;
+          case PixelFormatFloat: return FLOAT;
+          default: throw ExceptionUnsupportedImageFormat();
+        }
+    }
+
+    string make_channel_name(const string& layer_name, const size_t channel)
+    {
+        return layer_name.empty()
+            ? string(ChannelName[channel])
+            : layer_name + "." + ChannelName[channel];
+    }
+}
+
+struct MultiLayerEXRImageFileWriter::Impl
+{
+    struct Layer
+    {
+        string              m_name;
+        const ICanvas*      m_image;
+        PixelType           m_pixel_type;
+        size_t              m_pixel_size;   // size in bytes of one pixel
+        vector<char>        m_row;          // one row of tiles
+    };
+
+    vector<Layer>           m_layers;
+};
+
+MultiLayerEXRImageFileWriter::MultiLayerEXRImageFileWriter()
+  : impl(new Impl())
+{
+}
+
+MultiLayerEXRImageFileWriter::~MultiLayerEXRImageFileWriter()
+{
+    delete impl;
+}
+
+void MultiLayerEXRImageFileWriter::append_layer(
+    const char*             name,
+    const ICanvas&          image)
+{
+    assert(name);
+
+    const CanvasProperties& props = image.properties();
+
+    // todo: lift this limitation.
+    if (props.m_channel_count == 0 || props.m_channel_count > 4)
+        throw ExceptionUnsupportedImageFormat();
+
+    // Throws ExceptionUnsupportedImageFormat if the pixel format cannot be written.
+    const PixelType pixel_type = get_pixel_type(props.m_pixel_format);
+
+    if (!impl->m_layers.empty())
+    {
+        const CanvasProperties& main_props = impl->m_layers.front().m_image->properties();
+        assert(props.m_canvas_width == main_props.m_canvas_width);
+        assert(props.m_canvas_height == main_props.m_canvas_height);
+        assert(props.m_tile_width == main_props.m_tile_width);
+        assert(props.m_tile_height == main_props.m_tile_height);
+    }
+
+    Impl::Layer layer;
+    layer.m_name = name;
+    layer.m_image = &image;
+    layer.m_pixel_type = pixel_type;
+    layer.m_pixel_size = props.m_pixel_size;
+
+    impl->m_layers.push_back(layer);
+}
+
+size_t MultiLayerEXRImageFileWriter::get_layer_count() const
+{
+    return impl->m_layers.size();
+}
+
+void MultiLayerEXRImageFileWriter::write(
+    const char*             filename,
+    const ImageAttributes&  image_attributes)
+{
+    assert(filename);
+    assert(!impl->m_layers.empty());
+
+    initialize_openexr();
+
+    try
+    {
+        const CanvasProperties& props = impl->m_layers.front().m_image->properties();
+
+        // Construct ChannelList object.
+        ChannelList channels;
+        for (size_t i = 0; i < impl->m_layers.size(); ++i)
+        {
+            const Impl::Layer& layer = impl->m_layers[i];
+            const size_t channel_count = layer.m_image->properties().m_channel_count;
+
+            for (size_t c = 0; c < channel_count; ++c)
+            {
+                channels.insert(
+                    make_channel_name(layer.m_name, c).c_str(),
+                    Channel(layer.m_pixel_type));
+            }
+        }
+
+        // Construct Header object.
+        Header header(
+            static_cast<int>(props.m_canvas_width),
+            static_cast<int>(props.m_canvas_height),
+            static_cast<float>(props.m_canvas_width) / props.m_canvas_height);
+        header.setTileDescription(
+            TileDescription(
+                static_cast<unsigned int>(props.m_tile_width),
+                static_cast<unsigned int>(props.m_tile_height),
+                ONE_LEVEL));
+        header.channels() = channels;
+
+        // Add image attributes to the Header object.
+        add_attributes(image_attributes, header);
+
+        // Create the output file.
+        TiledOutputFile file(filename, header);
+
+        // Allocate one row of tiles per layer.
+        for (size_t i = 0; i < impl->m_layers.size(); ++i)
+        {
+            Impl::Layer& layer = impl->m_layers[i];
+            layer.m_row.resize(props.m_canvas_width * props.m_tile_height * layer.m_pixel_size);
+        }
+
+        for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+        {
+            const size_t row_origin_y = ty * props.m_tile_height;
+
+            FrameBuffer framebuffer;
+
+            for (size_t i = 0; i < impl->m_layers.size(); ++i)
+            {
+                Impl::Layer& layer = impl->m_layers[i];
+                const CanvasProperties& layer_props = layer.m_image->properties();
+                const size_t stride_x = layer.m_pixel_size;
+                const size_t stride_y = stride_x * props.m_canvas_width;
+
+                // Gather the tiles of this row into a contiguous buffer.
+                for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+                {
+                    const Tile& tile = layer.m_image->tile(tx, ty);
+                    const size_t tile_row_size = tile.get_width() * stride_x;
+                    char* dest = &layer.m_row[0] + tx * props.m_tile_width * stride_x;
+
+                    for (size_t y = 0; y < tile.get_height(); ++y)
+                    {
+                        memcpy(
+                            dest + y * stride_y,
+                            tile.pixel(0, y),
+                            tile_row_size);
+                    }
+                }
+
+                // OpenEXR addresses pixels with absolute coordinates.
+                const char* row_base = &layer.m_row[0] - row_origin_y * stride_y;
+                const size_t channel_size = stride_x / layer_props.m_channel_count;
+
+                for (size_t c = 0; c < layer_props.m_channel_count; ++c)
+                {
+                    framebuffer.insert(
+                        make_channel_name(layer.m_name, c).c_str(),
+                        Slice(
+                            layer.m_pixel_type,
+                            const_cast<char*>(row_base + c * channel_size),
+                            stride_x,
+                            stride_y));
+                }
+            }
+
+            // Write the whole row of tiles at once: tiles are compressed in parallel.
+            file.setFrameBuffer(framebuffer);
+            file.writeTiles(
+                0,
+                static_cast<int>(props.m_tile_count_x - 1),
+                static_cast<int>(ty),
+                static_cast<int>(ty));
+        }
+
+        // Release the row buffers.
+        for (size_t i = 0; i < impl->m_layers.size(); ++i)
+            vector<char>().swap(impl->m_layers[i].m_row);
+    }
+    catch (const BaseExc& e)
+    {
+        // I/O error.
+        throw ExceptionIOError(e.what());
+    }
+}
+
+}   // namespace foundation
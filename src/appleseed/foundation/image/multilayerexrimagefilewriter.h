@@ -0,0 +1,92 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_IMAGE_MULTILAYEREXRIMAGEFILEWRITER_H
+#define APPLESEED_FOUNDATION_IMAGE_MULTILAYEREXRIMAGEFILEWRITER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/image/imageattributes.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace foundation    { class ICanvas; }
+
+namespace foundation
+{
+
+//
+// Writes multiple images to the layers of a single tiled OpenEXR file.
+//
+// The channels of the main layer (the layer with an empty name) are named R, G, B and A;
+// the channels of the other layers are prefixed with the name of the layer, as in
+// "diffuse.R". All layers must have the same canvas and tile dimensions but may use
+// different pixel formats.
+//
+// Tiles are handed over to OpenEXR one row at a time so that they get compressed in
+// parallel by OpenEXR's global thread pool.
+//
+
+class DLLSYMBOL MultiLayerEXRImageFileWriter
+  : public NonCopyable
+{
+  public:
+    // Constructor.
+    MultiLayerEXRImageFileWriter();
+
+    // Destructor.
+    ~MultiLayerEXRImageFileWriter();
+
+    // Append a layer. The image must remain valid until write() returns.
+    // Throws ExceptionUnsupportedImageFormat if the image has more than four channels
+    // or a pixel format other than 32-bit unsigned integer, half or float.
+    void append_layer(
+        const char*             name,
+        const ICanvas&          image);
+
+    // Return the number of layers.
+    size_t get_layer_count() const;
+
+    // Write all layers to an OpenEXR file.
+    void write(
+        const char*             filename,
+        const ImageAttributes&  image_attributes = ImageAttributes());
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_IMAGE_MULTILAYEREXRIMAGEFILEWRITER_H
@@ -297,6 +297,14 @@ void Intersector<Tree, Visitor, Ray, StackSize, N>::intersect_motion(
 
         if (node_ptr->is_interior())
         {
+            if (node_ptr->is_temporal_split())
+            {
+                // Continue with the child node whose time interval contains the ray time.
+                const size_t child_node_index = node_ptr->get_child_node_index();
+                node_ptr = &tree.m_nodes[child_node_index + (ray_time < node_ptr->get_split_time() ? 0 : 1)];
+                continue;
+            }
+
             FOUNDATION_BVH_TRAVERSAL_STATS(intersected_bboxes += 2);
 
             ValueType tmin[2];
@@ -665,6 +673,14 @@ void Intersector<Tree, Visitor, Ray, StackSize, 3>::intersect_motion(
 
         if (node_ptr->is_interior())
         {
+            if (node_ptr->is_temporal_split())
+            {
+                // Continue with the child node whose time interval contains the ray time.
+                const size_t child_node_index = node_ptr->get_child_node_index();
+                node_ptr = &tree.m_nodes[child_node_index + (ray_time < node_ptr->get_split_time() ? 0 : 1)];
+                continue;
+            }
+
             FOUNDATION_BVH_TRAVERSAL_STATS(intersected_bboxes += 2);
 
             __m128d tmin, tmax;
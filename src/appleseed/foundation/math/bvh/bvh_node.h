@@ -76,6 +76,13 @@ class APPLESEED_ALIGN(64) Node
     size_t get_right_bbox_index() const;
     size_t get_right_bbox_count() const;
 
+    // Turn an interior node into a temporal split node (motion case): the left child node
+    // covers times in [0, split_time) and the right child node covers times in [split_time, 1].
+    // Temporal split nodes have no bounding boxes; the ray time alone selects the child node.
+    void make_temporal_split(const typename AABBType::ValueType split_time);
+    bool is_temporal_split() const;
+    typename AABBType::ValueType get_split_time() const;
+
     // Access user data (leaf nodes only).
     static const size_t MaxUserDataSize;
     template <typename U> void set_user_data(const U& data);
@@ -241,6 +248,28 @@ inline size_t Node<AABB>::get_right_bbox_count() const
     return static_cast<uint32>(m_right_bbox_count);
 }
 
+template <typename AABB>
+inline void Node<AABB>::make_temporal_split(const typename AABBType::ValueType split_time)
+{
+    assert(is_interior());
+    m_left_bbox_count = ~0;
+    m_right_bbox_count = ~0;
+    m_bbox_data[0] = split_time;
+}
+
+template <typename AABB>
+inline bool Node<AABB>::is_temporal_split() const
+{
+    return m_left_bbox_count == ~0;
+}
+
+template <typename AABB>
+inline typename AABB::ValueType Node<AABB>::get_split_time() const
+{
+    assert(is_temporal_split());
+    return m_bbox_data[0];
+}
+
 #define MAX_USER_DATA_SIZE (4 * Node<AABB>::Dimension * sizeof(typename AABB::ValueType))
 
 template <typename AABB>
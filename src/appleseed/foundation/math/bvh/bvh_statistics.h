@@ -150,6 +150,13 @@ void TreeStatistics<Tree>::collect_stats_recurse(
         if (bbox.is_valid())
             m_leaf_volume += bbox.volume();
     }
+    else if (node.is_temporal_split())
+    {
+        // Both children of a temporal split node cover the whole bounding box.
+        const size_t child_index = node.get_child_node_index();
+        collect_stats_recurse(tree, tree.m_nodes[child_index], bbox, depth + 1);
+        collect_stats_recurse(tree, tree.m_nodes[child_index + 1], bbox, depth + 1);
+    }
     else
     {
         // Fetch left and right children.
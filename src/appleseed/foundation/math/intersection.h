@@ -37,6 +37,7 @@
 #include "foundation/math/intersection/raysphere.h"
 #include "foundation/math/intersection/raytrianglehh.h"
 #include "foundation/math/intersection/raytrianglemt.h"
+#include "foundation/math/intersection/raytrianglemt4.h"
 #include "foundation/math/intersection/raytrianglessk.h"
 
 #endif  // !APPLESEED_FOUNDATION_MATH_INTERSECTION_H
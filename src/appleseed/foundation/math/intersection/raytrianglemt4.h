@@ -0,0 +1,309 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYTRIANGLEMT4_H
+#define APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYTRIANGLEMT4_H
+
+// appleseed.foundation headers.
+#include "foundation/math/intersection/raytrianglemt.h"
+#include "foundation/math/ray.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/compiler.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// Four triangles in structure-of-arrays layout, intersected at once with a 4-way
+// version of the Moeller-Trumbore ray-triangle intersection test (see raytrianglemt.h).
+//
+// For any given triangle, the test computes exactly the same thing as TriangleMT:
+// when intersecting rays of type U with triangles stored with type T, the result
+// is identical to the one of TriangleMT<U>(TriangleMT<T>(...)).intersect(ray, ...).
+//
+
+template <typename T>
+struct TriangleMT4
+{
+    // Types.
+    typedef T ValueType;
+    typedef Vector<T, 3> VectorType;
+    typedef TriangleMT<T> TriangleType;
+
+    // Number of triangles.
+    static const size_t Size = 4;
+
+    // First vertices.
+    ValueType   m_v0x[4];
+    ValueType   m_v0y[4];
+    ValueType   m_v0z[4];
+
+    // First edges.
+    ValueType   m_e0x[4];
+    ValueType   m_e0y[4];
+    ValueType   m_e0z[4];
+
+    // Second edges.
+    ValueType   m_e1x[4];
+    ValueType   m_e1y[4];
+    ValueType   m_e1z[4];
+
+    // Set/get one of the four triangles.
+    void set(const size_t index, const TriangleType& triangle);
+    TriangleType get(const size_t index) const;
+
+    // Intersect a ray with all four triangles. Returns a 4-bit mask where bit i is
+    // set if the ray hits triangle i, in which case t[i], u[i] and v[i] are set.
+    template <typename U>
+    size_t intersect(
+        const Ray<U, 3>&    ray,
+        U                   t[4],
+        U                   u[4],
+        U                   v[4]) const;
+
+    // Same as above, but only return the mask of the triangles hit by the ray.
+    template <typename U>
+    size_t intersect(const Ray<U, 3>& ray) const;
+};
+
+
+//
+// TriangleMT4 class implementation.
+//
+
+template <typename T>
+inline void TriangleMT4<T>::set(const size_t index, const TriangleType& triangle)
+{
+    assert(index < Size);
+
+    m_v0x[index] = triangle.m_v0.x;
+    m_v0y[index] = triangle.m_v0.y;
+    m_v0z[index] = triangle.m_v0.z;
+
+    m_e0x[index] = triangle.m_e0.x;
+    m_e0y[index] = triangle.m_e0.y;
+    m_e0z[index] = triangle.m_e0.z;
+
+    m_e1x[index] = triangle.m_e1.x;
+    m_e1y[index] = triangle.m_e1.y;
+    m_e1z[index] = triangle.m_e1.z;
+}
+
+template <typename T>
+inline TriangleMT<T> TriangleMT4<T>::get(const size_t index) const
+{
+    assert(index < Size);
+
+    TriangleType triangle;
+
+    triangle.m_v0 = VectorType(m_v0x[index], m_v0y[index], m_v0z[index]);
+    triangle.m_e0 = VectorType(m_e0x[index], m_e0y[index], m_e0z[index]);
+    triangle.m_e1 = VectorType(m_e1x[index], m_e1y[index], m_e1z[index]);
+
+    return triangle;
+}
+
+template <typename T>
+template <typename U>
+inline size_t TriangleMT4<T>::intersect(
+    const Ray<U, 3>&        ray,
+    U                       t[4],
+    U                       u[4],
+    U                       v[4]) const
+{
+    size_t mask = 0;
+
+    for (size_t i = 0; i < Size; ++i)
+    {
+        const TriangleMT<U> triangle(get(i));
+
+        if (triangle.intersect(ray, t[i], u[i], v[i]))
+            mask |= size_t(1) << i;
+    }
+
+    return mask;
+}
+
+template <typename T>
+template <typename U>
+inline size_t TriangleMT4<T>::intersect(const Ray<U, 3>& ray) const
+{
+    U t[4], u[4], v[4];
+    return intersect(ray, t, u, v);
+}
+
+#ifdef APPLESEED_USE_SSE
+
+//
+// SSE2 implementation for single precision triangles and double precision rays,
+// the combination used by the renderer. The four triangles are processed as two
+// pairs of double precision lanes, which preserves the exact results of TriangleMT.
+//
+
+namespace impl
+{
+    struct TriangleMT4DoubleLanes
+    {
+        __m128d m_org_x, m_org_y, m_org_z;
+        __m128d m_dir_x, m_dir_y, m_dir_z;
+        __m128d m_tmin, m_tmax;
+
+        explicit TriangleMT4DoubleLanes(const Ray<double, 3>& ray)
+          : m_org_x(_mm_set1_pd(ray.m_org.x))
+          , m_org_y(_mm_set1_pd(ray.m_org.y))
+          , m_org_z(_mm_set1_pd(ray.m_org.z))
+          , m_dir_x(_mm_set1_pd(ray.m_dir.x))
+          , m_dir_y(_mm_set1_pd(ray.m_dir.y))
+          , m_dir_z(_mm_set1_pd(ray.m_dir.z))
+          , m_tmin(_mm_set1_pd(ray.m_tmin))
+          , m_tmax(_mm_set1_pd(ray.m_tmax))
+        {
+        }
+
+        // Intersect triangles 'first' and 'first + 1'. Returns a 2-bit mask.
+        FORCE_INLINE int intersect(
+            const TriangleMT4<float>&   triangles,
+            const size_t                first,
+            double                      t[2],
+            double                      u[2],
+            double                      v[2]) const
+        {
+            const __m128d v0x = load(triangles.m_v0x + first);
+            const __m128d v0y = load(triangles.m_v0y + first);
+            const __m128d v0z = load(triangles.m_v0z + first);
+            const __m128d e0x = load(triangles.m_e0x + first);
+            const __m128d e0y = load(triangles.m_e0y + first);
+            const __m128d e0z = load(triangles.m_e0z + first);
+            const __m128d e1x = load(triangles.m_e1x + first);
+            const __m128d e1y = load(triangles.m_e1y + first);
+            const __m128d e1z = load(triangles.m_e1z + first);
+
+            // Calculate determinant: pvec = cross(dir, e1), det = dot(e0, pvec).
+            const __m128d pvec_x = _mm_sub_pd(_mm_mul_pd(m_dir_y, e1z), _mm_mul_pd(e1y, m_dir_z));
+            const __m128d pvec_y = _mm_sub_pd(_mm_mul_pd(m_dir_z, e1x), _mm_mul_pd(e1z, m_dir_x));
+            const __m128d pvec_z = _mm_sub_pd(_mm_mul_pd(m_dir_x, e1y), _mm_mul_pd(e1x, m_dir_y));
+            const __m128d det = dot(e0x, e0y, e0z, pvec_x, pvec_y, pvec_z);
+
+            // Calculate distance from v0 to ray origin.
+            const __m128d tvec_x = _mm_sub_pd(m_org_x, v0x);
+            const __m128d tvec_y = _mm_sub_pd(m_org_y, v0y);
+            const __m128d tvec_z = _mm_sub_pd(m_org_z, v0z);
+
+            // Calculate u parameter.
+            const __m128d uu = dot(tvec_x, tvec_y, tvec_z, pvec_x, pvec_y, pvec_z);
+
+            // Calculate v parameter: qvec = cross(tvec, e0), v = dot(dir, qvec).
+            const __m128d qvec_x = _mm_sub_pd(_mm_mul_pd(tvec_y, e0z), _mm_mul_pd(e0y, tvec_z));
+            const __m128d qvec_y = _mm_sub_pd(_mm_mul_pd(tvec_z, e0x), _mm_mul_pd(e0z, tvec_x));
+            const __m128d qvec_z = _mm_sub_pd(_mm_mul_pd(tvec_x, e0y), _mm_mul_pd(e0x, tvec_y));
+            const __m128d vv = dot(m_dir_x, m_dir_y, m_dir_z, qvec_x, qvec_y, qvec_z);
+
+            // Calculate t parameter.
+            const __m128d tt = dot(e1x, e1y, e1z, qvec_x, qvec_y, qvec_z);
+
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d uv = _mm_add_pd(uu, vv);
+            const __m128d tmax_det = _mm_mul_pd(m_tmax, det);
+            const __m128d tmin_det = _mm_mul_pd(m_tmin, det);
+
+            // Bound tests for positive determinants, written like the scalar version to handle NaNs identically.
+            const __m128d pos =
+                _mm_and_pd(
+                    _mm_and_pd(
+                        _mm_and_pd(_mm_cmpgt_pd(det, zero), _mm_cmpnlt_pd(uu, zero)),
+                        _mm_and_pd(_mm_cmpngt_pd(uu, det), _mm_cmpnlt_pd(vv, zero))),
+                    _mm_and_pd(
+                        _mm_cmpngt_pd(uv, det),
+                        _mm_and_pd(_mm_cmpnge_pd(tt, tmax_det), _mm_cmpnlt_pd(tt, tmin_det))));
+
+            // Bound tests for negative or null determinants.
+            const __m128d neg =
+                _mm_and_pd(
+                    _mm_and_pd(
+                        _mm_and_pd(_mm_cmpngt_pd(det, zero), _mm_cmpngt_pd(uu, zero)),
+                        _mm_and_pd(_mm_cmpnlt_pd(uu, det), _mm_cmpngt_pd(vv, zero))),
+                    _mm_and_pd(
+                        _mm_cmpnlt_pd(uv, det),
+                        _mm_and_pd(_mm_cmpnle_pd(tt, tmax_det), _mm_cmpngt_pd(tt, tmin_det))));
+
+            const int mask = _mm_movemask_pd(_mm_or_pd(pos, neg));
+
+            if (mask)
+            {
+                // Scale parameters.
+                const __m128d rcp_det = _mm_div_pd(_mm_set1_pd(1.0), det);
+                _mm_storeu_pd(t, _mm_mul_pd(tt, rcp_det));
+                _mm_storeu_pd(u, _mm_mul_pd(uu, rcp_det));
+                _mm_storeu_pd(v, _mm_mul_pd(vv, rcp_det));
+            }
+
+            return mask;
+        }
+
+      private:
+        static FORCE_INLINE __m128d load(const float* p)
+        {
+            return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+        }
+
+        static FORCE_INLINE __m128d dot(
+            const __m128d ax, const __m128d ay, const __m128d az,
+            const __m128d bx, const __m128d by, const __m128d bz)
+        {
+            return _mm_add_pd(_mm_add_pd(_mm_mul_pd(ax, bx), _mm_mul_pd(ay, by)), _mm_mul_pd(az, bz));
+        }
+    };
+}
+
+template <>
+template <>
+FORCE_INLINE size_t TriangleMT4<float>::intersect<double>(
+    const Ray<double, 3>&   ray,
+    double                  t[4],
+    double                  u[4],
+    double                  v[4]) const
+{
+    const impl::TriangleMT4DoubleLanes lanes(ray);
+
+    return
+        static_cast<size_t>(lanes.intersect(*this, 0, t, u, v)) |
+        static_cast<size_t>(lanes.intersect(*this, 2, t + 2, u + 2, v + 2)) << 2;
+}
+
+#endif  // APPLESEED_USE_SSE
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_INTERSECTION_RAYTRIANGLEMT4_H
@@ -0,0 +1,129 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
+#define APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+namespace foundation
+{
+
+//
+// Compact storage of unit vectors using the octahedral mapping.
+//
+// A unit vector is projected onto the octahedron |x| + |y| + |z| = 1, the lower
+// hemisphere is folded over the upper one, and the resulting 2D coordinates are
+// quantized to two signed 16-bit integers packed into a single 32-bit word.
+// The maximum angular error is well below 0.01 degree.
+//
+// Reference:
+//
+//   A Survey of Efficient Representations for Independent Unit Vectors
+//   http://jcgt.org/published/0003/02/01/
+//
+
+// Pack a unit vector into 32 bits.
+template <typename T>
+uint32 pack_unit_vector_octahedral(const Vector<T, 3>& v);
+
+// Unpack a unit vector packed with pack_unit_vector_octahedral().
+// The returned vector is unit-length.
+template <typename T>
+Vector<T, 3> unpack_unit_vector_octahedral(const uint32 packed);
+
+
+//
+// Implementation.
+//
+
+namespace octahedral_impl
+{
+    template <typename T>
+    inline T sign_not_zero(const T x)
+    {
+        return x >= T(0.0) ? T(1.0) : T(-1.0);
+    }
+
+    template <typename T>
+    inline uint32 quantize(const T x)
+    {
+        return static_cast<uint16>(static_cast<int16>(round<int32>(clamp(x, T(-1.0), T(1.0)) * T(32767.0))));
+    }
+
+    template <typename T>
+    inline T dequantize(const uint32 q)
+    {
+        return clamp(static_cast<T>(static_cast<int16>(static_cast<uint16>(q))) * T(1.0 / 32767.0), T(-1.0), T(1.0));
+    }
+}
+
+template <typename T>
+inline uint32 pack_unit_vector_octahedral(const Vector<T, 3>& v)
+{
+    const T rcp_norm1 = T(1.0) / (abs(v[0]) + abs(v[1]) + abs(v[2]));
+
+    T x = v[0] * rcp_norm1;
+    T y = v[1] * rcp_norm1;
+
+    if (v[2] < T(0.0))
+    {
+        const T folded_x = (T(1.0) - abs(y)) * octahedral_impl::sign_not_zero(x);
+        const T folded_y = (T(1.0) - abs(x)) * octahedral_impl::sign_not_zero(y);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    return octahedral_impl::quantize(x) | (octahedral_impl::quantize(y) << 16);
+}
+
+template <typename T>
+inline Vector<T, 3> unpack_unit_vector_octahedral(const uint32 packed)
+{
+    Vector<T, 3> v;
+    v[0] = octahedral_impl::dequantize<T>(packed & 0xFFFF);
+    v[1] = octahedral_impl::dequantize<T>(packed >> 16);
+    v[2] = T(1.0) - abs(v[0]) - abs(v[1]);
+
+    if (v[2] < T(0.0))
+    {
+        const T unfolded_x = (T(1.0) - abs(v[1])) * octahedral_impl::sign_not_zero(v[0]);
+        const T unfolded_y = (T(1.0) - abs(v[0])) * octahedral_impl::sign_not_zero(v[1]);
+        v[0] = unfolded_x;
+        v[1] = unfolded_y;
+    }
+
+    return normalize(v);
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_OCTAHEDRAL_H
@@ -297,4 +297,108 @@ const double PrecomputedHaltonSequence[4 * PrecomputedHaltonSequenceSize] =
     0.9960937500000000, 0.1495198902606310, 0.0432000000000000, 0.4635568513119533
 };
 
+
+//
+// Generator matrices of the first 16 dimensions of the Sobol sequence, stored bit-major.
+//
+
+const uint32 SobolMatrices[32 * SobolDimensionCount] =
+{
+    0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000,
+    0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000, 0x80000000,
+
+    0x40000000, 0xC0000000, 0xC0000000, 0xC0000000, 0x40000000, 0x40000000, 0xC0000000, 0x40000000,
+    0x40000000, 0x40000000, 0x40000000, 0x40000000, 0xC0000000, 0xC0000000, 0x40000000, 0xC0000000,
+
+    0x20000000, 0xA0000000, 0x60000000, 0x20000000, 0x20000000, 0x60000000, 0xA0000000, 0xA0000000,
+    0xA0000000, 0xE0000000, 0xA0000000, 0x20000000, 0xA0000000, 0x60000000, 0x20000000, 0x20000000,
+
+    0x10000000, 0xF0000000, 0x90000000, 0x50000000, 0xB0000000, 0x30000000, 0xD0000000, 0x50000000,
+    0x50000000, 0xB0000000, 0x10000000, 0x30000000, 0x50000000, 0x90000000, 0xF0000000, 0xD0000000,
+
+    0x08000000, 0x88000000, 0xE8000000, 0xF8000000, 0xF8000000, 0xC8000000, 0x58000000, 0x88000000,
+    0x28000000, 0x98000000, 0x08000000, 0x58000000, 0xF8000000, 0x38000000, 0xA8000000, 0xD8000000,
+
+    0x04000000, 0xCC000000, 0x5C000000, 0x74000000, 0xDC000000, 0x24000000, 0x94000000, 0x24000000,
+    0xD4000000, 0x94000000, 0x6C000000, 0xAC000000, 0x8C000000, 0xC4000000, 0x54000000, 0xC4000000,
+
+    0x02000000, 0xAA000000, 0x8E000000, 0xA2000000, 0x7A000000, 0x56000000, 0x3E000000, 0x12000000,
+    0x6A000000, 0x8A000000, 0x9E000000, 0x96000000, 0xE2000000, 0x42000000, 0x9A000000, 0x46000000,
+
+    0x01000000, 0xFF000000, 0xC5000000, 0x93000000, 0x9D000000, 0xFB000000, 0xE3000000, 0x2D000000,
+    0x71000000, 0x5B000000, 0x23000000, 0x2B000000, 0x33000000, 0xA3000000, 0x9D000000, 0x85000000,
+
+    0x00800000, 0x80800000, 0x68800000, 0xD8800000, 0x5A800000, 0xE0800000, 0xBE800000, 0x76800000,
+    0x38800000, 0x33800000, 0x57800000, 0xD4800000, 0x0F800000, 0xF1800000, 0x1E800000, 0xA5800000,
+
+    0x00400000, 0xC0C00000, 0x9CC00000, 0x25400000, 0x2FC00000, 0x70400000, 0x23C00000, 0x9E400000,
+    0x58400000, 0xD9C00000, 0xADC00000, 0x09400000, 0x21400000, 0xAA400000, 0x5CC00000, 0x76C00000,
+
+    0x00200000, 0xA0A00000, 0xEE600000, 0x59E00000, 0xA1600000, 0xA8600000, 0x1E200000, 0x08200000,
+    0xEA200000, 0x72200000, 0x7FA00000, 0xE2A00000, 0x95A00000, 0xFCE00000, 0x7D200000, 0xADA00000,
+
+    0x00100000, 0xF0F00000, 0x55900000, 0xE6D00000, 0xF0B00000, 0x14300000, 0xF3100000, 0x64100000,
+    0x31100000, 0x3F100000, 0x91D00000, 0x52500000, 0x5E700000, 0x85100000, 0x8D100000, 0x6AB00000,
+
+    0x00080000, 0x88880000, 0x80680000, 0x78080000, 0xDA880000, 0x9EC80000, 0x46780000, 0xB2280000,
+    0x98A80000, 0xC1B80000, 0x49880000, 0x4E280000, 0xD8080000, 0xE0080000, 0x24880000, 0x2DA80000,
+
+    0x00040000, 0xCCCC0000, 0xC09C0000, 0xB40C0000, 0x6FC40000, 0xDF240000, 0x67840000, 0x7D140000,
+    0x08540000, 0xA6EC0000, 0xCED40000, 0xC71C0000, 0x1C240000, 0x500C0000, 0x71C40000, 0xAABC0000,
+
+    0x00020000, 0xAAAA0000, 0x60EE0000, 0x82020000, 0x81620000, 0xB6D60000, 0x78460000, 0xFEA20000,
+    0xC22A0000, 0x53860000, 0x880A0000, 0x629E0000, 0xBA160000, 0x58060000, 0xEBA20000, 0x0DAA0000,
+
+    0x00010000, 0xFFFF0000, 0x90550000, 0xC3050000, 0x40BB0000, 0x8BBB0000, 0x84670000, 0xBA490000,
+    0xE5250000, 0x29F50000, 0x2C0F0000, 0x12670000, 0xEF370000, 0x54090000, 0x75DF0000, 0x7AB10000,
+
+    0x00008000, 0x80008000, 0xE8808000, 0x208F8000, 0x22878000, 0x48008000, 0xC6788000, 0x1A248000,
+    0xF2B28000, 0x0A3A8000, 0x3E0D8000, 0x6E138000, 0x15868000, 0x7A038000, 0x6BA28000, 0xD5A78000,
+
+    0x00004000, 0xC000C000, 0x5CC0C000, 0x51474000, 0xB3C9C000, 0x64004000, 0xA784C000, 0x491B4000,
+    0x79484000, 0x1B2AC000, 0x3317C000, 0xF731C000, 0x9E6FC000, 0x670C4000, 0x35D14000, 0xBEBD4000,
+
+    0x00002000, 0xA000A000, 0x8E606000, 0xFBEA2000, 0xFB65A000, 0x36006000, 0xD846A000, 0xC4B5A000,
+    0xFAA42000, 0xD392E000, 0x5FB06000, 0x3A98A000, 0x781B6000, 0xB3842000, 0x4BA3A000, 0x93A3E000,
+
+    0x00001000, 0xF000F000, 0xC5909000, 0x75D93000, 0xDDB2D000, 0xCB003000, 0x5467D000, 0xE3739000,
+    0xBD731000, 0x69FF7000, 0xC1F8B000, 0xBE449000, 0x4C349000, 0x094A3000, 0xC5D2D000, 0x3BB51000,
+
+    0x00000800, 0x88008800, 0x6868E800, 0xA0858800, 0x78022800, 0x2880C800, 0x9E78D800, 0xF6800800,
+    0x18A80800, 0xEA380800, 0xE18D8800, 0xF83B8800, 0x420E8800, 0x0D6F1800, 0xE3A16800, 0x3629B800,
+
+    0x00000400, 0xCC00CC00, 0x9C9C5C00, 0x914E5400, 0x9C0B3C00, 0x54402400, 0x33845400, 0xDE400400,
+    0x48540400, 0xAB2C0400, 0xB2D7C400, 0xDC2DC400, 0x630BCC00, 0x2F5AA400, 0x91DB8C00, 0x4D727C00,
+
+    0x00000200, 0xAA00AA00, 0xEEEE8E00, 0xDBE79E00, 0x5A0FB600, 0xFE605600, 0xE6469E00, 0xA8200A00,
+    0x622A0A00, 0x4BA60E00, 0x1E106A00, 0xEE06A200, 0xF7AD6A00, 0x1CE7CE00, 0x79AEF200, 0x9B836200,
+
+    0x00000100, 0xFF00FF00, 0x5555C500, 0x25DB6D00, 0x2D0DDB00, 0xEF30FB00, 0xB7673300, 0x34100500,
+    0xB5250500, 0xFDE50B00, 0x6328B100, 0xB7239300, 0xAD739500, 0xD5145100, 0x0CDF4100, 0x27C4D700,
+
+    0x00000080, 0x80808080, 0x8000E880, 0x58800080, 0xA2878080, 0x7E48E080, 0x20F86680, 0x3A280880,
+    0xDAB28280, 0x60028980, 0xF7858880, 0x1AA80D80, 0x77800780, 0xB8000080, 0x672A8080, 0xB629B880,
+
+    0x00000040, 0xC0C0C0C0, 0xC0005CC0, 0xE54000C0, 0xF3C9C040, 0xAF647040, 0x104477C0, 0x59140240,
+    0xAD484D40, 0xF006C940, 0xBDC3C2C0, 0x8E5C0EC0, 0x6D4004C0, 0x040000C0, 0x50154040, 0x8D727CC0,
+
+    0x00000020, 0xA0A0A0A0, 0x60008E60, 0x79E00020, 0xDB65A020, 0x1EB6A860, 0xF8668020, 0xECA20120,
+    0x90A426A0, 0x7834E8A0, 0x77BA63E0, 0xA03E0B60, 0xD7A00420, 0x22000060, 0x1A01A020, 0xBB836220,
+
+    0x00000010, 0xF0F0F0F0, 0x9000C590, 0xB6D00050, 0x6DB2D0B0, 0x9F8B1430, 0x4477C010, 0x974902D0,
+    0xCC731710, 0x241A75B0, 0xFDF7B330, 0x703701B0, 0x3D700630, 0x33000090, 0xDD0DD0F0, 0xF7C4D7D0,
+
+    0x00000008, 0x88888888, 0xE8006868, 0x800800F8, 0x800228F8, 0xD6C81EC8, 0x668020F8, 0x6CA48768,
+    0x20280B88, 0x123A8B38, 0xD7800DF8, 0x783B88C8, 0x2F880F78, 0xC9800038, 0x3E83E8A8, 0x6E29B858,
+
+    0x00000004, 0xCCCCCCCC, 0x5C009C9C, 0xC00C0074, 0x400B3CDC, 0xBB249F24, 0x77C01044, 0xD75B49E4,
+    0x10140184, 0xCF2AC99C, 0xEDC0081C, 0x9C2DCA54, 0xB1640AD4, 0x6E4000C4, 0xACCACC54, 0x49727C04,
+
+    0x00000002, 0xAAAAAAAA, 0x8E00EEEE, 0x200200A2, 0x200FB67A, 0x80D6D6D6, 0x8020F866, 0xCC95A082,
+    0x880A04A2, 0xB992E922, 0xDFA0041A, 0xCE06A74A, 0xCDB6077A, 0xBEE00042, 0xD52D529A, 0xFD836266,
+
+    0x00000001, 0xFFFFFFFF, 0xC5005555, 0x50050093, 0xB00DDB9D, 0x40BBBBBB, 0xC0104477, 0x87639641,
+    0x84350611, 0x82FF78F1, 0x81D00A2D, 0x87239795, 0x824706D7, 0x261000A3, 0xD91D919D, 0x72C4D755
+};
+
 }   // namespace foundation
@@ -31,14 +31,20 @@
 #define APPLESEED_FOUNDATION_MATH_QMC_H
 
 // appleseed.foundation headers.
+#include "foundation/math/hash.h"
 #include "foundation/math/vector.h"
+#ifdef APPLESEED_USE_SSE
+#include "foundation/platform/sse.h"
+#endif
 #include "foundation/platform/types.h"
 
 // boost headers.
 #include "boost/static_assert.hpp"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 
 namespace foundation
@@ -55,7 +61,6 @@ namespace foundation
 //   implement specializations of Halton and Hammersley sequences generators for bases (2,3).
 //   implement incremental radical inverse (for successive input values).
 //   implement vectorized radical inverse functions with SSE2.
-//   implement Sobol sequence generator.
 //
 
 
@@ -198,6 +203,73 @@ Vector<T, Dim> hammersley_zaremba_sequence(
     const size_t        count);         // total number of samples in sequence
 
 
+//
+// Sobol sequences of up to SobolDimensionCount dimensions, with optional Owen scrambling.
+//
+// The generator matrices are built from the direction numbers of Joe and Kuo. They are
+// stored bit-major (for a given bit of the input, the direction numbers of all dimensions
+// are contiguous) so that several dimensions can be generated at once.
+//
+// Owen scrambling is implemented with the hash-based nested uniform scrambling of Laine
+// and Karras, as improved by Burley. Scrambling preserves the stratification properties
+// of the sequence while decorrelating sequences that use different seeds.
+//
+// References:
+//
+//   Joe and Kuo, Constructing Sobol sequences with better two-dimensional projections
+//   http://web.maths.unsw.edu.au/~fkuo/sobol/
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+// Fixed point values are 32-bit unsigned integers representing numbers in [0, 1).
+// The other return values are in the interval [0, 1)^Dim.
+//
+
+const size_t SobolDimensionCount = 16;
+extern const uint32 SobolMatrices[32 * SobolDimensionCount];
+
+// Return the input'th sample of the Sobol sequence in a given dimension, in fixed point.
+uint32 sobol_uint32(
+    const size_t        dimension,      // dimension (less than SobolDimensionCount)
+    uint32              input);         // input digits
+
+// Return n consecutive dimensions of the input'th sample of the Sobol sequence, in fixed point.
+void sobol_uint32(
+    const size_t        first_dimension,// first dimension
+    const size_t        n,              // number of dimensions (first_dimension + n <= SobolDimensionCount)
+    uint32              input,          // input digits
+    uint32              output[]);      // output values (n entries)
+
+// Apply a nested uniform (Owen) scramble to a fixed point value.
+uint32 owen_scramble(
+    uint32              x,              // value to scramble
+    const uint32        seed);          // scrambling seed
+
+// Return the input'th sample of the Sobol sequence.
+template <typename T, size_t Dim>
+Vector<T, Dim> sobol_sequence(
+    const uint32        input);         // input digits
+
+// Return the input'th sample of an Owen-scrambled Sobol sequence.
+template <typename T, size_t Dim>
+Vector<T, Dim> sobol_owen_sequence(
+    const uint32        seed,           // scrambling seed
+    const uint32        input);         // input digits
+
+
+//
+// Discrepancy of point sets.
+//
+
+// Compute the L2-star discrepancy of a set of points in [0, 1]^Dim using Warnock's formula.
+// The cost is quadratic in the number of points.
+template <typename T, size_t Dim>
+T l2_star_discrepancy(
+    const Vector<T, Dim>    points[],
+    const size_t            count);
+
+
 
 //
 // Base-2 radical inverse functions implementation.
@@ -2560,6 +2632,183 @@ inline Vector<T, Dim> hammersley_zaremba_sequence(
     return p;
 }
 
+
+//
+// Sobol sequences implementation.
+//
+
+inline uint32 sobol_uint32(
+    const size_t        dimension,
+    uint32              input)
+{
+    assert(dimension < SobolDimensionCount);
+
+    uint32 result = 0;
+
+    for (const uint32* m = SobolMatrices + dimension; input; input >>= 1, m += SobolDimensionCount)
+    {
+        if (input & 1)
+            result ^= *m;
+    }
+
+    return result;
+}
+
+inline void sobol_uint32(
+    const size_t        first_dimension,
+    const size_t        n,
+    uint32              input,
+    uint32              output[])
+{
+    assert(first_dimension + n <= SobolDimensionCount);
+
+    const uint32* m = SobolMatrices + first_dimension;
+
+#ifdef APPLESEED_USE_SSE
+
+    if (n == 4)
+    {
+        __m128i result = _mm_setzero_si128();
+
+        for (; input; input >>= 1, m += SobolDimensionCount)
+        {
+            if (input & 1)
+                result = _mm_xor_si128(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(m)));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), result);
+
+        return;
+    }
+
+#endif
+
+    for (size_t i = 0; i < n; ++i)
+        output[i] = 0;
+
+    for (; input; input >>= 1, m += SobolDimensionCount)
+    {
+        if (input & 1)
+        {
+            for (size_t i = 0; i < n; ++i)
+                output[i] ^= m[i];
+        }
+    }
+}
+
+inline uint32 owen_scramble(
+    uint32              x,
+    const uint32        seed)
+{
+    // Reverse the bits so that the scrambling of each digit only depends on the preceding ones.
+    x = (x >> 16) | (x << 16);
+    x = ((x & 0xFF00FF00) >> 8) | ((x & 0x00FF00FF) << 8);
+    x = ((x & 0xF0F0F0F0) >> 4) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x & 0xCCCCCCCC) >> 2) | ((x & 0x33333333) << 2);
+    x = ((x & 0xAAAAAAAA) >> 1) | ((x & 0x55555555) << 1);
+
+    // Laine-Karras permutation: each bit only depends on the lower bits.
+    x ^= x * 0x3D20ADEAu;
+    x += seed;
+    x *= (seed >> 16) | 1;
+    x ^= x * 0x05526C56u;
+    x ^= x * 0x53A22864u;
+
+    x = (x >> 16) | (x << 16);
+    x = ((x & 0xFF00FF00) >> 8) | ((x & 0x00FF00FF) << 8);
+    x = ((x & 0xF0F0F0F0) >> 4) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x & 0xCCCCCCCC) >> 2) | ((x & 0x33333333) << 2);
+    x = ((x & 0xAAAAAAAA) >> 1) | ((x & 0x55555555) << 1);
+
+    return x;
+}
+
+template <typename T, size_t Dim>
+inline Vector<T, Dim> sobol_sequence(
+    const uint32        input)
+{
+    BOOST_STATIC_ASSERT(Dim <= SobolDimensionCount);
+
+    uint32 values[Dim];
+    sobol_uint32(0, Dim, input, values);
+
+    Vector<T, Dim> p;
+
+    for (size_t i = 0; i < Dim; ++i)
+        p[i] = static_cast<T>(values[i]) / static_cast<T>(0x100000000LL);
+
+    return p;
+}
+
+template <typename T, size_t Dim>
+inline Vector<T, Dim> sobol_owen_sequence(
+    const uint32        seed,
+    const uint32        input)
+{
+    BOOST_STATIC_ASSERT(Dim <= SobolDimensionCount);
+
+    uint32 values[Dim];
+    sobol_uint32(0, Dim, input, values);
+
+    Vector<T, Dim> p;
+
+    for (size_t i = 0; i < Dim; ++i)
+    {
+        const uint32 x = owen_scramble(values[i], mix_uint32(seed, static_cast<uint32>(i)));
+        p[i] = static_cast<T>(x) / static_cast<T>(0x100000000LL);
+    }
+
+    return p;
+}
+
+
+//
+// Discrepancy of point sets implementation.
+//
+
+template <typename T, size_t Dim>
+T l2_star_discrepancy(
+    const Vector<T, Dim>    points[],
+    const size_t            count)
+{
+    assert(count > 0);
+
+    T sum1(0.0);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        T prod(1.0);
+
+        for (size_t k = 0; k < Dim; ++k)
+            prod *= T(1.0) - points[i][k] * points[i][k];
+
+        sum1 += prod;
+    }
+
+    T sum2(0.0);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (size_t j = 0; j < count; ++j)
+        {
+            T prod(1.0);
+
+            for (size_t k = 0; k < Dim; ++k)
+                prod *= T(1.0) - std::max(points[i][k], points[j][k]);
+
+            sum2 += prod;
+        }
+    }
+
+    const T n = static_cast<T>(count);
+    const T square =
+          std::pow(T(3.0), -static_cast<T>(Dim))
+        - std::pow(T(2.0), T(1.0) - static_cast<T>(Dim)) / n * sum1
+        + sum2 / (n * n);
+
+    return std::sqrt(std::max(square, T(0.0)));
+}
+
 }       // namespace foundation
 
 #endif  // !APPLESEED_FOUNDATION_MATH_QMC_H
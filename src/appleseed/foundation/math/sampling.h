@@ -34,5 +34,6 @@
 #include "foundation/math/sampling/mappings.h"
 #include "foundation/math/sampling/qmcsamplingcontext.h"
 #include "foundation/math/sampling/rngsamplingcontext.h"
+#include "foundation/math/sampling/sobolsamplingcontext.h"
 
 #endif  // !APPLESEED_FOUNDATION_MATH_SAMPLING_H
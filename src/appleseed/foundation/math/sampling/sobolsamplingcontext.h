@@ -0,0 +1,356 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+#define APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
+
+// appleseed.foundation headers.
+#include "foundation/math/hash.h"
+#include "foundation/math/qmc.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+
+namespace foundation
+{
+
+//
+// A sampling context featuring:
+//
+//   - deterministic sampling based on the Sobol sequence
+//   - Owen scrambling of the sample values
+//   - shuffling of the sample indices
+//
+// Every split context draws from the first dimensions of a Sobol sequence whose values
+// are scrambled and whose indices are shuffled with seeds derived from the dimension
+// allocation and the instance of the parent context. This decorrelates the dimensions
+// of the trajectories without having to walk up the Sobol dimensions, which keeps the
+// high quality two-dimensional projections of the first dimensions everywhere.
+//
+// Reference:
+//
+//   Burley, Practical Hash-based Owen Scrambling
+//   http://www.jcgt.org/published/0009/04/01/
+//
+
+template <typename RNG>
+class SobolSamplingContext
+{
+  public:
+    // Random number generator type.
+    typedef RNG RNGType;
+
+    // Construct a sampling context of dimension 0. It cannot be used
+    // directly; only child contexts obtained by splitting can.
+    explicit SobolSamplingContext(RNG& rng);
+
+    // Construct a sampling context for a given number of dimensions
+    // and samples. Set sample_count to 0 if the required number of
+    // samples is unknown or infinite.
+    SobolSamplingContext(
+        RNG&            rng,
+        const size_t    dimension,
+        const size_t    sample_count,
+        const size_t    instance = 0);
+
+    // Assignment operator.
+    SobolSamplingContext& operator=(const SobolSamplingContext& rhs);
+
+    // Trajectory splitting: return a child sampling context for
+    // a given number of dimensions and samples.
+    SobolSamplingContext split(
+        const size_t    dimension,
+        const size_t    sample_count) const;
+
+    // In-place trajectory splitting.
+    void split_in_place(
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    // Set the instance number.
+    void set_instance(const size_t instance);
+
+    // Return the next sample in [0,1].
+    double next_double1();
+
+    // Return the next sample in [0,1).
+    double next_double2();
+
+    // Return the next sample in [0,1]^N.
+    void next_vector1(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector1();
+
+    // Return the next sample in [0,1)^N.
+    void next_vector2(const size_t n, double v[]);
+    template <size_t N> Vector<double, N> next_vector2();
+
+    // Return the total dimension of this sampler.
+    size_t get_total_dimension() const;
+
+    // Return the total instance number of this sampler.
+    size_t get_total_instance() const;
+
+  private:
+    enum { MaxDimension = 4 };
+
+    RNG&        m_rng;
+
+    size_t      m_base_dimension;
+    size_t      m_base_instance;
+
+    size_t      m_dimension;
+    size_t      m_sample_count;
+
+    size_t      m_instance;
+    uint32      m_index_seed;
+    uint32      m_seeds[MaxDimension];
+
+    SobolSamplingContext(
+        RNG&            rng,
+        const size_t    base_dimension,
+        const size_t    base_instance,
+        const size_t    dimension,
+        const size_t    sample_count);
+
+    void compute_seeds();
+
+    void next_uint32(const size_t n, uint32 v[]);
+};
+
+
+//
+// SobolSamplingContext class implementation.
+//
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(RNG& rng)
+  : m_rng(rng)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(0)
+  , m_sample_count(0)
+  , m_instance(0)
+{
+    compute_seeds();
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const size_t        dimension,
+    const size_t        sample_count,
+    const size_t        instance)
+  : m_rng(rng)
+  , m_base_dimension(0)
+  , m_base_instance(0)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(instance)
+{
+    assert(dimension <= MaxDimension);
+
+    compute_seeds();
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG>::SobolSamplingContext(
+    RNG&                rng,
+    const size_t        base_dimension,
+    const size_t        base_instance,
+    const size_t        dimension,
+    const size_t        sample_count)
+  : m_rng(rng)
+  , m_base_dimension(base_dimension)
+  , m_base_instance(base_instance)
+  , m_dimension(dimension)
+  , m_sample_count(sample_count)
+  , m_instance(0)
+{
+    assert(dimension <= MaxDimension);
+
+    compute_seeds();
+}
+
+template <typename RNG> inline
+SobolSamplingContext<RNG>&
+SobolSamplingContext<RNG>::operator=(const SobolSamplingContext& rhs)
+{
+    m_base_dimension = rhs.m_base_dimension;
+    m_base_instance = rhs.m_base_instance;
+    m_dimension = rhs.m_dimension;
+    m_sample_count = rhs.m_sample_count;
+    m_instance = rhs.m_instance;
+    m_index_seed = rhs.m_index_seed;
+
+    for (size_t i = 0; i < MaxDimension; ++i)
+        m_seeds[i] = rhs.m_seeds[i];
+
+    return *this;
+}
+
+template <typename RNG>
+inline SobolSamplingContext<RNG> SobolSamplingContext<RNG>::split(
+    const size_t    dimension,
+    const size_t    sample_count) const
+{
+    return
+        SobolSamplingContext(
+            m_rng,
+            m_base_dimension + m_dimension,         // dimension allocation
+            m_base_instance + m_instance,           // decorrelation by generalization
+            dimension,
+            sample_count);
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::split_in_place(
+    const size_t    dimension,
+    const size_t    sample_count)
+{
+    assert(m_sample_count == 0 || m_instance == m_sample_count);    // can't split in the middle of a sequence
+    assert(dimension <= MaxDimension);
+
+    m_base_dimension += m_dimension;                // dimension allocation
+    m_base_instance += m_instance;                  // decorrelation by generalization
+    m_dimension = dimension;
+    m_sample_count = sample_count;
+    m_instance = 0;
+
+    compute_seeds();
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::compute_seeds()
+{
+    const uint32 seed =
+        mix_uint32(
+            static_cast<uint32>(m_base_dimension),
+            static_cast<uint32>(m_base_instance));
+
+    m_index_seed = hash_uint32(seed);
+
+    for (size_t i = 0; i < MaxDimension; ++i)
+        m_seeds[i] = mix_uint32(seed, static_cast<uint32>(i));
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::set_instance(const size_t instance)
+{
+    m_instance = instance;
+}
+
+template <typename RNG>
+inline double SobolSamplingContext<RNG>::next_double1()
+{
+    return next_vector1<1>()[0];
+}
+
+template <typename RNG>
+inline double SobolSamplingContext<RNG>::next_double2()
+{
+    return next_vector2<1>()[0];
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::next_vector1(const size_t n, double v[])
+{
+    uint32 x[MaxDimension];
+    next_uint32(n, x);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = static_cast<double>(x[i]) / 4294967295.0;
+}
+
+template <typename RNG>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG>::next_vector1()
+{
+    Vector<double, N> v;
+
+    next_vector1(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::next_vector2(const size_t n, double v[])
+{
+    uint32 x[MaxDimension];
+    next_uint32(n, x);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = static_cast<double>(x[i]) / 4294967296.0;
+}
+
+template <typename RNG>
+template <size_t N>
+inline Vector<double, N> SobolSamplingContext<RNG>::next_vector2()
+{
+    Vector<double, N> v;
+
+    next_vector2(N, &v[0]);
+
+    return v;
+}
+
+template <typename RNG>
+inline size_t SobolSamplingContext<RNG>::get_total_dimension() const
+{
+    return m_base_dimension + m_dimension;
+}
+
+template <typename RNG>
+inline size_t SobolSamplingContext<RNG>::get_total_instance() const
+{
+    return m_base_instance + m_instance;
+}
+
+template <typename RNG>
+inline void SobolSamplingContext<RNG>::next_uint32(const size_t n, uint32 v[])
+{
+    assert(m_sample_count == 0 || m_instance < m_sample_count);
+    assert(n == m_dimension);
+    assert(n <= MaxDimension);
+
+    const uint32 index =
+        owen_scramble(static_cast<uint32>(m_instance), m_index_seed);
+
+    sobol_uint32(0, n, index, v);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = owen_scramble(v[i], m_seeds[i]);
+
+    ++m_instance;
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_MATH_SAMPLING_SOBOLSAMPLINGCONTEXT_H
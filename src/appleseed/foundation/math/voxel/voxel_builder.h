@@ -40,6 +40,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace foundation {
 namespace voxel {
@@ -89,6 +90,32 @@ class Builder
     template <typename ItemIntersector>
     void push(const ItemIntersector& item_intersector);
 
+    //
+    // Parallel construction.
+    //
+    // subdivide() refines an empty tree down to a given depth, following the same
+    // splitting rule as push(), and returns the resulting leaves. The subtree rooted
+    // at each leaf can then be built independently (for instance on separate threads)
+    // by another builder over the bounding box of the leaf, using the same maximum
+    // extent and only pushing items that intersect this bounding box. Finally,
+    // graft() replaces each leaf by its subtree. The resulting tree is identical to
+    // the one built by pushing all items into this builder, up to the order of nodes.
+    //
+
+    struct Leaf
+    {
+        size_t          m_node_index;
+        AABBType        m_bbox;
+    };
+
+    void subdivide(
+        const size_t        depth,
+        std::vector<Leaf>&  leaves);
+
+    void graft(
+        const size_t        leaf_node_index,
+        const TreeType&     subtree);
+
     // Complete the construction of the tree.
     void complete();
 
@@ -103,6 +130,19 @@ class Builder
     Stopwatch<Timer>    m_stopwatch;
     double              m_build_time;
 
+    // Convert a leaf node to an interior node with two empty leaf children.
+    // Return the index of the left child node.
+    size_t create_child_nodes(
+        const size_t            node_index,
+        const SplitType&        split);
+
+    // Recursively subdivide the tree.
+    void subdivide_recurse(
+        const size_t            node_index,
+        const AABBType&         node_bbox,
+        const size_t            depth,
+        std::vector<Leaf>&      leaves);
+
     // Recursively push an item into the tree.
     template <typename ItemIntersector>
     void push_recurse(
@@ -182,6 +222,51 @@ void Builder<Tree, Timer>::push(const ItemIntersector& item_intersector)
         m_tree.m_bbox);         // bounding box of the root node
 }
 
+// Refine an empty tree down to a given depth.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::subdivide(
+    const size_t                depth,
+    std::vector<Leaf>&          leaves)
+{
+    assert(m_tree.m_nodes.size() == 1);
+
+    subdivide_recurse(
+        0,                      // root node
+        m_tree.m_bbox,          // bounding box of the root node
+        depth,
+        leaves);
+}
+
+// Replace a leaf node by a copy of a given tree.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::graft(
+    const size_t                leaf_node_index,
+    const TreeType&             subtree)
+{
+    assert(leaf_node_index < m_tree.m_nodes.size());
+    assert(m_tree.m_nodes[leaf_node_index].is_leaf());
+    assert(!subtree.m_nodes.empty());
+
+    // The root of the subtree replaces the leaf node, the other nodes of the subtree are
+    // appended to this tree: node i of the subtree (i > 0) ends up at index base + i.
+    const size_t base = m_tree.m_nodes.size() - 1;
+    const size_t subtree_node_count = subtree.m_nodes.size();
+
+    m_tree.m_nodes.reserve(base + subtree_node_count);
+
+    for (size_t i = 0; i < subtree_node_count; ++i)
+    {
+        NodeType node = subtree.m_nodes[i];
+
+        if (node.is_interior())
+            node.set_child_node_index(base + node.get_child_node_index());
+
+        if (i == 0)
+            m_tree.m_nodes[leaf_node_index] = node;
+        else m_tree.m_nodes.push_back(node);
+    }
+}
+
 // Return the construction time.
 template <typename Tree, typename Timer>
 double Builder<Tree, Timer>::get_build_time() const
@@ -189,6 +274,74 @@ double Builder<Tree, Timer>::get_build_time() const
     return m_build_time;
 }
 
+// Convert a leaf node to an interior node with two empty leaf children.
+template <typename Tree, typename Timer>
+size_t Builder<Tree, Timer>::create_child_nodes(
+    const size_t                node_index,
+    const SplitType&            split)
+{
+    assert(m_tree.m_nodes[node_index].is_leaf());
+
+    // Compute the index of the left child node.
+    const size_t left_node_index = m_tree.m_nodes.size();
+
+    // Create the left node.
+    NodeType left_node;
+    left_node.make_leaf();
+    left_node.set_solid_bit(false);
+    m_tree.m_nodes.push_back(left_node);
+
+    // Create the right node.
+    NodeType right_node;
+    right_node.make_leaf();
+    right_node.set_solid_bit(false);
+    m_tree.m_nodes.push_back(right_node);
+
+    // Convert the parent node to an interior node.
+    m_tree.m_nodes[node_index].make_interior();
+    m_tree.m_nodes[node_index].set_child_node_index(left_node_index);
+    m_tree.m_nodes[node_index].set_split_dim(split.m_dimension);
+    m_tree.m_nodes[node_index].set_split_abs(split.m_abscissa);
+
+    return left_node_index;
+}
+
+// Recursively subdivide the tree.
+template <typename Tree, typename Timer>
+void Builder<Tree, Timer>::subdivide_recurse(
+    const size_t                node_index,
+    const AABBType&             node_bbox,
+    const size_t                depth,
+    std::vector<Leaf>&          leaves)
+{
+    // Compute the splitting dimension and abscissa.
+    const SplitType split = SplitType::middle(node_bbox);
+
+    // Compute the extent of the node along the splitting dimension.
+    const ValueType node_extent =
+          node_bbox.max[split.m_dimension]
+        - node_bbox.min[split.m_dimension];
+
+    // Stop at the requested depth, or where push() would stop refining.
+    if (depth == 0 || node_extent <= m_max_extent)
+    {
+        Leaf leaf;
+        leaf.m_node_index = node_index;
+        leaf.m_bbox = node_bbox;
+        leaves.push_back(leaf);
+        return;
+    }
+
+    const size_t left_node_index = create_child_nodes(node_index, split);
+
+    // Compute the bounding boxes of the child nodes.
+    AABBType left_node_bbox, right_node_bbox;
+    split_bbox(node_bbox, split, left_node_bbox, right_node_bbox);
+
+    subdivide_recurse(left_node_index, left_node_bbox, depth - 1, leaves);
+    subdivide_recurse(left_node_index + 1, right_node_bbox, depth - 1, leaves);
+}
+
 // Recursively push an item into the tree.
 template <typename Tree, typename Timer>
 template <typename ItemIntersector>
@@ -217,26 +370,8 @@ void Builder<Tree, Timer>::push_recurse(
         if (m_tree.m_nodes[node_index].is_leaf())
         {
             // Compute the indices of the child nodes.
-            left_node_index = m_tree.m_nodes.size();
+            left_node_index = create_child_nodes(node_index, split);
             right_node_index = left_node_index + 1;
-
-            // Create the left node.
-            NodeType left_node;
-            left_node.make_leaf();
-            left_node.set_solid_bit(false);
-            m_tree.m_nodes.push_back(left_node);
-
-            // Create the right node.
-            NodeType right_node;
-            right_node.make_leaf();
-            right_node.set_solid_bit(false);
-            m_tree.m_nodes.push_back(right_node);
-
-            // Convert the parent node to an interior node.
-            m_tree.m_nodes[node_index].make_interior();
-            m_tree.m_nodes[node_index].set_child_node_index(left_node_index);
-            m_tree.m_nodes[node_index].set_split_dim(split.m_dimension);
-            m_tree.m_nodes[node_index].set_split_abs(split.m_abscissa);
         }
         else
         {
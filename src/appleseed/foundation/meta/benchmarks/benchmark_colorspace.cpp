@@ -32,10 +32,12 @@
 #include "foundation/image/colorspace.h"
 #include "foundation/image/spectrum.h"
 #include "foundation/math/rng.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/benchmark.h"
 
 // Standard headers.
 #include <cstddef>
+#include <cstring>
 
 using namespace foundation;
 
@@ -62,6 +64,76 @@ BENCHMARK_SUITE(Foundation_Image_ColorSpace)
         m_output = fast_linear_rgb_to_srgb(m_input);
     }
 
+    struct TileFixture
+    {
+        static const size_t PixelCount = 64 * 64;
+        static const size_t ChannelCount = 4;
+        static const size_t ValueCount = PixelCount * ChannelCount;
+
+        uint8   m_uint8_input[ValueCount];
+        float   m_float_input[ValueCount];
+        float   m_output[ValueCount];
+
+        TileFixture()
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < ValueCount; ++i)
+            {
+                m_uint8_input[i] = static_cast<uint8>(rand_int1(rng, 0, 255));
+                m_float_input[i] = static_cast<float>(m_uint8_input[i]) * (1.0f / 255.0f);
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(sRGBToLinearRGBConversion_UInt8Tile_Scalar, TileFixture)
+    {
+        for (size_t i = 0; i < ValueCount; i += ChannelCount)
+        {
+            m_output[i + 0] = srgb_to_linear_rgb(static_cast<float>(m_uint8_input[i + 0]) * (1.0f / 255.0f));
+            m_output[i + 1] = srgb_to_linear_rgb(static_cast<float>(m_uint8_input[i + 1]) * (1.0f / 255.0f));
+            m_output[i + 2] = srgb_to_linear_rgb(static_cast<float>(m_uint8_input[i + 2]) * (1.0f / 255.0f));
+            m_output[i + 3] = static_cast<float>(m_uint8_input[i + 3]) * (1.0f / 255.0f);
+        }
+    }
+
+    BENCHMARK_CASE_F(sRGBToLinearRGBConversion_UInt8Tile_LookupTable, TileFixture)
+    {
+        convert_srgb_to_linear_rgb(m_uint8_input, m_output, PixelCount, ChannelCount);
+    }
+
+    BENCHMARK_CASE_F(sRGBToLinearRGBConversion_FloatTile_Scalar, TileFixture)
+    {
+        for (size_t i = 0; i < ValueCount; i += ChannelCount)
+        {
+            m_output[i + 0] = srgb_to_linear_rgb(m_float_input[i + 0]);
+            m_output[i + 1] = srgb_to_linear_rgb(m_float_input[i + 1]);
+            m_output[i + 2] = srgb_to_linear_rgb(m_float_input[i + 2]);
+            m_output[i + 3] = m_float_input[i + 3];
+        }
+    }
+
+    BENCHMARK_CASE_F(CIEXYZToLinearRGBConversion_FloatTile_Scalar, TileFixture)
+    {
+        for (size_t i = 0; i < ValueCount; i += ChannelCount)
+        {
+            const Color3f linear_rgb =
+                ciexyz_to_linear_rgb(
+                    Color3f(m_float_input[i + 0], m_float_input[i + 1], m_float_input[i + 2]));
+
+            m_output[i + 0] = linear_rgb[0];
+            m_output[i + 1] = linear_rgb[1];
+            m_output[i + 2] = linear_rgb[2];
+            m_output[i + 3] = m_float_input[i + 3];
+        }
+    }
+
+    BENCHMARK_CASE_F(CIEXYZToLinearRGBConversion_FloatTile_Bulk, TileFixture)
+    {
+        memcpy(m_output, m_float_input, sizeof(m_output));
+        convert_ciexyz_to_linear_rgb(m_output, PixelCount, ChannelCount);
+    }
+
     struct SpectrumFixture
     {
         typedef RegularSpectrum<float, 31> SpectrumType;
@@ -300,3 +300,59 @@ BENCHMARK_SUITE(Foundation_Math_Intersection_RayTriangleSSK)
     BENCHMARK_CASE_F(Intersect_DoublePrecision_HitRateIs66Percents, FixtureDouble66) { payload(); }
     BENCHMARK_CASE_F(Intersect_DoublePrecision_HitRateIs100Percents, FixtureDouble100) { payload(); }
 };
+
+BENCHMARK_SUITE(Foundation_Math_Intersection_RayTriangleMT4)
+{
+    // Compare the throughput of intersecting a leaf of four single precision triangles
+    // with double precision rays, one triangle at a time or all four at once.
+    struct Fixture
+      : public FixtureBase<double>
+    {
+        static const size_t RayCount = 1000;
+
+        TriangleMT<float>   m_triangles[4];
+        TriangleMT4<float>  m_triangles4;
+        Ray3d               m_ray[RayCount];
+
+        size_t              m_hits;
+        double              m_t[4];
+        double              m_u[4];
+        double              m_v[4];
+
+        Fixture()
+          : m_hits(0)
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const Vector3f v0 = FixtureBase<float>::get_random_vector<3>(rng, -1.0f, 1.0f);
+                const Vector3f v1 = FixtureBase<float>::get_random_vector<3>(rng, -1.0f, 1.0f);
+                const Vector3f v2 = FixtureBase<float>::get_random_vector<3>(rng, -1.0f, 1.0f);
+                m_triangles[i] = TriangleMT<float>(v0, v1, v2);
+                m_triangles4.set(i, m_triangles[i]);
+            }
+
+            for (size_t i = 0; i < RayCount; ++i)
+                get_random_ray(rng, 10.0, m_ray[i]);
+        }
+    };
+
+    BENCHMARK_CASE_F(IntersectLeaf_OneTriangleAtATime, Fixture)
+    {
+        for (size_t i = 0; i < RayCount; ++i)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const TriangleMT<double> triangle(m_triangles[j]);
+                m_hits += triangle.intersect(m_ray[i], m_t[j], m_u[j], m_v[j]) ? 1 : 0;
+            }
+        }
+    }
+
+    BENCHMARK_CASE_F(IntersectLeaf_FourTrianglesAtOnce, Fixture)
+    {
+        for (size_t i = 0; i < RayCount; ++i)
+            m_hits += m_triangles4.intersect(m_ray[i], m_t, m_u, m_v);
+    }
+}
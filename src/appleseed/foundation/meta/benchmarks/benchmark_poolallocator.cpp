@@ -28,10 +28,14 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/platform/thread.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/benchmark.h"
 #include "foundation/utility/poolallocator.h"
 
+// boost headers.
+#include "boost/thread/thread.hpp"
+
 // Standard headers.
 #include <cstddef>
 #include <memory>
@@ -80,6 +84,47 @@ BENCHMARK_SUITE(Foundation_Utility_PoolAllocator)
     typedef allocator<uint32> DefaultAllocator;
     typedef PoolAllocator<uint32, N> PoolAllocator;
 
+    const size_t ThreadCount = 8;
+    const size_t BatchCount = 100;
+
+    template <typename Allocator>
+    struct AllocateDeallocateBatches
+    {
+        void operator()()
+        {
+            Allocator allocator;
+            uint32* p[N];
+
+            for (size_t b = 0; b < BatchCount; ++b)
+            {
+                for (size_t i = 0; i < N; ++i)
+                    p[i] = allocator.allocate(1);
+
+                for (size_t i = 0; i < N; ++i)
+                    allocator.deallocate(p[i], 1);
+            }
+        }
+    };
+
+    template <typename Allocator>
+    struct MultiThreadedFixture
+    {
+        AllocateDeallocateBatches<Allocator> m_funcs[ThreadCount];
+
+        void multithreaded_batches()
+        {
+            boost::thread_group threads;
+
+            for (size_t i = 0; i < ThreadCount; ++i)
+            {
+                threads.create_thread(
+                    ThreadFunctionWrapper<AllocateDeallocateBatches<Allocator> >(&m_funcs[i]));
+            }
+
+            threads.join_all();
+        }
+    };
+
     BENCHMARK_CASE_F(RepeatedAllocation_PoolAllocator, Fixture<PoolAllocator>)
     {
         m_allocator.allocate(1);
@@ -114,4 +159,14 @@ BENCHMARK_SUITE(Foundation_Utility_PoolAllocator)
     {
         first_allocated_last_deallocated_batch();
     }
+
+    BENCHMARK_CASE_F(MultiThreadedBatches_DefaultAllocator, MultiThreadedFixture<DefaultAllocator>)
+    {
+        multithreaded_batches();
+    }
+
+    BENCHMARK_CASE_F(MultiThreadedBatches_PoolAllocator, MultiThreadedFixture<PoolAllocator>)
+    {
+        multithreaded_batches();
+    }
 }
@@ -31,13 +31,17 @@
 #include "foundation/math/permutation.h"
 #include "foundation/math/primes.h"
 #include "foundation/math/qmc.h"
+#include "foundation/math/rng.h"
 #include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/benchmark.h"
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 using namespace foundation;
+using namespace std;
 
 BENCHMARK_SUITE(Foundation_Math_QMC)
 {
@@ -145,6 +149,114 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
             for (size_t i = 0; i < 64; ++i)
                 m_x += hammersley_sequence<T, 2>(Bases, i, 64);
         }
+
+        void sobol_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+                m_x += sobol_sequence<T, 2>(i);
+        }
+
+        void sobol_owen_payload()
+        {
+            m_x = Vector<T, 2>(0.0f);
+
+            for (uint32 i = 0; i < 64; ++i)
+                m_x += sobol_owen_sequence<T, 2>(0x9E3779B9u, i);
+        }
+    };
+
+    struct Vector4Fixture
+    {
+        Vector4d m_x;
+
+        void halton_payload()
+        {
+            static const size_t Bases[] = { 2, 3, 5, 7 };
+
+            m_x = Vector4d(0.0);
+
+            for (size_t i = 0; i < 64; ++i)
+                m_x += halton_sequence<double, 4>(Bases, i);
+        }
+
+        void sobol_one_dimension_at_a_time_payload()
+        {
+            m_x = Vector4d(0.0);
+
+            for (uint32 i = 0; i < 64; ++i)
+            {
+                for (size_t d = 0; d < 4; ++d)
+                    m_x[d] += sobol_uint32(d, i);
+            }
+        }
+
+        void sobol_four_dimensions_at_once_payload()
+        {
+            m_x = Vector4d(0.0);
+
+            for (uint32 i = 0; i < 64; ++i)
+            {
+                uint32 values[4];
+                sobol_uint32(0, 4, i, values);
+
+                for (size_t d = 0; d < 4; ++d)
+                    m_x[d] += values[d];
+            }
+        }
+
+        void sobol_owen_payload()
+        {
+            m_x = Vector4d(0.0);
+
+            for (uint32 i = 0; i < 64; ++i)
+                m_x += sobol_owen_sequence<double, 4>(0x9E3779B9u, i);
+        }
+    };
+
+    // The discrepancy payloads generate a point set and measure its L2-star discrepancy.
+    // The discrepancy is stored in the fixture so that the computation is not optimized away.
+    struct DiscrepancyFixture
+    {
+        static const size_t PointCount = 128;
+
+        vector<Vector2d>    m_points;
+        double              m_discrepancy;
+
+        DiscrepancyFixture()
+          : m_points(PointCount)
+          , m_discrepancy(0.0)
+        {
+        }
+
+        void random_payload()
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < PointCount; ++i)
+                m_points[i] = Vector2d(rand_double2(rng), rand_double2(rng));
+
+            m_discrepancy = l2_star_discrepancy(&m_points[0], PointCount);
+        }
+
+        void halton_payload()
+        {
+            static const size_t Bases[] = { 2, 3 };
+
+            for (size_t i = 0; i < PointCount; ++i)
+                m_points[i] = halton_sequence<double, 2>(Bases, i);
+
+            m_discrepancy = l2_star_discrepancy(&m_points[0], PointCount);
+        }
+
+        void sobol_owen_payload()
+        {
+            for (size_t i = 0; i < PointCount; ++i)
+                m_points[i] = sobol_owen_sequence<double, 2>(0x9E3779B9u, static_cast<uint32>(i));
+
+            m_discrepancy = l2_star_discrepancy(&m_points[0], PointCount);
+        }
     };
 
     // Radical inverse, single precision.
@@ -224,4 +336,65 @@ BENCHMARK_SUITE(Foundation_Math_QMC)
     {
         hammersley_payload();
     }
+
+    // Sobol sequence.
+
+    BENCHMARK_CASE_F(SobolSequence_2D_SinglePrecision, Vector2Fixture<float>)
+    {
+        sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(SobolSequence_2D_DoublePrecision, Vector2Fixture<double>)
+    {
+        sobol_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_2D_SinglePrecision, Vector2Fixture<float>)
+    {
+        sobol_owen_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_2D_DoublePrecision, Vector2Fixture<double>)
+    {
+        sobol_owen_payload();
+    }
+
+    // 4D sequences.
+
+    BENCHMARK_CASE_F(HaltonSequence_4D, Vector4Fixture)
+    {
+        halton_payload();
+    }
+
+    BENCHMARK_CASE_F(SobolSequence_4D_OneDimensionAtATime, Vector4Fixture)
+    {
+        sobol_one_dimension_at_a_time_payload();
+    }
+
+    BENCHMARK_CASE_F(SobolSequence_4D_FourDimensionsAtOnce, Vector4Fixture)
+    {
+        sobol_four_dimensions_at_once_payload();
+    }
+
+    BENCHMARK_CASE_F(OwenScrambledSobolSequence_4D, Vector4Fixture)
+    {
+        sobol_owen_payload();
+    }
+
+    // Discrepancy.
+
+    BENCHMARK_CASE_F(L2StarDiscrepancy_Random, DiscrepancyFixture)
+    {
+        random_payload();
+    }
+
+    BENCHMARK_CASE_F(L2StarDiscrepancy_HaltonSequence, DiscrepancyFixture)
+    {
+        halton_payload();
+    }
+
+    BENCHMARK_CASE_F(L2StarDiscrepancy_OwenScrambledSobolSequence, DiscrepancyFixture)
+    {
+        sobol_owen_payload();
+    }
 }
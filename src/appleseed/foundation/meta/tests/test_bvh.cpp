@@ -73,6 +73,18 @@ TEST_SUITE(Foundation_Math_BVH_Node)
         EXPECT_EQ(LeftBBox, node.get_left_bbox());
         EXPECT_EQ(RightBBox, node.get_right_bbox());
     }
+
+    TEST_CASE(TestStorageAndRetrievalOfSplitTime)
+    {
+        bvh::Node<AABB3d> node;
+        node.make_interior();
+
+        node.make_temporal_split(0.25);
+
+        EXPECT_TRUE(node.is_interior());
+        EXPECT_TRUE(node.is_temporal_split());
+        EXPECT_EQ(0.25, node.get_split_time());
+    }
 }
 
 TEST_SUITE(Foundation_Math_BVH_SpatialBuilder)
@@ -149,3 +161,85 @@ TEST_SUITE(Foundation_Math_BVH_Intersector_2D)
         > intersector;
     }
 }
+
+TEST_SUITE(Foundation_Math_BVH_Intersector_TemporalSplit)
+{
+    typedef bvh::Node<AABB3d> NodeType;
+    typedef AlignedVector<NodeType> NodeVector;
+
+    struct TestTree
+      : public bvh::Tree<NodeVector>
+    {
+        // Build a temporal split node whose two children are leaves.
+        TestTree()
+        {
+            m_nodes.resize(3);
+
+            m_nodes[0].make_interior();
+            m_nodes[0].set_child_node_index(1);
+            m_nodes[0].make_temporal_split(0.5);
+
+            m_nodes[1].make_leaf();
+            m_nodes[1].set_item_index(0);
+            m_nodes[1].set_item_count(1);
+
+            m_nodes[2].make_leaf();
+            m_nodes[2].set_item_index(1);
+            m_nodes[2].set_item_count(1);
+        }
+    };
+
+    struct Visitor
+    {
+        vector<size_t> m_visited_items;
+
+        bool visit(
+            const NodeType&             node,
+            const Ray3d&                ray,
+            const RayInfo3d&            ray_info,
+            double&                     distance
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+            , bvh::TraversalStatistics& stats
+#endif
+            )
+        {
+            m_visited_items.push_back(node.get_item_index());
+            distance = ray.m_tmax;
+            return true;
+        }
+    };
+
+    vector<size_t> intersect_at_time(const double time)
+    {
+        const TestTree tree;
+        const Ray3d ray(Vector3d(0.0), Vector3d(1.0, 0.0, 0.0));
+        const RayInfo3d ray_info(ray);
+
+        Visitor visitor;
+        bvh::Intersector<TestTree, Visitor, Ray3d> intersector;
+#ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
+        bvh::TraversalStatistics stats;
+        intersector.intersect_motion(tree, ray, ray_info, time, visitor, stats);
+#else
+        intersector.intersect_motion(tree, ray, ray_info, time, visitor);
+#endif
+
+        return visitor.m_visited_items;
+    }
+
+    TEST_CASE(IntersectMotion_RayTimeBeforeSplitTime_VisitsLeftChildOnly)
+    {
+        const vector<size_t> visited_items = intersect_at_time(0.25);
+
+        ASSERT_EQ(1, visited_items.size());
+        EXPECT_EQ(0, visited_items[0]);
+    }
+
+    TEST_CASE(IntersectMotion_RayTimeAfterSplitTime_VisitsRightChildOnly)
+    {
+        const vector<size_t> visited_items = intersect_at_time(0.75);
+
+        ASSERT_EQ(1, visited_items.size());
+        EXPECT_EQ(1, visited_items[0]);
+    }
+}
@@ -31,6 +31,7 @@
 #include "foundation/image/color.h"
 #include "foundation/image/colorspace.h"
 #include "foundation/image/spectrum.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/iostreamop.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/maplefile.h"
@@ -177,6 +178,85 @@ TEST_SUITE(Foundation_Image_ColorSpace)
             1.0e-5f);
     }
 
+    TEST_CASE(TestsRGBUInt8ToLinearRGBConversion)
+    {
+        EXPECT_EQ(0.0f, srgb_uint8_to_linear_rgb(0));
+        EXPECT_FEQ(0.21586050011389923f, srgb_uint8_to_linear_rgb(128));
+        EXPECT_FEQ(1.0f, srgb_uint8_to_linear_rgb(255));
+    }
+
+    TEST_CASE(TestsRGBUInt16ToLinearRGBConversion)
+    {
+        EXPECT_EQ(0.0f, srgb_uint16_to_linear_rgb(0));
+        EXPECT_FEQ(static_cast<float>(srgb_to_linear_rgb(32768.0 / 65535.0)), srgb_uint16_to_linear_rgb(32768));
+        EXPECT_FEQ(1.0f, srgb_uint16_to_linear_rgb(65535));
+    }
+
+    TEST_CASE(ConvertsRGBToLinearRGB_GivenUInt8RGBAPixels_ConvertsColorAndNormalizesAlpha)
+    {
+        const uint8 input[8] = { 0, 128, 255, 51, 255, 128, 0, 255 };
+        float output[8];
+
+        convert_srgb_to_linear_rgb(input, output, 2, 4);
+
+        EXPECT_EQ(0.0f, output[0]);
+        EXPECT_FEQ(0.21586050011389923f, output[1]);
+        EXPECT_FEQ(1.0f, output[2]);
+        EXPECT_FEQ(0.2f, output[3]);
+        EXPECT_FEQ(1.0f, output[4]);
+        EXPECT_FEQ(0.21586050011389923f, output[5]);
+        EXPECT_EQ(0.0f, output[6]);
+        EXPECT_FEQ(1.0f, output[7]);
+    }
+
+    TEST_CASE(ConvertsRGBToLinearRGB_GivenFloatRGBPixels_MatchesScalarConversion)
+    {
+        float pixels[15];
+        for (size_t i = 0; i < 15; ++i)
+            pixels[i] = static_cast<float>(i) / 14.0f;
+
+        convert_srgb_to_linear_rgb(pixels, 5, 3);
+
+        for (size_t i = 0; i < 15; ++i)
+        {
+            const float expected = srgb_to_linear_rgb(static_cast<float>(i) / 14.0f);
+            EXPECT_EQ(expected, pixels[i]);
+        }
+    }
+
+    TEST_CASE(ConvertsRGBToLinearRGB_GivenFloatRGBAPixels_LeavesAlphaUntouched)
+    {
+        float pixels[8] = { 0.73535698f, 0.85430583f, 0.48452920f, 0.3f, 0.0f, 0.02f, 1.0f, 0.7f };
+
+        convert_srgb_to_linear_rgb(pixels, 2, 4);
+
+        EXPECT_FEQ_EPS(0.5f, pixels[0], 1.0e-6f);
+        EXPECT_FEQ_EPS(0.7f, pixels[1], 1.0e-6f);
+        EXPECT_FEQ_EPS(0.2f, pixels[2], 1.0e-6f);
+        EXPECT_EQ(0.3f, pixels[3]);
+        EXPECT_EQ(0.0f, pixels[4]);
+        EXPECT_FEQ(0.02f / 12.92f, pixels[5]);
+        EXPECT_FEQ(1.0f, pixels[6]);
+        EXPECT_EQ(0.7f, pixels[7]);
+    }
+
+    TEST_CASE(ConvertCIEXYZToLinearRGB_GivenFloatRGBAPixels_MatchesScalarConversionAndLeavesAlphaUntouched)
+    {
+        float pixels[8] = { 0.5f, 0.7f, 0.2f, 0.3f, 0.0f, 1.0f, 0.0f, 0.7f };
+
+        convert_ciexyz_to_linear_rgb(pixels, 2, 4);
+
+        EXPECT_FEQ_EPS(
+            Color3f(0.44452747702598583f, 0.83687689900398254f, 0.096456110477447538f),
+            Color3f(pixels[0], pixels[1], pixels[2]),
+            1.0e-5f);
+        EXPECT_EQ(0.3f, pixels[3]);
+        EXPECT_EQ(
+            ciexyz_to_linear_rgb(Color3f(0.0f, 1.0f, 0.0f)),
+            Color3f(pixels[4], pixels[5], pixels[6]));
+        EXPECT_EQ(0.7f, pixels[7]);
+    }
+
     static Spectrum31f get_white_spectrum()
     {
         // The white color from the Cornell Box scene.
@@ -31,10 +31,12 @@
 #include "foundation/math/aabb.h"
 #include "foundation/math/intersection.h"
 #include "foundation/math/ray.h"
+#include "foundation/math/rng.h"
 #include "foundation/math/vector.h"
 #include "foundation/utility/test.h"
 
 // Standard headers.
+#include <cstddef>
 #include <limits>
 
 using namespace foundation;
@@ -552,3 +554,109 @@ TEST_SUITE(Foundation_Math_Intersection_RayTriangleSSK)
         EXPECT_FEQ(0.5, v);
     }
 }
+
+TEST_SUITE(Foundation_Math_Intersection_RayTriangleMT4)
+{
+    struct Fixture
+    {
+        TriangleMT4<float>  m_triangles;
+
+        Fixture()
+        {
+            // Four parallel triangles stacked along the Y axis.
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const float y = -static_cast<float>(i);
+                m_triangles.set(
+                    i,
+                    TriangleMT<float>(
+                        Vector3f(0.5f, y, 0.5f),
+                        Vector3f(-0.5f, y, 0.5f),
+                        Vector3f(-0.5f, y, -0.5f)));
+            }
+        }
+    };
+
+    TEST_CASE_F(Intersect_GivenRayPiercingAllTriangles_ReturnsFullMask, Fixture)
+    {
+        const Ray3d ray(Vector3d(-0.2, 1.0, 0.2), Vector3d(0.0, -1.0, 0.0));
+
+        double t[4], u[4], v[4];
+        const size_t mask = m_triangles.intersect(ray, t, u, v);
+
+        ASSERT_EQ(15, mask);
+        EXPECT_FEQ(1.0, t[0]);
+        EXPECT_FEQ(2.0, t[1]);
+        EXPECT_FEQ(3.0, t[2]);
+        EXPECT_FEQ(4.0, t[3]);
+    }
+
+    TEST_CASE_F(Intersect_GivenRayWithLimitedExtent_ReturnsMaskOfTrianglesWithinExtent, Fixture)
+    {
+        const Ray3d ray(Vector3d(-0.2, 1.0, 0.2), Vector3d(0.0, -1.0, 0.0), 1.5, 3.0);
+
+        const size_t mask = m_triangles.intersect(ray);
+
+        EXPECT_EQ(2, mask);
+    }
+
+    TEST_CASE(Intersect_GivenRandomTrianglesAndRays_MatchesTriangleMT)
+    {
+        MersenneTwister rng;
+
+        TriangleMT<float> triangles[4];
+        TriangleMT4<float> triangles4;
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            Vector3f v[3];
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                for (size_t k = 0; k < 3; ++k)
+                    v[j][k] = static_cast<float>(rand_double1(rng, -1.0, 1.0));
+            }
+
+            triangles[i] = TriangleMT<float>(v[0], v[1], v[2]);
+            triangles4.set(i, triangles[i]);
+        }
+
+        bool identical = true;
+        size_t hit_count = 0;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            Vector3d org, target;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                org[k] = rand_double1(rng, -2.0, 2.0);
+                target[k] = rand_double1(rng, -0.5, 0.5);
+            }
+
+            const Ray3d ray(org, target - org, 0.0, rand_double1(rng, 0.5, 1.5));
+
+            double t4[4], u4[4], v4[4];
+            const size_t mask = triangles4.intersect(ray, t4, u4, v4);
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                double t, u, v;
+                const bool hit = TriangleMT<double>(triangles[j]).intersect(ray, t, u, v);
+
+                if (hit != ((mask & (size_t(1) << j)) != 0))
+                    identical = false;
+                else if (hit)
+                {
+                    ++hit_count;
+
+                    if (t != t4[j] || u != u4[j] || v != v4[j])
+                        identical = false;
+                }
+            }
+        }
+
+        EXPECT_TRUE(identical);
+        EXPECT_GT(0, hit_count);
+    }
+}
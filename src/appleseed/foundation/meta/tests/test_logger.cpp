@@ -0,0 +1,186 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/log.h"
+#include "foundation/utility/string.h"
+#include "foundation/utility/test.h"
+
+// boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_Log_Logger)
+{
+    struct Fixture
+    {
+        Logger              m_logger;
+        StringLogTarget*    m_target;
+
+        Fixture()
+          : m_target(create_string_log_target())
+        {
+            m_logger.set_all_formats("{message}");
+            m_logger.add_target(m_target);
+        }
+
+        ~Fixture()
+        {
+            m_logger.set_asynchronous(false);
+            m_logger.remove_target(m_target);
+            m_target->release();
+        }
+    };
+
+    TEST_CASE_F(Write_SynchronousMode_SendsMessageToTargetImmediately, Fixture)
+    {
+        LOG_INFO(m_logger, "hello");
+
+        EXPECT_EQ("hello\n", string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Flush_AsynchronousMode_SendsPendingMessagesInOrder, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        LOG_INFO(m_logger, "first");
+        LOG_INFO(m_logger, "second");
+        m_logger.flush();
+
+        EXPECT_EQ("first\nsecond\n", string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(SetAsynchronous_False_SendsPendingMessages, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        LOG_INFO(m_logger, "message");
+        m_logger.set_asynchronous(false);
+
+        EXPECT_EQ("message\n", string(m_target->get_string()));
+    }
+
+    struct WriteMessages
+    {
+        Logger&         m_logger;
+        const size_t    m_thread;
+        const size_t    m_message_count;
+
+        WriteMessages(
+            Logger&         logger,
+            const size_t    thread,
+            const size_t    message_count)
+          : m_logger(logger)
+          , m_thread(thread)
+          , m_message_count(message_count)
+        {
+        }
+
+        void operator()()
+        {
+            for (size_t i = 0; i < m_message_count; ++i)
+                LOG_INFO(m_logger, FMT_SIZE_T " " FMT_SIZE_T, m_thread, i);
+        }
+    };
+
+    TEST_CASE_F(ThreadExit_AsynchronousMode_SendsMessagesOfExitingThread, Fixture)
+    {
+        m_logger.set_asynchronous();
+
+        // Run threads one after the other so that their message queues get recycled.
+        for (size_t i = 0; i < 3; ++i)
+        {
+            WriteMessages function(m_logger, i, 2);
+            ThreadFunctionWrapper<WriteMessages> wrapper(&function);
+            boost::thread thread(wrapper);
+            thread.join();
+        }
+
+        // No flush: the messages were sent when their thread exited.
+        EXPECT_EQ("0 0\n0 1\n1 0\n1 1\n2 0\n2 1\n", string(m_target->get_string()));
+    }
+
+    TEST_CASE_F(Write_AsynchronousModeWithManyThreads_PreservesPerThreadOrdering, Fixture)
+    {
+        const size_t ThreadCount = 4;
+        const size_t MessageCount = 5000;   // more than the capacity of a thread's queue
+
+        m_logger.set_asynchronous();
+
+        vector<WriteMessages*> functions;
+        boost::thread_group threads;
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+        {
+            functions.push_back(new WriteMessages(m_logger, i, MessageCount));
+            threads.create_thread(ThreadFunctionWrapper<WriteMessages>(functions.back()));
+        }
+
+        threads.join_all();
+        m_logger.flush();
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+            delete functions[i];
+
+        vector<string> lines;
+        split(m_target->get_string(), "\n", lines);
+
+        vector<size_t> next_message(ThreadCount, 0);
+        bool ordered = true;
+
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            if (lines[i].empty())
+                continue;
+
+            vector<string> tokens;
+            split(lines[i], " ", tokens);
+
+            const size_t thread = from_string<size_t>(tokens[0]);
+            const size_t message = from_string<size_t>(tokens[1]);
+
+            if (message != next_message[thread])
+                ordered = false;
+
+            next_message[thread] = message + 1;
+        }
+
+        EXPECT_TRUE(ordered);
+
+        for (size_t i = 0; i < ThreadCount; ++i)
+            EXPECT_EQ(MessageCount, next_message[i]);
+    }
+}
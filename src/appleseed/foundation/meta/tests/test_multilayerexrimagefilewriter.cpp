@@ -0,0 +1,125 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/image/exceptionunsupportedimageformat.h"
+#include "foundation/image/image.h"
+#include "foundation/image/multilayerexrimagefilewriter.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/progressiveexrimagefilereader.h"
+#include "foundation/image/tile.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+TEST_SUITE(Foundation_Image_MultiLayerEXRImageFileWriter)
+{
+    using namespace foundation;
+
+    static const char* Filename = "unit tests/outputs/test_multilayerexrimagefilewriter.exr";
+    static const Color4b MainReference(50, 100, 150, 42);
+    static const Color4b LayerReference(200, 10, 20, 255);
+
+    TEST_CASE(GetLayerCount_GivenTwoAppendedLayers_ReturnsTwo)
+    {
+        Image main_image(2, 2, 32, 32, 4, PixelFormatFloat);
+        Image layer_image(2, 2, 32, 32, 4, PixelFormatFloat);
+
+        MultiLayerEXRImageFileWriter writer;
+        writer.append_layer("", main_image);
+        writer.append_layer("diffuse", layer_image);
+
+        EXPECT_EQ(2, writer.get_layer_count());
+    }
+
+    TEST_CASE(AppendLayer_GivenImageWithEightBitPixels_ThrowsExceptionUnsupportedImageFormat)
+    {
+        Image image(2, 2, 32, 32, 4, PixelFormatUInt8);
+
+        MultiLayerEXRImageFileWriter writer;
+
+        EXPECT_EXCEPTION(ExceptionUnsupportedImageFormat,
+        {
+            writer.append_layer("", image);
+        });
+
+        EXPECT_EQ(0, writer.get_layer_count());
+    }
+
+    TEST_CASE(AppendLayer_GivenImageWithMoreThanFourChannels_ThrowsExceptionUnsupportedImageFormat)
+    {
+        Image image(2, 2, 32, 32, 5, PixelFormatFloat);
+
+        MultiLayerEXRImageFileWriter writer;
+
+        EXPECT_EXCEPTION(ExceptionUnsupportedImageFormat,
+        {
+            writer.append_layer("", image);
+        });
+
+        EXPECT_EQ(0, writer.get_layer_count());
+    }
+
+    TEST_CASE(Write_GivenMainLayerAndExtraLayer_MainLayerIsReadBackUnprefixed)
+    {
+        // 40x40 pixels with 32x32 tiles: exercises partial tiles on the right and bottom edges.
+        Image main_image(40, 40, 32, 32, 4, PixelFormatFloat);
+        main_image.clear(MainReference);
+
+        Image layer_image(40, 40, 32, 32, 4, PixelFormatHalf);
+        layer_image.clear(LayerReference);
+
+        MultiLayerEXRImageFileWriter writer;
+        writer.append_layer("", main_image);
+        writer.append_layer("diffuse", layer_image);
+        writer.write(Filename);
+
+        ProgressiveEXRImageFileReader reader;
+        reader.open(Filename);
+
+        for (size_t ty = 0; ty < 2; ++ty)
+        {
+            for (size_t tx = 0; tx < 2; ++tx)
+            {
+                Tile* tile = reader.read_tile(tx, ty);
+
+                for (size_t i = 0; i < tile->get_pixel_count(); ++i)
+                {
+                    Color4b c;
+                    tile->get_pixel(i, c);
+                    EXPECT_EQ(MainReference, c);
+                }
+
+                delete tile;
+            }
+        }
+    }
+}
@@ -28,12 +28,18 @@
 //
 
 // appleseed.foundation headers.
+#include "foundation/platform/thread.h"
 #include "foundation/utility/poolallocator.h"
 #include "foundation/utility/test.h"
 
+// boost headers.
+#include "boost/thread/thread.hpp"
+
 // Standard headers.
 #include <cstddef>
 #include <memory>
+#include <set>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -106,4 +112,112 @@ TEST_SUITE(Foundation_Utility_PoolAllocator)
 
         allocator.deallocate(p, 1);
     }
+
+    TEST_CASE(AllocateManyItems_ReturnsDistinctItems)
+    {
+        PoolAllocator<int, 2> allocator;
+
+        const size_t N = 1000;
+
+        vector<int*> items;
+        set<int*> unique_items;
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            int* p = allocator.allocate(1);
+            items.push_back(p);
+            unique_items.insert(p);
+        }
+
+        EXPECT_EQ(N, unique_items.size());
+
+        for (size_t i = 0; i < N; ++i)
+            allocator.deallocate(items[i], 1);
+    }
+
+    struct DeallocateItems
+    {
+        vector<int*>& m_items;
+
+        explicit DeallocateItems(vector<int*>& items)
+          : m_items(items)
+        {
+        }
+
+        void operator()()
+        {
+            PoolAllocator<int, 2> allocator;
+
+            for (size_t i = 0; i < m_items.size(); ++i)
+                allocator.deallocate(m_items[i], 1);
+        }
+    };
+
+    TEST_CASE(DeallocateItemsOnAnotherThread_ItemsCanBeReallocated)
+    {
+        PoolAllocator<int, 2> allocator;
+
+        const size_t N = 1000;
+
+        vector<int*> items;
+        for (size_t i = 0; i < N; ++i)
+            items.push_back(allocator.allocate(1));
+
+        DeallocateItems func(items);
+        ThreadFunctionWrapper<DeallocateItems> wrapper(&func);
+        boost::thread worker(wrapper);
+        worker.join();
+
+        set<int*> unique_items;
+        for (size_t i = 0; i < N; ++i)
+        {
+            int* p = allocator.allocate(1);
+            unique_items.insert(p);
+            items[i] = p;
+        }
+
+        EXPECT_EQ(N, unique_items.size());
+
+        for (size_t i = 0; i < N; ++i)
+            allocator.deallocate(items[i], 1);
+    }
+
+    struct AllocateAndDeallocateItem
+    {
+        void*   m_item;
+
+        void operator()()
+        {
+            PoolAllocator<double, 64> allocator;
+
+            double* p = allocator.allocate(1);
+            m_item = p;
+            allocator.deallocate(p, 1);
+        }
+    };
+
+    TEST_CASE(ThreadExit_ReturnsNodesCachedByThreadToSharedPool)
+    {
+        // This is the only test using this pool: its shared pool is initially empty.
+        AllocateAndDeallocateItem func;
+        ThreadFunctionWrapper<AllocateAndDeallocateItem> wrapper(&func);
+        boost::thread worker(wrapper);
+        worker.join();
+
+        // The nodes cached by the worker thread are the first ones to be reused.
+        PoolAllocator<double, 64> allocator;
+        vector<double*> items;
+        bool reused = false;
+        for (size_t i = 0; i < impl::Pool<sizeof(double), 64>::BatchSize; ++i)
+        {
+            items.push_back(allocator.allocate(1));
+            if (items.back() == func.m_item)
+                reused = true;
+        }
+
+        EXPECT_TRUE(reused);
+
+        for (size_t i = 0; i < items.size(); ++i)
+            allocator.deallocate(items[i], 1);
+    }
 }
@@ -0,0 +1,179 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/profiler.h"
+#include "foundation/utility/test.h"
+
+// boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Utility_Profiler)
+{
+    string get_json_report(const Profiler& profiler)
+    {
+        FILE* file = tmpfile();
+        profiler.write_json(file);
+
+        string result;
+        rewind(file);
+
+        char buffer[256];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            result.append(buffer, count);
+
+        fclose(file);
+
+        return result;
+    }
+
+    size_t count_occurrences(const string& s, const string& pattern)
+    {
+        size_t count = 0;
+
+        for (size_t pos = s.find(pattern); pos != string::npos; pos = s.find(pattern, pos + 1))
+            ++count;
+
+        return count;
+    }
+
+    TEST_CASE(ScopedProfile_GivenDisabledProfiler_RecordsNothing)
+    {
+        Profiler profiler;
+
+        {
+            ScopedProfile profile(profiler, "scope");
+        }
+
+        const string report = get_json_report(profiler);
+
+        EXPECT_EQ(string::npos, report.find("\"scope\""));
+    }
+
+    TEST_CASE(ScopedProfile_GivenRepeatedScope_MergesCalls)
+    {
+        Profiler profiler;
+        profiler.set_enabled(true);
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            ScopedProfile profile(profiler, "scope");
+        }
+
+        const string report = get_json_report(profiler);
+
+        EXPECT_EQ(1, count_occurrences(report, "\"name\": \"scope\""));
+        EXPECT_EQ(1, count_occurrences(report, "\"calls\": 3"));
+    }
+
+    TEST_CASE(ScopedProfile_GivenNestedScopes_RecordsHierarchy)
+    {
+        Profiler profiler;
+        profiler.set_enabled(true);
+        profiler.set_thread_name("main");
+
+        {
+            ScopedProfile outer(profiler, "outer");
+            ScopedProfile inner(profiler, "inner");
+        }
+
+        const string report = get_json_report(profiler);
+
+        const size_t thread_pos = report.find("\"name\": \"main\"");
+        const size_t outer_pos = report.find("\"name\": \"outer\"");
+        const size_t inner_pos = report.find("\"name\": \"inner\"");
+
+        ASSERT_NEQ(string::npos, thread_pos);
+        ASSERT_NEQ(string::npos, outer_pos);
+        ASSERT_NEQ(string::npos, inner_pos);
+        EXPECT_LT(outer_pos, thread_pos);
+        EXPECT_LT(inner_pos, outer_pos);
+    }
+
+    struct ProfiledFunc
+    {
+        Profiler&   m_profiler;
+
+        explicit ProfiledFunc(Profiler& profiler)
+          : m_profiler(profiler)
+        {
+        }
+
+        void operator()()
+        {
+            ScopedProfile profile(m_profiler, "worker scope");
+        }
+    };
+
+    TEST_CASE(ScopedProfile_GivenScopesOnTwoThreads_ReportsThreadsSeparately)
+    {
+        Profiler profiler;
+        profiler.set_enabled(true);
+
+        {
+            ScopedProfile profile(profiler, "main scope");
+        }
+
+        ProfiledFunc func(profiler);
+        ThreadFunctionWrapper<ProfiledFunc> wrapper(&func);
+        boost::thread worker(wrapper);
+        worker.join();
+
+        const string report = get_json_report(profiler);
+
+        EXPECT_EQ(1, count_occurrences(report, "\"name\": \"thread 0\""));
+        EXPECT_EQ(1, count_occurrences(report, "\"name\": \"thread 1\""));
+        EXPECT_EQ(1, count_occurrences(report, "\"name\": \"worker scope\""));
+    }
+
+    TEST_CASE(Clear_DiscardsRecordedScopes)
+    {
+        Profiler profiler;
+        profiler.set_enabled(true);
+
+        {
+            ScopedProfile profile(profiler, "scope");
+        }
+
+        profiler.clear();
+
+        const string report = get_json_report(profiler);
+
+        EXPECT_EQ(string::npos, report.find("\"scope\""));
+    }
+}
@@ -421,6 +421,102 @@ TEST_SUITE(Foundation_Math_QMC)
                 MaplePlotDef("qmc_rmsd").set_legend("RMS Deviation (QMC)").set_color("red")));
     }
 
+    bool is_stratified(const vector<uint32>& values, const size_t log2_count)
+    {
+        vector<bool> hit(size_t(1) << log2_count, false);
+
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const size_t cell = values[i] >> (32 - log2_count);
+
+            if (hit[cell])
+                return false;
+
+            hit[cell] = true;
+        }
+
+        return true;
+    }
+
+    TEST_CASE(SobolUint32_FirstDimension_MatchesRadicalInverseBase2)
+    {
+        for (uint32 i = 0; i < 1024; ++i)
+        {
+            const double x = sobol_uint32(0, i) / 4294967296.0;
+            EXPECT_EQ(radical_inverse_base2<double>(i), x);
+        }
+    }
+
+    TEST_CASE(SobolUint32_AllDimensions_AreStratified)
+    {
+        for (size_t d = 0; d < SobolDimensionCount; ++d)
+        {
+            vector<uint32> values;
+
+            for (uint32 i = 0; i < 256; ++i)
+                values.push_back(sobol_uint32(d, i));
+
+            EXPECT_TRUE(is_stratified(values, 8));
+        }
+    }
+
+    TEST_CASE(SobolUint32_MultipleDimensions_MatchesSingleDimension)
+    {
+        for (uint32 i = 0; i < 1024; ++i)
+        {
+            uint32 values[4];
+            sobol_uint32(3, 4, i, values);
+
+            for (size_t d = 0; d < 4; ++d)
+                EXPECT_EQ(sobol_uint32(3 + d, i), values[d]);
+        }
+    }
+
+    TEST_CASE(OwenScramble_PreservesStratification)
+    {
+        for (size_t d = 0; d < SobolDimensionCount; ++d)
+        {
+            vector<uint32> values;
+
+            for (uint32 i = 0; i < 256; ++i)
+                values.push_back(owen_scramble(sobol_uint32(d, i), 0x12345678u + static_cast<uint32>(d)));
+
+            EXPECT_TRUE(is_stratified(values, 8));
+        }
+    }
+
+    TEST_CASE(OwenScramble_GivenDifferentSeeds_ReturnsDifferentValues)
+    {
+        EXPECT_NEQ(owen_scramble(0x80000000u, 1), owen_scramble(0x80000000u, 2));
+    }
+
+    TEST_CASE(L2StarDiscrepancy_GivenSinglePointAtCenter_ReturnsExactValue)
+    {
+        const Vector<double, 1> point(0.5);
+
+        // 1/3 - (1 - 0.25) + (1 - 0.5) = 1/12.
+        EXPECT_FEQ(sqrt(1.0 / 12.0), l2_star_discrepancy(&point, 1));
+    }
+
+    TEST_CASE(L2StarDiscrepancy_SobolOwenSequenceIsLowerThanRandom)
+    {
+        const size_t Count = 256;
+
+        vector<Vector2d> sobol_points;
+        vector<Vector2d> random_points;
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < Count; ++i)
+        {
+            sobol_points.push_back(sobol_owen_sequence<double, 2>(7, static_cast<uint32>(i)));
+            random_points.push_back(Vector2d(rand_double2(rng), rand_double2(rng)));
+        }
+
+        EXPECT_LT(
+            l2_star_discrepancy(&random_points[0], Count),
+            l2_star_discrepancy(&sobol_points[0], Count));
+    }
+
 #if 0
 
     TEST_CASE(PrecomputeHaltonSequence)
@@ -106,6 +106,69 @@ TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext)
     }
 }
 
+TEST_SUITE(Foundation_Math_Sampling_SobolSamplingContext)
+{
+    typedef MersenneTwister RNG;
+    typedef SobolSamplingContext<RNG> SamplingContext;
+
+    TEST_CASE(TestSplitting)
+    {
+        RNG rng;
+        SamplingContext context(rng, 2, 64, 7);
+        SamplingContext child_context = context.split(3, 16);
+
+        EXPECT_EQ(5, child_context.get_total_dimension());
+        EXPECT_EQ(7, child_context.get_total_instance());
+    }
+
+    TEST_CASE(NextVector2_ReturnsStratifiedSamples)
+    {
+        RNG rng;
+        SamplingContext context(rng, 2, 0, 0);
+        SamplingContext child_context = context.split(2, 16);
+
+        bool hit[4][4] = { { false } };
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            const Vector2d s = child_context.next_vector2<2>();
+
+            ASSERT_TRUE(s[0] >= 0.0 && s[0] < 1.0);
+            ASSERT_TRUE(s[1] >= 0.0 && s[1] < 1.0);
+
+            const size_t x = static_cast<size_t>(s[0] * 4.0);
+            const size_t y = static_cast<size_t>(s[1] * 4.0);
+
+            EXPECT_FALSE(hit[y][x]);
+            hit[y][x] = true;
+        }
+    }
+
+    TEST_CASE(NextVector2_GivenDifferentParentInstances_ReturnsDifferentSequences)
+    {
+        RNG rng;
+        SamplingContext context1(rng, 2, 0, 0);
+        SamplingContext context2(rng, 2, 0, 1);
+
+        const Vector2d s1 = context1.split(2, 1).next_vector2<2>();
+        const Vector2d s2 = context2.split(2, 1).next_vector2<2>();
+
+        EXPECT_NEQ(s1, s2);
+    }
+
+    TEST_CASE(AssignmentOperator_CopiesSequence)
+    {
+        RNG rng;
+        SamplingContext parent(rng, 2, 64, 7);
+        SamplingContext original = parent.split(3, 16);
+
+        SamplingContext copy(rng, 4, 16, 9);
+        copy = original;
+
+        EXPECT_EQ(original.next_vector2<3>(), copy.next_vector2<3>());
+    }
+}
+
 TEST_SUITE(Foundation_Math_Sampling_QMCSamplingContext_DirectIlluminationSimulation)
 {
     typedef MersenneTwister RNG;
@@ -0,0 +1,171 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.foundation headers.
+#include "foundation/math/aabb.h"
+#include "foundation/math/ray.h"
+#include "foundation/math/vector.h"
+#include "foundation/math/voxel.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace std;
+
+TEST_SUITE(Foundation_Math_Voxel_Builder)
+{
+    typedef voxel::Tree<double, 3> TreeType;
+    typedef voxel::Builder<TreeType> BuilderType;
+    typedef voxel::Intersector<double, TreeType> IntersectorType;
+
+    struct SphereIntersector
+    {
+        Vector3d    m_center;
+        double      m_radius;
+
+        SphereIntersector(const Vector3d& center, const double radius)
+          : m_center(center)
+          , m_radius(radius)
+        {
+        }
+
+        bool intersect(const AABB3d& bbox) const
+        {
+            double square_distance = 0.0;
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const double d =
+                    max(max(bbox.min[i] - m_center[i], m_center[i] - bbox.max[i]), 0.0);
+                square_distance += d * d;
+            }
+
+            return square_distance <= m_radius * m_radius;
+        }
+    };
+
+    struct Fixture
+    {
+        const AABB3d                m_bbox;
+        const double                m_max_extent;
+        vector<SphereIntersector>   m_spheres;
+
+        Fixture()
+          : m_bbox(Vector3d(0.0), Vector3d(1.0))
+          , m_max_extent(0.05)
+        {
+            m_spheres.push_back(SphereIntersector(Vector3d(0.2, 0.3, 0.4), 0.15));
+            m_spheres.push_back(SphereIntersector(Vector3d(0.7, 0.6, 0.5), 0.2));
+            m_spheres.push_back(SphereIntersector(Vector3d(0.5, 0.9, 0.1), 0.05));
+        }
+
+        void build_serially(TreeType& tree) const
+        {
+            BuilderType builder(tree, m_bbox, m_max_extent);
+
+            for (size_t i = 0; i < m_spheres.size(); ++i)
+                builder.push(m_spheres[i]);
+
+            builder.complete();
+        }
+
+        void build_by_subtrees(TreeType& tree, const size_t depth) const
+        {
+            BuilderType builder(tree, m_bbox, m_max_extent);
+
+            vector<BuilderType::Leaf> leaves;
+            builder.subdivide(depth, leaves);
+
+            for (size_t i = 0; i < leaves.size(); ++i)
+            {
+                TreeType subtree;
+                BuilderType subtree_builder(subtree, leaves[i].m_bbox, m_max_extent);
+
+                for (size_t j = 0; j < m_spheres.size(); ++j)
+                {
+                    if (m_spheres[j].intersect(leaves[i].m_bbox))
+                        subtree_builder.push(m_spheres[j]);
+                }
+
+                builder.graft(leaves[i].m_node_index, subtree);
+            }
+
+            builder.complete();
+        }
+    };
+
+    TEST_CASE_F(Subdivide_GivenDepth_ReturnsTwoToThePowerOfDepthLeaves, Fixture)
+    {
+        TreeType tree;
+        BuilderType builder(tree, m_bbox, m_max_extent);
+
+        vector<BuilderType::Leaf> leaves;
+        builder.subdivide(3, leaves);
+
+        EXPECT_EQ(8, leaves.size());
+    }
+
+    TEST_CASE_F(Graft_SubtreesBuiltIndependently_MatchesSerialBuild, Fixture)
+    {
+        TreeType serial_tree;
+        build_serially(serial_tree);
+
+        TreeType grafted_tree;
+        build_by_subtrees(grafted_tree, 4);
+
+        EXPECT_EQ(serial_tree.get_max_diag_length(), grafted_tree.get_max_diag_length());
+
+        const IntersectorType intersector;
+
+        for (size_t y = 0; y < 16; ++y)
+        {
+            for (size_t x = 0; x < 16; ++x)
+            {
+                const Ray3d ray(
+                    Vector3d((x + 0.5) / 16.0, (y + 0.5) / 16.0, 0.0),
+                    normalize(Vector3d(0.1, 0.2, 1.0)));
+                const RayInfo3d ray_info(ray);
+
+                double serial_distance = -1.0;
+                const bool serial_hit =
+                    intersector.intersect(serial_tree, ray, ray_info, true, serial_distance);
+
+                double grafted_distance = -1.0;
+                const bool grafted_hit =
+                    intersector.intersect(grafted_tree, ray, ray_info, true, grafted_distance);
+
+                EXPECT_EQ(serial_hit, grafted_hit);
+                EXPECT_EQ(serial_distance, grafted_distance);
+            }
+        }
+    }
+}
@@ -40,6 +40,8 @@
 
 // boost headers.
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include "boost/thread/condition_variable.hpp"
+#include "boost/thread/tss.hpp"
 
 // Standard headers.
 #include <algorithm>
@@ -199,6 +201,91 @@ namespace
 // Logger class implementation.
 //
 
+namespace
+{
+    const size_t InitialBufferSize = 1024;      // in bytes
+    const size_t MaxBufferSize = 1024 * 1024;   // in bytes
+    const size_t DrainPeriod = 20;              // in milliseconds
+
+    struct PendingMessage
+    {
+        uint32                  m_sequence;
+        LogMessage::Category    m_category;
+        const char*             m_file;
+        size_t                  m_line;
+        size_t                  m_thread;
+        ptime                   m_datetime;
+        string                  m_message;
+    };
+
+    bool precedes(const PendingMessage* lhs, const PendingMessage* rhs)
+    {
+        // Robust to wrap-around of the sequence counter.
+        return static_cast<int32>(lhs->m_sequence - rhs->m_sequence) < 0;
+    }
+
+    //
+    // A single-producer, single-consumer ring buffer of pending messages.
+    // Messages are only pushed by the thread that owns the queue, and only
+    // popped by the thread that drains the queues, so no lock is needed.
+    //
+
+    class MessageQueue
+      : public NonCopyable
+    {
+      public:
+        static const uint32 Capacity = 1024;    // must be a power of two
+
+        size_t                  m_thread;       // reassigned when the queue is recycled
+        vector<char>            m_buffer;       // formatting buffer, only used by the owning thread
+
+        explicit MessageQueue(const size_t thread)
+          : m_thread(thread)
+          , m_buffer(InitialBufferSize)
+          , m_head(0)
+          , m_tail(0)
+          , m_slots(Capacity)
+        {
+        }
+
+        // Return the slot to fill, or 0 if the queue is full. Owning thread only.
+        PendingMessage* begin_push()
+        {
+            if (m_tail - boost_atomic::atomic_read32(&m_head) == Capacity)
+                return 0;
+
+            return &m_slots[m_tail & (Capacity - 1)];
+        }
+
+        // Publish the slot returned by begin_push(). Owning thread only.
+        void end_push()
+        {
+            boost_atomic::atomic_write32(&m_tail, m_tail + 1);
+        }
+
+        bool empty()
+        {
+            return boost_atomic::atomic_read32(&m_head) == boost_atomic::atomic_read32(&m_tail);
+        }
+
+        // Append all pending messages to a vector. Draining thread only.
+        void pop_all(vector<PendingMessage>& messages)
+        {
+            const uint32 tail = boost_atomic::atomic_read32(&m_tail);
+
+            for (uint32 head = m_head; head != tail; ++head)
+                messages.push_back(m_slots[head & (Capacity - 1)]);
+
+            boost_atomic::atomic_write32(&m_head, tail);
+        }
+
+      private:
+        volatile uint32         m_head;
+        volatile uint32         m_tail;
+        vector<PendingMessage>  m_slots;
+    };
+}
+
 struct Logger::Impl
 {
     typedef list<ILogTarget*> LogTargetContainer;
@@ -209,13 +296,233 @@ struct Logger::Impl
     vector<char>        m_message_buffer;
     ThreadMap           m_thread_map;
     Formatter           m_formatter;
-};
 
-namespace
-{
-    const size_t InitialBufferSize = 1024;      // in bytes
-    const size_t MaxBufferSize = 1024 * 1024;   // in bytes
-}
+    // Message queues are owned by the logger. When a thread exits, its queue is
+    // flushed and kept aside for reuse by the next thread that writes a message.
+    struct QueueSlot
+    {
+        Impl*           m_impl;
+        MessageQueue*   m_queue;
+    };
+
+    // Asynchronous mode.
+    volatile uint32                             m_asynchronous;
+    volatile uint32                             m_sequence;
+    boost::thread_specific_ptr<QueueSlot>       m_current_queue;
+    boost::mutex                                m_drain_mutex;      // protects all members below
+    vector<MessageQueue*>                       m_queues;
+    vector<MessageQueue*>                       m_free_queues;
+    vector<PendingMessage>                      m_drained_messages;
+    vector<const PendingMessage*>               m_sorted_messages;
+    boost::condition_variable                   m_drainer_event;
+    bool                                        m_stop_drainer;
+    boost::thread*                              m_drainer;
+
+    Impl()
+      : m_asynchronous(0)
+      , m_sequence(0)
+      , m_current_queue(&release_queue_slot)
+      , m_stop_drainer(false)
+      , m_drainer(0)
+    {
+    }
+
+    ~Impl()
+    {
+        // Only the slot of the current thread can be reached from here.
+        delete m_current_queue.release();
+
+        for (size_t i = 0; i < m_queues.size(); ++i)
+            delete m_queues[i];
+
+        for (size_t i = 0; i < m_free_queues.size(); ++i)
+            delete m_free_queues[i];
+    }
+
+    // Send a formatted message to all log targets. m_mutex must be locked.
+    void send(
+        const LogMessage::Category  category,
+        const char*                 file,
+        const size_t                line,
+        const size_t                thread,
+        const ptime&                datetime,
+        const char*                 message_text)
+    {
+        // Format the header and message.
+        const FormatEvaluator format_evaluator(category, datetime, thread, message_text);
+        const string header = format_evaluator.evaluate(m_formatter.get_header_format(category));
+        const string message = format_evaluator.evaluate(m_formatter.get_message_format(category));
+
+        if (!message.empty())
+        {
+            // Send the header and message to all log targets.
+            for (const_each<LogTargetContainer> i = m_targets; i; ++i)
+            {
+                ILogTarget* target = *i;
+                target->write(
+                    category,
+                    file,
+                    line,
+                    header.c_str(),
+                    message.c_str());
+            }
+        }
+    }
+
+    MessageQueue& get_thread_queue()
+    {
+        QueueSlot* slot = m_current_queue.get();
+
+        if (slot == 0)
+        {
+            size_t thread;
+
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                thread = m_thread_map.thread_id_to_int(boost::this_thread::get_id());
+            }
+
+            MessageQueue* queue = 0;
+
+            {
+                boost::mutex::scoped_lock lock(m_drain_mutex);
+
+                if (m_free_queues.empty())
+                    queue = new MessageQueue(thread);
+                else
+                {
+                    queue = m_free_queues.back();
+                    m_free_queues.pop_back();
+                    queue->m_thread = thread;
+                }
+
+                m_queues.push_back(queue);
+            }
+
+            slot = new QueueSlot();
+            slot->m_impl = this;
+            slot->m_queue = queue;
+            m_current_queue.reset(slot);
+        }
+
+        return *slot->m_queue;
+    }
+
+    // Called by boost::thread_specific_ptr when a thread that wrote messages exits.
+    static void release_queue_slot(QueueSlot* slot)
+    {
+        slot->m_impl->release_queue(slot->m_queue);
+        delete slot;
+    }
+
+    void release_queue(MessageQueue* queue)
+    {
+        boost::mutex::scoped_lock lock(m_drain_mutex);
+
+        // Send the messages of the exiting thread, in order with those of the other threads.
+        drain();
+        assert(queue->empty());
+
+        m_queues.erase(find(m_queues.begin(), m_queues.end(), queue));
+        m_free_queues.push_back(queue);
+    }
+
+    // Send all pending messages to log targets. m_drain_mutex must be locked.
+    void drain()
+    {
+        for (size_t i = 0; i < m_queues.size(); ++i)
+            m_queues[i]->pop_all(m_drained_messages);
+
+        if (m_drained_messages.empty())
+            return;
+
+        // Restore the order in which messages were written.
+        m_sorted_messages.resize(m_drained_messages.size());
+        for (size_t i = 0; i < m_drained_messages.size(); ++i)
+            m_sorted_messages[i] = &m_drained_messages[i];
+        sort(m_sorted_messages.begin(), m_sorted_messages.end(), precedes);
+
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            if (m_enabled)
+            {
+                for (size_t i = 0; i < m_sorted_messages.size(); ++i)
+                {
+                    const PendingMessage& pending = *m_sorted_messages[i];
+                    send(
+                        pending.m_category,
+                        pending.m_file,
+                        pending.m_line,
+                        pending.m_thread,
+                        pending.m_datetime,
+                        pending.m_message.c_str());
+                }
+            }
+        }
+
+        m_drained_messages.clear();
+        m_sorted_messages.clear();
+    }
+
+    void flush()
+    {
+        boost::mutex::scoped_lock lock(m_drain_mutex);
+        drain();
+    }
+
+    void run_drainer()
+    {
+        boost::mutex::scoped_lock lock(m_drain_mutex);
+
+        while (!m_stop_drainer)
+        {
+            drain();
+            m_drainer_event.timed_wait(lock, milliseconds(DrainPeriod));
+        }
+    }
+
+    struct DrainerFunction
+    {
+        Impl* m_impl;
+
+        explicit DrainerFunction(Impl* impl)
+          : m_impl(impl)
+        {
+        }
+
+        void operator()()
+        {
+            m_impl->run_drainer();
+        }
+    };
+
+    void start_drainer()
+    {
+        if (m_drainer == 0)
+        {
+            m_stop_drainer = false;
+            m_drainer = new boost::thread(DrainerFunction(this));
+        }
+    }
+
+    void stop_drainer()
+    {
+        if (m_drainer)
+        {
+            {
+                boost::mutex::scoped_lock lock(m_drain_mutex);
+                m_stop_drainer = true;
+            }
+
+            m_drainer_event.notify_one();
+            m_drainer->join();
+
+            delete m_drainer;
+            m_drainer = 0;
+        }
+    }
+};
 
 Logger::Logger()
   : impl(new Impl())
@@ -226,6 +533,7 @@ Logger::Logger()
 
 Logger::~Logger()
 {
+    set_asynchronous(false);
     delete impl;
 }
 
@@ -235,6 +543,26 @@ void Logger::set_enabled(const bool enabled)
     impl->m_enabled = enabled;
 }
 
+void Logger::set_asynchronous(const bool asynchronous)
+{
+    if (asynchronous)
+    {
+        impl->start_drainer();
+        boost_atomic::atomic_write32(&impl->m_asynchronous, 1);
+    }
+    else
+    {
+        boost_atomic::atomic_write32(&impl->m_asynchronous, 0);
+        impl->stop_drainer();
+        impl->flush();
+    }
+}
+
+void Logger::flush()
+{
+    impl->flush();
+}
+
 void Logger::reset_all_formats()
 {
     boost::mutex::scoped_lock lock(impl->m_mutex);
@@ -275,6 +603,8 @@ void Logger::add_target(ILogTarget* target)
 
 void Logger::remove_target(ILogTarget* target)
 {
+    impl->flush();
+
     boost::mutex::scoped_lock lock(impl->m_mutex);
 
     assert(target);
@@ -328,6 +658,40 @@ void Logger::write(
     const size_t                line,
     PRINTF_FMT const char*      format, ...)
 {
+    if (boost_atomic::atomic_read32(&impl->m_asynchronous))
+    {
+        MessageQueue& queue = impl->get_thread_queue();
+
+        // Print the message into the thread's buffer.
+        va_list argptr;
+        va_start(argptr, format);
+        write_to_buffer(queue.m_buffer, MaxBufferSize, format, argptr);
+        va_end(argptr);
+
+        // If the queue is full, drain it from this thread rather than waiting for the drainer.
+        PendingMessage* pending;
+        while ((pending = queue.begin_push()) == 0)
+            impl->flush();
+
+        pending->m_sequence = boost_atomic::atomic_inc32(&impl->m_sequence);
+        pending->m_category = category;
+        pending->m_file = file;
+        pending->m_line = line;
+        pending->m_thread = queue.m_thread;
+        pending->m_datetime = microsec_clock::universal_time();
+        pending->m_message = &queue.m_buffer[0];
+        queue.end_push();
+
+        // Flush all pending messages and terminate the application if the message category is 'Fatal'.
+        if (category == LogMessage::Fatal)
+        {
+            impl->flush();
+            exit(EXIT_FAILURE);
+        }
+
+        return;
+    }
+
     boost::mutex::scoped_lock lock(impl->m_mutex);
 
     if (impl->m_enabled)
@@ -340,26 +704,9 @@ void Logger::write(
         // Retrieve the current UTC time.
         const ptime datetime(microsec_clock::universal_time());
 
-        // Format the header and message.
+        // Send the message to all log targets.
         const size_t thread = impl->m_thread_map.thread_id_to_int(boost::this_thread::get_id());
-        const FormatEvaluator format_evaluator(category, datetime, thread, &impl->m_message_buffer[0]);
-        const string header = format_evaluator.evaluate(impl->m_formatter.get_header_format(category));
-        const string message = format_evaluator.evaluate(impl->m_formatter.get_message_format(category));
-
-        if (!message.empty())
-        {
-            // Send the header and message to all log targets.
-            for (const_each<Impl::LogTargetContainer> i = impl->m_targets; i; ++i)
-            {
-                ILogTarget* target = *i;
-                target->write(
-                    category,
-                    file,
-                    line,
-                    header.c_str(),
-                    message.c_str());
-            }
-        }
+        impl->send(category, file, line, thread, datetime, &impl->m_message_buffer[0]);
     }
 
     // Terminate the application if the message category is 'Fatal'.
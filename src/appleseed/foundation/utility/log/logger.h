@@ -90,12 +90,26 @@ class DLLSYMBOL Logger
 
     // Remove all instances of a given log target.
     // If the specified target cannot be found, nothing happens.
-    // Log targets can be removed at any time.
+    // Log targets can be removed at any time. Pending messages
+    // are flushed before the target is removed.
     void remove_target(ILogTarget* target);
 
+    // Enable/disable asynchronous mode. In asynchronous mode, messages are formatted
+    // by the calling thread and queued into a buffer assigned to that thread; a background
+    // thread sends them to log targets. Messages from a given thread are always sent
+    // in the order in which they were written. Switching modes while other threads are
+    // writing messages may delay some of their messages until the next flush. The buffer
+    // of a thread is flushed and recycled when the thread exits, so the logger must
+    // outlive the threads that wrote messages in asynchronous mode.
+    void set_asynchronous(const bool asynchronous = true);
+
+    // Send all pending messages to log targets. Returns immediately
+    // if no message is pending (in particular in synchronous mode).
+    void flush();
+
     // Write a message. If the message category is Fatal,
-    // this function will not return and the program will
-    // be terminated.
+    // all pending messages are flushed, then this function
+    // will not return and the program will be terminated.
     void write(
         const LogMessage::Category  category,
         const char*                 file,
@@ -35,6 +35,9 @@
 #include "foundation/platform/thread.h"
 #include "foundation/platform/types.h"
 
+// boost headers.
+#include "boost/thread/tss.hpp"
+
 // Standard headers.
 #include <cassert>
 #include <cstddef>
@@ -47,6 +50,12 @@ namespace foundation
 //
 // A standard-conformant, thread-safe, fixed-size object allocator.
 //
+// Each thread keeps a small cache (a "magazine") of free nodes in front of the
+// shared pool. Nodes move between a magazine and the shared pool in batches, so
+// the spinlock protecting the shared pool is only taken once every few allocations
+// or deallocations. When a thread exits, the nodes of its magazine are returned
+// to the shared pool.
+//
 // Note that memory allocated through this allocator is never returned
 // to the system, and thus is never made available for other uses.
 //
@@ -61,11 +70,85 @@ namespace impl
       : public Singleton<Pool<ItemSize, ItemsPerPage> >
     {
       public:
+        // Number of nodes transferred at once between a magazine and the shared pool.
+        static const size_t BatchSize = 32;
+
         // Allocate a memory block.
         void* allocate()
         {
-            Spinlock::ScopedLock lock(m_spinlock);
+            Magazine& magazine = get_magazine();
+
+            if (magazine.m_head == 0)
+                refill(magazine);
+
+            // Return the first node from the magazine.
+            Node* node = magazine.m_head;
+            magazine.m_head = node->m_next;
+            --magazine.m_count;
+
+            return node;
+        }
+
+        // Return a memory block to the pool.
+        void deallocate(void* p)
+        {
+            assert(p);
+
+            Node* node = static_cast<Node*>(p);
+            Magazine& magazine = get_magazine();
+
+            // Insert this node at the beginning of the magazine.
+            node->m_next = magazine.m_head;
+            magazine.m_head = node;
+            ++magazine.m_count;
+
+            // Give a batch of nodes back to the shared pool if the magazine is overflowing.
+            if (magazine.m_count > 2 * BatchSize)
+                flush(magazine);
+        }
+
+      private:
+        friend class Singleton<Pool<ItemSize, ItemsPerPage> >;
+
+        union Node
+        {
+            uint8   m_item[ItemSize];   // the actual storage for one item
+            Node*   m_next;             // pointer to the next free node
+        };
+
+        // Per-thread cache of free nodes.
+        struct Magazine
+        {
+            Pool*   m_pool;
+            Node*   m_head;
+            size_t  m_count;
+        };
+
+        Spinlock                                m_spinlock;
+        Node*                                   m_page;
+        size_t                                  m_page_index;
+        Node*                                   m_free_head;
+        boost::thread_specific_ptr<Magazine>    m_magazine;
+
+        // Constructor.
+        Pool()
+          : m_page(0)
+          , m_page_index(ItemsPerPage)
+          , m_free_head(0)
+          , m_magazine(&release_magazine)
+        {
+        }
 
+        // Destructor.
+        ~Pool()
+        {
+            // Pages are never freed: simply discard the magazine of the current thread.
+            delete m_magazine.release();
+        }
+
+        // Fetch a node from the shared pool. The spinlock must be held.
+        Node* allocate_node()
+        {
             if (Node* node = m_free_head)
             {
                 // Return the first node from the list of free nodes.
@@ -86,40 +169,82 @@ namespace impl
             }
         }
 
-        // Return a memory block to the pool.
-        void deallocate(void* p)
+        // Return the magazine of the calling thread, creating it if necessary.
+        Magazine& get_magazine()
         {
-            Spinlock::ScopedLock lock(m_spinlock);
+            Magazine* magazine = m_magazine.get();
 
-            assert(p);
+            if (magazine == 0)
+            {
+                magazine = new Magazine();
+                magazine->m_pool = this;
+                magazine->m_head = 0;
+                magazine->m_count = 0;
+                m_magazine.reset(magazine);
+            }
 
-            Node* node = static_cast<Node*>(p);
+            return *magazine;
+        }
 
-            // Insert this node at the beginning of the list of free nodes.
-            node->m_next = m_free_head;
-            m_free_head = node;
+        // Called by boost::thread_specific_ptr when a thread that used the pool exits.
+        static void release_magazine(Magazine* magazine)
+        {
+            magazine->m_pool->empty(*magazine);
+            delete magazine;
         }
 
-      private:
-        friend class Singleton<Pool<ItemSize, ItemsPerPage> >;
+        // Move a batch of nodes from the shared pool to a magazine.
+        void refill(Magazine& magazine)
+        {
+            assert(magazine.m_head == 0);
 
-        union Node
+            Spinlock::ScopedLock lock(m_spinlock);
+
+            for (size_t i = 0; i < BatchSize; ++i)
+            {
+                Node* node = allocate_node();
+                node->m_next = magazine.m_head;
+                magazine.m_head = node;
+            }
+
+            magazine.m_count = BatchSize;
+        }
+
+        // Move a batch of nodes from a magazine back to the shared pool.
+        void flush(Magazine& magazine)
         {
-            uint8   m_item[ItemSize];   // the actual storage for one item
-            Node*   m_next;             // pointer to the next free node
-        };
+            assert(magazine.m_count > BatchSize);
 
-        Spinlock    m_spinlock;
-        Node*       m_page;
-        size_t      m_page_index;
-        Node*       m_free_head;
+            // Detach the first BatchSize nodes of the magazine without holding the lock.
+            Node* first = magazine.m_head;
+            Node* last = first;
+            for (size_t i = 1; i < BatchSize; ++i)
+                last = last->m_next;
+            magazine.m_head = last->m_next;
+            magazine.m_count -= BatchSize;
 
-        // Constructor.
-        Pool()
-          : m_page(0)
-          , m_page_index(ItemsPerPage)
-          , m_free_head(0)
+            // Splice them at the beginning of the list of free nodes.
+            Spinlock::ScopedLock lock(m_spinlock);
+            last->m_next = m_free_head;
+            m_free_head = first;
+        }
+
+        // Move all the nodes of a magazine back to the shared pool.
+        void empty(Magazine& magazine)
         {
+            if (magazine.m_head == 0)
+                return;
+
+            Node* last = magazine.m_head;
+            while (last->m_next)
+                last = last->m_next;
+
+            Spinlock::ScopedLock lock(m_spinlock);
+            last->m_next = m_free_head;
+            m_free_head = magazine.m_head;
+
+            magazine.m_head = 0;
+            magazine.m_count = 0;
         }
     };
 }
@@ -0,0 +1,363 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "profiler.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/platform/timer.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/thread/tss.hpp"
+
+// Standard headers.
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace foundation
+{
+
+//
+// Profiler class implementation.
+//
+
+namespace
+{
+    struct Scope
+    {
+        string              m_name;
+        Scope*              m_parent;
+        vector<Scope*>      m_children;
+        uint64              m_first_begin;      // timer value when the scope was first opened
+        uint64              m_begin;            // timer value when the scope was last opened
+        uint64              m_ticks;            // accumulated duration
+        size_t              m_calls;
+
+        Scope(const string& name, Scope* parent)
+          : m_name(name)
+          , m_parent(parent)
+          , m_first_begin(0)
+          , m_begin(0)
+          , m_ticks(0)
+          , m_calls(0)
+        {
+        }
+
+        ~Scope()
+        {
+            for (size_t i = 0; i < m_children.size(); ++i)
+                delete m_children[i];
+        }
+
+        Scope* get_child(const char* name)
+        {
+            for (size_t i = 0; i < m_children.size(); ++i)
+            {
+                if (m_children[i]->m_name == name)
+                    return m_children[i];
+            }
+
+            m_children.push_back(new Scope(name, this));
+            return m_children.back();
+        }
+    };
+
+    struct ThreadRecord
+    {
+        string              m_name;
+        Scope               m_root;
+        Scope*              m_current;
+
+        explicit ThreadRecord(const string& name)
+          : m_name(name)
+          , m_root(string(), 0)
+          , m_current(&m_root)
+        {
+        }
+    };
+
+    // Thread records are owned by the profiler, not by the threads.
+    void no_cleanup(ThreadRecord*)
+    {
+    }
+
+    string escape_json(const string& s)
+    {
+        string result;
+        result.reserve(s.size());
+
+        for (size_t i = 0; i < s.size(); ++i)
+        {
+            const char c = s[i];
+
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+                result += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+                result += ' ';
+            else result += c;
+        }
+
+        return result;
+    }
+
+    void write_indent(FILE* file, const size_t indent)
+    {
+        for (size_t i = 0; i < indent; ++i)
+            fputs("    ", file);
+    }
+}
+
+struct Profiler::Impl
+{
+    mutable uint32                          m_enabled;
+    uint64                                  m_origin;
+    double                                  m_rcp_frequency;
+    boost::mutex                            m_mutex;
+    vector<ThreadRecord*>                   m_threads;
+    boost::thread_specific_ptr<ThreadRecord> m_current_thread;
+
+    Impl()
+      : m_enabled(0)
+      , m_current_thread(&no_cleanup)
+    {
+        DefaultWallclockTimer timer;
+        m_origin = timer.read();
+        m_rcp_frequency = 1.0 / timer.frequency();
+    }
+
+    ~Impl()
+    {
+        for (size_t i = 0; i < m_threads.size(); ++i)
+            delete m_threads[i];
+    }
+
+    ThreadRecord& get_thread_record()
+    {
+        ThreadRecord* record = m_current_thread.get();
+
+        if (record == 0)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            record = new ThreadRecord("thread " + to_string(m_threads.size()));
+            m_threads.push_back(record);
+            m_current_thread.reset(record);
+        }
+
+        return *record;
+    }
+
+    double to_seconds(const uint64 ticks) const
+    {
+        return static_cast<double>(ticks) * m_rcp_frequency;
+    }
+
+    void write_scope(FILE* file, const Scope& scope, const size_t indent) const
+    {
+        write_indent(file, indent);
+        fprintf(file, "{\n");
+
+        write_indent(file, indent + 1);
+        fprintf(file, "\"name\": \"%s\",\n", escape_json(scope.m_name).c_str());
+
+        write_indent(file, indent + 1);
+        fprintf(file, "\"start\": %.6f,\n",
+            scope.m_first_begin >= m_origin ? to_seconds(scope.m_first_begin - m_origin) : 0.0);
+
+        write_indent(file, indent + 1);
+        fprintf(file, "\"seconds\": %.6f,\n", to_seconds(scope.m_ticks));
+
+        write_indent(file, indent + 1);
+        fprintf(file, "\"calls\": %lu,\n", static_cast<unsigned long>(scope.m_calls));
+
+        write_scopes(file, scope, indent + 1);
+
+        write_indent(file, indent);
+        fprintf(file, "}");
+    }
+
+    void write_scopes(FILE* file, const Scope& parent, const size_t indent) const
+    {
+        write_indent(file, indent);
+
+        if (parent.m_children.empty())
+        {
+            fprintf(file, "\"scopes\": []\n");
+            return;
+        }
+
+        fprintf(file, "\"scopes\": [\n");
+
+        for (size_t i = 0; i < parent.m_children.size(); ++i)
+        {
+            write_scope(file, *parent.m_children[i], indent + 1);
+            fprintf(file, i + 1 < parent.m_children.size() ? ",\n" : "\n");
+        }
+
+        write_indent(file, indent);
+        fprintf(file, "]\n");
+    }
+};
+
+Profiler::Profiler()
+  : impl(new Impl())
+{
+}
+
+Profiler::~Profiler()
+{
+    delete impl;
+}
+
+void Profiler::set_enabled(const bool enabled)
+{
+    boost_atomic::atomic_write32(&impl->m_enabled, enabled ? 1 : 0);
+}
+
+bool Profiler::is_enabled() const
+{
+    return boost_atomic::atomic_read32(&impl->m_enabled) != 0;
+}
+
+void Profiler::clear()
+{
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    // Keep the thread records (and their names) but discard their scopes.
+    for (size_t i = 0; i < impl->m_threads.size(); ++i)
+    {
+        ThreadRecord& record = *impl->m_threads[i];
+
+        for (size_t j = 0; j < record.m_root.m_children.size(); ++j)
+            delete record.m_root.m_children[j];
+
+        record.m_root.m_children.clear();
+        record.m_current = &record.m_root;
+    }
+
+    DefaultWallclockTimer timer;
+    impl->m_origin = timer.read();
+}
+
+void Profiler::set_thread_name(const char* name)
+{
+    assert(name);
+
+    ThreadRecord& record = impl->get_thread_record();
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+    record.m_name = name;
+}
+
+void Profiler::begin_scope(const char* name)
+{
+    assert(name);
+
+    ThreadRecord& record = impl->get_thread_record();
+    Scope* scope = record.m_current->get_child(name);
+
+    DefaultWallclockTimer timer;
+    scope->m_begin = timer.read();
+
+    if (scope->m_calls == 0)
+        scope->m_first_begin = scope->m_begin;
+
+    record.m_current = scope;
+}
+
+void Profiler::end_scope()
+{
+    ThreadRecord& record = impl->get_thread_record();
+    Scope* scope = record.m_current;
+
+    // Tolerate scopes that were opened before the profiler was cleared.
+    if (scope->m_parent == 0)
+        return;
+
+    DefaultWallclockTimer timer;
+    const uint64 end = timer.read();
+
+    scope->m_ticks += end > scope->m_begin ? end - scope->m_begin : 0;
+    ++scope->m_calls;
+
+    record.m_current = scope->m_parent;
+}
+
+void Profiler::write_json(FILE* file) const
+{
+    assert(file);
+
+    boost::mutex::scoped_lock lock(impl->m_mutex);
+
+    fprintf(file, "{\n");
+    fprintf(file, "    \"threads\": [\n");
+
+    for (size_t i = 0; i < impl->m_threads.size(); ++i)
+    {
+        const ThreadRecord& record = *impl->m_threads[i];
+
+        // Total time spent in top-level scopes on this thread.
+        uint64 total_ticks = 0;
+        for (size_t j = 0; j < record.m_root.m_children.size(); ++j)
+            total_ticks += record.m_root.m_children[j]->m_ticks;
+
+        fprintf(file, "        {\n");
+        fprintf(file, "            \"name\": \"%s\",\n", escape_json(record.m_name).c_str());
+        fprintf(file, "            \"seconds\": %.6f,\n", impl->to_seconds(total_ticks));
+        impl->write_scopes(file, record.m_root, 3);
+        fprintf(file, i + 1 < impl->m_threads.size() ? "        },\n" : "        }\n");
+    }
+
+    fprintf(file, "    ]\n");
+    fprintf(file, "}\n");
+}
+
+bool Profiler::write_json(const char* filename) const
+{
+    assert(filename);
+
+    FILE* file = fopen(filename, "wt");
+
+    if (file == 0)
+        return false;
+
+    write_json(file);
+
+    return fclose(file) == 0;
+}
+
+}   // namespace foundation
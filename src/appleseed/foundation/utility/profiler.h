@@ -0,0 +1,137 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_FOUNDATION_UTILITY_PROFILER_H
+#define APPLESEED_FOUNDATION_UTILITY_PROFILER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Standard headers.
+#include <cstdio>
+
+namespace foundation
+{
+
+//
+// A hierarchical, thread-aware profiler.
+//
+// Each thread records its own tree of named scopes: a scope opened while another
+// scope is open on the same thread becomes its child. Scopes with the same name
+// and the same parent are merged, and their time and call count are accumulated.
+// Threads are reported separately, in the order in which they first used the
+// profiler, so that per-thread times can be compared.
+//
+// The profiler is disabled by default, in which case opening and closing scopes
+// with ScopedProfile costs a single test.
+//
+// Scopes must be properly nested on each thread. The report must only be written
+// while no scope is open on any thread.
+//
+
+class DLLSYMBOL Profiler
+  : public NonCopyable
+{
+  public:
+    // Constructor.
+    Profiler();
+
+    // Destructor.
+    ~Profiler();
+
+    // Enable or disable the profiler.
+    void set_enabled(const bool enabled);
+    bool is_enabled() const;
+
+    // Discard all recorded scopes and reset the time origin.
+    // No scope may be open on any thread.
+    void clear();
+
+    // Set the name of the calling thread in the report (default is "thread n").
+    void set_thread_name(const char* name);
+
+    // Open/close a scope on the calling thread.
+    void begin_scope(const char* name);
+    void end_scope();
+
+    // Write a JSON report of all recorded scopes.
+    void write_json(std::FILE* file) const;
+    bool write_json(const char* filename) const;
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+
+//
+// Opens a profiler scope upon construction and closes it upon destruction.
+//
+
+class ScopedProfile
+  : public NonCopyable
+{
+  public:
+    // Constructor, opens the scope if the profiler is enabled.
+    ScopedProfile(
+        Profiler&       profiler,
+        const char*     name);
+
+    // Destructor, closes the scope.
+    ~ScopedProfile();
+
+  private:
+    Profiler*           m_profiler;
+};
+
+
+//
+// ScopedProfile class implementation.
+//
+
+inline ScopedProfile::ScopedProfile(
+    Profiler&           profiler,
+    const char*         name)
+  : m_profiler(profiler.is_enabled() ? &profiler : 0)
+{
+    if (m_profiler)
+        m_profiler->begin_scope(name);
+}
+
+inline ScopedProfile::~ScopedProfile()
+{
+    if (m_profiler)
+        m_profiler->end_scope();
+}
+
+}       // namespace foundation
+
+#endif  // !APPLESEED_FOUNDATION_UTILITY_PROFILER_H
@@ -32,5 +32,6 @@
 
 // API headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 
 #endif  // !APPLESEED_RENDERER_API_LOG_H
@@ -123,6 +123,12 @@ const Image& ImageStack::get_image(const size_t index) const
     return *impl->m_images[index].m_image;
 }
 
+Image& ImageStack::get_image(const size_t index)
+{
+    assert(index < impl->m_images.size());
+    return *impl->m_images[index].m_image;
+}
+
 size_t ImageStack::get(const char* name) const
 {
     const size_t size = impl->m_images.size();
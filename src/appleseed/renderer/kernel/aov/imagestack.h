@@ -80,6 +80,7 @@ class DLLSYMBOL ImageStack
     Type get_type(const size_t index) const;
 
     const foundation::Image& get_image(const size_t index) const;
+    foundation::Image& get_image(const size_t index);
 
     // Returns ~0 if the requested image cannot be found.
     size_t get(const char* name) const;
@@ -64,6 +64,7 @@ namespace renderer
 AssemblyTree::AssemblyTree(const Scene& scene)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_scene(scene)
+  , m_build_sah_cost(0.0)
 {
     update();
 }
@@ -86,7 +87,21 @@ AssemblyTree::~AssemblyTree()
 
 void AssemblyTree::update()
 {
-    rebuild_assembly_tree();
+    bump_version_id();
+
+    // Collect all assembly instances of the scene.
+    ItemVector items;
+    AABBVector assembly_instance_bboxes;
+    collect_assembly_instances(
+        m_scene.assembly_instances(),
+        TransformSequence(),
+        items,
+        assembly_instance_bboxes);
+
+    // Refit the assembly tree if possible, otherwise rebuild it.
+    if (!refit_assembly_tree(items, assembly_instance_bboxes))
+        rebuild_assembly_tree(items, assembly_instance_bboxes);
+
     update_child_trees();
 }
 
@@ -97,12 +112,14 @@ size_t AssemblyTree::get_memory_size() const
         - sizeof(*static_cast<const TreeType*>(this))
         + sizeof(*this)
         + m_items.capacity() * sizeof(AssemblyInstance*)
+        + m_item_ordering.capacity() * sizeof(size_t)
         + m_assembly_versions.size() * sizeof(pair<UniqueID, VersionID>);
 }
 
 void AssemblyTree::collect_assembly_instances(
     const AssemblyInstanceContainer&    assembly_instances,
     const TransformSequence&            parent_transform_seq,
+    ItemVector&                         items,
     AABBVector&                         assembly_instance_bboxes)
 {
     for (const_each<AssemblyInstanceContainer> i = assembly_instances; i; ++i)
@@ -122,6 +139,7 @@ void AssemblyTree::collect_assembly_instances(
         collect_assembly_instances(
             assembly.assembly_instances(),
             cumulated_transform_seq,
+            items,
             assembly_instance_bboxes);
 
         // Skip empty assemblies.
@@ -129,7 +147,7 @@ void AssemblyTree::collect_assembly_instances(
             continue;
 
         // Create and store an item for this assembly instance.
-        m_items.push_back(
+        items.push_back(
             Item(
                 &assembly,
                 &assembly_instance,
@@ -144,21 +162,16 @@ void AssemblyTree::collect_assembly_instances(
     }
 }
 
-void AssemblyTree::rebuild_assembly_tree()
+void AssemblyTree::rebuild_assembly_tree(
+    ItemVector&                         items,
+    const AABBVector&                   assembly_instance_bboxes)
 {
     // Clear the current tree.
     clear();
-    m_items.clear();
+    m_items.swap(items);
 
     Statistics statistics;
 
-    // Collect all assembly instances of the scene.
-    AABBVector assembly_instance_bboxes;
-    collect_assembly_instances(
-        m_scene.assembly_instances(),
-        TransformSequence(),
-        assembly_instance_bboxes);
-
     RENDERER_LOG_INFO(
         "building assembly tree (%s %s)...",
         pretty_int(m_items.size()).c_str(),
@@ -179,9 +192,13 @@ void AssemblyTree::rebuild_assembly_tree()
     statistics.insert_time("build time", builder.get_build_time());
     statistics.merge(bvh::TreeStatistics<AssemblyTree>(*this, AABB3d(m_scene.compute_bbox())));
 
+    // Keep track of where each item went, in order to refit the tree later.
+    m_item_ordering = partitioner.get_item_ordering();
+    m_build_sah_cost = refit_nodes(assembly_instance_bboxes);
+
     if (!m_items.empty())
     {
-        const vector<size_t>& ordering = partitioner.get_item_ordering();
+        const vector<size_t>& ordering = m_item_ordering;
         assert(m_items.size() == ordering.size());
 
         // Reorder the items according to the tree ordering.
@@ -203,6 +220,109 @@ void AssemblyTree::rebuild_assembly_tree()
             statistics).to_string().c_str());
 }
 
+bool AssemblyTree::refit_assembly_tree(
+    const ItemVector&                   items,
+    const AABBVector&                   assembly_instance_bboxes)
+{
+    // The tree can only be refitted if the scene contains the same assembly instances,
+    // in the same order, as when it was built: only their transforms may have changed.
+    if (m_nodes.empty() || items.size() != m_items.size())
+        return false;
+
+    assert(m_item_ordering.size() == m_items.size());
+
+    for (size_t i = 0; i < m_items.size(); ++i)
+    {
+        const Item& item = items[m_item_ordering[i]];
+
+        if (item.m_assembly_instance != m_items[i].m_assembly_instance ||
+            item.m_assembly != m_items[i].m_assembly)
+            return false;
+    }
+
+    RENDERER_LOG_INFO(
+        "refitting assembly tree (%s %s)...",
+        pretty_int(m_items.size()).c_str(),
+        plural(m_items.size(), "assembly instance").c_str());
+
+    // Update the bounding boxes of the nodes and check that the tree is still good enough.
+    const double sah_cost = refit_nodes(assembly_instance_bboxes);
+    if (sah_cost > AssemblyTreeMaxRefitCostRatio * m_build_sah_cost)
+    {
+        RENDERER_LOG_DEBUG(
+            "assembly tree quality dropped too much after refitting (SAH cost %f, was %f when built).",
+            sah_cost,
+            m_build_sah_cost);
+        return false;
+    }
+
+    // Update the items, in tree order.
+    for (size_t i = 0; i < m_items.size(); ++i)
+        m_items[i] = items[m_item_ordering[i]];
+
+    // Update the items stored in the tree leaves.
+    Statistics statistics;
+    store_items_in_leaves(statistics);
+
+    return true;
+}
+
+double AssemblyTree::refit_nodes(const AABBVector& assembly_instance_bboxes)
+{
+    const size_t node_count = m_nodes.size();
+    vector<AABB3d> node_bboxes(node_count);
+    vector<double> node_costs(node_count);
+
+    // Child nodes are always stored after their parent: visit nodes in reverse order
+    // to compute their bounding boxes bottom-up, along with the SAH cost of their subtree.
+    for (size_t i = node_count; i-- > 0; )
+    {
+        NodeType& node = m_nodes[i];
+        AABB3d& bbox = node_bboxes[i];
+
+        if (node.is_leaf())
+        {
+            const size_t item_begin = node.get_item_index();
+            const size_t item_count = node.get_item_count();
+
+            bbox.invalidate();
+
+            for (size_t j = 0; j < item_count; ++j)
+                bbox.insert(assembly_instance_bboxes[m_item_ordering[item_begin + j]]);
+
+            node_costs[i] =
+                item_count > 0
+                    ? AssemblyTreeTriangleIntersectionCost * item_count * half_surface_area(bbox)
+                    : 0.0;
+        }
+        else
+        {
+            const size_t left_index = node.get_child_node_index();
+            const size_t right_index = left_index + 1;
+            assert(left_index > i);
+
+            node.set_left_bbox(node_bboxes[left_index]);
+            node.set_right_bbox(node_bboxes[right_index]);
+
+            bbox = node_bboxes[left_index];
+            bbox.insert(node_bboxes[right_index]);
+
+            node_costs[i] =
+                  AssemblyTreeInteriorNodeTraversalCost * half_surface_area(bbox)
+                + node_costs[left_index]
+                + node_costs[right_index];
+        }
+    }
+
+    // Return the SAH cost of the tree, relative to the surface area of its root.
+    if (node_count == 0 || !node_bboxes[0].is_valid())
+        return 0.0;
+
+    const double root_area = half_surface_area(node_bboxes[0]);
+
+    return root_area > 0.0 ? node_costs[0] / root_area : 0.0;
+}
+
 void AssemblyTree::store_items_in_leaves(Statistics& statistics)
 {
     size_t leaf_count = 0;
@@ -486,9 +606,8 @@ bool AssemblyLeafVisitor::visit(
         const AssemblyTree::Item& item = items[i];
 
         // Evaluate the transformation of the assembly instance.
-        Transformd tmp;
         const Transformd& assembly_instance_transform =
-            item.m_transform_sequence.evaluate(ray.m_time, tmp);
+            m_transform_cache.evaluate(item.m_transform_sequence, ray.m_time);
 
         // Transform the ray to assembly instance space.
         ShadingPoint local_shading_point;
@@ -615,9 +734,8 @@ bool AssemblyLeafProbeVisitor::visit(
         const AssemblyTree::Item& item = items[i];
 
         // Evaluate the transformation of the assembly instance.
-        Transformd tmp;
         const Transformd& assembly_instance_transform =
-            item.m_transform_sequence.evaluate(ray.m_time, tmp);
+            m_transform_cache.evaluate(item.m_transform_sequence, ray.m_time);
 
         // Transform the ray to assembly instance space.
         ShadingRay local_ray;
@@ -641,7 +759,8 @@ bool AssemblyLeafProbeVisitor::visit(
 
             // Check the intersection between the ray and the region tree.
             RegionLeafProbeVisitor visitor(
-                m_triangle_tree_cache
+                m_triangle_tree_cache,
+                m_skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
                 , m_triangle_tree_stats
 #endif
@@ -653,6 +772,10 @@ bool AssemblyLeafProbeVisitor::visit(
                 local_ray_info,
                 visitor);
         
+            // Keep track of surfaces that may be transparent.
+            if (visitor.hit_transparent())
+                m_hit_transparent = true;
+
             // Terminate traversal if there was a hit.
             if (visitor.hit())
             {
@@ -672,7 +795,7 @@ bool AssemblyLeafProbeVisitor::visit(
             {
                 // Check the intersection between the ray and the triangle tree.
                 TriangleTreeProbeIntersector intersector;
-                TriangleLeafProbeVisitor visitor(*triangle_tree);
+                TriangleLeafProbeVisitor visitor(*triangle_tree, m_skip_transparent);
                 if (triangle_tree->get_moving_triangle_count() > 0)
                 {
                     intersector.intersect_motion(
@@ -699,6 +822,10 @@ bool AssemblyLeafProbeVisitor::visit(
                         );
                 }
 
+                // Keep track of surfaces that may be transparent.
+                if (visitor.hit_transparent())
+                    m_hit_transparent = true;
+
                 // Terminate traversal if there was a hit.
                 if (visitor.hit())
                 {
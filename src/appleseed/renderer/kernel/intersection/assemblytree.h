@@ -72,6 +72,7 @@ class AssemblyTree
                    foundation::bvh::Node<foundation::AABB3d>
                >
            >
+  , public foundation::Versionable
 {
   public:
     // Constructor, builds the tree for a given scene.
@@ -80,7 +81,12 @@ class AssemblyTree
     // Destructor.
     ~AssemblyTree();
 
-    // Update the assembly tree and all the child trees.
+    // Update the assembly tree and all the child trees. If the scene still contains the
+    // same assembly instances, the assembly tree is refitted rather than rebuilt.
+    // A refit updates the items of the tree in place: their transform sequences keep
+    // their addresses while their content changes, so an AssemblyTransformCache that
+    // outlives a call to update() must be cleared before it is used again. The version
+    // ID of the tree is bumped by every call to update() to allow detecting this case.
     void update();
 
     // Return the size (in bytes) of this object in memory.
@@ -121,13 +127,22 @@ class AssemblyTree
     RegionTreeContainer     m_region_trees;
     TriangleTreeContainer   m_triangle_trees;
     ItemVector              m_items;
+    std::vector<size_t>     m_item_ordering;        // collection index of the item at each position in the tree
+    double                  m_build_sah_cost;       // SAH cost of the tree when it was last built
     AssemblyVersionMap      m_assembly_versions;
 
     void collect_assembly_instances(
         const AssemblyInstanceContainer&        assembly_instances,
         const TransformSequence&                parent_transform_seq,
+        ItemVector&                             items,
         AABBVector&                             assembly_instance_bboxes);
-    void rebuild_assembly_tree();
+    void rebuild_assembly_tree(
+        ItemVector&                             items,
+        const AABBVector&                       assembly_instance_bboxes);
+    bool refit_assembly_tree(
+        const ItemVector&                       items,
+        const AABBVector&                       assembly_instance_bboxes);
+    double refit_nodes(const AABBVector& assembly_instance_bboxes);
     void store_items_in_leaves(foundation::Statistics& statistics);
 
     void collect_unique_assemblies(AssemblyVector& assemblies) const;
@@ -135,6 +150,16 @@ class AssemblyTree
 };
 
 
+//
+// Assembly instance transform cache.
+//
+// Entries are keyed by the address of the transform sequences stored in the
+// assembly tree, which remain the same across refits (see AssemblyTree::update()).
+//
+
+typedef TransformSequenceCache<AssemblyTreeTransformCacheLines> AssemblyTransformCache;
+
+
 //
 // Assembly leaf visitor, used during tree intersection.
 //
@@ -147,6 +172,7 @@ class AssemblyLeafVisitor
     AssemblyLeafVisitor(
         ShadingPoint&                               shading_point,
         const AssemblyTree&                         tree,
+        AssemblyTransformCache&                     transform_cache,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
         const ShadingPoint*                         parent_shading_point
@@ -169,6 +195,7 @@ class AssemblyLeafVisitor
   private:
     ShadingPoint&                                   m_shading_point;
     const AssemblyTree&                             m_tree;
+    AssemblyTransformCache&                         m_transform_cache;
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
@@ -190,9 +217,11 @@ class AssemblyLeafProbeVisitor
     // Constructor.
     AssemblyLeafProbeVisitor(
         const AssemblyTree&                         tree,
+        AssemblyTransformCache&                     transform_cache,
         RegionTreeAccessCache&                      region_tree_cache,
         TriangleTreeAccessCache&                    triangle_tree_cache,
-        const ShadingPoint*                         parent_shading_point
+        const ShadingPoint*                         parent_shading_point,
+        const bool                                  skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
@@ -211,6 +240,7 @@ class AssemblyLeafProbeVisitor
 
   private:
     const AssemblyTree&                             m_tree;
+    AssemblyTransformCache&                         m_transform_cache;
     RegionTreeAccessCache&                          m_region_tree_cache;
     TriangleTreeAccessCache&                        m_triangle_tree_cache;
     const ShadingPoint*                             m_parent_shading_point;
@@ -244,6 +274,7 @@ typedef foundation::bvh::Intersector<
 inline AssemblyLeafVisitor::AssemblyLeafVisitor(
     ShadingPoint&                                   shading_point,
     const AssemblyTree&                             tree,
+    AssemblyTransformCache&                         transform_cache,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
     const ShadingPoint*                             parent_shading_point
@@ -253,6 +284,7 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
     )
   : m_shading_point(shading_point)
   , m_tree(tree)
+  , m_transform_cache(transform_cache)
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
@@ -269,14 +301,18 @@ inline AssemblyLeafVisitor::AssemblyLeafVisitor(
 
 inline AssemblyLeafProbeVisitor::AssemblyLeafProbeVisitor(
     const AssemblyTree&                             tree,
+    AssemblyTransformCache&                         transform_cache,
     RegionTreeAccessCache&                          region_tree_cache,
     TriangleTreeAccessCache&                        triangle_tree_cache,
-    const ShadingPoint*                             parent_shading_point
+    const ShadingPoint*                             parent_shading_point,
+    const bool                                      skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&         triangle_tree_stats
 #endif
     )
-  : m_tree(tree)
+  : ProbeVisitorBase(skip_transparent)
+  , m_tree(tree)
+  , m_transform_cache(transform_cache)
   , m_region_tree_cache(region_tree_cache)
   , m_triangle_tree_cache(triangle_tree_cache)
   , m_parent_shading_point(parent_shading_point)
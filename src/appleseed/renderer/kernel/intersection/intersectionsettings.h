@@ -35,6 +35,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/math/intersection.h"
+#include "foundation/platform/types.h"
 
 // Standard headers.
 #include <cstddef>
@@ -53,6 +54,12 @@ typedef foundation::TriangleMT<GScalar> GTriangleType;
 typedef foundation::TriangleMT<double> TriangleType;
 typedef foundation::TriangleMTSupportPlane<double> TriangleSupportPlaneType;
 
+// Format used for storing four static triangles of a leaf, intersected at once.
+typedef foundation::TriangleMT4<GScalar> GTriangleBatchType;
+
+// In leaf data, this value replaces the motion segment count to introduce a triangle batch.
+const foundation::uint32 TriangleBatchTag = ~foundation::uint32(0);
+
 
 //
 // Assembly tree settings.
@@ -67,6 +74,13 @@ const double AssemblyTreeInteriorNodeTraversalCost = 1.0;
 // Relative cost of intersecting an assembly.
 const double AssemblyTreeTriangleIntersectionCost = 10.0;
 
+// Size of the per-thread cache of evaluated assembly instance transforms.
+const size_t AssemblyTreeTransformCacheLines = 32;
+
+// When only assembly instance transforms changed, the assembly tree is refitted instead of
+// being rebuilt, unless its SAH cost grows beyond this factor of its cost when it was built.
+const double AssemblyTreeMaxRefitCostRatio = 1.5;
+
 
 //
 // Region tree settings.
@@ -90,8 +104,9 @@ const size_t RegionTreeAccessCacheWays = 1;
 // Triangle tree settings.
 //
 
-// Maximum number of triangles per leaf.
-const size_t TriangleTreeDefaultMaxLeafSize = 2;
+// Maximum number of triangles per leaf. Leaves of four or more static triangles are
+// intersected with SIMD triangle batches, see the TriangleTree_LeafSize benchmarks.
+const size_t TriangleTreeDefaultMaxLeafSize = 8;
 
 // Relative cost of traversing an interior node.
 const GScalar TriangleTreeDefaultInteriorNodeTraversalCost(1.0);
@@ -102,6 +117,16 @@ const GScalar TriangleTreeDefaultTriangleIntersectionCost(1.0);
 // Number of bins used during SBVH construction.
 const size_t TriangleTreeDefaultBinCount = 256;
 
+// Maximum number of nested temporal splits at the top of BVH triangle trees containing
+// moving triangles. Each temporal split duplicates the triangles it covers. 0 disables them.
+// Deciding whether to split costs two extra subtree builds per candidate split, see the
+// Renderer_Kernel_Intersection_TriangleTree_TemporalSplits benchmarks.
+const size_t TriangleTreeDefaultTemporalSplitDepth = 2;
+
+// A temporal split is only made if it reduces the estimated traversal cost below this
+// fraction of the cost of the unsplit subtree.
+const GScalar TriangleTreeDefaultTemporalSplitCostRatio(0.8);
+
 // Define this symbol to enable reordering the nodes of triangle trees for better
 // locality of reference. Requires a lot of temporary memory for minimal results.
 #undef RENDERER_TRIANGLE_TREE_REORDER_NODES
@@ -62,6 +62,7 @@ Intersector::Intersector(
   : m_trace_context(trace_context)
   , m_texture_cache(texture_cache)
   , m_report_self_intersections(report_self_intersections)
+  , m_assembly_tree_version(trace_context.get_assembly_tree().get_version_id())
   , m_shading_ray_count(0)
   , m_probe_ray_count(0)
 {
@@ -242,6 +243,8 @@ bool Intersector::trace(
     assert(parent_shading_point == 0 || parent_shading_point != &shading_point);
     assert(parent_shading_point == 0 || parent_shading_point->hit());
 
+    RENDERER_CYCLE_COUNTER_SCOPE(m_trace_cycles);
+
     // Update ray casting statistics.
     ++m_shading_ray_count;
 
@@ -262,13 +265,14 @@ bool Intersector::trace(
         parent_shading_point->refine_and_offset();
 
     // Retrieve assembly tree.
-    const AssemblyTree& assembly_tree = m_trace_context.get_assembly_tree();
+    const AssemblyTree& assembly_tree = get_assembly_tree();
 
     // Check the intersection between the ray and the assembly tree.
     AssemblyTreeIntersector intersector;
     AssemblyLeafVisitor visitor(
         shading_point,
         assembly_tree,
+        m_assembly_transform_cache,
         m_region_tree_cache,
         m_triangle_tree_cache,
         parent_shading_point
@@ -296,9 +300,44 @@ bool Intersector::trace(
 bool Intersector::trace_probe(
     const ShadingRay&               ray,
     const ShadingPoint*             parent_shading_point) const
+{
+    bool hit_transparent;
+    return do_trace_probe(ray, parent_shading_point, false, hit_transparent);
+}
+
+bool Intersector::trace_opaque_probe(
+    const ShadingRay&               ray,
+    bool&                           hit_transparent,
+    const ShadingPoint*             parent_shading_point) const
+{
+    return do_trace_probe(ray, parent_shading_point, true, hit_transparent);
+}
+
+const AssemblyTree& Intersector::get_assembly_tree() const
+{
+    const AssemblyTree& assembly_tree = m_trace_context.get_assembly_tree();
+
+    // Refitting the assembly tree changes the transform sequences that the assembly
+    // transform cache is keyed on without changing their addresses.
+    if (m_assembly_tree_version != assembly_tree.get_version_id())
+    {
+        m_assembly_transform_cache.clear();
+        m_assembly_tree_version = assembly_tree.get_version_id();
+    }
+
+    return assembly_tree;
+}
+
+bool Intersector::do_trace_probe(
+    const ShadingRay&               ray,
+    const ShadingPoint*             parent_shading_point,
+    const bool                      skip_transparent,
+    bool&                           hit_transparent) const
 {
     assert(parent_shading_point == 0 || parent_shading_point->hit());
 
+    RENDERER_CYCLE_COUNTER_SCOPE(m_trace_probe_cycles);
+
     // Update ray casting statistics.
     ++m_probe_ray_count;
 
@@ -312,15 +351,17 @@ bool Intersector::trace_probe(
         parent_shading_point->refine_and_offset();
 
     // Retrieve assembly tree.
-    const AssemblyTree& assembly_tree = m_trace_context.get_assembly_tree();
+    const AssemblyTree& assembly_tree = get_assembly_tree();
 
     // Check the intersection between the ray and the assembly tree.
     AssemblyTreeProbeIntersector intersector;
     AssemblyLeafProbeVisitor visitor(
         assembly_tree,
+        m_assembly_transform_cache,
         m_region_tree_cache,
         m_triangle_tree_cache,
-        parent_shading_point
+        parent_shading_point,
+        skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , m_triangle_tree_traversal_stats
 #endif
@@ -335,6 +376,8 @@ bool Intersector::trace_probe(
 #endif
         );
 
+    hit_transparent = visitor.hit_transparent();
+
     return visitor.hit();
 }
 
@@ -434,6 +477,17 @@ StatisticsVector Intersector::get_statistics() const
         m_triangle_tree_traversal_stats.get_statistics());
 #endif
 
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+    Statistics time_stats;
+    m_trace_cycles.insert_statistics(time_stats, "trace");
+    m_trace_probe_cycles.insert_statistics(time_stats, "trace probe");
+    vec.insert("time breakdown statistics", time_stats);
+#endif
+
+    vec.insert(
+        "assembly transform cache statistics",
+        make_single_stage_cache_stats(m_assembly_transform_cache));
+
     vec.insert(
         "region tree access cache statistics",
         make_dual_stage_cache_stats(m_region_tree_cache));
@@ -31,11 +31,13 @@
 #define APPLESEED_RENDERER_KERNEL_INTERSECTION_INTERSECTOR_H
 
 // appleseed.renderer headers.
+#include "renderer/kernel/intersection/assemblytree.h"
 #include "renderer/kernel/intersection/intersectionsettings.h"
 #include "renderer/kernel/intersection/regiontree.h"
 #include "renderer/kernel/intersection/triangletree.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/object/regionkit.h"
+#include "renderer/utility/cyclecounter.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
@@ -43,6 +45,7 @@
 #include "foundation/math/transform.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/types.h"
+#include "foundation/utility/version.h"
 
 // Standard headers.
 #include <cstddef>
@@ -102,6 +105,15 @@ class Intersector
         const ShadingRay&               ray,
         const ShadingPoint*             parent_shading_point = 0) const;
 
+    // Trace a world space probe ray through the scene, ignoring surfaces whose materials
+    // may be transparent (e.g. alpha-mapped materials). Returns true if an opaque surface
+    // was hit. Otherwise, 'hit_transparent' tells whether the ray crossed surfaces that
+    // may be transparent.
+    bool trace_opaque_probe(
+        const ShadingRay&               ray,
+        bool&                           hit_transparent,
+        const ShadingPoint*             parent_shading_point = 0) const;
+
     // Manufacture a hit "by hand".
     void manufacture_hit(
         ShadingPoint&                   shading_point,
@@ -122,6 +134,8 @@ class Intersector
     const bool                                      m_report_self_intersections;
 
     // Access caches.
+    mutable foundation::VersionID                   m_assembly_tree_version;    // version of the assembly tree the caches refer to
+    mutable AssemblyTransformCache                  m_assembly_transform_cache;
     mutable RegionTreeAccessCache                   m_region_tree_cache;
     mutable TriangleTreeAccessCache                 m_triangle_tree_cache;
     mutable RegionKitAccessCache                    m_region_kit_cache;
@@ -134,6 +148,19 @@ class Intersector
     mutable foundation::bvh::TraversalStatistics    m_assembly_tree_traversal_stats;
     mutable foundation::bvh::TraversalStatistics    m_triangle_tree_traversal_stats;
 #endif
+
+    // Time breakdown counters.
+    mutable CycleCounter                            m_trace_cycles;
+    mutable CycleCounter                            m_trace_probe_cycles;
+
+    // Return the assembly tree, after clearing caches that may refer to a previous version of it.
+    const AssemblyTree& get_assembly_tree() const;
+
+    bool do_trace_probe(
+        const ShadingRay&               ray,
+        const ShadingPoint*             parent_shading_point,
+        const bool                      skip_transparent,
+        bool&                           hit_transparent) const;
 };
 
 }       // namespace renderer
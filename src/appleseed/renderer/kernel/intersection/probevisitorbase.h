@@ -39,19 +39,28 @@ namespace renderer
 //
 // Base class for probe visitors.
 //
+// When 'skip_transparent' is true, surfaces whose materials may be transparent
+// (see TriangleTree::may_be_transparent()) are not considered as hits; instead,
+// the visitor only records that such surfaces were crossed.
+//
 
 class ProbeVisitorBase
   : public foundation::NonCopyable
 {
   public:
     // Constructor.
-    ProbeVisitorBase();
+    explicit ProbeVisitorBase(const bool skip_transparent = false);
 
     // Return whether a hit was found.
     bool hit() const;
 
+    // Return whether surfaces that may be transparent were crossed.
+    bool hit_transparent() const;
+
   protected:
-    bool m_hit;
+    const bool  m_skip_transparent;
+    bool        m_hit;
+    bool        m_hit_transparent;
 };
 
 
@@ -59,8 +68,10 @@ class ProbeVisitorBase
 // ProbeVisitorBase class implementation.
 //
 
-inline ProbeVisitorBase::ProbeVisitorBase()
-  : m_hit(false)
+inline ProbeVisitorBase::ProbeVisitorBase(const bool skip_transparent)
+  : m_skip_transparent(skip_transparent)
+  , m_hit(false)
+  , m_hit_transparent(false)
 {
 }
 
@@ -69,6 +80,11 @@ inline bool ProbeVisitorBase::hit() const
     return m_hit;
 }
 
+inline bool ProbeVisitorBase::hit_transparent() const
+{
+    return m_hit_transparent;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_INTERSECTION_PROBEVISITORBASE_H
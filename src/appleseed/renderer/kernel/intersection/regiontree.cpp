@@ -569,7 +569,7 @@ double RegionLeafProbeVisitor::visit(
     {
         // Check the intersection between the ray and the triangle tree.
         TriangleTreeProbeIntersector intersector;
-        TriangleLeafProbeVisitor visitor(*triangle_tree);
+        TriangleLeafProbeVisitor visitor(*triangle_tree, m_skip_transparent);
         if (triangle_tree->get_moving_triangle_count() > 0)
         {
             intersector.intersect_motion(
@@ -596,6 +596,10 @@ double RegionLeafProbeVisitor::visit(
                 );
         }
 
+        // Keep track of surfaces that may be transparent.
+        if (visitor.hit_transparent())
+            m_hit_transparent = true;
+
         // Terminate traversal if there was a hit.
         if (visitor.hit())
         {
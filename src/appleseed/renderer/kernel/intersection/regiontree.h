@@ -204,7 +204,8 @@ class RegionLeafProbeVisitor
   public:
     // Constructor.
     RegionLeafProbeVisitor(
-        TriangleTreeAccessCache&                triangle_tree_cache
+        TriangleTreeAccessCache&                triangle_tree_cache,
+        const bool                              skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
         , foundation::bvh::TraversalStatistics& triangle_tree_stats
 #endif
@@ -291,12 +292,14 @@ inline RegionLeafVisitor::RegionLeafVisitor(
 //
 
 inline RegionLeafProbeVisitor::RegionLeafProbeVisitor(
-    TriangleTreeAccessCache&                    triangle_tree_cache
+    TriangleTreeAccessCache&                    triangle_tree_cache,
+    const bool                                  skip_transparent
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
     , foundation::bvh::TraversalStatistics&     triangle_tree_stats
 #endif
     )
-  : m_triangle_tree_cache(triangle_tree_cache)
+  : ProbeVisitorBase(skip_transparent)
+  , m_triangle_tree_cache(triangle_tree_cache)
 #ifdef FOUNDATION_BVH_ENABLE_TRAVERSAL_STATS
   , m_triangle_tree_stats(triangle_tree_stats)
 #endif
@@ -44,24 +44,58 @@ using namespace std;
 namespace renderer
 {
 
+namespace
+{
+    // Return true if the next GTriangleBatchType::Size triangles are static.
+    bool is_static_batch(
+        const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+        const vector<size_t>&               triangle_indices,
+        const size_t                        item_begin,
+        const size_t                        item_count)
+    {
+        if (item_count < GTriangleBatchType::Size)
+            return false;
+
+        for (size_t i = 0; i < GTriangleBatchType::Size; ++i)
+        {
+            const size_t triangle_index = triangle_indices[item_begin + i];
+
+            if (triangle_vertex_infos[triangle_index].m_motion_segment_count > 0)
+                return false;
+        }
+
+        return true;
+    }
+}
+
 size_t TriangleEncoder::compute_size(
     const vector<TriangleVertexInfo>&   triangle_vertex_infos,
     const vector<size_t>&               triangle_indices,
     const size_t                        item_begin,
-    const size_t                        item_count)
+    const size_t                        item_count,
+    const bool                          batch_triangles)
 {
     size_t size = 0;
 
-    for (size_t i = 0; i < item_count; ++i)
+    for (size_t i = 0; i < item_count; )
     {
+        size += sizeof(uint32);         // motion segment count or batch tag
+
+        if (batch_triangles && is_static_batch(triangle_vertex_infos, triangle_indices, item_begin + i, item_count - i))
+        {
+            size += sizeof(GTriangleBatchType);
+            i += GTriangleBatchType::Size;
+            continue;
+        }
+
         const size_t triangle_index = triangle_indices[item_begin + i];
         const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
 
-        size += sizeof(uint32);         // motion segment count
-
         if (vertex_info.m_motion_segment_count == 0)
             size += sizeof(GTriangleType);
         else size += (vertex_info.m_motion_segment_count + 1) * 3 * sizeof(GVector3);
+
+        ++i;
     }
 
     return size;
@@ -73,10 +107,35 @@ void TriangleEncoder::encode(
     const vector<size_t>&               triangle_indices,
     const size_t                        item_begin,
     const size_t                        item_count,
+    const bool                          batch_triangles,
     MemoryWriter&                       writer)
 {
-    for (size_t i = 0; i < item_count; ++i)
+    for (size_t i = 0; i < item_count; )
     {
+        if (batch_triangles && is_static_batch(triangle_vertex_infos, triangle_indices, item_begin + i, item_count - i))
+        {
+            GTriangleBatchType batch;
+
+            for (size_t j = 0; j < GTriangleBatchType::Size; ++j)
+            {
+                const size_t triangle_index = triangle_indices[item_begin + i + j];
+                const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
+
+                batch.set(
+                    j,
+                    GTriangleType(
+                        triangle_vertices[vertex_info.m_vertex_index + 0],
+                        triangle_vertices[vertex_info.m_vertex_index + 1],
+                        triangle_vertices[vertex_info.m_vertex_index + 2]));
+            }
+
+            writer.write(TriangleBatchTag);
+            writer.write(batch);
+
+            i += GTriangleBatchType::Size;
+            continue;
+        }
+
         const size_t triangle_index = triangle_indices[item_begin + i];
         const TriangleVertexInfo& vertex_info = triangle_vertex_infos[triangle_index];
 
@@ -96,6 +155,8 @@ void TriangleEncoder::encode(
                 &triangle_vertices[vertex_info.m_vertex_index],
                 (vertex_info.m_motion_segment_count + 1) * 3 * sizeof(GVector3));
         }
+
+        ++i;
     }
 }
 
@@ -44,6 +44,13 @@ namespace renderer      { class TriangleVertexInfo; }
 namespace renderer
 {
 
+//
+// Encode the triangles of a leaf. Each triangle is introduced by its number of motion
+// segments, followed by its vertices. When batching is enabled, runs of four consecutive
+// static triangles are instead encoded as a single triangle batch, introduced by
+// TriangleBatchTag.
+//
+
 class TriangleEncoder
 {
   public:
@@ -51,7 +58,8 @@ class TriangleEncoder
         const std::vector<TriangleVertexInfo>&  triangle_vertex_infos,
         const std::vector<size_t>&              triangle_indices,
         const size_t                            item_begin,
-        const size_t                            item_count);
+        const size_t                            item_count,
+        const bool                              batch_triangles);
 
     static void encode(
         const std::vector<TriangleVertexInfo>&  triangle_vertex_infos,
@@ -59,6 +67,7 @@ class TriangleEncoder
         const std::vector<size_t>&              triangle_indices,
         const size_t                            item_begin,
         const size_t                            item_count,
+        const bool                              batch_triangles,
         foundation::MemoryWriter&               writer);
 };
 
@@ -32,12 +32,14 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/kernel/intersection/triangleencoder.h"
 #include "renderer/kernel/intersection/triangleitemhandler.h"
 #include "renderer/kernel/intersection/trianglevertexinfo.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/kernel/texturing/texturecache.h"
 #include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/source.h"
 #include "renderer/modeling/material/material.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/object.h"
@@ -46,11 +48,15 @@
 #include "renderer/modeling/scene/assembly.h"
 #include "renderer/modeling/scene/containers.h"
 #include "renderer/modeling/scene/objectinstance.h"
+#ifdef WITH_OSL
+#include "renderer/modeling/shadergroup/shadergroup.h"
+#endif
 #include "renderer/utility/bbox.h"
 #include "renderer/utility/messagecontext.h"
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/area.h"
 #include "foundation/math/permutation.h"
 #include "foundation/math/treeoptimizer.h"
@@ -64,6 +70,7 @@
 // Standard headers.
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <set>
 
 using namespace foundation;
@@ -393,6 +400,8 @@ TriangleTree::TriangleTree(const Arguments& arguments)
   : TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
   , m_arguments(arguments)
 {
+    ScopedProfile profile(global_profiler(), "triangle tree build");
+
     // Retrieve construction parameters.
     const MessageContext message_context(
         string("while building acceleration structure for assembly \"") + m_arguments.m_assembly.get_name() + "\"");
@@ -429,6 +438,9 @@ TriangleTree::TriangleTree(const Arguments& arguments)
     // Create intersection filters.
     if (m_arguments.m_assembly.get_parameters().get_optional<bool>("enable_intersection_filters", true))
         create_intersection_filters();
+
+    // Classify materials as opaque or possibly transparent.
+    classify_materials();
 }
 
 TriangleTree::~TriangleTree()
@@ -446,6 +458,9 @@ void TriangleTree::update_non_geometry()
     delete_intersection_filters();
     if (m_arguments.m_assembly.get_parameters().get_optional<bool>("enable_intersection_filters", true))
         create_intersection_filters();
+
+    // Update material classification.
+    classify_materials();
 }
 
 size_t TriangleTree::get_memory_size() const
@@ -491,6 +506,326 @@ namespace
 
         return count;
     }
+
+    // Compute the bounding box of a triangle at a given time.
+    GAABB3 compute_triangle_bbox(
+        const TriangleVertexInfo&           vertex_info,
+        const vector<GVector3>&             triangle_vertices,
+        const double                        time)
+    {
+        GAABB3 bbox;
+        bbox.invalidate();
+
+        if (vertex_info.m_motion_segment_count == 0)
+        {
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 0]);
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 1]);
+            bbox.insert(triangle_vertices[vertex_info.m_vertex_index + 2]);
+        }
+        else
+        {
+            const double x = time * vertex_info.m_motion_segment_count;
+            const size_t prev_pose_index = min(truncate<size_t>(x), vertex_info.m_motion_segment_count - 1);
+            const size_t base_vertex_index = vertex_info.m_vertex_index + prev_pose_index * 3;
+            const GScalar k = static_cast<GScalar>(x - prev_pose_index);
+
+            bbox.insert(lerp(triangle_vertices[base_vertex_index + 0], triangle_vertices[base_vertex_index + 3], k));
+            bbox.insert(lerp(triangle_vertices[base_vertex_index + 1], triangle_vertices[base_vertex_index + 4], k));
+            bbox.insert(lerp(triangle_vertices[base_vertex_index + 2], triangle_vertices[base_vertex_index + 5], k));
+        }
+
+        return bbox;
+    }
+
+    // A standalone tree with the same node layout as triangle trees.
+    class TriangleSubtree
+      : public TriangleTree::TreeType
+    {
+      public:
+        TriangleSubtree()
+          : TriangleTree::TreeType(AlignedAllocator<void>(System::get_l1_data_cache_line_size()))
+        {
+        }
+
+        const NodeVectorType& get_nodes() const
+        {
+            return m_nodes;
+        }
+    };
+
+    //
+    // Builds the nodes of a triangle tree containing moving triangles.
+    //
+    // The topology of a tree built from triangle bounding boxes taken at a single
+    // time degrades away from that time when triangles deform. At the top of the
+    // tree, this builder recursively halves the shutter interval and builds one
+    // subtree per half, as long as the estimated SAH cost of the pair of subtrees
+    // is sufficiently lower than the cost of a single subtree for the whole interval.
+    // The two halves are joined by temporal split nodes that traversal resolves
+    // using the ray time alone. Triangles are referenced once per time interval.
+    //
+
+    class TemporalSplitBuilder
+      : public NonCopyable
+    {
+      public:
+        typedef TriangleTree::NodeVectorType NodeVectorType;
+        typedef TriangleTree::NodeType NodeType;
+
+        TemporalSplitBuilder(
+            const vector<TriangleVertexInfo>&   triangle_vertex_infos,
+            const vector<GVector3>&             triangle_vertices,
+            const double                        time,
+            const size_t                        max_depth,
+            const GScalar                       cost_ratio,
+            const size_t                        max_leaf_size,
+            const GScalar                       interior_node_traversal_cost,
+            const GScalar                       triangle_intersection_cost)
+          : m_triangle_vertex_infos(triangle_vertex_infos)
+          , m_triangle_vertices(triangle_vertices)
+          , m_time(time)
+          , m_max_depth(max_depth)
+          , m_cost_ratio(cost_ratio)
+          , m_max_leaf_size(max_leaf_size)
+          , m_interior_node_traversal_cost(interior_node_traversal_cost)
+          , m_triangle_intersection_cost(triangle_intersection_cost)
+          , m_temporal_split_count(0)
+          , m_build_time(0.0)
+        {
+        }
+
+        void build(NodeVectorType& nodes)
+        {
+            nodes.clear();
+            nodes.push_back(NodeType());
+
+            m_item_ordering.clear();
+            m_temporal_split_count = 0;
+            m_build_time = 0.0;
+
+            auto_ptr<IntervalTree> root_tree(build_interval_tree(0.0, 1.0));
+            build_recurse(nodes, 0, 0.0, 1.0, 0, root_tree);
+        }
+
+        // Return the triangle indices referenced by the leaves of the tree.
+        const vector<size_t>& get_item_ordering() const
+        {
+            return m_item_ordering;
+        }
+
+        size_t get_temporal_split_count() const
+        {
+            return m_temporal_split_count;
+        }
+
+        double get_build_time() const
+        {
+            return m_build_time;
+        }
+
+      private:
+        struct IntervalTree
+        {
+            TriangleSubtree                 m_tree;
+            vector<size_t>                  m_item_ordering;
+            GScalar                         m_cost;
+        };
+
+        const vector<TriangleVertexInfo>&   m_triangle_vertex_infos;
+        const vector<GVector3>&             m_triangle_vertices;
+        const double                        m_time;
+        const size_t                        m_max_depth;
+        const GScalar                       m_cost_ratio;
+        const size_t                        m_max_leaf_size;
+        const GScalar                       m_interior_node_traversal_cost;
+        const GScalar                       m_triangle_intersection_cost;
+        vector<size_t>                      m_item_ordering;
+        size_t                              m_temporal_split_count;
+        double                              m_build_time;
+
+        void build_recurse(
+            NodeVectorType&                 nodes,
+            const size_t                    node_index,
+            const double                    t0,
+            const double                    t1,
+            const size_t                    depth,
+            auto_ptr<IntervalTree>&         interval_tree)
+        {
+            if (depth < m_max_depth)
+            {
+                const double tm = 0.5 * (t0 + t1);
+                auto_ptr<IntervalTree> left_tree(build_interval_tree(t0, tm));
+                auto_ptr<IntervalTree> right_tree(build_interval_tree(tm, t1));
+
+                // Both halves of the time interval are equally likely to be sampled.
+                const GScalar split_cost = GScalar(0.5) * (left_tree->m_cost + right_tree->m_cost);
+
+                if (split_cost < m_cost_ratio * interval_tree->m_cost)
+                {
+                    interval_tree.reset();
+
+                    const size_t left_node_index = nodes.size();
+                    nodes.push_back(NodeType());
+                    nodes.push_back(NodeType());
+
+                    NodeType& node = nodes[node_index];
+                    node.make_interior();
+                    node.set_child_node_index(left_node_index);
+                    node.make_temporal_split(tm);
+                    ++m_temporal_split_count;
+
+                    build_recurse(nodes, left_node_index + 0, t0, tm, depth + 1, left_tree);
+                    build_recurse(nodes, left_node_index + 1, tm, t1, depth + 1, right_tree);
+
+                    return;
+                }
+            }
+
+            splice(nodes, node_index, *interval_tree);
+        }
+
+        auto_ptr<IntervalTree> build_interval_tree(const double t0, const double t1)
+        {
+            const size_t triangle_count = m_triangle_vertex_infos.size();
+
+            // Partition the triangles using their bounding boxes at the build time within the interval.
+            const double build_time = t0 + m_time * (t1 - t0);
+            vector<GAABB3> triangle_bboxes(triangle_count);
+            for (size_t i = 0; i < triangle_count; ++i)
+                triangle_bboxes[i] = compute_triangle_bbox(m_triangle_vertex_infos[i], m_triangle_vertices, build_time);
+
+            typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
+            Partitioner partitioner(
+                triangle_bboxes,
+                m_max_leaf_size,
+                m_interior_node_traversal_cost,
+                m_triangle_intersection_cost);
+
+            auto_ptr<IntervalTree> interval_tree(new IntervalTree());
+
+            typedef bvh::Builder<TriangleSubtree, Partitioner> Builder;
+            Builder builder;
+            builder.build<DefaultWallclockTimer>(interval_tree->m_tree, partitioner, triangle_count, m_max_leaf_size);
+            m_build_time += builder.get_build_time();
+
+            interval_tree->m_item_ordering = partitioner.get_item_ordering();
+            interval_tree->m_cost = estimate_cost(*interval_tree, t0, t1);
+
+            return interval_tree;
+        }
+
+        // Estimate the SAH cost of a tree over a time interval, using the average
+        // surface area of its nodes at the start, middle and end of the interval.
+        GScalar estimate_cost(const IntervalTree& interval_tree, const double t0, const double t1) const
+        {
+            const size_t triangle_count = m_triangle_vertex_infos.size();
+            const double times[3] = { t0, 0.5 * (t0 + t1), t1 };
+
+            vector<GAABB3> triangle_bboxes[3];
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                triangle_bboxes[j].resize(triangle_count);
+
+                for (size_t i = 0; i < triangle_count; ++i)
+                    triangle_bboxes[j][i] = compute_triangle_bbox(m_triangle_vertex_infos[i], m_triangle_vertices, times[j]);
+            }
+
+            GAABB3 root_bboxes[3];
+            GScalar cost(0.0);
+            estimate_cost_recurse(interval_tree, triangle_bboxes, 0, root_bboxes, cost);
+
+            return cost;
+        }
+
+        void estimate_cost_recurse(
+            const IntervalTree&             interval_tree,
+            const vector<GAABB3>            triangle_bboxes[3],
+            const size_t                    node_index,
+            GAABB3                          node_bboxes[3],
+            GScalar&                        cost) const
+        {
+            const NodeType& node = interval_tree.m_tree.get_nodes()[node_index];
+
+            if (node.is_interior())
+            {
+                GAABB3 left_bboxes[3], right_bboxes[3];
+                estimate_cost_recurse(interval_tree, triangle_bboxes, node.get_child_node_index() + 0, left_bboxes, cost);
+                estimate_cost_recurse(interval_tree, triangle_bboxes, node.get_child_node_index() + 1, right_bboxes, cost);
+
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    node_bboxes[j] = left_bboxes[j];
+                    node_bboxes[j].insert(right_bboxes[j]);
+                }
+
+                cost += m_interior_node_traversal_cost * average_half_surface_area(node_bboxes);
+            }
+            else
+            {
+                const size_t item_begin = node.get_item_index();
+                const size_t item_count = node.get_item_count();
+
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    node_bboxes[j].invalidate();
+
+                    for (size_t i = 0; i < item_count; ++i)
+                        node_bboxes[j].insert(triangle_bboxes[j][interval_tree.m_item_ordering[item_begin + i]]);
+                }
+
+                cost +=
+                      m_triangle_intersection_cost
+                    * static_cast<GScalar>(item_count)
+                    * average_half_surface_area(node_bboxes);
+            }
+        }
+
+        static GScalar average_half_surface_area(const GAABB3 bboxes[3])
+        {
+            GScalar area(0.0);
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                if (bboxes[j].is_valid())
+                    area += half_surface_area(bboxes[j]);
+            }
+
+            return area * GScalar(1.0 / 3.0);
+        }
+
+        // Append the nodes of a subtree to the tree, the root of the subtree replacing a given node.
+        void splice(
+            NodeVectorType&                 nodes,
+            const size_t                    node_index,
+            const IntervalTree&             interval_tree)
+        {
+            const NodeVectorType& subtree_nodes = interval_tree.m_tree.get_nodes();
+            const size_t first_node_index = nodes.size();
+            const size_t item_offset = m_item_ordering.size();
+
+            nodes.reserve(nodes.size() + subtree_nodes.size() - 1);
+
+            for (size_t i = 0; i < subtree_nodes.size(); ++i)
+            {
+                NodeType node = subtree_nodes[i];
+
+                // The subtree root is not appended, hence the -1.
+                if (node.is_interior())
+                    node.set_child_node_index(first_node_index + node.get_child_node_index() - 1);
+                else node.set_item_index(item_offset + node.get_item_index());
+
+                if (i == 0)
+                    nodes[node_index] = node;
+                else nodes.push_back(node);
+            }
+
+            m_item_ordering.insert(
+                m_item_ordering.end(),
+                interval_tree.m_item_ordering.begin(),
+                interval_tree.m_item_ordering.end());
+        }
+    };
 }
 
 void TriangleTree::build_bvh(
@@ -539,6 +874,68 @@ void TriangleTree::build_bvh(
     const size_t max_leaf_size = params.get_optional<size_t>("max_leaf_size", TriangleTreeDefaultMaxLeafSize);
     const GScalar interior_node_travesal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
     const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
+    const size_t temporal_split_depth = params.get_optional<size_t>("temporal_split_depth", TriangleTreeDefaultTemporalSplitDepth);
+    const GScalar temporal_split_cost_ratio = params.get_optional<GScalar>("temporal_split_cost_ratio", TriangleTreeDefaultTemporalSplitCostRatio);
+    const bool triangle_batches = params.get_optional<bool>("triangle_batches", true);
+
+    if (m_moving_triangle_count > 0 && temporal_split_depth > 0)
+    {
+        // Bounding boxes taken at a single time are not needed.
+        clear_release_memory(triangle_bboxes);
+
+        // Collect triangle vertices.
+        stopwatch.start();
+        vector<GVector3> triangle_vertices;
+        collect_triangles<GAABB3>(
+            m_arguments,
+            time,
+            save_memory,
+            0,
+            0,
+            &triangle_vertices,
+            0);
+        const double vertex_collection_time = stopwatch.measure().get_seconds();
+
+        // Build the tree, splitting the shutter interval where it lowers the traversal cost.
+        TemporalSplitBuilder builder(
+            triangle_vertex_infos,
+            triangle_vertices,
+            time,
+            temporal_split_depth,
+            temporal_split_cost_ratio,
+            max_leaf_size,
+            interior_node_travesal_cost,
+            triangle_intersection_cost);
+        builder.build(m_nodes);
+        statistics.merge(bvh::TreeStatistics<TriangleTree>(*this, AABB3d(m_arguments.m_bbox)));
+        statistics.insert("temporal splits", pretty_uint(builder.get_temporal_split_count()));
+
+        stopwatch.start();
+
+        // Compute and propagate motion bounding boxes.
+        compute_motion_bboxes(
+            builder.get_item_ordering(),
+            triangle_vertex_infos,
+            triangle_vertices,
+            0);
+
+        // Store triangles and triangle keys into the tree.
+        store_triangles(
+            builder.get_item_ordering(),
+            triangle_vertex_infos,
+            triangle_vertices,
+            triangle_keys,
+            triangle_batches,
+            statistics);
+
+        const double storing_time = stopwatch.measure().get_seconds();
+
+        statistics.insert_time("collection time", collection_time + vertex_collection_time);
+        statistics.insert_time("partition time", builder.get_build_time());
+        statistics.insert_time("store time", storing_time);
+
+        return;
+    }
 
     // Create the partitioner.
     typedef bvh::SAHPartitioner<vector<GAABB3> > Partitioner;
@@ -583,6 +980,7 @@ void TriangleTree::build_bvh(
         triangle_vertex_infos,
         triangle_vertices,
         triangle_keys,
+        triangle_batches,
         statistics);
 
     const double storing_time = stopwatch.measure().get_seconds();
@@ -640,6 +1038,7 @@ void TriangleTree::build_sbvh(
     const size_t bin_count = params.get_optional<size_t>("bin_count", TriangleTreeDefaultBinCount);
     const GScalar interior_node_travesal_cost = params.get_optional<GScalar>("interior_node_traversal_cost", TriangleTreeDefaultInteriorNodeTraversalCost);
     const GScalar triangle_intersection_cost = params.get_optional<GScalar>("triangle_intersection_cost", TriangleTreeDefaultTriangleIntersectionCost);
+    const bool triangle_batches = params.get_optional<bool>("triangle_batches", true);
 
     // Create the partitioner.
     typedef bvh::SBVHPartitioner<TriangleItemHandler, vector<AABB3d> > Partitioner;
@@ -696,6 +1095,7 @@ void TriangleTree::build_sbvh(
         triangle_vertex_infos,
         triangle_vertices,
         triangle_keys,
+        triangle_batches,
         statistics);
 
     const double storing_time = stopwatch.measure().get_seconds();
@@ -774,6 +1174,19 @@ vector<GAABB3> TriangleTree::compute_motion_bboxes(
                 triangle_vertices,
                 node.get_child_node_index() + 1);
 
+        const size_t bbox_count = max(left_bboxes.size(), right_bboxes.size());
+        vector<GAABB3> bboxes(bbox_count);
+
+        for (size_t i = 0; i < bbox_count; ++i)
+        {
+            bboxes[i] = left_bboxes[i * left_bboxes.size() / bbox_count];
+            bboxes[i].insert(right_bboxes[i * right_bboxes.size() / bbox_count]);
+        }
+
+        // Temporal split nodes don't store bounding boxes.
+        if (node.is_temporal_split())
+            return bboxes;
+
         node.set_left_bbox_count(left_bboxes.size());
         node.set_right_bbox_count(right_bboxes.size());
 
@@ -793,15 +1206,6 @@ vector<GAABB3> TriangleTree::compute_motion_bboxes(
                 m_node_bboxes.push_back(swizzle(AABB3d(*i)));
         }
 
-        const size_t bbox_count = max(left_bboxes.size(), right_bboxes.size());
-        vector<GAABB3> bboxes(bbox_count);
-
-        for (size_t i = 0; i < bbox_count; ++i)
-        {
-            bboxes[i] = left_bboxes[i * left_bboxes.size() / bbox_count];
-            bboxes[i].insert(right_bboxes[i * right_bboxes.size() / bbox_count]);
-        }
-
         return bboxes;
     }
     else
@@ -878,6 +1282,7 @@ void TriangleTree::store_triangles(
     const vector<TriangleVertexInfo>&   triangle_vertex_infos,
     const vector<GVector3>&             triangle_vertices,
     const vector<TriangleKey>&          triangle_keys,
+    const bool                          batch_triangles,
     Statistics&                         statistics)
 {
     const size_t node_count = m_nodes.size();
@@ -904,7 +1309,8 @@ void TriangleTree::store_triangles(
                     triangle_vertex_infos,
                     triangle_indices,
                     item_begin,
-                    item_count);
+                    item_count,
+                    batch_triangles);
 
             if (leaf_size < NodeType::MaxUserDataSize)
                 ++fat_leaf_count;
@@ -941,7 +1347,8 @@ void TriangleTree::store_triangles(
                     triangle_vertex_infos,
                     triangle_indices,
                     item_begin,
-                    item_count);
+                    item_count,
+                    batch_triangles);
 
             MemoryWriter user_data_writer(&node.get_user_data<uint8>());
 
@@ -955,6 +1362,7 @@ void TriangleTree::store_triangles(
                     triangle_indices,
                     item_begin,
                     item_count,
+                    batch_triangles,
                     user_data_writer);
             }
             else
@@ -967,6 +1375,7 @@ void TriangleTree::store_triangles(
                     triangle_indices,
                     item_begin,
                     item_count,
+                    batch_triangles,
                     leaf_data_writer);
             }
         }
@@ -1175,6 +1584,98 @@ void TriangleTree::delete_intersection_filters()
     m_intersection_filters.clear();
 }
 
+namespace
+{
+    // Return true if a material may make surfaces (partially) transparent.
+    bool may_be_transparent(const Material* material)
+    {
+        if (material == 0)
+            return false;
+
+        // Use the uncached versions of get_alpha_map() and get_osl_surface()
+        // since on_frame_begin() may not have been called on the material yet.
+        if (const Source* alpha_map = material->get_uncached_alpha_map())
+        {
+            // A uniform, fully opaque alpha map doesn't make surfaces transparent.
+            if (!alpha_map->is_uniform())
+                return true;
+
+            Alpha alpha;
+            alpha_map->evaluate_uniform(alpha);
+
+            if (alpha[0] < 1.0f)
+                return true;
+        }
+
+#ifdef WITH_OSL
+        if (const ShaderGroup* sg = material->get_uncached_osl_surface())
+        {
+            // The transparency flag of a shader group is only known once the shader
+            // group went through on_frame_begin(), which may not have happened yet.
+            if (!sg->has_shader_info() || sg->has_transparency())
+                return true;
+        }
+#endif
+
+        return false;
+    }
+
+    // Classify the material slots of an object instance. Returns false if all materials are opaque.
+    bool classify_object_instance_materials(
+        const ObjectInstance&               object_instance,
+        vector<bool>&                       transparent_materials)
+    {
+        const MaterialArray& front_materials = object_instance.get_front_materials();
+        const MaterialArray& back_materials = object_instance.get_back_materials();
+        const size_t material_count = max(front_materials.size(), back_materials.size());
+
+        transparent_materials.assign(material_count, false);
+
+        bool has_transparent_materials = false;
+
+        for (size_t i = 0; i < material_count; ++i)
+        {
+            const bool transparent =
+                (i < front_materials.size() && may_be_transparent(front_materials[i])) ||
+                (i < back_materials.size() && may_be_transparent(back_materials[i]));
+
+            transparent_materials[i] = transparent;
+            has_transparent_materials = has_transparent_materials || transparent;
+        }
+
+        return has_transparent_materials;
+    }
+}
+
+void TriangleTree::classify_materials()
+{
+    m_transparent_materials.clear();
+
+    // Collect object instance indices.
+    IndexSet object_instance_indices;
+    collect_object_instance_indices(
+        m_arguments.m_regions,
+        object_instance_indices);
+
+    const ObjectInstanceContainer& object_instances = m_arguments.m_assembly.object_instances();
+    vector<bool> transparent_materials;
+
+    for (const_each<IndexSet> i = object_instance_indices; i; ++i)
+    {
+        const size_t object_instance_index = *i;
+        const ObjectInstance* object_instance =
+            object_instances.get_by_index(object_instance_index);
+
+        if (!classify_object_instance_materials(*object_instance, transparent_materials))
+            continue;
+
+        if (m_transparent_materials.size() <= object_instance_index)
+            m_transparent_materials.resize(object_instance_index + 1);
+
+        m_transparent_materials[object_instance_index].swap(transparent_materials);
+    }
+}
+
 
 //
 // TriangleTreeFactory class implementation.
@@ -128,6 +128,10 @@ class TriangleTree
     std::vector<const IntersectionFilter*>      m_intersection_filters_repository;
     std::vector<const IntersectionFilter*>      m_intersection_filters;
 
+    // Indexed by object instance index, then by material slot: true if the surface may be
+    // transparent. Empty if no material referenced by this tree may be transparent.
+    std::vector<std::vector<bool> >             m_transparent_materials;
+
     void build_bvh(
         const ParamArray&                       params,
         const double                            time,
@@ -151,10 +155,16 @@ class TriangleTree
         const std::vector<TriangleVertexInfo>&  triangle_vertex_infos,
         const std::vector<GVector3>&            triangle_vertices,
         const std::vector<TriangleKey>&         triangle_keys,
+        const bool                              batch_triangles,
         foundation::Statistics&                 statistics);
 
     void create_intersection_filters();
     void delete_intersection_filters();
+
+    void classify_materials();
+
+    // Return true if the surface of a given triangle may be (partially) transparent.
+    bool may_be_transparent(const TriangleKey& triangle_key) const;
 };
 
 
@@ -247,7 +257,8 @@ class TriangleLeafProbeVisitor
   public:
     // Constructor.
     explicit TriangleLeafProbeVisitor(
-        const TriangleTree&                     tree);
+        const TriangleTree&                     tree,
+        const bool                              skip_transparent = false);
 
     // Visit a leaf.
     bool visit(
@@ -337,6 +348,19 @@ inline size_t TriangleTree::get_moving_triangle_count() const
     return m_moving_triangle_count;
 }
 
+inline bool TriangleTree::may_be_transparent(const TriangleKey& triangle_key) const
+{
+    const size_t object_instance_index = triangle_key.get_object_instance_index();
+
+    if (object_instance_index >= m_transparent_materials.size())
+        return false;
+
+    const std::vector<bool>& materials = m_transparent_materials[object_instance_index];
+    const size_t material_index = triangle_key.get_triangle_pa();
+
+    return material_index < materials.size() && materials[material_index];
+}
+
 
 //
 // TriangleLeafVisitor class implementation.
@@ -382,7 +406,42 @@ inline bool TriangleLeafVisitor::visit(
             *reinterpret_cast<const foundation::uint32*>(leaf_data);
         leaf_data += sizeof(foundation::uint32);
 
-        if (motion_segment_count == 0)
+        if (motion_segment_count == TriangleBatchTag)
+        {
+            // Intersect a batch of static triangles at once.
+            const GTriangleBatchType* batch_ptr = reinterpret_cast<const GTriangleBatchType*>(leaf_data);
+            leaf_data += sizeof(GTriangleBatchType);
+
+            double t[GTriangleBatchType::Size], u[GTriangleBatchType::Size], v[GTriangleBatchType::Size];
+            const size_t mask = batch_ptr->intersect(m_shading_point.m_ray, t, u, v);
+
+            // Record hits as if the triangles had been intersected one after the other.
+            for (size_t j = 0; mask != 0 && j < GTriangleBatchType::Size; ++j)
+            {
+                if ((mask & (size_t(1) << j)) == 0 || t[j] >= m_shading_point.m_ray.m_tmax)
+                    continue;
+
+                // Optionally filter intersections.
+                if (m_has_intersection_filters)
+                {
+                    const TriangleKey& triangle_key = m_tree.m_triangle_keys[triangle_index + i + j];
+                    const IntersectionFilter* filter =
+                        m_tree.m_intersection_filters[triangle_key.get_object_instance_index()];
+                    if (filter && !filter->accept(triangle_key, u[j], v[j]))
+                        continue;
+                }
+
+                m_interpolated_triangle = batch_ptr->get(j);
+                m_hit_triangle = &m_interpolated_triangle;
+                m_hit_triangle_index = triangle_index + i + j;
+                m_shading_point.m_ray.m_tmax = t[j];
+                m_shading_point.m_bary[0] = u[j];
+                m_shading_point.m_bary[1] = v[j];
+            }
+
+            i += GTriangleBatchType::Size - 1;
+        }
+        else if (motion_segment_count == 0)
         {
             // Load the triangle, converting it to the right format if necessary.
             const GTriangleType* triangle_ptr = reinterpret_cast<const GTriangleType*>(leaf_data);
@@ -484,8 +543,10 @@ inline void TriangleLeafVisitor::read_hit_triangle_data() const
 //
 
 inline TriangleLeafProbeVisitor::TriangleLeafProbeVisitor(
-    const TriangleTree&                     tree)
-  : m_tree(tree)
+    const TriangleTree&                     tree,
+    const bool                              skip_transparent)
+  : ProbeVisitorBase(skip_transparent && !tree.m_transparent_materials.empty())
+  , m_tree(tree)
   , m_has_intersection_filters(!tree.m_intersection_filters.empty())
 {
 }
@@ -509,6 +570,7 @@ inline bool TriangleLeafProbeVisitor::visit(
             ? user_data + sizeof(foundation::uint32)    // triangles are stored in the leaf node
             : &m_tree.m_leaf_data[leaf_data_index];     // triangles are stored in the tree
 
+    const size_t triangle_index = node.get_item_index();
     const size_t triangle_count = node.get_item_count();
 
     // Sequentially intersect triangles until a hit is found.
@@ -519,7 +581,34 @@ inline bool TriangleLeafProbeVisitor::visit(
             *reinterpret_cast<const foundation::uint32*>(leaf_data);
         leaf_data += sizeof(foundation::uint32);
 
-        if (motion_segment_count == 0)
+        if (motion_segment_count == TriangleBatchTag)
+        {
+            // Intersect a batch of static triangles at once.
+            const GTriangleBatchType* batch_ptr = reinterpret_cast<const GTriangleBatchType*>(leaf_data);
+            leaf_data += sizeof(GTriangleBatchType);
+
+            const size_t mask = batch_ptr->intersect(ray);
+
+            for (size_t j = 0; mask != 0 && j < GTriangleBatchType::Size; ++j)
+            {
+                if ((mask & (size_t(1) << j)) == 0)
+                    continue;
+
+                // Optionally skip surfaces that may be transparent.
+                if (m_skip_transparent && m_tree.may_be_transparent(m_tree.m_triangle_keys[triangle_index + i + j]))
+                {
+                    m_hit_transparent = true;
+                    continue;
+                }
+
+                FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + j + 1));
+                m_hit = true;
+                return false;
+            }
+
+            i += GTriangleBatchType::Size - 1;
+        }
+        else if (motion_segment_count == 0)
         {
             // Load the triangle, converting it to the right format if necessary.
             const GTriangleType* triangle_ptr = reinterpret_cast<const GTriangleType*>(leaf_data);
@@ -529,6 +618,13 @@ inline bool TriangleLeafProbeVisitor::visit(
             // Intersect the triangle.
             if (reader.m_triangle.intersect(ray))
             {
+                // Optionally skip surfaces that may be transparent.
+                if (m_skip_transparent && m_tree.may_be_transparent(m_tree.m_triangle_keys[triangle_index + i]))
+                {
+                    m_hit_transparent = true;
+                    continue;
+                }
+
                 FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + 1));
                 m_hit = true;
                 return false;
@@ -555,6 +651,13 @@ inline bool TriangleLeafProbeVisitor::visit(
             // Intersect the triangle.
             if (reader.m_triangle.intersect(ray))
             {
+                // Optionally skip surfaces that may be transparent.
+                if (m_skip_transparent && m_tree.may_be_transparent(m_tree.m_triangle_keys[triangle_index + i]))
+                {
+                    m_hit_transparent = true;
+                    continue;
+                }
+
                 FOUNDATION_BVH_TRAVERSAL_STATS(stats.m_intersected_items.insert(i + 1));
                 m_hit = true;
                 return false;
@@ -104,6 +104,8 @@ void DirectLightingIntegrator::sample_bsdf_and_lights(
     Spectrum&                   radiance,
     SpectrumStack&              aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     sample_bsdf(
         sampling_context,
         DirectLightingIntegrator::mis_power2,
@@ -128,6 +130,8 @@ void DirectLightingIntegrator::sample_bsdf_and_lights_low_variance(
     Spectrum&                   radiance,
     SpectrumStack&              aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     sample_bsdf(
         sampling_context,
         DirectLightingIntegrator::mis_power2,
@@ -152,6 +156,8 @@ void DirectLightingIntegrator::take_single_bsdf_or_light_sample(
     Spectrum&                   radiance,
     SpectrumStack&              aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     radiance.set(0.0f);
     aovs.set(0.0f);
 
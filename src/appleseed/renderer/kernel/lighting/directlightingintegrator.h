@@ -42,6 +42,7 @@
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/input/inputevaluator.h"
 #include "renderer/modeling/material/material.h"
+#include "renderer/utility/cyclecounter.h"
 
 // appleseed.foundation headers.
 #include "foundation/math/basis.h"
@@ -279,6 +280,8 @@ void DirectLightingIntegrator::sample_bsdf(
     Spectrum&                           radiance,
     SpectrumStack&                      aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     radiance.set(0.0f);
     aovs.set(0.0f);
 
@@ -309,6 +312,8 @@ void DirectLightingIntegrator::sample_lights(
     Spectrum&                           radiance,
     SpectrumStack&                      aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     radiance.set(0.0f);
     aovs.set(0.0f);
 
@@ -338,6 +343,8 @@ void DirectLightingIntegrator::sample_lights_low_variance(
     Spectrum&                           radiance,
     SpectrumStack&                      aovs)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_shading_context.get_direct_lighting_cycle_counter());
+
     radiance.set(0.0f);
     aovs.set(0.0f);
 
@@ -32,12 +32,15 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/aov/spectrumstack.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/lighting/drt/irradiancecache.h"
 #include "renderer/kernel/lighting/directlightingintegrator.h"
 #include "renderer/kernel/lighting/imagebasedlighting.h"
 #include "renderer/kernel/lighting/lightsampler.h"
 #include "renderer/kernel/lighting/pathtracer.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/edf/edf.h"
 #include "renderer/modeling/environment/environment.h"
@@ -51,12 +54,20 @@
 #include "foundation/math/basis.h"
 #include "foundation/math/mis.h"
 #include "foundation/math/population.h"
+#include "foundation/math/sampling.h"
+#include "foundation/platform/defaulttimers.h"
 #include "foundation/utility/memory.h"
 #include "foundation/utility/statistics.h"
+#include "foundation/utility/stopwatch.h"
 #include "foundation/utility/string.h"
 
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+
 // Standard headers.
 #include <algorithm>
+#include <limits>
+#include <string>
 
 // Forward declarations.
 namespace renderer  { class EnvironmentEDF; }
@@ -88,6 +99,13 @@ namespace
             const double    m_dl_light_sample_count;        // number of light samples used to estimate direct illumination
             const double    m_ibl_env_sample_count;         // number of environment samples used to estimate IBL
 
+            const bool      m_enable_ic;                    // is the irradiance cache enabled?
+            const double    m_ic_max_error;                 // maximum interpolation error of the irradiance cache
+            const double    m_ic_min_spacing;               // minimum record spacing, relative to the scene diameter
+            const double    m_ic_max_spacing;               // maximum record spacing, relative to the scene diameter
+            const size_t    m_ic_gather_sample_count;       // number of hemisphere samples used to compute a record
+            const string    m_ic_filename;                  // file used to persist the irradiance cache, empty if none
+
             float           m_rcp_dl_light_sample_count;
             float           m_rcp_ibl_env_sample_count;
 
@@ -97,6 +115,12 @@ namespace
               , m_rr_min_path_length(nz(params.get_optional<size_t>("rr_min_path_length", 3)))
               , m_dl_light_sample_count(params.get_optional<double>("dl_light_samples", 1.0))
               , m_ibl_env_sample_count(params.get_optional<double>("ibl_env_samples", 1.0))
+              , m_enable_ic(params.get_optional<bool>("enable_irradiance_cache", false))
+              , m_ic_max_error(params.get_optional<double>("ic_max_error", 0.3))
+              , m_ic_min_spacing(params.get_optional<double>("ic_min_spacing", 0.001))
+              , m_ic_max_spacing(params.get_optional<double>("ic_max_spacing", 0.05))
+              , m_ic_gather_sample_count(max<size_t>(params.get_optional<size_t>("ic_gather_samples", 64), 1))
+              , m_ic_filename(params.get_optional<string>("ic_filename", ""))
             {
                 // Precompute the reciprocal of the number of light samples.
                 m_rcp_dl_light_sample_count =
@@ -124,21 +148,43 @@ namespace
                     "  max path length  %s\n"
                     "  rr min path len. %s\n"
                     "  dl light samples %s\n"
-                    "  ibl env samples  %s",
+                    "  ibl env samples  %s\n"
+                    "  irradiance cache %s",
                     m_enable_ibl ? "on" : "off",
                     m_max_path_length == ~0 ? "infinite" : pretty_uint(m_max_path_length).c_str(),
                     m_rr_min_path_length == ~0 ? "infinite" : pretty_uint(m_rr_min_path_length).c_str(),
                     pretty_scalar(m_dl_light_sample_count).c_str(),
-                    pretty_scalar(m_ibl_env_sample_count).c_str());
+                    pretty_scalar(m_ibl_env_sample_count).c_str(),
+                    m_enable_ic ? "on" : "off");
+
+                if (m_enable_ic)
+                {
+                    RENDERER_LOG_INFO(
+                        "irradiance cache settings:\n"
+                        "  max error        %s\n"
+                        "  min spacing      %s\n"
+                        "  max spacing      %s\n"
+                        "  gather samples   %s\n"
+                        "  cache file       %s",
+                        pretty_scalar(m_ic_max_error).c_str(),
+                        pretty_scalar(m_ic_min_spacing, 4).c_str(),
+                        pretty_scalar(m_ic_max_spacing, 4).c_str(),
+                        pretty_uint(m_ic_gather_sample_count).c_str(),
+                        m_ic_filename.empty() ? "none" : m_ic_filename.c_str());
+                }
             }
         };
 
         DRTLightingEngine(
             const LightSampler&     light_sampler,
+            IrradianceCache*        irradiance_cache,
             const ParamArray&       params)
           : m_params(params)
           , m_light_sampler(light_sampler)
+          , m_irradiance_cache(irradiance_cache)
           , m_path_count(0)
+          , m_ic_hit_count(0)
+          , m_ic_miss_count(0)
         {
         }
 
@@ -158,6 +204,9 @@ namespace
             PathVisitor path_visitor(
                 m_params,
                 m_light_sampler,
+                m_irradiance_cache,
+                m_ic_hit_count,
+                m_ic_miss_count,
                 sampling_context,
                 shading_context,
                 shading_point.get_scene(),
@@ -187,20 +236,33 @@ namespace
             stats.insert("path count", m_path_count);
             stats.insert("path length", m_path_length);
 
+            if (m_irradiance_cache)
+            {
+                stats.insert("ic lookups", m_ic_hit_count + m_ic_miss_count);
+                stats.insert("ic hits", m_ic_hit_count);
+                stats.insert("ic misses", m_ic_miss_count);
+            }
+
             return StatisticsVector::make("distribution ray tracing statistics", stats);
         }
 
       private:
         const Parameters        m_params;
         const LightSampler&     m_light_sampler;
+        IrradianceCache*        m_irradiance_cache;
 
         uint64                  m_path_count;
         Population<uint64>      m_path_length;
+        uint64                  m_ic_hit_count;
+        uint64                  m_ic_miss_count;
 
         struct PathVisitor
         {
             const Parameters&           m_params;
             const LightSampler&         m_light_sampler;
+            IrradianceCache*            m_irradiance_cache;
+            uint64&                     m_ic_hit_count;
+            uint64&                     m_ic_miss_count;
             SamplingContext&            m_sampling_context;
             const ShadingContext&       m_shading_context;
             TextureCache&               m_texture_cache;
@@ -211,6 +273,9 @@ namespace
             PathVisitor(
                 const Parameters&       params,
                 const LightSampler&     light_sampler,
+                IrradianceCache*        irradiance_cache,
+                uint64&                 ic_hit_count,
+                uint64&                 ic_miss_count,
                 SamplingContext&        sampling_context,
                 const ShadingContext&   shading_context,
                 const Scene&            scene,
@@ -218,6 +283,9 @@ namespace
                 SpectrumStack&          path_aovs)
               : m_params(params)
               , m_light_sampler(light_sampler)
+              , m_irradiance_cache(irradiance_cache)
+              , m_ic_hit_count(ic_hit_count)
+              , m_ic_miss_count(ic_miss_count)
               , m_sampling_context(sampling_context)
               , m_shading_context(shading_context)
               , m_texture_cache(shading_context.get_texture_cache())
@@ -261,6 +329,14 @@ namespace
                             vertex_radiance,
                             vertex_aovs);
                     }
+
+                    // Indirect diffuse lighting from the irradiance cache.
+                    if (m_irradiance_cache && (vertex.m_bsdf->get_modes() & BSDF::Diffuse))
+                    {
+                        add_cached_indirect_lighting_contribution(
+                            vertex,
+                            vertex_radiance);
+                    }
                 }
 
                 // Emitted light.
@@ -360,6 +436,178 @@ namespace
                 vertex_aovs.add(m_env_edf->get_render_layer_index(), ibl_radiance);
             }
 
+            void add_cached_indirect_lighting_contribution(
+                const PathVertex&       vertex,
+                Spectrum&               vertex_radiance)
+            {
+                // Irradiance is computed over the hemisphere on the side of the outgoing direction.
+                const Vector3d normal =
+                    vertex.m_cos_on < 0.0
+                        ? -vertex.get_shading_normal()
+                        : vertex.get_shading_normal();
+
+                Spectrum irradiance;
+
+                if (m_irradiance_cache->lookup(vertex.get_point(), normal, irradiance))
+                    ++m_ic_hit_count;
+                else
+                {
+                    double mean_distance;
+                    compute_indirect_irradiance(vertex, normal, irradiance, mean_distance);
+                    m_irradiance_cache->insert(vertex.get_point(), normal, irradiance, mean_distance);
+                    ++m_ic_miss_count;
+                }
+
+                // Only the diffuse component of the BSDF is used to reflect the cached irradiance.
+                Spectrum bsdf_value;
+                const double bsdf_prob =
+                    vertex.m_bsdf->evaluate(
+                        vertex.m_bsdf_data,
+                        false,                  // not adjoint
+                        false,                  // do not multiply by |cos(incoming, normal)|
+                        vertex.get_geometric_normal(),
+                        vertex.get_shading_basis(),
+                        vertex.m_outgoing,
+                        normal,
+                        BSDF::Diffuse,
+                        bsdf_value);
+                if (bsdf_prob == 0.0)
+                    return;
+
+                irradiance *= bsdf_value;
+                vertex_radiance += irradiance;
+            }
+
+            void compute_indirect_irradiance(
+                const PathVertex&       vertex,
+                const Vector3d&         normal,
+                Spectrum&               irradiance,
+                double&                 mean_distance)
+            {
+                const size_t sample_count = m_params.m_ic_gather_sample_count;
+                const Basis3d basis(normal);
+                const ShadingRay& ray = vertex.get_ray();
+
+                irradiance.set(0.0f);
+                double rcp_distance_sum = 0.0;
+
+                SamplingContext child_sampling_context =
+                    m_sampling_context.split(2, sample_count);
+
+                for (size_t i = 0; i < sample_count; ++i)
+                {
+                    // Cosine-weighted sampling of the hemisphere.
+                    const Vector2d s = child_sampling_context.next_vector2<2>();
+                    const Vector3d incoming = basis.transform_to_parent(sample_hemisphere_cosine(s));
+
+                    const ShadingRay gather_ray(
+                        vertex.m_shading_point->get_biased_point(incoming),
+                        incoming,
+                        ray.m_time,
+                        ShadingRay::DiffuseRay,
+                        ray.m_depth + 1);
+
+                    ShadingPoint shading_point;
+                    m_shading_context.get_intersector().trace(
+                        gather_ray,
+                        shading_point,
+                        vertex.m_shading_point);
+
+                    // Light coming directly from the environment is accounted for by IBL.
+                    if (!shading_point.hit())
+                        continue;
+
+                    rcp_distance_sum += 1.0 / shading_point.get_distance();
+
+                    Spectrum radiance;
+                    compute_reflected_direct_radiance(
+                        child_sampling_context,
+                        shading_point,
+                        -incoming,
+                        radiance);
+
+                    irradiance += radiance;
+                }
+
+                // The cosine term cancels out with the probability density p = cos(theta) / Pi.
+                irradiance *= static_cast<float>(Pi / sample_count);
+
+                // Harmonic mean distance to the surfaces visible from this point.
+                mean_distance =
+                    rcp_distance_sum > 0.0
+                        ? sample_count / rcp_distance_sum
+                        : numeric_limits<double>::max();
+            }
+
+            void compute_reflected_direct_radiance(
+                SamplingContext&        sampling_context,
+                const ShadingPoint&     shading_point,
+                const Vector3d&         outgoing,
+                Spectrum&               radiance)
+            {
+                radiance.set(0.0f);
+
+                const Material* material = shading_point.get_material();
+                if (material == 0)
+                    return;
+
+#ifdef WITH_OSL
+                if (material->get_osl_surface())
+                {
+                    m_shading_context.execute_osl_shadergroup(
+                        *material->get_osl_surface(),
+                        shading_point);
+                }
+#endif
+
+                const BSDF* bsdf = material->get_bsdf();
+                if (bsdf == 0)
+                    return;
+
+                InputEvaluator input_evaluator(m_texture_cache);
+                bsdf->evaluate_inputs(input_evaluator, shading_point);
+
+                // Direct lighting at the gather point.
+                DirectLightingIntegrator integrator(
+                    m_shading_context,
+                    m_light_sampler,
+                    shading_point,
+                    outgoing,
+                    *bsdf,
+                    input_evaluator.data(),
+                    BSDF::AllScatteringModes,
+                    BSDF::AllScatteringModes,
+                    1,
+                    1,
+                    true);              // computing indirect lighting
+
+                SpectrumStack dl_aovs(m_path_aovs.size());
+                integrator.sample_bsdf_and_lights_low_variance(
+                    sampling_context,
+                    radiance,
+                    dl_aovs);
+
+                // Image-based lighting at the gather point.
+                if (m_params.m_enable_ibl && m_env_edf)
+                {
+                    Spectrum ibl_radiance;
+                    compute_ibl(
+                        sampling_context,
+                        m_shading_context,
+                        *m_env_edf,
+                        shading_point,
+                        outgoing,
+                        *bsdf,
+                        input_evaluator.data(),
+                        BSDF::AllScatteringModes,
+                        BSDF::AllScatteringModes,
+                        1,
+                        1,
+                        ibl_radiance);
+                    radiance += ibl_radiance;
+                }
+            }
+
             void add_emitted_light_contribution(
                 const PathVertex&       vertex,
                 Spectrum&               vertex_radiance,
@@ -439,12 +687,83 @@ namespace
 //
 
 DRTLightingEngineFactory::DRTLightingEngineFactory(
+    const Scene&        scene,
     const LightSampler& light_sampler,
     const ParamArray&   params)
   : m_light_sampler(light_sampler)
   , m_params(params)
 {
-    DRTLightingEngine::Parameters(params).print();
+    const DRTLightingEngine::Parameters engine_params(params);
+    engine_params.print();
+
+    if (engine_params.m_enable_ic)
+    {
+        const GAABB3 scene_bbox = scene.compute_bbox();
+        const double scene_diameter =
+            scene_bbox.is_valid() ? static_cast<double>(norm(scene_bbox.extent())) : 1.0;
+
+        m_irradiance_cache.reset(
+            new IrradianceCache(
+                scene_bbox,
+                engine_params.m_ic_max_error,
+                engine_params.m_ic_min_spacing * scene_diameter,
+                engine_params.m_ic_max_spacing * scene_diameter));
+
+        // Reuse the records of a previous render, if any.
+        m_ic_filename = engine_params.m_ic_filename;
+        if (!m_ic_filename.empty() && boost::filesystem::exists(m_ic_filename))
+        {
+            Stopwatch<DefaultWallclockTimer> stopwatch;
+            stopwatch.start();
+
+            if (m_irradiance_cache->load(m_ic_filename.c_str()))
+            {
+                stopwatch.measure();
+                RENDERER_LOG_INFO(
+                    "loaded %s irradiance cache %s from %s in %s.",
+                    pretty_uint(m_irradiance_cache->size()).c_str(),
+                    plural(m_irradiance_cache->size(), "record").c_str(),
+                    m_ic_filename.c_str(),
+                    pretty_time(stopwatch.get_seconds()).c_str());
+            }
+            else
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to load irradiance cache from %s.",
+                    m_ic_filename.c_str());
+                m_irradiance_cache->clear();
+            }
+        }
+    }
+}
+
+DRTLightingEngineFactory::~DRTLightingEngineFactory()
+{
+    if (m_irradiance_cache.get() == 0)
+        return;
+
+    RENDERER_LOG_DEBUG("%s",
+        StatisticsVector::make(
+            "irradiance cache statistics",
+            m_irradiance_cache->get_statistics()).to_string().c_str());
+
+    if (!m_ic_filename.empty())
+    {
+        if (m_irradiance_cache->save(m_ic_filename.c_str()))
+        {
+            RENDERER_LOG_INFO(
+                "wrote %s irradiance cache %s to %s.",
+                pretty_uint(m_irradiance_cache->size()).c_str(),
+                plural(m_irradiance_cache->size(), "record").c_str(),
+                m_ic_filename.c_str());
+        }
+        else
+        {
+            RENDERER_LOG_ERROR(
+                "failed to write irradiance cache to %s.",
+                m_ic_filename.c_str());
+        }
+    }
 }
 
 void DRTLightingEngineFactory::release()
@@ -454,7 +773,11 @@ void DRTLightingEngineFactory::release()
 
 ILightingEngine* DRTLightingEngineFactory::create()
 {
-    return new DRTLightingEngine(m_light_sampler, m_params);
+    return
+        new DRTLightingEngine(
+            m_light_sampler,
+            m_irradiance_cache.get(),
+            m_params);
 }
 
 }   // namespace renderer
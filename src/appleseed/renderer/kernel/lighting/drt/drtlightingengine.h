@@ -34,8 +34,14 @@
 #include "renderer/global/global.h"
 #include "renderer/kernel/lighting/ilightingengine.h"
 
+// Standard headers.
+#include <memory>
+#include <string>
+
 // Forward declarations.
+namespace renderer  { class IrradianceCache; }
 namespace renderer  { class LightSampler; }
+namespace renderer  { class Scene; }
 
 namespace renderer
 {
@@ -50,9 +56,13 @@ class DRTLightingEngineFactory
   public:
     // Constructor.
     DRTLightingEngineFactory(
+        const Scene&        scene,
         const LightSampler& light_sampler,
         const ParamArray&   params);
 
+    // Destructor.
+    ~DRTLightingEngineFactory();
+
     // Delete this instance.
     virtual void release() OVERRIDE;
 
@@ -60,8 +70,10 @@ class DRTLightingEngineFactory
     virtual ILightingEngine* create() OVERRIDE;
 
   private:
-    const LightSampler&     m_light_sampler;
-    ParamArray              m_params;
+    const LightSampler&             m_light_sampler;
+    ParamArray                      m_params;
+    std::auto_ptr<IrradianceCache>  m_irradiance_cache;    // shared by all DRT lighting engines
+    std::string                     m_ic_filename;
 };
 
 }       // namespace renderer
@@ -0,0 +1,379 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "irradiancecache.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/scalar.h"
+#include "foundation/utility/bufferedfile.h"
+#include "foundation/utility/statistics.h"
+
+// boost headers.
+#include "boost/thread/locks.hpp"
+
+// Standard headers.
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace boost;
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+namespace
+{
+    // Signature and version of irradiance cache files.
+    const char IrradianceCacheFileSignature[] = { 'A', 'S', 'I', 'C' };
+    const uint16 IrradianceCacheFileVersion = 1;
+
+    // Return the distance between two points using the L-infinity norm.
+    double linf_distance(const Vector3d& a, const Vector3d& b)
+    {
+        return
+            max(
+                max(abs(a[0] - b[0]), abs(a[1] - b[1])),
+                abs(a[2] - b[2]));
+    }
+}
+
+
+//
+// IrradianceCache class implementation.
+//
+
+IrradianceCache::IrradianceCache(
+    const GAABB3&           bbox,
+    const double            max_error,
+    const double            min_spacing,
+    const double            max_spacing)
+  : m_max_error(max_error)
+  , m_rcp_max_error(1.0 / max_error)
+  , m_min_spacing(min_spacing)
+  , m_max_spacing(max(min_spacing, max_spacing))
+{
+    assert(max_error > 0.0);
+    assert(min_spacing > 0.0);
+
+    Node root;
+
+    if (bbox.is_valid())
+    {
+        // Slightly enlarge the root node to account for points lying exactly on the scene boundary.
+        root.m_center = Vector3d(bbox.center());
+        root.m_half_size = 0.51 * max(static_cast<double>(max_value(bbox.extent())), m_max_spacing);
+    }
+    else
+    {
+        root.m_center = Vector3d(0.0);
+        root.m_half_size = 1.0;
+    }
+
+    fill(root.m_children, root.m_children + 8, 0);
+
+    m_nodes.push_back(root);
+}
+
+void IrradianceCache::clear()
+{
+    unique_lock<shared_mutex> lock(m_mutex);
+
+    m_records.clear();
+
+    // Keep the root node.
+    m_nodes.resize(1);
+    m_nodes[0].m_records.clear();
+    fill(m_nodes[0].m_children, m_nodes[0].m_children + 8, 0);
+}
+
+size_t IrradianceCache::size() const
+{
+    shared_lock<shared_mutex> lock(m_mutex);
+    return m_records.size();
+}
+
+size_t IrradianceCache::get_memory_size() const
+{
+    shared_lock<shared_mutex> lock(m_mutex);
+
+    size_t size = sizeof(*this);
+    size += m_records.capacity() * sizeof(Record);
+    size += m_nodes.capacity() * sizeof(Node);
+
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+        size += m_nodes[i].m_records.capacity() * sizeof(size_t);
+
+    return size;
+}
+
+bool IrradianceCache::lookup(
+    const Vector3d&         point,
+    const Vector3d&         normal,
+    Spectrum&               irradiance) const
+{
+    assert(is_normalized(normal));
+
+    Spectrum weighted_irradiance(0.0f);
+    double weight_sum = 0.0;
+
+    {
+        shared_lock<shared_mutex> lock(m_mutex);
+        lookup_node(0, point, normal, weighted_irradiance, weight_sum);
+    }
+
+    if (weight_sum == 0.0)
+        return false;
+
+    irradiance = weighted_irradiance;
+    irradiance /= static_cast<float>(weight_sum);
+
+    return true;
+}
+
+void IrradianceCache::insert(
+    const Vector3d&         point,
+    const Vector3d&         normal,
+    const Spectrum&         irradiance,
+    const double            mean_distance)
+{
+    assert(is_normalized(normal));
+    assert(mean_distance > 0.0);
+
+    // Clamp the harmonic mean distance such that the radius of validity
+    // of the record (max_error * mean_distance) lies within the allowed range.
+    const double min_distance = m_min_spacing * m_rcp_max_error;
+    const double max_distance = m_max_spacing * m_rcp_max_error;
+
+    Record record;
+    record.m_point = point;
+    record.m_normal = normal;
+    record.m_irradiance = irradiance;
+    record.m_mean_distance = clamp(mean_distance, min_distance, max_distance);
+    record.m_rcp_mean_distance = 1.0 / record.m_mean_distance;
+
+    unique_lock<shared_mutex> lock(m_mutex);
+    insert_record(record);
+}
+
+bool IrradianceCache::load(const char* path)
+{
+    BufferedFile file;
+
+    if (!file.open(path, BufferedFile::BinaryType, BufferedFile::ReadMode))
+        return false;
+
+    char signature[sizeof(IrradianceCacheFileSignature)];
+    if (file.read(signature, sizeof(signature)) != sizeof(signature))
+        return false;
+    if (memcmp(signature, IrradianceCacheFileSignature, sizeof(signature)))
+        return false;
+
+    uint16 version;
+    if (file.read(version) != sizeof(version) || version != IrradianceCacheFileVersion)
+        return false;
+
+    uint64 record_count;
+    if (file.read(record_count) != sizeof(record_count))
+        return false;
+
+    vector<Record> records(static_cast<size_t>(record_count));
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        Record& record = records[i];
+
+        if (file.read(record.m_point) != sizeof(record.m_point) ||
+            file.read(record.m_normal) != sizeof(record.m_normal) ||
+            file.read(&record.m_irradiance[0], Spectrum::Samples * sizeof(float)) != Spectrum::Samples * sizeof(float) ||
+            file.read(record.m_mean_distance) != sizeof(record.m_mean_distance))
+            return false;
+
+        if (record.m_mean_distance <= 0.0)
+            return false;
+
+        record.m_rcp_mean_distance = 1.0 / record.m_mean_distance;
+    }
+
+    unique_lock<shared_mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < records.size(); ++i)
+        insert_record(records[i]);
+
+    return true;
+}
+
+bool IrradianceCache::save(const char* path) const
+{
+    BufferedFile file;
+
+    if (!file.open(path, BufferedFile::BinaryType, BufferedFile::WriteMode))
+        return false;
+
+    shared_lock<shared_mutex> lock(m_mutex);
+
+    const uint64 record_count = static_cast<uint64>(m_records.size());
+
+    file.write(IrradianceCacheFileSignature, sizeof(IrradianceCacheFileSignature));
+    file.write(IrradianceCacheFileVersion);
+    file.write(record_count);
+
+    for (size_t i = 0; i < m_records.size(); ++i)
+    {
+        const Record& record = m_records[i];
+        file.write(record.m_point);
+        file.write(record.m_normal);
+        file.write(&record.m_irradiance[0], Spectrum::Samples * sizeof(float));
+        file.write(record.m_mean_distance);
+    }
+
+    return file.close();
+}
+
+Statistics IrradianceCache::get_statistics() const
+{
+    Statistics stats;
+
+    {
+        shared_lock<shared_mutex> lock(m_mutex);
+        stats.insert<uint64>("records", m_records.size());
+        stats.insert<uint64>("octree nodes", m_nodes.size());
+    }
+
+    stats.insert_size("memory size", get_memory_size());
+
+    return stats;
+}
+
+void IrradianceCache::insert_record(const Record& record)
+{
+    const size_t record_index = m_records.size();
+    m_records.push_back(record);
+
+    // Radius of validity of the record.
+    const double radius = m_max_error * record.m_mean_distance;
+
+    // Find the deepest node whose half size is still larger than the radius of validity.
+    size_t node_index = 0;
+
+    while (0.5 * m_nodes[node_index].m_half_size >= radius)
+    {
+        const Node& node = m_nodes[node_index];
+
+        if (linf_distance(record.m_point, node.m_center) > node.m_half_size)
+            break;
+
+        const size_t child_slot =
+              (record.m_point[0] > node.m_center[0] ? 1 : 0)
+            | (record.m_point[1] > node.m_center[1] ? 2 : 0)
+            | (record.m_point[2] > node.m_center[2] ? 4 : 0);
+
+        const size_t child_index = node.m_children[child_slot];
+
+        node_index =
+            child_index != 0
+                ? child_index
+                : create_child_node(node_index, child_slot);
+    }
+
+    m_nodes[node_index].m_records.push_back(record_index);
+}
+
+size_t IrradianceCache::create_child_node(
+    const size_t            parent_index,
+    const size_t            child_slot)
+{
+    const Vector3d parent_center = m_nodes[parent_index].m_center;
+    const double child_half_size = 0.5 * m_nodes[parent_index].m_half_size;
+
+    Node child;
+    child.m_center[0] = parent_center[0] + (child_slot & 1 ? child_half_size : -child_half_size);
+    child.m_center[1] = parent_center[1] + (child_slot & 2 ? child_half_size : -child_half_size);
+    child.m_center[2] = parent_center[2] + (child_slot & 4 ? child_half_size : -child_half_size);
+    child.m_half_size = child_half_size;
+    fill(child.m_children, child.m_children + 8, 0);
+
+    const size_t child_index = m_nodes.size();
+    m_nodes.push_back(child);   // invalidates references to nodes
+
+    m_nodes[parent_index].m_children[child_slot] = child_index;
+
+    return child_index;
+}
+
+void IrradianceCache::lookup_node(
+    const size_t            node_index,
+    const Vector3d&         point,
+    const Vector3d&         normal,
+    Spectrum&               weighted_irradiance,
+    double&                 weight_sum) const
+{
+    const Node& node = m_nodes[node_index];
+
+    // Records of this node may cover points up to one half size outside of the node.
+    if (linf_distance(point, node.m_center) > 2.0 * node.m_half_size)
+        return;
+
+    for (size_t i = 0, e = node.m_records.size(); i < e; ++i)
+    {
+        const Record& record = m_records[node.m_records[i]];
+
+        // Reject records lying in front of the lookup point.
+        const Vector3d d = point - record.m_point;
+        if (dot(d, normal + record.m_normal) < -0.1 * record.m_mean_distance)
+            continue;
+
+        // Ward's error metric.
+        const double cos_n = dot(normal, record.m_normal);
+        const double error =
+              norm(d) * record.m_rcp_mean_distance
+            + sqrt(max(1.0 - cos_n, 0.0));
+        if (error >= m_max_error)
+            continue;
+
+        // Weights smoothly go to zero at the boundary of the record's radius of validity.
+        const double weight = 1.0 / max(error, 1.0e-10) - m_rcp_max_error;
+
+        Spectrum contribution = record.m_irradiance;
+        contribution *= static_cast<float>(weight);
+        weighted_irradiance += contribution;
+        weight_sum += weight;
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        const size_t child_index = node.m_children[i];
+
+        if (child_index != 0)
+            lookup_node(child_index, point, normal, weighted_irradiance, weight_sum);
+    }
+}
+
+}   // namespace renderer
@@ -0,0 +1,152 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
+#define APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// boost headers.
+#include "boost/thread/shared_mutex.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Statistics; }
+
+namespace renderer
+{
+
+//
+// An irradiance cache (Ward et al., "A Ray Tracing Solution for Diffuse Interreflection", 1988).
+//
+// Irradiance records are stored in an octree covering the scene. Each record is stored in the
+// octree node whose size is comparable to the record's radius of validity, such that a lookup
+// only needs to visit the nodes whose extended bounding box contains the lookup point.
+//
+// Lookups and insertions can be made concurrently from multiple threads: lookups acquire a
+// shared lock on the cache while insertions acquire an exclusive lock.
+//
+
+class IrradianceCache
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    IrradianceCache(
+        const GAABB3&                   bbox,               // bounding box of the scene
+        const double                    max_error,          // maximum allowed interpolation error
+        const double                    min_spacing,        // minimum record spacing, in world units
+        const double                    max_spacing);       // maximum record spacing, in world units
+
+    // Remove all records from the cache.
+    void clear();
+
+    // Return the number of records in the cache.
+    size_t size() const;
+
+    // Return the size (in bytes) of this object in memory.
+    size_t get_memory_size() const;
+
+    // Estimate irradiance at a given point by interpolating nearby records.
+    // Return false if no record is valid at this point, true otherwise.
+    bool lookup(
+        const foundation::Vector3d&     point,
+        const foundation::Vector3d&     normal,             // unit-length
+        Spectrum&                       irradiance) const;
+
+    // Insert a new irradiance record into the cache.
+    void insert(
+        const foundation::Vector3d&     point,
+        const foundation::Vector3d&     normal,             // unit-length
+        const Spectrum&                 irradiance,
+        const double                    mean_distance);     // harmonic mean distance to visible surfaces
+
+    // Read records from disk. Records are added to the existing records.
+    // Return true on success, false on error.
+    bool load(const char* path);
+
+    // Write all records to disk.
+    // Return true on success, false on error.
+    bool save(const char* path) const;
+
+    // Retrieve statistics about the cache.
+    foundation::Statistics get_statistics() const;
+
+  private:
+    struct Record
+    {
+        foundation::Vector3d            m_point;
+        foundation::Vector3d            m_normal;
+        Spectrum                        m_irradiance;
+        double                          m_mean_distance;    // clamped harmonic mean distance
+        double                          m_rcp_mean_distance;
+    };
+
+    struct Node
+    {
+        foundation::Vector3d            m_center;
+        double                          m_half_size;
+        size_t                          m_children[8];      // 0 if the child does not exist
+        std::vector<size_t>             m_records;
+    };
+
+    const double                        m_max_error;
+    const double                        m_rcp_max_error;
+    const double                        m_min_spacing;
+    const double                        m_max_spacing;
+
+    mutable boost::shared_mutex         m_mutex;
+    std::vector<Record>                 m_records;
+    std::vector<Node>                   m_nodes;
+
+    void insert_record(const Record& record);
+
+    size_t create_child_node(
+        const size_t                    parent_index,
+        const size_t                    child_slot);
+
+    void lookup_node(
+        const size_t                    node_index,
+        const foundation::Vector3d&     point,
+        const foundation::Vector3d&     normal,
+        Spectrum&                       weighted_irradiance,
+        double&                         weight_sum) const;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_LIGHTING_DRT_IRRADIANCECACHE_H
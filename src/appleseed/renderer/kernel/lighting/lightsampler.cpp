@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/intersection/intersector.h"
 #include "renderer/kernel/shading/shadingpoint.h"
@@ -114,6 +115,8 @@ LightSampler::LightSampler(const Scene& scene, const ParamArray& params)
   : m_params(params)
   , m_emitting_triangle_hash_table(m_triangle_key_hasher)
 {
+    ScopedProfile profile(global_profiler(), "light sampler construction");
+
     RENDERER_LOG_INFO("collecting light emitters...");
 
     // Collect all non-physical lights.
@@ -327,9 +330,9 @@ void LightSampler::collect_emitting_triangles(
                 assert(is_normalized(geometric_normal));
 
                 // Retrieve object instance space vertex normals.
-                const GVector3& n0_os = tess->m_vertex_normals[triangle.m_n0];
-                const GVector3& n1_os = tess->m_vertex_normals[triangle.m_n1];
-                const GVector3& n2_os = tess->m_vertex_normals[triangle.m_n2];
+                const GVector3 n0_os = tess->get_vertex_normal(triangle.m_n0);
+                const GVector3 n1_os = tess->get_vertex_normal(triangle.m_n1);
+                const GVector3 n2_os = tess->get_vertex_normal(triangle.m_n2);
 
                 // Transform vertex normals to world space.
                 const Vector3d n0(normalize(global_transform.normal_to_parent(n0_os)));
@@ -225,7 +225,13 @@ namespace
             stats.insert("path count", m_path_count);
             stats.insert("path length", m_path_length);
 
-            return StatisticsVector::make("light tracing statistics", stats);
+            StatisticsVector vec;
+            vec.insert("light tracing statistics", stats);
+            vec.merge(m_texture_cache.get_statistics());
+            vec.merge(m_intersector.get_statistics());
+            vec.merge(m_shading_context.get_statistics());
+
+            return vec;
         }
 
       private:
@@ -149,7 +149,7 @@ Tracer::Tracer(
     {
         if (m_assume_no_alpha_mapping)
             RENDERER_LOG_DEBUG("the scene does not rely on alpha mapping; using probe tracing.");
-        else RENDERER_LOG_DEBUG("the scene uses alpha mapping; using standard tracing.");
+        else RENDERER_LOG_DEBUG("the scene uses alpha mapping; using probe tracing for opaque surfaces and standard tracing for possibly transparent ones.");
     }
 }
 
@@ -152,6 +152,14 @@ class Tracer
     const size_t                        m_max_iterations;
     ShadingPoint                        m_shading_points[2];
 
+    // Compute the transmission along a ray using probe tracing only. Returns false
+    // if the ray crosses surfaces that may be transparent but no opaque surface,
+    // in which case the ray must be traced iteratively.
+    bool probe_transmission(
+        const ShadingRay&               ray,
+        const ShadingPoint*             parent_shading_point,
+        double&                         transmission) const;
+
     const ShadingPoint& do_trace(
         const foundation::Vector3d&     origin,
         const foundation::Vector3d&     direction,
@@ -219,20 +227,17 @@ inline double Tracer::trace(
     const ShadingRay::Type              ray_type,
     const ShadingRay::DepthType         ray_depth)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const ShadingRay ray(
-            origin,
-            direction,
-            time,
-            ray_type,
-            ray_depth);
+    const ShadingRay ray(
+        origin,
+        direction,
+        time,
+        ray_type,
+        ray_depth);
 
-        return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
-    }
-    else
+    double transmission;
+
+    if (!probe_transmission(ray, 0, transmission))
     {
-        double transmission;
         const ShadingPoint& shading_point =
             trace(
                 origin,
@@ -242,8 +247,11 @@ inline double Tracer::trace(
                 ray_depth,
                 transmission);
 
-        return shading_point.hit() ? 0.0 : transmission;
+        if (shading_point.hit())
+            transmission = 0.0;
     }
+
+    return transmission;
 }
 
 inline double Tracer::trace(
@@ -251,20 +259,17 @@ inline double Tracer::trace(
     const foundation::Vector3d&         direction,
     const ShadingRay::Type              type)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const ShadingRay ray(
-            origin.get_biased_point(direction),
-            direction,
-            origin.get_time(),
-            type,
-            origin.get_ray().m_depth + 1);
+    const ShadingRay ray(
+        origin.get_biased_point(direction),
+        direction,
+        origin.get_time(),
+        type,
+        origin.get_ray().m_depth + 1);
 
-        return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
-    }
-    else
+    double transmission;
+
+    if (!probe_transmission(ray, &origin, transmission))
     {
-        double transmission;
         const ShadingPoint& shading_point =
             trace(
                 origin,
@@ -272,8 +277,11 @@ inline double Tracer::trace(
                 type,
                 transmission);
 
-        return shading_point.hit() ? 0.0 : transmission;
+        if (shading_point.hit())
+            transmission = 0.0;
     }
+
+    return transmission;
 }
 
 inline const ShadingPoint& Tracer::trace_between(
@@ -319,22 +327,19 @@ inline double Tracer::trace_between(
     const ShadingRay::Type              ray_type,
     const ShadingRay::DepthType         ray_depth)
 {
-    if (m_assume_no_alpha_mapping)
+    const ShadingRay ray(
+        origin,
+        target - origin,
+        0.0,                            // ray tmin
+        1.0 - 1.0e-6,                   // ray tmax
+        time,
+        ray_type,
+        ray_depth);
+
+    double transmission;
+
+    if (!probe_transmission(ray, 0, transmission))
     {
-        const ShadingRay ray(
-            origin,
-            target - origin,
-            0.0,                        // ray tmin
-            1.0 - 1.0e-6,               // ray tmax
-            time,
-            ray_type,
-            ray_depth);
-
-        return m_intersector.trace_probe(ray) ? 0.0 : 1.0;
-    }
-    else
-    {
-        double transmission;
         const ShadingPoint& shading_point =
             trace_between(
                 origin,
@@ -344,8 +349,11 @@ inline double Tracer::trace_between(
                 ray_depth,
                 transmission);
 
-        return shading_point.hit() ? 0.0 : transmission;
+        if (shading_point.hit())
+            transmission = 0.0;
     }
+
+    return transmission;
 }
 
 inline double Tracer::trace_between(
@@ -353,24 +361,21 @@ inline double Tracer::trace_between(
     const foundation::Vector3d&         target,
     const ShadingRay::Type              type)
 {
-    if (m_assume_no_alpha_mapping)
-    {
-        const foundation::Vector3d direction = target - origin.get_point();
+    const foundation::Vector3d direction = target - origin.get_point();
 
-        const ShadingRay ray(
-            origin.get_biased_point(direction),
-            direction,
-            0.0,                        // ray tmin
-            1.0 - 1.0e-6,               // ray tmax
-            origin.get_time(),
-            type,
-            origin.get_ray().m_depth + 1);
+    const ShadingRay ray(
+        origin.get_biased_point(direction),
+        direction,
+        0.0,                            // ray tmin
+        1.0 - 1.0e-6,                   // ray tmax
+        origin.get_time(),
+        type,
+        origin.get_ray().m_depth + 1);
 
-        return m_intersector.trace_probe(ray, &origin) ? 0.0 : 1.0;
-    }
-    else
+    double transmission;
+
+    if (!probe_transmission(ray, &origin, transmission))
     {
-        double transmission;
         const ShadingPoint& shading_point =
             trace_between(
                 origin,
@@ -378,8 +383,40 @@ inline double Tracer::trace_between(
                 type,
                 transmission);
 
-        return shading_point.hit() ? 0.0 : transmission;
+        if (shading_point.hit())
+            transmission = 0.0;
+    }
+
+    return transmission;
+}
+
+inline bool Tracer::probe_transmission(
+    const ShadingRay&                   ray,
+    const ShadingPoint*                 parent_shading_point,
+    double&                             transmission) const
+{
+    if (m_assume_no_alpha_mapping)
+    {
+        transmission = m_intersector.trace_probe(ray, parent_shading_point) ? 0.0 : 1.0;
+        return true;
+    }
+
+    // Only opaque surfaces are considered by this probe ray.
+    bool hit_transparent;
+    if (m_intersector.trace_opaque_probe(ray, hit_transparent, parent_shading_point))
+    {
+        transmission = 0.0;
+        return true;
+    }
+
+    // No surface at all along the ray.
+    if (!hit_transparent)
+    {
+        transmission = 1.0;
+        return true;
     }
+
+    return false;
 }
 
 }       // namespace renderer
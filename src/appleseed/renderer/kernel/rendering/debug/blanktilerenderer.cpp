@@ -38,6 +38,7 @@
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
 #include "foundation/utility/statistics.h"
 
 // Standard headers.
@@ -72,6 +73,7 @@ namespace
             const Frame&    frame,
             const size_t    tile_x,
             const size_t    tile_y,
+            const AABB2u&   tile_region,
             const size_t    pass_hash,
             AbortSwitch&    abort_switch) OVERRIDE
         {
@@ -81,9 +83,16 @@ namespace
             assert(tile_y < image.properties().m_tile_count_y);
 
             Tile& tile = image.tile(tile_x, tile_y);
-
-            // Set all pixels of the tile to opaque black.
-            tile.clear(Color4f(0.0f, 0.0f, 0.0f, 1.0f));
+            assert(tile_region.max.x < tile.get_width());
+            assert(tile_region.max.y < tile.get_height());
+
+            // Set all pixels of the tile region to opaque black.
+            const Color4f black(0.0f, 0.0f, 0.0f, 1.0f);
+            for (size_t y = tile_region.min.y; y <= tile_region.max.y; ++y)
+            {
+                for (size_t x = tile_region.min.x; x <= tile_region.max.x; ++x)
+                    tile.set_pixel(x, y, black);
+            }
         }
 
         virtual StatisticsVector get_statistics() const OVERRIDE
@@ -38,6 +38,8 @@
 #include "foundation/image/color.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/statistics.h"
 
 // Standard headers.
@@ -72,6 +74,7 @@ namespace
             const Frame&    frame,
             const size_t    tile_x,
             const size_t    tile_y,
+            const AABB2u&   tile_region,
             const size_t    pass_hash,
             AbortSwitch&    abort_switch) OVERRIDE
         {
@@ -85,11 +88,13 @@ namespace
             const size_t tile_height = tile.get_height();
             const size_t max_x = tile_width - 1;
             const size_t max_y = tile_height - 1;
+            assert(tile_region.max.x <= max_x);
+            assert(tile_region.max.y <= max_y);
 
-            // Draw a pixel-sized checkerboard inside the tile.
-            for (size_t y = 0; y < tile_height; ++y)
+            // Draw a pixel-sized checkerboard inside the tile region.
+            for (size_t y = tile_region.min.y; y <= tile_region.max.y; ++y)
             {
-                for (size_t x = 0; x < tile_width; ++x)
+                for (size_t x = tile_region.min.x; x <= tile_region.max.x; ++x)
                 {
                     const float gray = 0.6f + ((x + y) & 1) * 0.2f;
                     const Color4f pixel_color(gray, gray, gray, 1.0f);
@@ -98,16 +103,28 @@ namespace
             }
 
             // Color the corners of the tile.
-            tile.set_pixel(0,     0,     Color4f(1.0f, 0.0f, 0.0f, 1.0f));      // top left pixel is red
-            tile.set_pixel(max_x, 0,     Color4f(0.0f, 1.0f, 0.0f, 1.0f));      // top right pixel is green
-            tile.set_pixel(0,     max_y, Color4f(1.0f, 1.0f, 1.0f, 1.0f));      // bottom left pixel is white
-            tile.set_pixel(max_x, max_y, Color4f(0.0f, 0.0f, 1.0f, 1.0f));      // bottom right pixel is blue
+            set_pixel_in_region(tile, tile_region, 0,     0,     Color4f(1.0f, 0.0f, 0.0f, 1.0f));     // top left pixel is red
+            set_pixel_in_region(tile, tile_region, max_x, 0,     Color4f(0.0f, 1.0f, 0.0f, 1.0f));     // top right pixel is green
+            set_pixel_in_region(tile, tile_region, 0,     max_y, Color4f(1.0f, 1.0f, 1.0f, 1.0f));     // bottom left pixel is white
+            set_pixel_in_region(tile, tile_region, max_x, max_y, Color4f(0.0f, 0.0f, 1.0f, 1.0f));     // bottom right pixel is blue
         }
 
         virtual StatisticsVector get_statistics() const OVERRIDE
         {
             return StatisticsVector();
         }
+
+      private:
+        static void set_pixel_in_region(
+            Tile&           tile,
+            const AABB2u&   tile_region,
+            const size_t    x,
+            const size_t    y,
+            const Color4f&  color)
+        {
+            if (tile_region.contains(Vector2u(x, y)))
+                tile.set_pixel(x, y, color);
+        }
     };
 }
 
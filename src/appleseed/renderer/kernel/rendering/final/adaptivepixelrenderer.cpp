@@ -119,7 +119,8 @@ namespace
         virtual void on_tile_begin(
             const Frame&                frame,
             Tile&                       tile,
-            TileStack&                  aov_tiles) OVERRIDE
+            TileStack&                  aov_tiles,
+            const AABB2u&               tile_region) OVERRIDE
         {
             m_scratch_fb_half_width = truncate<int>(ceil(frame.get_filter().get_xradius()));
             m_scratch_fb_half_height = truncate<int>(ceil(frame.get_filter().get_yradius()));
@@ -138,16 +139,14 @@ namespace
         virtual void on_tile_end(
             const Frame&                frame,
             Tile&                       tile,
-            TileStack&                  aov_tiles) OVERRIDE
+            TileStack&                  aov_tiles,
+            const AABB2u&               tile_region) OVERRIDE
         {
             if (m_params.m_diagnostics)
             {
-                const size_t width = tile.get_width();
-                const size_t height = tile.get_height();
-
-                for (size_t y = 0; y < height; ++y)
+                for (size_t y = tile_region.min.y; y <= tile_region.max.y; ++y)
                 {
-                    for (size_t x = 0; x < width; ++x)
+                    for (size_t x = tile_region.min.x; x <= tile_region.max.x; ++x)
                     {
                         Color<float, 2> values;
                         m_diagnostics->get_pixel(x, y, values);
@@ -155,10 +155,13 @@ namespace
                 new PassManagerFunc(
                     m_frame,
                     m_params.m_tile_ordering,
+                    m_params.m_cost_driven_tile_scheduling,
+                    get_split_tile_count(),
                     m_params.m_pass_count,
                     m_tile_renderers,
                     m_tile_callbacks,
                     m_pass_callback,
+                    m_tile_job_factory,
                     m_job_queue,
                     m_abort_switch,
                     m_is_rendering));
@@ -198,11 +201,15 @@ namespace
         {
             const size_t                        m_thread_count;     // number of rendering threads
             const TileJobFactory::TileOrdering  m_tile_ordering;    // tile rendering order
+            const bool                          m_cost_driven_tile_scheduling;  // render the costliest tiles first? (requires costs from a previous pass)
+            const bool                          m_tile_splitting;   // split the last tiles of the frame into smaller jobs? (requires ephemeral framebuffers)
             const size_t                        m_pass_count;       // number of rendering passes
 
             explicit Parameters(const ParamArray& params)
               : m_thread_count(FrameRendererBase::get_rendering_thread_count(params))
               , m_tile_ordering(get_tile_ordering(params))
+              , m_cost_driven_tile_scheduling(params.get_optional<bool>("cost_driven_tile_scheduling", false))
+              , m_tile_splitting(params.get_optional<bool>("tile_splitting", false))
               , m_pass_count(params.get_optional<size_t>("passes", 1))
             {
             }
@@ -248,19 +255,25 @@ namespace
             PassManagerFunc(
                 const Frame&                        frame,
                 const TileJobFactory::TileOrdering  tile_ordering,
+                const bool                          cost_driven_tile_scheduling,
+                const size_t                        split_tile_count,
                 const size_t                        pass_count,
                 vector<ITileRenderer*>&             tile_renderers,
                 vector<ITileCallback*>&             tile_callbacks,
                 IPassCallback*                      pass_callback,
+                TileJobFactory&                     tile_job_factory,
                 JobQueue&                           job_queue,
                 AbortSwitch&                        abort_switch,
                 bool&                               is_rendering)
               : m_frame(frame)
               , m_tile_ordering(tile_ordering)
+              , m_cost_driven_tile_scheduling(cost_driven_tile_scheduling)
+              , m_split_tile_count(split_tile_count)
               , m_pass_count(pass_count)
               , m_tile_renderers(tile_renderers)
               , m_tile_callbacks(tile_callbacks)
               , m_pass_callback(pass_callback)
+              , m_tile_job_factory(tile_job_factory)
               , m_job_queue(job_queue)
               , m_abort_switch(abort_switch)
               , m_is_rendering(is_rendering)
@@ -288,6 +301,8 @@ namespace
                     m_tile_job_factory.create(
                         m_frame,
                         m_tile_ordering,
+                        m_cost_driven_tile_scheduling,
+                        m_split_tile_count,
                         m_tile_renderers,
                         m_tile_callbacks,
                         pass_hash,
@@ -301,6 +316,10 @@ namespace
                     // Wait until tile jobs have effectively stopped.
                     m_job_queue.wait_until_completion();
 
+                    // Use the rendering times of this pass to schedule the next one.
+                    if (!m_abort_switch.is_aborted())
+                        m_tile_job_factory.record_tile_costs();
+
                     // Invoke the post-pass callback if there is one.
                     if (m_pass_callback)
                     {
@@ -316,14 +335,16 @@ namespace
           private:
             const Frame&                            m_frame;
             const TileJobFactory::TileOrdering      m_tile_ordering;
+            const bool                              m_cost_driven_tile_scheduling;
+            const size_t                            m_split_tile_count;
             vector<ITileRenderer*>&                 m_tile_renderers;
             vector<ITileCallback*>&                 m_tile_callbacks;
             IPassCallback*                          m_pass_callback;
             const size_t                            m_pass_count;
+            TileJobFactory&                         m_tile_job_factory;
             JobQueue&                               m_job_queue;
             AbortSwitch&                            m_abort_switch;
             bool&                                   m_is_rendering;
-            TileJobFactory                          m_tile_job_factory;
         };
 
         const Frame&                m_frame;            // target framebuffer
@@ -337,12 +358,21 @@ namespace
         vector<ITileCallback*>      m_tile_callbacks;   // tile callbacks, none or one per thread
         IPassCallback*              m_pass_callback;
 
-        TileJobFactory              m_tile_job_factory;
+        TileJobFactory              m_tile_job_factory;     // persists across renders to keep tile costs
 
         bool                        m_is_rendering;
         auto_ptr<PassManagerFunc>   m_pass_manager_func;
         auto_ptr<thread>            m_pass_manager_thread;
 
+        size_t get_split_tile_count() const
+        {
+            // The master renderer only enables tile splitting with ephemeral framebuffers,
+            // which are private to each job, so subtiles of a same tile never share state,
+            // even across passes. Splitting as many tiles as there are threads keeps them
+            // all busy until the end.
+            return m_params.m_tile_splitting ? m_params.m_thread_count : 0;
+        }
+
         void print_tile_renderers_stats() const
         {
             assert(!m_tile_renderers.empty());
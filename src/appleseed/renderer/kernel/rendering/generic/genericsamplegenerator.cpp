@@ -90,6 +90,7 @@ namespace
           , m_sample_renderer(sample_renderer_factory->create(primary))
           , m_window_width_next_pow2(next_power(static_cast<double>(m_window_width), 2.0))
           , m_window_height_next_pow3(next_power(static_cast<double>(m_window_height), 3.0))
+          , m_skipped_sample_count(0)
         {
         }
 
@@ -109,6 +110,7 @@ namespace
             Statistics stats;
             stats.insert("max. samp. dim.", m_total_sampling_dim);
             stats.insert("max. samp. inst.", m_total_sampling_inst);
+            stats.insert("converged skips", m_skipped_sample_count);
 
             StatisticsVector vec;
             vec.insert("generic sample generator statistics", stats);
@@ -134,6 +136,7 @@ namespace
 
         Population<uint64>                  m_total_sampling_dim;
         Population<uint64>                  m_total_sampling_inst;
+        uint64                              m_skipped_sample_count;
 
         virtual size_t generate_samples(
             const size_t                    sequence_index,
@@ -152,17 +155,24 @@ namespace
             if (x >= m_window_width || y >= m_window_height)
                 return 0;
 
-            // Create a pixel context that identifies the pixel currently being rendered.
-            const PixelContext pixel_context(
-                m_window_origin_x + x,
-                m_window_origin_y + y);
-
             // Transform the sample position back to NDC. Full precision divisions are required
             // to ensure that the sample position indeed lies in the [0,1)^2 interval.
             const Vector2d sample_position(
                 (m_window_origin_x + t[0]) / m_canvas_width,
                 (m_window_origin_y + t[1]) / m_canvas_height);
 
+            // Skip pixels that have already converged when adaptive sampling is enabled.
+            if (is_converged(sample_position))
+            {
+                ++m_skipped_sample_count;
+                return 0;
+            }
+
+            // Create a pixel context that identifies the pixel currently being rendered.
+            const PixelContext pixel_context(
+                m_window_origin_x + x,
+                m_window_origin_y + y);
+
             // Create a sampling context. We start with an initial dimension of 2,
             // corresponding to the Halton sequence used for the sample positions.
             SamplingContext sampling_context(
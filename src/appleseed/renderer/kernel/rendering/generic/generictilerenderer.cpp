@@ -113,6 +113,7 @@ namespace
             const Frame&    frame,
             const size_t    tile_x,
             const size_t    tile_y,
+            const AABB2u&   tile_region,
             const size_t    pass_hash,
             AbortSwitch&    abort_switch) OVERRIDE
         {
@@ -128,11 +129,13 @@ namespace
             const size_t tile_origin_y = frame_properties.m_tile_height * tile_y;
 
             // Compute the image space bounding box of the pixels to render.
+            assert(tile_region.max.x < tile.get_width());
+            assert(tile_region.max.y < tile.get_height());
             AABB2u tile_bbox;
-            tile_bbox.min.x = tile_origin_x;
-            tile_bbox.min.y = tile_origin_y;
-            tile_bbox.max.x = tile_origin_x + tile.get_width() - 1;
-            tile_bbox.max.y = tile_origin_y + tile.get_height() - 1;
+            tile_bbox.min.x = tile_origin_x + tile_region.min.x;
+            tile_bbox.min.y = tile_origin_y + tile_region.min.y;
+            tile_bbox.max.x = tile_origin_x + tile_region.max.x;
+            tile_bbox.max.y = tile_origin_y + tile_region.max.y;
             tile_bbox = AABB2u::intersect(tile_bbox, frame.get_crop_window());
             if (!tile_bbox.is_valid())
                 return;
@@ -144,7 +147,7 @@ namespace
             tile_bbox.max.y -= tile_origin_y;
 
             // Inform the pixel renderer that we are about to render a tile.
-            m_pixel_renderer->on_tile_begin(frame, tile, aov_tiles);
+            m_pixel_renderer->on_tile_begin(frame, tile, aov_tiles, tile_region);
 
             // Create the framebuffer into which we will accumulate the samples.
             ShadingResultFrameBuffer* framebuffer =
@@ -155,10 +158,16 @@ namespace
                     tile_bbox);
             assert(framebuffer);
 
-            // Seed the RNG with the tile index.
-            m_rng = SamplingContext::RNGType(
+            // Seed the RNG with the tile index. Distinct regions of a same tile get distinct seeds.
+            uint32 seed =
                 hash_uint32(
-                    static_cast<uint32>(pass_hash + tile_y * frame_properties.m_tile_count_x + tile_x)));
+                    static_cast<uint32>(pass_hash + tile_y * frame_properties.m_tile_count_x + tile_x));
+            if (tile_region.min.x > 0 || tile_region.min.y > 0)
+            {
+                seed = hash_uint32(
+                    seed + static_cast<uint32>(tile_region.min.y * frame_properties.m_tile_width + tile_region.min.x));
+            }
+            m_rng = SamplingContext::RNGType(seed);
 
             // Loop over tile pixels.
             const size_t tile_pixel_count = m_pixel_ordering.size();
@@ -207,14 +216,14 @@ namespace
 
             // Develop the framebuffer to the tile.
             if (frame.is_premultiplied_alpha())
-                framebuffer->develop_to_tile_premult_alpha(tile, aov_tiles);
-            else framebuffer->develop_to_tile_straight_alpha(tile, aov_tiles);
+                framebuffer->develop_to_tile_premult_alpha(tile, aov_tiles, tile_region);
+            else framebuffer->develop_to_tile_straight_alpha(tile, aov_tiles, tile_region);
 
             // Release the framebuffer.
             m_framebuffer_factory->destroy(framebuffer);
 
             // Inform the pixel renderer that we are done rendering the tile.
-            m_pixel_renderer->on_tile_end(frame, tile, aov_tiles);
+            m_pixel_renderer->on_tile_end(frame, tile, aov_tiles, tile_region);
         }
 
         virtual StatisticsVector get_statistics() const OVERRIDE
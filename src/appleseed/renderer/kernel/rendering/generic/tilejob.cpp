@@ -31,6 +31,7 @@
 #include "tilejob.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalprofiler.h"
 #include "renderer/kernel/rendering/itilecallback.h"
 #include "renderer/kernel/rendering/itilerenderer.h"
 #include "renderer/modeling/frame/frame.h"
@@ -38,7 +39,9 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
-#include "foundation/image/tile.h"
+#include "foundation/platform/defaulttimers.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/stopwatch.h"
 
 // Standard headers.
 #include <cassert>
@@ -60,14 +63,20 @@ TileJob::TileJob(
     const Frame&                frame,
     const size_t                tile_x,
     const size_t                tile_y,
+    const AABB2u&               tile_region,
     const size_t                pass_hash,
+    double&                     render_time,
+    boost::uint32_t&            pending_tile_jobs,
     AbortSwitch&                abort_switch)
   : m_tile_renderers(tile_renderers)
   , m_tile_callbacks(tile_callbacks)
   , m_frame(frame)
   , m_tile_x(tile_x)
   , m_tile_y(tile_y)
+  , m_tile_region(tile_region)
   , m_pass_hash(pass_hash)
+  , m_render_time(render_time)
+  , m_pending_tile_jobs(pending_tile_jobs)
   , m_abort_switch(abort_switch)
 {
     // Either there is no tile callback, or there is the same number
@@ -81,6 +90,8 @@ void TileJob::execute(const size_t thread_index)
 {
     assert(thread_index < m_tile_renderers.size());
 
+    ScopedProfile profile(global_profiler(), "tile rendering");
+
     // Retrieve the tile callback.
     ITileCallback* tile_callback =
         m_tile_callbacks.size() == m_tile_renderers.size()
@@ -90,19 +101,18 @@ void TileJob::execute(const size_t thread_index)
     // Call the pre-render tile callback.
     if (tile_callback)
     {
-        const Image& frame_image = m_frame.image();
-
-        const CanvasProperties& frame_props = frame_image.properties();
-        const size_t x = m_tile_x * frame_props.m_tile_width;
-        const size_t y = m_tile_y * frame_props.m_tile_height;
-
-        const Tile& tile = frame_image.tile(m_tile_x, m_tile_y);
-        const size_t width = tile.get_width();
-        const size_t height = tile.get_height();
+        const CanvasProperties& frame_props = m_frame.image().properties();
+        const size_t x = m_tile_x * frame_props.m_tile_width + m_tile_region.min.x;
+        const size_t y = m_tile_y * frame_props.m_tile_height + m_tile_region.min.y;
+        const size_t width = m_tile_region.extent(0) + 1;
+        const size_t height = m_tile_region.extent(1) + 1;
 
         tile_callback->pre_render(x, y, width, height);
     }
 
+    Stopwatch<DefaultWallclockTimer> stopwatch(0);
+    stopwatch.start();
+
     try
     {
         // Render the tile.
@@ -110,20 +120,33 @@ void TileJob::execute(const size_t thread_index)
             m_frame,
             m_tile_x,
             m_tile_y,
+            m_tile_region,
             m_pass_hash,
             m_abort_switch);
     }
     catch (const exception&)
     {
         // Call the post-render tile callback.
-        if (tile_callback)
-            tile_callback->post_render_tile(&m_frame, m_tile_x, m_tile_y);
+        post_render_tile(tile_callback);
 
         // Rethrow the exception.
         throw;
     }
 
+    // Record the rendering time of this job.
+    stopwatch.measure();
+    m_render_time = stopwatch.get_seconds();
+
     // Call the post-render tile callback.
+    post_render_tile(tile_callback);
+}
+
+void TileJob::post_render_tile(ITileCallback* tile_callback) const
+{
+    // When the tile was split, only call the callback once all its subtiles are rendered.
+    if (boost_atomic::atomic_dec32(&m_pending_tile_jobs) != 1)
+        return;
+
     if (tile_callback)
         tile_callback->post_render_tile(&m_frame, m_tile_x, m_tile_y);
 }
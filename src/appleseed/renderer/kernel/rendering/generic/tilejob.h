@@ -31,8 +31,12 @@
 #define APPLESEED_RENDERER_KERNEL_RENDERING_GENERIC_TILEJOB_H
 
 // appleseed.foundation headers.
+#include "foundation/math/aabb.h"
 #include "foundation/utility/job.h"
 
+// boost headers.
+#include "boost/cstdint.hpp"
+
 // Standard headers.
 #include <cstddef>
 #include <vector>
@@ -56,14 +60,20 @@ class TileJob
     typedef std::vector<ITileRenderer*> TileRendererVector;
     typedef std::vector<ITileCallback*> TileCallbackVector;
 
-    // Constructor.
+    // Constructor. The job renders the pixels of tile (tile_x, tile_y) that lie inside
+    // tile_region (in tile space) and stores its rendering time in seconds into render_time.
+    // pending_tile_jobs counts the jobs of the tile that have not completed yet: only the
+    // last one to complete calls the post-render tile callback.
     TileJob(
         const TileRendererVector&   tile_renderers,
         const TileCallbackVector&   tile_callbacks,
         const Frame&                frame,
         const size_t                tile_x,
         const size_t                tile_y,
+        const foundation::AABB2u&   tile_region,
         const size_t                pass_hash,
+        double&                     render_time,
+        boost::uint32_t&            pending_tile_jobs,
         foundation::AbortSwitch&    abort_switch);
 
     // Execute the job.
@@ -75,8 +85,13 @@ class TileJob
     const Frame&                    m_frame;
     const size_t                    m_tile_x;
     const size_t                    m_tile_y;
+    const foundation::AABB2u        m_tile_region;
     const size_t                    m_pass_hash;
+    double&                         m_render_time;
+    boost::uint32_t&                m_pending_tile_jobs;
     foundation::AbortSwitch&        m_abort_switch;
+
+    void post_render_tile(ITileCallback* tile_callback) const;
 };
 
 }       // namespace renderer
@@ -36,10 +36,13 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
+#include "foundation/image/tile.h"
 #include "foundation/math/ordering.h"
+#include "foundation/math/vector.h"
 #include "foundation/utility/otherwise.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 
 using namespace foundation;
@@ -48,13 +51,39 @@ using namespace std;
 namespace renderer
 {
 
+namespace
+{
+    struct TileCostPredicate
+    {
+        const vector<double>& m_tile_costs;
+
+        explicit TileCostPredicate(const vector<double>& tile_costs)
+          : m_tile_costs(tile_costs)
+        {
+        }
+
+        bool operator()(const size_t lhs, const size_t rhs) const
+        {
+            return m_tile_costs[lhs] > m_tile_costs[rhs];
+        }
+    };
+}
+
+
 //
 // TileJobFactory class implementation.
 //
 
+TileJobFactory::TileJobFactory()
+  : m_has_tile_costs(false)
+{
+}
+
 void TileJobFactory::create(
     const Frame&                        frame,
     const TileOrdering                  tile_ordering,
+    const bool                          cost_driven_scheduling,
+    const size_t                        split_tile_count,
     const TileJob::TileRendererVector&  tile_renderers,
     const TileJob::TileCallbackVector&  tile_callbacks,
     const size_t                        pass_hash,
@@ -62,7 +91,8 @@ void TileJobFactory::create(
     AbortSwitch&                        abort_switch)
 {
     // Retrieve frame properties.
-    const CanvasProperties& props = frame.image().properties();
+    const Image& image = frame.image();
+    const CanvasProperties& props = image.properties();
 
     // Generate tiles ordering.
     vector<size_t> tiles;
@@ -71,13 +101,66 @@ void TileJobFactory::create(
     // Make sure the right number of tiles was created.
     assert(tiles.size() == props.m_tile_count);
 
-    // Create tile jobs, one per tile.
+    // Forget tile costs recorded for a frame with a different tiling.
+    if (m_tile_costs.size() != props.m_tile_count)
+    {
+        m_tile_costs.clear();
+        m_tile_costs.resize(props.m_tile_count, 0.0);
+        m_has_tile_costs = false;
+    }
+
+    // Schedule the most expensive tiles first if their costs are known.
+    if (cost_driven_scheduling && m_has_tile_costs)
+        sort_tiles_by_decreasing_cost(tiles);
+
+    // Compute the tile and the region of the tile covered by each job.
+    const size_t first_split_tile =
+        props.m_tile_count - min(split_tile_count, props.m_tile_count);
+    vector<AABB2u> job_regions;
+    m_job_tiles.clear();
+    m_pending_tile_jobs.assign(props.m_tile_count, 0);
     for (size_t i = 0; i < props.m_tile_count; ++i)
     {
-        // Compute coordinates of the tile in the frame.
         const size_t tile_index = tiles[i];
         const size_t tile_x = tile_index % props.m_tile_count_x;
         const size_t tile_y = tile_index / props.m_tile_count_x;
+        const Tile& tile = image.tile(tile_x, tile_y);
+        const size_t tile_width = tile.get_width();
+        const size_t tile_height = tile.get_height();
+
+        // Split the tile into up to 2x2 subtiles if it's one of the last tiles to be rendered.
+        const size_t split_x = i >= first_split_tile && tile_width > 1 ? 2 : 1;
+        const size_t split_y = i >= first_split_tile && tile_height > 1 ? 2 : 1;
+
+        for (size_t y = 0; y < split_y; ++y)
+        {
+            for (size_t x = 0; x < split_x; ++x)
+            {
+                job_regions.push_back(
+                    AABB2u(
+                        Vector2u(
+                            x * tile_width / split_x,
+                            y * tile_height / split_y),
+                        Vector2u(
+                            (x + 1) * tile_width / split_x - 1,
+                            (y + 1) * tile_height / split_y - 1)));
+                m_job_tiles.push_back(tile_index);
+                ++m_pending_tile_jobs[tile_index];
+            }
+        }
+    }
+
+    // Jobs store their rendering time in this array and update the pending job counts
+    // of their tile, these arrays must not be resized until the jobs complete.
+    m_job_times.assign(m_job_tiles.size(), 0.0);
+
+    // Create tile jobs.
+    for (size_t i = 0; i < m_job_tiles.size(); ++i)
+    {
+        // Compute coordinates of the tile in the frame.
+        const size_t tile_index = m_job_tiles[i];
+        const size_t tile_x = tile_index % props.m_tile_count_x;
+        const size_t tile_y = tile_index / props.m_tile_count_x;
         assert(tile_x >= 0 && tile_x < props.m_tile_count_x);
         assert(tile_y >= 0 && tile_y < props.m_tile_count_y);
 
@@ -89,11 +172,32 @@ void TileJobFactory::create(
                 frame,
                 tile_x,
                 tile_y,
+                job_regions[i],
                 pass_hash,
+                m_job_times[i],
+                m_pending_tile_jobs[tile_index],
                 abort_switch));
     }
 }
 
+void TileJobFactory::record_tile_costs()
+{
+    assert(m_job_tiles.size() == m_job_times.size());
+
+    fill(m_tile_costs.begin(), m_tile_costs.end(), 0.0);
+
+    for (size_t i = 0; i < m_job_tiles.size(); ++i)
+        m_tile_costs[m_job_tiles[i]] += m_job_times[i];
+
+    m_has_tile_costs = true;
+}
+
+void TileJobFactory::sort_tiles_by_decreasing_cost(vector<size_t>& tiles) const
+{
+    // Use a stable sort so that tiles of equal cost keep their original ordering.
+    stable_sort(tiles.begin(), tiles.end(), TileCostPredicate(m_tile_costs));
+}
+
 void TileJobFactory::generate_tile_ordering(
     const CanvasProperties&             frame_properties,
     const TileOrdering                  tile_ordering,
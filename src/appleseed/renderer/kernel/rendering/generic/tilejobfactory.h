@@ -36,6 +36,9 @@
 // appleseed.foundation headers.
 #include "foundation/math/rng.h"
 
+// boost headers.
+#include "boost/cstdint.hpp"
+
 // Standard headers.
 #include <cstddef>
 #include <vector>
@@ -67,23 +70,45 @@ class TileJobFactory
         RandomOrdering
     };
 
+    // Constructor.
+    TileJobFactory();
+
     // Create tile jobs for a given frame.
+    // If cost_driven_scheduling is true and tile costs were recorded by a previous call
+    // to record_tile_costs(), tiles are scheduled by decreasing cost and tile_ordering is
+    // only used to break ties. The last split_tile_count tiles of the schedule are split
+    // into four jobs each so that all rendering threads remain busy until the end.
+    // The post-render tile callback is only called once per tile, by its last job.
     void create(
         const Frame&                        frame,
         const TileOrdering                  tile_ordering,
+        const bool                          cost_driven_scheduling,
+        const size_t                        split_tile_count,
         const TileJob::TileRendererVector&  tile_renderers,
         const TileJob::TileCallbackVector&  tile_callbacks,
         const size_t                        pass_hash,
         TileJobVector&                      tile_jobs,
         foundation::AbortSwitch&            abort_switch);
 
+    // Record the cost of each tile from the rendering times of the jobs created by
+    // the last call to create(). Must be called once all these jobs have completed.
+    void record_tile_costs();
+
   private:
     foundation::MersenneTwister             m_rng;
+    std::vector<double>                     m_tile_costs;       // rendering time of each tile in seconds
+    bool                                    m_has_tile_costs;
+    std::vector<size_t>                     m_job_tiles;        // tile index of each job
+    std::vector<double>                     m_job_times;        // rendering time of each job in seconds
+    std::vector<boost::uint32_t>            m_pending_tile_jobs;    // number of jobs of each tile that have not completed
 
     void generate_tile_ordering(
         const foundation::CanvasProperties& frame_properties,
         const TileOrdering                  tile_ordering,
         std::vector<size_t>&                tiles);
+
+    void sort_tiles_by_decreasing_cost(
+        std::vector<size_t>&                tiles) const;
 };
 
 }       // namespace renderer
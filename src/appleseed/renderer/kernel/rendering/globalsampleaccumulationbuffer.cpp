@@ -40,20 +40,33 @@
 #include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/math/scalar.h"
 #include "foundation/platform/thread.h"
 
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+
 using namespace foundation;
 using namespace std;
 
 namespace renderer
 {
 
+namespace
+{
+    // Dimensions in pixels of the buckets by which samples are binned before splatting.
+    const size_t BucketSize = 32;
+}
+
 GlobalSampleAccumulationBuffer::GlobalSampleAccumulationBuffer(
     const size_t    width,
     const size_t    height,
     const Filter2d& filter)
   : m_fb(width, height, 3, filter)
   , m_filter_rcp_norm_factor(static_cast<float>(1.0 / compute_normalization_factor(filter)))
+  , m_bucket_count_x((width + BucketSize - 1) / BucketSize)
+  , m_bucket_count_y((height + BucketSize - 1) / BucketSize)
 {
 }
 
@@ -70,14 +83,18 @@ void GlobalSampleAccumulationBuffer::store_samples(
     const size_t    sample_count,
     const Sample    samples[])
 {
+    // This is done by the calling thread, without holding the lock.
+    vector<uint32> sample_indices;
+    sort_samples_by_bucket(sample_count, samples, sample_indices);
+
     boost::mutex::scoped_lock lock(m_mutex);
 
     const double fw = static_cast<double>(m_fb.get_width());
     const double fh = static_cast<double>(m_fb.get_height());
-    const Sample* sample_end = samples + sample_count;
 
-    for (const Sample* sample_ptr = samples; sample_ptr < sample_end; ++sample_ptr)
+    for (size_t i = 0; i < sample_count; ++i)
     {
+        const Sample* sample_ptr = samples + sample_indices[i];
         const double fx = sample_ptr->m_position.x * fw;
         const double fy = sample_ptr->m_position.y * fh;
 
@@ -86,6 +103,9 @@ void GlobalSampleAccumulationBuffer::store_samples(
 
         m_fb.add(fx, fy, &value[0]);
     }
+
+    if (m_convergence_map)
+        m_convergence_map->store_samples(sample_count, samples);
 }
 
 void GlobalSampleAccumulationBuffer::develop_to_frame(Frame& frame)
@@ -122,6 +142,40 @@ void GlobalSampleAccumulationBuffer::increment_sample_count(const uint64 delta_s
     m_sample_count += delta_sample_count;
 }
 
+void GlobalSampleAccumulationBuffer::sort_samples_by_bucket(
+    const size_t    sample_count,
+    const Sample    samples[],
+    vector<uint32>& sample_indices) const
+{
+    const size_t bucket_count = m_bucket_count_x * m_bucket_count_y;
+    const double fw = static_cast<double>(m_fb.get_width());
+    const double fh = static_cast<double>(m_fb.get_height());
+    const size_t max_x = m_fb.get_width() - 1;
+    const size_t max_y = m_fb.get_height() - 1;
+
+    // Compute the bucket of each sample and count the samples in each bucket.
+    vector<uint32> sample_buckets(sample_count);
+    vector<uint32> bucket_offsets(bucket_count + 1, 0);
+    for (size_t i = 0; i < sample_count; ++i)
+    {
+        const Vector2d& position = samples[i].m_position;
+        const size_t x = min(truncate<size_t>(max(position.x * fw, 0.0)), max_x);
+        const size_t y = min(truncate<size_t>(max(position.y * fh, 0.0)), max_y);
+        const size_t bucket = (y / BucketSize) * m_bucket_count_x + x / BucketSize;
+        sample_buckets[i] = static_cast<uint32>(bucket);
+        ++bucket_offsets[bucket + 1];
+    }
+
+    // Turn the bucket sizes into offsets.
+    for (size_t i = 1; i <= bucket_count; ++i)
+        bucket_offsets[i] += bucket_offsets[i - 1];
+
+    // Counting sort, stable within each bucket.
+    sample_indices.resize(sample_count);
+    for (size_t i = 0; i < sample_count; ++i)
+        sample_indices[bucket_offsets[sample_buckets[i]]++] = static_cast<uint32>(i);
+}
+
 void GlobalSampleAccumulationBuffer::develop_to_tile(
     Tile&           tile,
     const size_t    origin_x,
@@ -41,6 +41,7 @@
 
 // Standard headers.
 #include <cstddef>
+#include <vector>
 
 // Forward declarations.
 namespace foundation    { class Tile; }
@@ -64,6 +65,8 @@ class GlobalSampleAccumulationBuffer
     virtual void clear() OVERRIDE;
 
     // Store @samples into the buffer. Thread-safe.
+    // Samples are binned by image bucket before the buffer is locked,
+    // so that they are splatted in bucket order rather than randomly.
     virtual void store_samples(
         const size_t                sample_count,
         const Sample                samples[]) OVERRIDE;
@@ -77,6 +80,14 @@ class GlobalSampleAccumulationBuffer
   private:
     foundation::FilteredTile        m_fb;
     const float                     m_filter_rcp_norm_factor;
+    const size_t                    m_bucket_count_x;
+    const size_t                    m_bucket_count_y;
+
+    // Compute the order in which samples should be splatted. Thread-safe.
+    void sort_samples_by_bucket(
+        const size_t                sample_count,
+        const Sample                samples[],
+        std::vector<foundation::uint32>& sample_indices) const;
 
     void develop_to_tile(
         foundation::Tile&           tile,
@@ -59,17 +59,19 @@ class IPixelRenderer
   : public foundation::IUnknown
 {
   public:
-    // This method is called before a tile gets rendered.
+    // This method is called before a region of a tile gets rendered.
     virtual void on_tile_begin(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) = 0;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2u&   tile_region) = 0;
 
-    // This method is called after a tile has been rendered.
+    // This method is called after a region of a tile has been rendered.
     virtual void on_tile_end(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) = 0;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2u&   tile_region) = 0;
 
     // Render a pixel.
     virtual void render_pixel(
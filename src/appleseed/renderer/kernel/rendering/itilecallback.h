@@ -65,8 +65,8 @@ class DLLSYMBOL ITileCallback
         const size_t    width,
         const size_t    height) = 0;
 
-    // This method is called after a tile is rendered.
-    // Only tile-based renderers call this method.
+    // This method is called once after a tile is rendered, even if the tile
+    // was rendered in several regions. Only tile-based renderers call this method.
     virtual void post_render_tile(
         const Frame*    frame,
         const size_t    tile_x,
@@ -32,6 +32,7 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/iunknown.h"
+#include "foundation/math/aabb.h"
 
 // Standard headers.
 #include <cstddef>
@@ -52,11 +53,13 @@ class ITileRenderer
   : public foundation::IUnknown
 {
   public:
-    // Render a tile.
+    // Render the pixels of a tile that lie inside a given region.
+    // The region is expressed in tile space and its bounds are inclusive.
     virtual void render_tile(
         const Frame&                frame,
         const size_t                tile_x,
         const size_t                tile_y,
+        const foundation::AABB2u&   tile_region,
         const size_t                pass_hash,
         foundation::AbortSwitch&    abort_switch) = 0;
 
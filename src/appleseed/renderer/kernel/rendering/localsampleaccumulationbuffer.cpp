@@ -180,6 +180,9 @@ void LocalSampleAccumulationBuffer::store_samples(
     }
 
     m_sample_count += sample_count;
+
+    if (m_convergence_map)
+        m_convergence_map->store_samples(sample_count, samples);
 }
 
 namespace
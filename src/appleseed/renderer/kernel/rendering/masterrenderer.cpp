@@ -30,6 +30,8 @@
 #include "masterrenderer.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/kernel/lighting/drt/drtlightingengine.h"
 #include "renderer/kernel/lighting/lighttracing/lighttracingsamplegenerator.h"
 #include "renderer/kernel/lighting/pt/ptlightingengine.h"
@@ -50,6 +52,7 @@
 #include "renderer/kernel/rendering/generic/generictilerenderer.h"
 #include "renderer/kernel/rendering/progressive/progressiveframerenderer.h"
 #include "renderer/kernel/rendering/ephemeralshadingresultframebufferfactory.h"
+#include "renderer/kernel/rendering/framerendererbase.h"
 #include "renderer/kernel/rendering/iframerenderer.h"
 #include "renderer/kernel/rendering/ipasscallback.h"
 #include "renderer/kernel/rendering/ipixelrenderer.h"
@@ -78,6 +81,8 @@
 #include "foundation/platform/compiler.h"
 #include "foundation/platform/thread.h"
 #include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/searchpaths.h"
 
 // boost headers.
@@ -182,11 +187,25 @@ bool MasterRenderer::render()
 
 void MasterRenderer::do_render()
 {
+    // Scene entities are prepared concurrently before each frame, using as many threads
+    // as for rendering. The same threads are used for all the frames of the render.
+    // Entities that parallelize their own preparation use that many threads as well.
+    const size_t thread_count = FrameRendererBase::get_rendering_thread_count(m_params);
+    m_project.set_rendering_thread_count(thread_count);
+
+    JobQueue job_queue;
+    JobManager job_manager(
+        global_logger(),
+        job_queue,
+        thread_count,
+        JobManager::KeepRunningOnEmptyQueue | JobManager::KeepRunningOnJobFailure);
+    job_manager.start();
+
     while (true)
     {
         m_renderer_controller->on_rendering_begin();
 
-        const IRendererController::Status status = initialize_and_render_frame_sequence();
+        const IRendererController::Status status = initialize_and_render_frame_sequence(job_queue);
 
         switch (status)
         {
@@ -231,11 +250,13 @@ namespace
 #endif
 }
 
-IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence()
+IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence(JobQueue& job_queue)
 {
     assert(m_project.get_scene());
     assert(m_project.get_frame());
 
+    ScopedProfile profile(global_profiler(), "rendering");
+
     // Reset the abort switch.
     if (m_abort_switch)
         m_abort_switch->clear();
@@ -355,8 +376,11 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
 #endif  // WITH_OSL
 
     // We start by binding entities inputs. This must be done before creating/updating the trace context.
-    if (!bind_scene_entities_inputs())
-        return IRendererController::AbortRendering;
+    {
+        ScopedProfile profile(global_profiler(), "input binding");
+        if (!bind_scene_entities_inputs())
+            return IRendererController::AbortRendering;
+    }
 
     m_project.create_aov_images();
     m_project.update_trace_context();
@@ -390,6 +414,7 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
         {
             lighting_engine_factory.reset(
                 new DRTLightingEngineFactory(
+                    scene,
                     light_sampler,
                     m_params.child("drt")));    // todo: change to "drt_lighting_engine" -- or?
         }
@@ -550,6 +575,7 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     //
 
     auto_ptr<IShadingResultFrameBufferFactory> shading_result_framebuffer_factory;
+    bool has_ephemeral_framebuffers = false;
     {
         const string value =
             m_params.get_optional<string>("shading_result_framebuffer", "ephemeral");
@@ -558,11 +584,14 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
         {
             shading_result_framebuffer_factory.reset(
                 new EphemeralShadingResultFrameBufferFactory());
+            has_ephemeral_framebuffers = true;
         }
         else if (value == "permanent")
         {
             shading_result_framebuffer_factory.reset(
-                new PermanentShadingResultFrameBufferFactory(frame));
+                new PermanentShadingResultFrameBufferFactory(
+                    frame,
+                    m_params.child("permanent_shading_result_framebuffer")));
         }
         else if (!value.empty())
         {
@@ -622,6 +651,13 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
             ParamArray params = m_params.child("generic_frame_renderer");
             copy_param(params, m_params, "rendering_threads");
 
+            // Subtiles are rendered concurrently: they cannot share a permanent tile framebuffer.
+            if (params.get_optional<bool>("tile_splitting", false) && !has_ephemeral_framebuffers)
+            {
+                RENDERER_LOG_WARNING("tile splitting requires ephemeral shading result framebuffers, disabling it.");
+                params.insert("tile_splitting", false);
+            }
+
             frame_renderer.reset(
                 GenericFrameRendererFactory::create(
                     frame,
@@ -655,7 +691,8 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     // Execute the main rendering loop.
     const IRendererController::Status status =
         render_frame_sequence(
-            frame_renderer.get()
+            frame_renderer.get(),
+            job_queue
 #ifdef WITH_OSL
             , *shading_system
 #endif
@@ -667,8 +704,26 @@ IRendererController::Status MasterRenderer::initialize_and_render_frame_sequence
     return status;
 }
 
+bool MasterRenderer::prepare_scene(
+    JobQueue&               job_queue
+#ifdef WITH_OSL
+    , OSL::ShadingSystem&   shading_system
+#endif
+    )
+{
+    return
+        m_project.get_scene()->on_frame_begin(
+            m_project,
+#ifdef WITH_OSL
+            &shading_system,
+#endif
+            m_abort_switch,
+            &job_queue);
+}
+
 IRendererController::Status MasterRenderer::render_frame_sequence(
-    IFrameRenderer*         frame_renderer
+    IFrameRenderer*         frame_renderer,
+    JobQueue&               job_queue
 #ifdef WITH_OSL
     , OSL::ShadingSystem&   shading_system
 #endif
@@ -684,11 +739,12 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
         m_renderer_controller->on_frame_begin();
 
         // Prepare the scene for rendering. Don't proceed if that failed.
+        if (!prepare_scene(
+                job_queue
 #ifdef WITH_OSL
-        if (!m_project.get_scene()->on_frame_begin(m_project, &shading_system, m_abort_switch))
-#else
-        if (!m_project.get_scene()->on_frame_begin(m_project, m_abort_switch))
+                , shading_system
 #endif
+                ))
         {
             m_renderer_controller->on_frame_end();
             return IRendererController::AbortRendering;
@@ -701,23 +757,29 @@ IRendererController::Status MasterRenderer::render_frame_sequence(
             return m_renderer_controller->on_progress();
         }
 
-        frame_renderer->start_rendering();
+        IRendererController::Status status;
 
-        const IRendererController::Status status = wait_for_event(frame_renderer);
-
-        switch (status)
         {
-          case IRendererController::TerminateRendering:
-          case IRendererController::AbortRendering:
-          case IRendererController::ReinitializeRendering:
-            frame_renderer->terminate_rendering();
-            break;
+            ScopedProfile profile(global_profiler(), "frame rendering");
 
-          case IRendererController::RestartRendering:
-            frame_renderer->stop_rendering();
-            break;
+            frame_renderer->start_rendering();
 
-          assert_otherwise;
+            status = wait_for_event(frame_renderer);
+
+            switch (status)
+            {
+              case IRendererController::TerminateRendering:
+              case IRendererController::AbortRendering:
+              case IRendererController::ReinitializeRendering:
+                frame_renderer->terminate_rendering();
+                break;
+
+              case IRendererController::RestartRendering:
+                frame_renderer->stop_rendering();
+                break;
+
+              assert_otherwise;
+            }
         }
 
         assert(!frame_renderer->is_rendering());
@@ -49,6 +49,7 @@
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
+namespace foundation    { class JobQueue; }
 namespace renderer      { class IFrameRenderer; }
 namespace renderer      { class ITileCallbackFactory; }
 namespace renderer      { class ITileCallback; }
@@ -112,11 +113,22 @@ class DLLSYMBOL MasterRenderer
     void do_render();
 
     // Initialize the rendering components and render a frame sequence.
-    IRendererController::Status initialize_and_render_frame_sequence();
+    IRendererController::Status initialize_and_render_frame_sequence(
+        foundation::JobQueue&       job_queue);
+
+    // Prepare the scene for rendering a frame, in parallel, using a given job queue.
+    // Returns true on success, false otherwise.
+    bool prepare_scene(
+        foundation::JobQueue&       job_queue
+#ifdef WITH_OSL
+        , OSL::ShadingSystem&       shading_system
+#endif
+        );
 
     // Render a frame sequence until the sequence is completed or rendering is aborted.
     IRendererController::Status render_frame_sequence(
-        IFrameRenderer*             frame_renderer
+        IFrameRenderer*             frame_renderer,
+        foundation::JobQueue&       job_queue
 #ifdef WITH_OSL
         , OSL::ShadingSystem&       shading_system
 #endif
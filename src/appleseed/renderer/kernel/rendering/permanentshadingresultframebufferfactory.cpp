@@ -31,16 +31,32 @@
 #include "permanentshadingresultframebufferfactory.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/rendering/shadingresultframebuffer.h"
 #include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/tile.h"
+#include "foundation/utility/string.h"
+
+// lz4 headers.
+#include "lz4.h"
+
+// OpenEXR headers.
+#include "OpenEXR/half.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <vector>
 
 using namespace foundation;
+using namespace std;
 
 namespace renderer
 {
@@ -51,16 +67,50 @@ void PermanentShadingResultFrameBufferFactory::release()
 }
 
 PermanentShadingResultFrameBufferFactory::PermanentShadingResultFrameBufferFactory(
-    const Frame&                frame)
+    const Frame&                frame,
+    const ParamArray&           params)
+  : m_storage_mode(StorageFull)
+  , m_peak_resident_size(0)
+  , m_resident_size(0)
 {
+    const string storage = params.get_optional<string>("storage", "full");
+
+    if (storage == "half")
+        m_storage_mode = StorageHalf;
+    else if (storage == "compressed")
+        m_storage_mode = StorageCompressed;
+    else if (storage != "full")
+    {
+        RENDERER_LOG_ERROR(
+            "invalid value \"%s\" for parameter \"storage\", using default value \"full\"",
+            storage.c_str());
+    }
+
     const size_t tile_count_x = frame.image().properties().m_tile_count_x;
     const size_t tile_count_y = frame.image().properties().m_tile_count_y;
+    const size_t tile_count = tile_count_x * tile_count_y;
+
+    m_framebuffers.resize(tile_count, 0);
 
-    m_framebuffers.resize(tile_count_x * tile_count_y, 0);
+    if (m_storage_mode != StorageFull)
+        m_packed_tiles.resize(tile_count);
 }
 
 PermanentShadingResultFrameBufferFactory::~PermanentShadingResultFrameBufferFactory()
 {
+    if (m_storage_mode != StorageFull)
+    {
+        uint64 packed_size = 0;
+
+        for (size_t i = 0; i < m_packed_tiles.size(); ++i)
+            packed_size += m_packed_tiles[i].size();
+
+        RENDERER_LOG_DEBUG(
+            "permanent shading result framebuffers: %s packed, %s peak resident.",
+            pretty_size(packed_size).c_str(),
+            pretty_size(m_peak_resident_size).c_str());
+    }
+
     for (size_t i = 0; i < m_framebuffers.size(); ++i)
         delete m_framebuffers[i];
 }
@@ -78,7 +128,7 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
     {
         const Tile& tile = frame.image().tile(tile_x, tile_y);
 
-        m_framebuffers[index] =
+        ShadingResultFrameBuffer* framebuffer =
             new ShadingResultFrameBuffer(
                 tile.get_width(),
                 tile.get_height(),
@@ -86,7 +136,23 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
                 tile_bbox,
                 frame.get_filter());
 
-        m_framebuffers[index]->clear();
+        if (m_storage_mode == StorageFull || m_packed_tiles[index].empty())
+            framebuffer->clear();
+        else
+        {
+            unpack(m_packed_tiles[index], *framebuffer);
+            PackedTile().swap(m_packed_tiles[index]);
+        }
+
+        m_framebuffers[index] = framebuffer;
+
+        if (m_storage_mode != StorageFull)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_resident_tiles[framebuffer] = index;
+            m_resident_size += framebuffer->get_size();
+            m_peak_resident_size = max(m_peak_resident_size, m_resident_size);
+        }
     }
 
     return m_framebuffers[index];
@@ -95,6 +161,119 @@ ShadingResultFrameBuffer* PermanentShadingResultFrameBufferFactory::create(
 void PermanentShadingResultFrameBufferFactory::destroy(
     ShadingResultFrameBuffer*   framebuffer)
 {
+    if (m_storage_mode == StorageFull)
+        return;
+
+    size_t index;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+        const TileIndexMap::iterator i = m_resident_tiles.find(framebuffer);
+        assert(i != m_resident_tiles.end());
+        index = i->second;
+        m_resident_tiles.erase(i);
+        m_resident_size -= framebuffer->get_size();
+    }
+
+    pack(*framebuffer, m_packed_tiles[index]);
+
+    delete framebuffer;
+    m_framebuffers[index] = 0;
+}
+
+void PermanentShadingResultFrameBufferFactory::pack(
+    const ShadingResultFrameBuffer&     framebuffer,
+    PackedTile&                         packed_tile) const
+{
+    const float* values = reinterpret_cast<const float*>(framebuffer.get_storage());
+
+    if (m_storage_mode == StorageHalf)
+    {
+        // Pixels hold a weight followed by weighted sums. The weights and sums keep growing
+        // from pass to pass and would quickly lose precision or overflow if stored as halfs,
+        // so we store the weights as floats and the normalized values (sum / weight) as halfs.
+        const size_t pixel_count = framebuffer.get_pixel_count();
+        const size_t channel_count = framebuffer.get_channel_count();
+        assert(framebuffer.get_size() == pixel_count * channel_count * sizeof(float));
+
+        packed_tile.resize(
+              pixel_count * sizeof(float)
+            + pixel_count * (channel_count - 1) * sizeof(half));
+
+        float* packed_weights = reinterpret_cast<float*>(&packed_tile[0]);
+        half* packed_values = reinterpret_cast<half*>(packed_weights + pixel_count);
+
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            const float weight = *values++;
+            const float rcp_weight = weight == 0.0f ? 0.0f : 1.0f / weight;
+
+            *packed_weights++ = weight;
+
+            for (size_t c = 1; c < channel_count; ++c)
+                *packed_values++ = half(*values++ * rcp_weight);
+        }
+    }
+    else
+    {
+        assert(m_storage_mode == StorageCompressed);
+
+        const int input_size = static_cast<int>(framebuffer.get_size());
+        vector<uint8> buffer(static_cast<size_t>(LZ4_compressBound(input_size)));
+
+        const int compressed_size =
+            LZ4_compress(
+                reinterpret_cast<const char*>(values),
+                reinterpret_cast<char*>(&buffer[0]),
+                input_size);
+
+        // Copy to a vector of the exact size to release the slack of the compression buffer.
+        PackedTile(buffer.begin(), buffer.begin() + compressed_size).swap(packed_tile);
+    }
+}
+
+void PermanentShadingResultFrameBufferFactory::unpack(
+    const PackedTile&                   packed_tile,
+    ShadingResultFrameBuffer&           framebuffer) const
+{
+    float* values = reinterpret_cast<float*>(framebuffer.get_storage());
+
+    if (m_storage_mode == StorageHalf)
+    {
+        const size_t pixel_count = framebuffer.get_pixel_count();
+        const size_t channel_count = framebuffer.get_channel_count();
+        assert(framebuffer.get_size() == pixel_count * channel_count * sizeof(float));
+        assert(
+               packed_tile.size()
+            == pixel_count * sizeof(float) + pixel_count * (channel_count - 1) * sizeof(half));
+
+        const float* packed_weights = reinterpret_cast<const float*>(&packed_tile[0]);
+        const half* packed_values = reinterpret_cast<const half*>(packed_weights + pixel_count);
+
+        // Rebuild the weighted sums from the weights and the normalized values.
+        for (size_t i = 0; i < pixel_count; ++i)
+        {
+            const float weight = *packed_weights++;
+
+            *values++ = weight;
+
+            for (size_t c = 1; c < channel_count; ++c)
+                *values++ = static_cast<float>(*packed_values++) * weight;
+        }
+    }
+    else
+    {
+        assert(m_storage_mode == StorageCompressed);
+
+        const int decompressed_size =
+            LZ4_decompress_safe(
+                reinterpret_cast<const char*>(&packed_tile[0]),
+                reinterpret_cast<char*>(values),
+                static_cast<int>(packed_tile.size()),
+                static_cast<int>(framebuffer.get_size()));
+
+        assert(decompressed_size == static_cast<int>(framebuffer.get_size()));
+    }
 }
 
 }   // namespace renderer
@@ -36,25 +36,41 @@
 // appleseed.foundation headers.
 #include "foundation/math/aabb.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
+
+// boost headers.
+#include "boost/thread/mutex.hpp"
 
 // Standard headers.
 #include <cstddef>
+#include <map>
 #include <vector>
 
 // Forward declarations.
 namespace renderer  { class Frame; }
+namespace renderer  { class ParamArray; }
 namespace renderer  { class ShadingResultFrameBuffer; }
 
 namespace renderer
 {
 
+//
+// A factory that keeps the content of each tile's framebuffer across rendering passes.
+//
+// By default, framebuffers of all tiles stay resident in memory for the whole frame.
+// With the "half" or "compressed" storage modes, only the framebuffers of the tiles
+// being rendered are resident; idle tiles are packed either to half-precision floats
+// (lossy) or LZ4-compressed (lossless) when they are handed back to the factory.
+//
+
 class PermanentShadingResultFrameBufferFactory
   : public IShadingResultFrameBufferFactory
 {
   public:
     // Constructor.
-    explicit PermanentShadingResultFrameBufferFactory(
-        const Frame&                frame);
+    PermanentShadingResultFrameBufferFactory(
+        const Frame&                frame,
+        const ParamArray&           params);
 
     // Destructor.
     ~PermanentShadingResultFrameBufferFactory();
@@ -72,7 +88,31 @@ class PermanentShadingResultFrameBufferFactory
         ShadingResultFrameBuffer*   framebuffer) OVERRIDE;
 
   private:
-    std::vector<ShadingResultFrameBuffer*> m_framebuffers;
+    enum StorageMode
+    {
+        StorageFull,                            // full precision, always resident
+        StorageHalf,                            // float weights and half precision normalized values when idle
+        StorageCompressed                       // LZ4-compressed when idle
+    };
+
+    typedef std::vector<foundation::uint8> PackedTile;
+    typedef std::map<const ShadingResultFrameBuffer*, size_t> TileIndexMap;
+
+    StorageMode                             m_storage_mode;
+    std::vector<ShadingResultFrameBuffer*>  m_framebuffers;
+    std::vector<PackedTile>                 m_packed_tiles;
+    boost::mutex                            m_mutex;
+    TileIndexMap                            m_resident_tiles;
+    foundation::uint64                      m_peak_resident_size;
+    foundation::uint64                      m_resident_size;
+
+    void pack(
+        const ShadingResultFrameBuffer&     framebuffer,
+        PackedTile&                         packed_tile) const;
+
+    void unpack(
+        const PackedTile&                   packed_tile,
+        ShadingResultFrameBuffer&           framebuffer) const;
 };
 
 }       // namespace renderer
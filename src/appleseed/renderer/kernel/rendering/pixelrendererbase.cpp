@@ -67,14 +67,16 @@ PixelRendererBase::~PixelRendererBase()
 void PixelRendererBase::on_tile_begin(
     const Frame&    frame,
     Tile&           tile,
-    TileStack&      aov_tiles)
+    TileStack&      aov_tiles,
+    const AABB2u&   tile_region)
 {
 }
 
 void PixelRendererBase::on_tile_end(
     const Frame&    frame,
     Tile&           tile,
-    TileStack&      aov_tiles)
+    TileStack&      aov_tiles,
+    const AABB2u&   tile_region)
 {
 }
 
@@ -59,17 +59,19 @@ class PixelRendererBase
     // Destructor.
     virtual ~PixelRendererBase();
 
-    // This method is called before a tile gets rendered.
+    // This method is called before a region of a tile gets rendered.
     virtual void on_tile_begin(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) OVERRIDE;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2u&   tile_region) OVERRIDE;
 
-    // This method is called after a tile has been rendered.
+    // This method is called after a region of a tile has been rendered.
     virtual void on_tile_end(
         const Frame&                frame,
         foundation::Tile&           tile,
-        TileStack&                  aov_tiles) OVERRIDE;
+        TileStack&                  aov_tiles,
+        const foundation::AABB2u&   tile_region) OVERRIDE;
 
   protected:
     void signal_invalid_sample();
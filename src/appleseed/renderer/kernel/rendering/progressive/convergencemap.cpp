@@ -0,0 +1,279 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "convergencemap.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/color.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// ConvergenceMap class implementation.
+//
+
+namespace
+{
+    // Luminance below which the relative error is measured against this value instead,
+    // to prevent nearly black pixels from never converging.
+    const float MinLuminance = 1.0e-3f;
+}
+
+const char* const ConvergenceMap::AOVName = "convergence";
+
+ConvergenceMap::ConvergenceMap(
+    const size_t    canvas_width,
+    const size_t    canvas_height,
+    const AABB2u&   crop_window,
+    const size_t    block_size,
+    const float     noise_threshold,
+    const size_t    min_samples_per_pixel)
+  : m_canvas_width(canvas_width)
+  , m_canvas_height(canvas_height)
+  , m_crop_window(crop_window)
+  , m_block_size(max<size_t>(block_size, 1))
+  , m_noise_threshold(noise_threshold)
+  , m_min_samples_per_pixel(max<size_t>(min_samples_per_pixel, 2))
+  , m_block_count_x((canvas_width + m_block_size - 1) / m_block_size)
+  , m_block_count_y((canvas_height + m_block_size - 1) / m_block_size)
+  , m_pixels(canvas_width * canvas_height)
+  , m_block_errors(m_block_count_x * m_block_count_y)
+  , m_block_converged(m_block_count_x * m_block_count_y)
+  , m_block_dirty(m_block_count_x * m_block_count_y)
+{
+    assert(noise_threshold > 0.0f);
+
+    clear();
+}
+
+void ConvergenceMap::clear()
+{
+    const PixelStats empty = { 0.0f, 0.0f, 0 };
+    fill(m_pixels.begin(), m_pixels.end(), empty);
+
+    m_dirty_blocks.clear();
+    m_tracked_block_count = 0;
+
+    size_t converged_block_count = 0;
+
+    for (size_t by = 0; by < m_block_count_y; ++by)
+    {
+        for (size_t bx = 0; bx < m_block_count_x; ++bx)
+        {
+            const size_t block = by * m_block_count_x + bx;
+
+            // Blocks that lie entirely outside the crop window never receive samples:
+            // consider them converged from the start.
+            const AABB2u block_bbox(
+                Vector2u(bx * m_block_size, by * m_block_size),
+                Vector2u(
+                    min((bx + 1) * m_block_size, m_canvas_width) - 1,
+                    min((by + 1) * m_block_size, m_canvas_height) - 1));
+            const bool tracked = AABB2u::overlap(block_bbox, m_crop_window);
+
+            m_block_errors[block] = tracked ? numeric_limits<float>::max() : 0.0f;
+            m_block_converged[block] = tracked ? 0 : 1;
+            m_block_dirty[block] = false;
+
+            if (tracked)
+                ++m_tracked_block_count;
+            else ++converged_block_count;
+        }
+    }
+
+    boost_atomic::atomic_write32(
+        &m_converged_block_count,
+        static_cast<boost::uint32_t>(converged_block_count));
+}
+
+void ConvergenceMap::store_samples(
+    const size_t    sample_count,
+    const Sample    samples[])
+{
+    const double fw = static_cast<double>(m_canvas_width);
+    const double fh = static_cast<double>(m_canvas_height);
+    const Sample* sample_end = samples + sample_count;
+
+    for (const Sample* sample_ptr = samples; sample_ptr < sample_end; ++sample_ptr)
+    {
+        const size_t x = static_cast<size_t>(sample_ptr->m_position.x * fw);
+        const size_t y = static_cast<size_t>(sample_ptr->m_position.y * fh);
+
+        if (x >= m_canvas_width || y >= m_canvas_height)
+            continue;
+
+        const float lum = luminance(sample_ptr->m_color.rgb());
+
+        PixelStats& stats = m_pixels[y * m_canvas_width + x];
+        stats.m_sum += lum;
+        stats.m_sum_sq += lum * lum;
+        ++stats.m_count;
+
+        const size_t block = block_index(x, y);
+
+        if (!m_block_dirty[block] && m_block_converged[block] == 0)
+        {
+            m_block_dirty[block] = true;
+            m_dirty_blocks.push_back(block);
+        }
+    }
+
+    for (size_t i = 0; i < m_dirty_blocks.size(); ++i)
+    {
+        const size_t block = m_dirty_blocks[i];
+        update_block(block);
+        m_block_dirty[block] = false;
+    }
+
+    m_dirty_blocks.clear();
+}
+
+size_t ConvergenceMap::get_converged_block_count() const
+{
+    const size_t untracked_block_count = m_block_converged.size() - m_tracked_block_count;
+    return boost_atomic::atomic_read32(&m_converged_block_count) - untracked_block_count;
+}
+
+void ConvergenceMap::develop_to_image(Image& image) const
+{
+    const CanvasProperties& props = image.properties();
+
+    assert(props.m_canvas_width == m_canvas_width);
+    assert(props.m_canvas_height == m_canvas_height);
+
+    const float rcp_noise_threshold = 1.0f / m_noise_threshold;
+
+    for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            Tile& tile = image.tile(tx, ty);
+
+            const size_t origin_x = tx * props.m_tile_width;
+            const size_t origin_y = ty * props.m_tile_height;
+            const size_t tile_width = tile.get_width();
+            const size_t tile_height = tile.get_height();
+
+            for (size_t y = 0; y < tile_height; ++y)
+            {
+                for (size_t x = 0; x < tile_width; ++x)
+                {
+                    const size_t block = block_index(origin_x + x, origin_y + y);
+                    const float error = m_block_errors[block];
+
+                    // Blocks that don't have enough samples yet have an infinite error.
+                    const float value =
+                        error == numeric_limits<float>::max()
+                            ? 1.0e3f
+                            : error * rcp_noise_threshold;
+
+                    Color4f color(value, value, value, m_block_converged[block] ? 1.0f : 0.0f);
+                    tile.set_pixel(x, y, color);
+                }
+            }
+        }
+    }
+}
+
+float ConvergenceMap::compute_block_error(
+    const size_t    bx,
+    const size_t    by,
+    bool&           complete) const
+{
+    const size_t x0 = max(bx * m_block_size, m_crop_window.min.x);
+    const size_t y0 = max(by * m_block_size, m_crop_window.min.y);
+    const size_t x1 = min(min((bx + 1) * m_block_size, m_canvas_width) - 1, m_crop_window.max.x);
+    const size_t y1 = min(min((by + 1) * m_block_size, m_canvas_height) - 1, m_crop_window.max.y);
+
+    float max_error = 0.0f;
+    complete = true;
+
+    for (size_t y = y0; y <= y1; ++y)
+    {
+        for (size_t x = x0; x <= x1; ++x)
+        {
+            const PixelStats& stats = m_pixels[y * m_canvas_width + x];
+
+            if (stats.m_count < m_min_samples_per_pixel)
+            {
+                complete = false;
+                return numeric_limits<float>::max();
+            }
+
+            // Relative standard error of the mean luminance of the pixel.
+            const float n = static_cast<float>(stats.m_count);
+            const float mean = stats.m_sum / n;
+            const float variance = max(stats.m_sum_sq / n - mean * mean, 0.0f) / (n - 1.0f);
+            const float error = sqrt(variance) / max(mean, MinLuminance);
+
+            max_error = max(max_error, error);
+        }
+    }
+
+    return max_error;
+}
+
+void ConvergenceMap::update_block(const size_t block)
+{
+    assert(m_block_converged[block] == 0);
+
+    bool complete;
+    const float error =
+        compute_block_error(
+            block % m_block_count_x,
+            block / m_block_count_x,
+            complete);
+
+    m_block_errors[block] = error;
+
+    if (complete && error <= m_noise_threshold)
+    {
+        boost_atomic::atomic_write32(&m_block_converged[block], 1);
+        boost_atomic::atomic_inc32(&m_converged_block_count);
+    }
+}
+
+}   // namespace renderer
@@ -0,0 +1,176 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_RENDERING_PROGRESSIVE_CONVERGENCEMAP_H
+#define APPLESEED_RENDERER_KERNEL_RENDERING_PROGRESSIVE_CONVERGENCEMAP_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/thread.h"
+
+// boost headers.
+#include "boost/cstdint.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class Image; }
+namespace renderer      { class Sample; }
+
+namespace renderer
+{
+
+//
+// Tracks the convergence of a progressive render.
+//
+// The canvas is divided into square blocks of pixels. For every pixel we keep running
+// sums of the luminance of the samples that landed in it, from which we derive the
+// relative standard error of the pixel's mean. A block is considered converged once
+// all its pixels have received at least a minimum number of samples and the worst
+// relative error among them is below the noise threshold. Converged blocks stay
+// converged until the map is cleared.
+//
+// Updates must be serialized by the caller (they are performed under the lock of the
+// sample accumulation buffer that owns the map) but convergence queries are lock-free
+// so that sample generators can cheaply skip converged pixels.
+//
+
+class ConvergenceMap
+  : public foundation::NonCopyable
+{
+  public:
+    // Name of the AOV the map is developed to.
+    static const char* const AOVName;
+
+    // Constructor.
+    ConvergenceMap(
+        const size_t                canvas_width,
+        const size_t                canvas_height,
+        const foundation::AABB2u&   crop_window,
+        const size_t                block_size,
+        const float                 noise_threshold,
+        const size_t                min_samples_per_pixel);
+
+    // Reset the map to its initial state. Not thread-safe.
+    void clear();
+
+    // Account for a batch of samples. Not thread-safe.
+    void store_samples(
+        const size_t                sample_count,
+        const Sample                samples[]);
+
+    // Return true if the pixel containing a given point (in NDC) has converged. Thread-safe.
+    bool is_converged(const foundation::Vector2d& point) const;
+
+    // Return true if the whole crop window has converged. Thread-safe.
+    bool is_converged() const;
+
+    // Return the number of blocks that are being tracked.
+    size_t get_block_count() const;
+
+    // Return the number of blocks that have converged. Thread-safe.
+    size_t get_converged_block_count() const;
+
+    // Write the per-block relative error, normalized by the noise threshold, to an image.
+    // Converged blocks thus have values in [0, 1]. The alpha channel is set to 1 in
+    // converged blocks and to 0 elsewhere. Not thread-safe.
+    void develop_to_image(foundation::Image& image) const;
+
+  private:
+    struct PixelStats
+    {
+        float   m_sum;
+        float   m_sum_sq;
+        size_t  m_count;
+    };
+
+    const size_t                    m_canvas_width;
+    const size_t                    m_canvas_height;
+    const foundation::AABB2u        m_crop_window;
+    const size_t                    m_block_size;
+    const float                     m_noise_threshold;
+    const size_t                    m_min_samples_per_pixel;
+    const size_t                    m_block_count_x;
+    const size_t                    m_block_count_y;
+    size_t                          m_tracked_block_count;
+
+    std::vector<PixelStats>         m_pixels;
+    std::vector<float>              m_block_errors;
+    mutable std::vector<boost::uint32_t> m_block_converged;
+    std::vector<size_t>             m_dirty_blocks;
+    std::vector<bool>               m_block_dirty;
+    mutable volatile boost::uint32_t m_converged_block_count;
+
+    size_t block_index(const size_t x, const size_t y) const;
+
+    float compute_block_error(
+        const size_t                bx,
+        const size_t                by,
+        bool&                       complete) const;
+
+    void update_block(const size_t block);
+};
+
+
+//
+// ConvergenceMap class implementation.
+//
+
+inline size_t ConvergenceMap::block_index(const size_t x, const size_t y) const
+{
+    return (y / m_block_size) * m_block_count_x + x / m_block_size;
+}
+
+inline bool ConvergenceMap::is_converged(const foundation::Vector2d& point) const
+{
+    const size_t x = static_cast<size_t>(point.x * m_canvas_width);
+    const size_t y = static_cast<size_t>(point.y * m_canvas_height);
+
+    if (x >= m_canvas_width || y >= m_canvas_height)
+        return false;
+
+    return boost_atomic::atomic_read32(&m_block_converged[block_index(x, y)]) == 1;
+}
+
+inline bool ConvergenceMap::is_converged() const
+{
+    return boost_atomic::atomic_read32(&m_converged_block_count) == m_block_converged.size();
+}
+
+inline size_t ConvergenceMap::get_block_count() const
+{
+    return m_tracked_block_count;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_RENDERING_PROGRESSIVE_CONVERGENCEMAP_H
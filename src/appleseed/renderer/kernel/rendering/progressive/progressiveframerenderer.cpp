@@ -31,6 +31,10 @@
 #include "progressiveframerenderer.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/aov/aovsettings.h"
+#include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/progressive/convergencemap.h"
 #include "renderer/kernel/rendering/progressive/samplecounter.h"
 #include "renderer/kernel/rendering/progressive/samplegeneratorjob.h"
 #include "renderer/kernel/rendering/framerendererbase.h"
@@ -45,6 +49,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/genericimagefilereader.h"
 #include "foundation/image/image.h"
+#include "foundation/image/pixel.h"
 #include "foundation/math/fixedsizehistory.h"
 #include "foundation/platform/thread.h"
 #include "foundation/platform/timer.h"
@@ -95,6 +100,10 @@ namespace
             // Create an accumulation buffer.
             m_buffer.reset(generator_factory->create_sample_accumulation_buffer());
 
+            // Create a convergence map if adaptive sampling is enabled.
+            if (m_params.m_adaptive_sampling)
+                create_convergence_map();
+
             // Create and initialize the job manager.
             m_job_manager.reset(
                 new JobManager(
@@ -247,6 +256,11 @@ namespace
         {
             stop_rendering();
 
+            // When rendering stopped because the image converged, some samples may have been
+            // stored after the last development of the frame.
+            if (m_convergence_map.get() && m_convergence_map->is_converged())
+                develop_final_frame();
+
             m_job_manager->stop();
 
             m_statistics_func->write_rms_deviation_file();
@@ -266,12 +280,20 @@ namespace
             const uint64    m_max_sample_count;         // maximum total number of samples to compute
             const bool      m_print_luminance_stats;    // compute and print luminance statistics?
             const string    m_ref_image_path;           // path to the reference image
+            const bool      m_adaptive_sampling;        // stop sampling converged regions?
+            const size_t    m_adaptive_block_size;      // size in pixels of the blocks whose convergence is tracked
+            const float     m_adaptive_noise_threshold; // relative error below which a block is converged
+            const size_t    m_adaptive_min_samples;     // minimum number of samples per pixel before testing convergence
 
             explicit Parameters(const ParamArray& params)
               : m_thread_count(FrameRendererBase::get_rendering_thread_count(params))
               , m_max_sample_count(params.get_optional<uint64>("max_samples", numeric_limits<uint64>::max()))
               , m_print_luminance_stats(params.get_optional<bool>("print_luminance_statistics", false))
               , m_ref_image_path(params.get_optional<string>("reference_image", ""))
+              , m_adaptive_sampling(params.get_optional<bool>("adaptive_sampling", false))
+              , m_adaptive_block_size(params.get_optional<size_t>("adaptive_block_size", 8))
+              , m_adaptive_noise_threshold(params.get_optional<float>("adaptive_noise_threshold", 0.02f))
+              , m_adaptive_min_samples(params.get_optional<size_t>("adaptive_min_samples", 16))
             {
             }
         };
@@ -363,11 +385,27 @@ namespace
 
                 const uint64 avg_sps_count = truncate<uint64>(m_sps_count_history.compute_average());
 
-                RENDERER_LOG_INFO(
-                    "%s samples, %s samples/pixel, %s samples/second",
-                    pretty_uint(new_sample_count).c_str(),
-                    pretty_scalar(spp_count).c_str(),
-                    pretty_uint(avg_sps_count).c_str());
+                const ConvergenceMap* convergence_map = m_buffer.get_convergence_map();
+
+                if (convergence_map)
+                {
+                    RENDERER_LOG_INFO(
+                        "%s samples, %s samples/pixel, %s samples/second, %s converged",
+                        pretty_uint(new_sample_count).c_str(),
+                        pretty_scalar(spp_count).c_str(),
+                        pretty_uint(avg_sps_count).c_str(),
+                        pretty_percent(
+                            convergence_map->get_converged_block_count(),
+                            convergence_map->get_block_count()).c_str());
+                }
+                else
+                {
+                    RENDERER_LOG_INFO(
+                        "%s samples, %s samples/pixel, %s samples/second",
+                        pretty_uint(new_sample_count).c_str(),
+                        pretty_scalar(spp_count).c_str(),
+                        pretty_uint(avg_sps_count).c_str());
+                }
 
                 m_last_sample_count = new_sample_count;
             }
@@ -420,6 +458,7 @@ namespace
         const Parameters                    m_params;
         SampleCounter                       m_sample_counter;
 
+        auto_ptr<ConvergenceMap>            m_convergence_map;
         auto_ptr<SampleAccumulationBuffer>  m_buffer;
 
         JobQueue                            m_job_queue;
@@ -435,6 +474,55 @@ namespace
         auto_ptr<StatisticsFunc>            m_statistics_func;
         auto_ptr<thread>                    m_statistics_thread;
 
+        void create_convergence_map()
+        {
+            const CanvasProperties& props = m_frame.image().properties();
+
+            m_convergence_map.reset(
+                new ConvergenceMap(
+                    props.m_canvas_width,
+                    props.m_canvas_height,
+                    m_frame.get_crop_window(),
+                    m_params.m_adaptive_block_size,
+                    m_params.m_adaptive_noise_threshold,
+                    m_params.m_adaptive_min_samples));
+
+            m_buffer->set_convergence_map(m_convergence_map.get());
+
+            ImageStack& aov_images = m_frame.aov_images();
+
+            if (aov_images.get(ConvergenceMap::AOVName) == ~0)
+            {
+                if (aov_images.size() < MaxAOVCount)
+                    aov_images.append(ConvergenceMap::AOVName, ImageStack::IdentificationType, PixelFormatFloat);
+                else
+                {
+                    RENDERER_LOG_WARNING(
+                        "could not create the convergence AOV, maximum number of AOVs (" FMT_SIZE_T ") reached.",
+                        MaxAOVCount);
+                }
+            }
+
+            RENDERER_LOG_INFO(
+                "adaptive sampling enabled: %s blocks of %sx%s pixels, noise threshold %s, at least %s per pixel.",
+                pretty_uint(m_convergence_map->get_block_count()).c_str(),
+                pretty_uint(m_params.m_adaptive_block_size).c_str(),
+                pretty_uint(m_params.m_adaptive_block_size).c_str(),
+                pretty_scalar(m_params.m_adaptive_noise_threshold, 4).c_str(),
+                plural(m_params.m_adaptive_min_samples, "sample").c_str());
+        }
+
+        void develop_final_frame()
+        {
+            m_buffer->develop_to_frame(m_frame);
+
+            ImageStack& aov_images = m_frame.aov_images();
+            const size_t aov_index = aov_images.get(ConvergenceMap::AOVName);
+
+            if (aov_index != ~0)
+                m_buffer->develop_convergence_map(aov_images.get_image(aov_index));
+        }
+
         void print_sample_generators_stats() const
         {
             assert(!m_sample_generators.empty());
@@ -31,6 +31,9 @@
 #include "samplegeneratorjob.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalprofiler.h"
+#include "renderer/kernel/aov/imagestack.h"
+#include "renderer/kernel/rendering/progressive/convergencemap.h"
 #include "renderer/kernel/rendering/progressive/samplecounter.h"
 #include "renderer/kernel/rendering/isamplegenerator.h"
 #include "renderer/kernel/rendering/itilecallback.h"
@@ -97,6 +100,8 @@ SampleGeneratorJob::SampleGeneratorJob(
 
 void SampleGeneratorJob::execute(const size_t thread_index)
 {
+    ScopedProfile profile(global_profiler(), "sample generation");
+
     const size_t sample_count =
         m_sample_counter.reserve(compute_sample_count(m_pass));
 
@@ -130,11 +135,17 @@ void SampleGeneratorJob::execute(const size_t thread_index)
     if (m_job_index == 0)
     {
         m_buffer.develop_to_frame(m_frame);
+        develop_convergence_map();
 
         if (m_tile_callback)
             m_tile_callback->post_render(&m_frame);
     }
 
+    // Stop once the whole image has converged.
+    const ConvergenceMap* convergence_map = m_buffer.get_convergence_map();
+    if (convergence_map && convergence_map->is_converged())
+        return;
+
     // This job reschedules itself automatically.
     if (!m_abort_switch.is_aborted())
     {
@@ -153,4 +164,16 @@ void SampleGeneratorJob::execute(const size_t thread_index)
     }
 }
 
+void SampleGeneratorJob::develop_convergence_map()
+{
+    if (m_buffer.get_convergence_map() == 0)
+        return;
+
+    ImageStack& aov_images = m_frame.aov_images();
+    const size_t aov_index = aov_images.get(ConvergenceMap::AOVName);
+
+    if (aov_index != ~0)
+        m_buffer.develop_convergence_map(aov_images.get_image(aov_index));
+}
+
 }   // namespace renderer
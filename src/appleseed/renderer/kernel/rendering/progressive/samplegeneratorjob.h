@@ -77,6 +77,8 @@ class SampleGeneratorJob
     const size_t                    m_job_count;
     const size_t                    m_pass;
     foundation::AbortSwitch&        m_abort_switch;
+
+    void develop_convergence_map();
 };
 
 }       // namespace renderer
@@ -30,6 +30,9 @@
 #ifndef APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLEACCUMULATIONBUFFER_H
 #define APPLESEED_RENDERER_KERNEL_RENDERING_SAMPLEACCUMULATIONBUFFER_H
 
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/progressive/convergencemap.h"
+
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
 #include "foundation/platform/thread.h"
@@ -39,8 +42,9 @@
 #include <cstddef>
 
 // Forward declarations.
-namespace renderer  { class Frame; }
-namespace renderer  { class Sample; }
+namespace foundation    { class Image; }
+namespace renderer      { class Frame; }
+namespace renderer      { class Sample; }
 
 namespace renderer
 {
@@ -49,6 +53,9 @@ class SampleAccumulationBuffer
   : public foundation::NonCopyable
 {
   public:
+    // Constructor.
+    SampleAccumulationBuffer();
+
     // Destructor.
     virtual ~SampleAccumulationBuffer() {}
 
@@ -66,9 +73,20 @@ class SampleAccumulationBuffer
     // Develop the buffer to a frame. Thread-safe.
     virtual void develop_to_frame(Frame& frame) = 0;
 
+    // Attach a convergence map to the buffer, or detach it if @convergence_map is 0.
+    // The map is updated with every batch of stored samples and cleared with the buffer.
+    void set_convergence_map(ConvergenceMap* convergence_map);
+
+    // Return the convergence map attached to the buffer, or 0 if there is none.
+    const ConvergenceMap* get_convergence_map() const;
+
+    // Develop the convergence map to an image. Thread-safe.
+    void develop_convergence_map(foundation::Image& image) const;
+
   protected:
     mutable boost::mutex    m_mutex;
     foundation::uint64      m_sample_count;
+    ConvergenceMap*         m_convergence_map;
 
     void clear_no_lock();
 };
@@ -78,6 +96,12 @@ class SampleAccumulationBuffer
 // SampleAccumulationBufferclass implementation.
 //
 
+inline SampleAccumulationBuffer::SampleAccumulationBuffer()
+  : m_sample_count(0)
+  , m_convergence_map(0)
+{
+}
+
 inline foundation::uint64 SampleAccumulationBuffer::get_sample_count() const
 {
     boost::mutex::scoped_lock lock(m_mutex);
@@ -85,9 +109,32 @@ inline foundation::uint64 SampleAccumulationBuffer::get_sample_count() const
     return m_sample_count;
 }
 
+inline void SampleAccumulationBuffer::set_convergence_map(ConvergenceMap* convergence_map)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    m_convergence_map = convergence_map;
+}
+
+inline const ConvergenceMap* SampleAccumulationBuffer::get_convergence_map() const
+{
+    return m_convergence_map;
+}
+
+inline void SampleAccumulationBuffer::develop_convergence_map(foundation::Image& image) const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    if (m_convergence_map)
+        m_convergence_map->develop_to_image(image);
+}
+
 inline void SampleAccumulationBuffer::clear_no_lock()
 {
     m_sample_count = 0;
+
+    if (m_convergence_map)
+        m_convergence_map->clear();
 }
 
 }       // namespace renderer
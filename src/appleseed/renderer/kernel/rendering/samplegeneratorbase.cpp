@@ -31,6 +31,7 @@
 #include "samplegeneratorbase.h"
 
 // appleseed.renderer headers.
+#include "renderer/kernel/rendering/progressive/convergencemap.h"
 #include "renderer/kernel/rendering/sampleaccumulationbuffer.h"
 
 // appleseed.foundation headers.
@@ -48,6 +49,11 @@ namespace renderer
 namespace
 {
     const size_t SampleBatchSize = 67;
+
+    // When adaptive sampling is enabled, maximum number of sequence indices consumed
+    // per requested sample before returning early. This lets the convergence map catch
+    // up when only a small portion of the image still needs samples.
+    const size_t MaxAdaptiveSampleRejectionRate = 16;
 }
 
 SampleGeneratorBase::SampleGeneratorBase(
@@ -55,6 +61,7 @@ SampleGeneratorBase::SampleGeneratorBase(
     const size_t                generator_count)
   : m_generator_index(generator_index)
   , m_stride((generator_count - 1) * SampleBatchSize)
+  , m_convergence_map(0)
 {
     reset();
 }
@@ -72,16 +79,26 @@ void SampleGeneratorBase::generate_samples(
 {
     assert(sample_count > 0);
 
+    m_convergence_map = buffer.get_convergence_map();
+
+    if (m_convergence_map && m_convergence_map->is_converged())
+        return;
+
     clear_keep_memory(m_samples);
     m_samples.reserve(sample_count);
 
+    const size_t max_attempt_count =
+        m_convergence_map ? sample_count * MaxAdaptiveSampleRejectionRate : ~size_t(0);
+
     size_t stored_sample_count = 0;
+    size_t attempt_count = 0;
 
     while (stored_sample_count < sample_count)
     {
         stored_sample_count += generate_samples(m_sequence_index, m_samples);
 
         ++m_sequence_index;
+        ++attempt_count;
 
         if (++m_current_batch_size == SampleBatchSize)
         {
@@ -90,6 +107,15 @@ void SampleGeneratorBase::generate_samples(
 
             if (abort_switch.is_aborted())
                 break;
+
+            if (m_convergence_map)
+            {
+                if (m_convergence_map->is_converged())
+                    break;
+
+                if (stored_sample_count > 0 && attempt_count >= max_attempt_count)
+                    break;
+            }
         }
     }
 
@@ -97,4 +123,9 @@ void SampleGeneratorBase::generate_samples(
         buffer.store_samples(stored_sample_count, &m_samples[0]);
 }
 
+bool SampleGeneratorBase::is_converged(const Vector2d& point) const
+{
+    return m_convergence_map && m_convergence_map->is_converged(point);
+}
+
 }   // namespace renderer
@@ -34,12 +34,16 @@
 #include "renderer/kernel/rendering/isamplegenerator.h"
 #include "renderer/kernel/rendering/sample.h"
 
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+
 // Standard headers.
 #include <cstddef>
 #include <vector>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
+namespace renderer      { class ConvergenceMap; }
 namespace renderer      { class SampleAccumulationBuffer; }
 
 namespace renderer
@@ -75,12 +79,17 @@ class SampleGeneratorBase
         const size_t                sequence_index,
         SampleVector&               samples) = 0;
 
+    // Return true if the pixel containing a given point (in NDC) has converged and
+    // doesn't need more samples. Always false if the buffer has no convergence map.
+    bool is_converged(const foundation::Vector2d& point) const;
+
   private:
     const size_t                    m_generator_index;
     const size_t                    m_stride;
     size_t                          m_sequence_index;
     size_t                          m_current_batch_size;
     SampleVector                    m_samples;
+    const ConvergenceMap*           m_convergence_map;
 };
 
 }       // namespace renderer
@@ -137,13 +137,17 @@ void ShadingResultFrameBuffer::merge(
 
 void ShadingResultFrameBuffer::develop_to_tile_premult_alpha(
     Tile&                           tile,
-    TileStack&                      aov_tiles) const
+    TileStack&                      aov_tiles,
+    const AABB2u&                   region) const
 {
-    const float* ptr = pixel(0);
+    assert(region.max.x < m_width);
+    assert(region.max.y < m_height);
 
-    for (size_t y = 0; y < m_height; ++y)
+    for (size_t y = region.min.y; y <= region.max.y; ++y)
     {
-        for (size_t x = 0; x < m_width; ++x)
+        const float* ptr = pixel(region.min.x, y);
+
+        for (size_t x = region.min.x; x <= region.max.x; ++x)
         {
             const float weight = *ptr++;
             const float rcp_weight = weight == 0.0f ? 0.0f : 1.0f / weight;
@@ -164,13 +168,17 @@ void ShadingResultFrameBuffer::develop_to_tile_premult_alpha(
 
 void ShadingResultFrameBuffer::develop_to_tile_straight_alpha(
     Tile&                           tile,
-    TileStack&                      aov_tiles) const
+    TileStack&                      aov_tiles,
+    const AABB2u&                   region) const
 {
-    const float* ptr = pixel(0);
+    assert(region.max.x < m_width);
+    assert(region.max.y < m_height);
 
-    for (size_t y = 0; y < m_height; ++y)
+    for (size_t y = region.min.y; y <= region.max.y; ++y)
     {
-        for (size_t x = 0; x < m_width; ++x)
+        const float* ptr = pixel(region.min.x, y);
+
+        for (size_t x = region.min.x; x <= region.max.x; ++x)
         {
             const float weight = *ptr++;
             const float rcp_weight = weight == 0.0f ? 0.0f : 1.0f / weight;
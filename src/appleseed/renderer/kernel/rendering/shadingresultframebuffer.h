@@ -78,13 +78,16 @@ class ShadingResultFrameBuffer
         const size_t                    source_y,
         const float                     scaling);
 
+    // Develop the pixels inside a given region of the tile. The region is expressed in tile space.
     void develop_to_tile_premult_alpha(
         foundation::Tile&               tile,
-        TileStack&                      aov_tiles) const;
+        TileStack&                      aov_tiles,
+        const foundation::AABB2u&       region) const;
 
     void develop_to_tile_straight_alpha(
         foundation::Tile&               tile,
-        TileStack&                      aov_tiles) const;
+        TileStack&                      aov_tiles,
+        const foundation::AABB2u&       region) const;
 
   private:
     const size_t                        m_aov_count;
@@ -31,6 +31,7 @@
 #include "fastambientocclusion.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
 #include "renderer/kernel/tessellation/statictessellation.h"
 #include "renderer/modeling/object/iregion.h"
 #include "renderer/modeling/object/object.h"
@@ -45,12 +46,20 @@
 // appleseed.foundation headers.
 #include "foundation/math/intersection.h"
 #include "foundation/math/sampling.h"
+#include "foundation/math/scalar.h"
 #include "foundation/math/transform.h"
 #include "foundation/utility/foreach.h"
+#include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
 #include "foundation/utility/lazy.h"
 
 // Standard headers.
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -62,32 +71,133 @@ namespace renderer
 // AOVoxelTree class implementation.
 //
 
+namespace
+{
+    // Number of subtrees built per thread, for load balancing.
+    const size_t SubtreesPerThread = 8;
+}
+
+class AOVoxelTree::BuildSubtreeJob
+  : public IJob
+{
+  public:
+    BuildSubtreeJob(
+        const Scene&        scene,
+        const GAABB3&       bbox,
+        const GScalar       max_extent,
+        TreeType&           subtree,
+        AbortSwitch*        abort_switch)
+      : m_scene(scene)
+      , m_bbox(bbox)
+      , m_max_extent(max_extent)
+      , m_subtree(subtree)
+      , m_abort_switch(abort_switch)
+    {
+    }
+
+    virtual void execute(const size_t thread_index)
+    {
+        BuilderType builder(m_subtree, m_bbox, m_max_extent);
+        push_triangles(m_scene, m_bbox, builder, m_abort_switch);
+    }
+
+  private:
+    const Scene&            m_scene;
+    const GAABB3            m_bbox;
+    const GScalar           m_max_extent;
+    TreeType&               m_subtree;
+    AbortSwitch*            m_abort_switch;
+};
+
 AOVoxelTree::AOVoxelTree(
     const Scene&    scene,
-    const GScalar   max_extent_fraction)
+    const GScalar   max_extent_fraction,
+    const size_t    thread_count,
+    AbortSwitch*    abort_switch)
+  : m_build_time(0.0)
+  , m_thread_count(max<size_t>(thread_count, 1))
+  , m_subtree_count(1)
 {
     assert(max_extent_fraction > GScalar(0.0));
 
-    // Print a progress message.
-    RENDERER_LOG_INFO("building ambient occlusion voxel tree...");
-
     // Compute the bounding box of the scene.
     const GAABB3 scene_bbox = scene.compute_bbox();
+    if (!scene_bbox.is_valid())
+        return;
+
+    // Print a progress message.
+    RENDERER_LOG_INFO("building ambient occlusion voxel tree...");
 
     // Compute the maximum extent of a leaf, in world space.
     const GScalar max_extent = max_extent_fraction * max_value(scene_bbox.extent());
 
     // Build the tree.
     BuilderType builder(m_tree, scene_bbox, max_extent);
-    build(scene, builder);
+    if (m_thread_count > 1)
+    {
+        // Subdivide the top of the tree.
+        vector<BuilderType::Leaf> leaves;
+        builder.subdivide(
+            int_log2(next_pow2(m_thread_count * SubtreesPerThread)),
+            leaves);
+        m_subtree_count = leaves.size();
+
+        // Build one subtree per leaf, concurrently.
+        vector<TreeType*> subtrees(leaves.size());
+        {
+            JobQueue job_queue;
+            JobManager job_manager(global_logger(), job_queue, m_thread_count);
+
+            for (size_t i = 0; i < leaves.size(); ++i)
+            {
+                subtrees[i] = new TreeType();
+                job_queue.schedule(
+                    new BuildSubtreeJob(
+                        scene,
+                        leaves[i].m_bbox,
+                        max_extent,
+                        *subtrees[i],
+                        abort_switch));
+            }
+
+            job_manager.start();
+            job_queue.wait_until_completion();
+        }
+
+        // Attach the subtrees to the tree.
+        for (size_t i = 0; i < leaves.size(); ++i)
+        {
+            builder.graft(leaves[i].m_node_index, *subtrees[i]);
+            delete subtrees[i];
+        }
+    }
+    else push_triangles(scene, scene_bbox, builder, abort_switch);
     builder.complete();
 
+    if (is_aborted(abort_switch))
+    {
+        m_tree.clear();
+        return;
+    }
+
+    m_build_time = builder.get_build_time();
+
     // Print statistics.
     TreeStatisticsType tree_stats(m_tree, builder);
     RENDERER_LOG_DEBUG("ambient occlusion voxel tree statistics:");
     tree_stats.print(global_logger());
 }
 
+Statistics AOVoxelTree::get_statistics() const
+{
+    Statistics stats;
+    stats.insert_time("build time", m_build_time);
+    stats.insert("build threads", m_thread_count);
+    stats.insert("subtrees", m_subtree_count);
+    stats.insert_size("size", m_tree.get_memory_size());
+    return stats;
+}
+
 void AOVoxelTree::dump_solid_leaves_to_disk(const string& filename) const
 {
     RENDERER_LOG_INFO(
@@ -170,9 +280,11 @@ namespace
     };
 }
 
-void AOVoxelTree::build(
+void AOVoxelTree::push_triangles(
     const Scene&    scene,
-    BuilderType&    builder)
+    const GAABB3&   bbox,
+    BuilderType&    builder,
+    AbortSwitch*    abort_switch)
 {
     // The voxel tree is built using the scene geometry at the middle of the shutter interval.
     const double time = scene.get_camera()->get_shutter_middle_time();
@@ -186,15 +298,28 @@ void AOVoxelTree::build(
         // Retrieve the assembly.
         const Assembly& assembly = assembly_instance.get_assembly();
 
+        // Compute the assembly space to world space transformation.
+        const Transformd assembly_instance_transform =
+            assembly_instance.transform_sequence().evaluate(time);
+
         // Loop over the object instances of the assembly.
         for (const_each<ObjectInstanceContainer> j = assembly.object_instances(); j; ++j)
         {
+            if (is_aborted(abort_switch))
+                return;
+
             // Retrieve the object instance.
             const ObjectInstance& object_instance = *j;
 
+            // Skip object instances that don't intersect the bounding box.
+            const GAABB3 object_instance_bbox =
+                assembly_instance_transform.to_parent(object_instance.compute_parent_bbox());
+            if (!GAABB3::overlap(object_instance_bbox, bbox))
+                continue;
+
             // Compute the object space to world space transformation.
             const Transformd transform =
-                  assembly_instance.transform_sequence().evaluate(time)
+                  assembly_instance_transform
                 * object_instance.get_transform();
 
             // Retrieve the object.
@@ -213,7 +338,7 @@ void AOVoxelTree::build(
                 // Retrieve the tessellation of the region.
                 Access<StaticTriangleTess> tess(&region->get_static_triangle_tess());
 
-                // Push all triangles of the region into the tree.
+                // Push all triangles of the region that intersect the bounding box into the tree.
                 const size_t triangle_count = tess->m_primitives.size();
                 for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
                 {
@@ -232,7 +357,8 @@ void AOVoxelTree::build(
 
                     // Push the triangle into the tree.
                     TriangleIntersector intersector(v0, v1, v2);
-                    builder.push(intersector);
+                    if (intersector.intersect(bbox))
+                        builder.push(intersector);
                 }
             }
         }
@@ -315,7 +441,7 @@ double compute_fast_ambient_occlusion(
     // Construct the ambient occlusion ray.
     ShadingRay::RayType ray;
     ray.m_org = point;
-    ray.m_tmin = 0.0;
+    ray.m_tmin = static_cast<double>(intersector.get_max_diag_length());
     ray.m_tmax = max_distance;
 
     size_t computed_samples = 0;
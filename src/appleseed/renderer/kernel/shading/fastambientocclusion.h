@@ -35,10 +35,17 @@
 #include "renderer/kernel/shading/shadingray.h"
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/basis.h"
 #include "foundation/math/voxel.h"
+#include "foundation/utility/statistics.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
 
 // Forward declarations.
+namespace foundation    { class AbortSwitch; }
 namespace renderer      { class Scene; }
 
 namespace renderer
@@ -49,16 +56,27 @@ namespace renderer
 //
 
 class AOVoxelTree
+  : public foundation::NonCopyable
 {
   public:
-    // Constructor, build the tree for a given scene.
+    // Constructor, build the tree for a given scene. When thread_count is greater
+    // than one, the top of the tree is subdivided and the resulting subtrees are
+    // built concurrently. If the construction is aborted, the tree is left empty.
     AOVoxelTree(
-        const Scene&        scene,
-        const GScalar       max_extent_fraction);
+        const Scene&                scene,
+        const GScalar               max_extent_fraction,
+        const size_t                thread_count = 1,
+        foundation::AbortSwitch*    abort_switch = 0);
 
     // Return the maximum leaf node diagonal length.
     GScalar get_max_diag_length() const;
 
+    // Return true if the tree is empty (for instance because its construction was aborted).
+    bool empty() const;
+
+    // Retrieve construction statistics.
+    foundation::Statistics get_statistics() const;
+
     // Dump all solid leaves of the tree to disk, as an .obj mesh file.
     void dump_solid_leaves_to_disk(const std::string& filename) const;
 
@@ -68,6 +86,8 @@ class AOVoxelTree
   private:
     friend class AOVoxelTreeIntersector;
 
+    class BuildSubtreeJob;
+
     // Types.
     typedef foundation::voxel::Tree<GScalar, 3> TreeType;
     typedef foundation::voxel::Builder<TreeType> BuilderType;
@@ -79,10 +99,17 @@ class AOVoxelTree
     // Voxel tree.
     TreeType                m_tree;
 
-    // Build the tree.
-    void build(
-        const Scene&        scene,
-        BuilderType&        builder);
+    // Construction statistics.
+    double                  m_build_time;
+    size_t                  m_thread_count;
+    size_t                  m_subtree_count;
+
+    // Push all the triangles of the scene that intersect a given bounding box into a tree.
+    static void push_triangles(
+        const Scene&                scene,
+        const GAABB3&               bbox,
+        BuilderType&                builder,
+        foundation::AbortSwitch*    abort_switch);
 };
 
 
@@ -99,6 +126,9 @@ class AOVoxelTreeIntersector
     // Destructor.
     ~AOVoxelTreeIntersector();
 
+    // Return the maximum leaf node diagonal length of the voxel tree.
+    GScalar get_max_diag_length() const;
+
     // Trace a world space ray through the voxel tree.
     bool trace(
         ShadingRay::RayType ray,
@@ -125,6 +155,9 @@ class AOVoxelTreeIntersector
 //
 // Compute fast ambient occlusion at a given point in space.
 //
+// Occluders closer to the point than the diagonal of the largest leaf of the
+// voxel tree are ignored, since the point itself lies in a solid leaf.
+//
 // todo: implement optional computation of the mean unoccluded direction.
 //
 
@@ -148,6 +181,21 @@ inline GScalar AOVoxelTree::get_max_diag_length() const
     return m_tree.get_max_diag_length();
 }
 
+inline bool AOVoxelTree::empty() const
+{
+    return !m_tree.get_bbox().is_valid();
+}
+
+
+//
+// AOVoxelTreeIntersector class implementation.
+//
+
+inline GScalar AOVoxelTreeIntersector::get_max_diag_length() const
+{
+    return m_tree.get_max_diag_length();
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_SHADING_FASTAMBIENTOCCLUSION_H
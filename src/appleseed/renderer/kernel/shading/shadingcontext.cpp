@@ -36,6 +36,8 @@
 #include "renderer/modeling/shadergroup/shadergroup.h"
 #endif
 
+using namespace foundation;
+
 namespace renderer
 {
 
@@ -71,6 +73,8 @@ void ShadingContext::execute_osl_shadergroup(
     const ShaderGroup&          shader_group,
     const ShadingPoint&         shading_point) const
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_osl_cycles);
+
     m_shadergroup_exec.execute(
         shader_group,
         shading_point);
@@ -78,4 +82,19 @@ void ShadingContext::execute_osl_shadergroup(
 
 #endif
 
+StatisticsVector ShadingContext::get_statistics() const
+{
+    StatisticsVector vec;
+
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+    Statistics time_stats;
+    m_shading_cycles.insert_statistics(time_stats, "shading");
+    m_direct_lighting_cycles.insert_statistics(time_stats, "direct lighting");
+    m_osl_cycles.insert_statistics(time_stats, "osl execution");
+    vec.insert("time breakdown statistics", time_stats);
+#endif
+
+    return vec;
+}
+
 }   // namespace renderer
@@ -34,9 +34,11 @@
 #ifdef WITH_OSL
 #include "renderer/kernel/shading/oslshadergroupexec.h"
 #endif
+#include "renderer/utility/cyclecounter.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/utility/statistics.h"
 
 // Standard headers.
 #include <cstddef>
@@ -90,7 +92,14 @@ class ShadingContext
         const ShaderGroup&      shader_group, 
         const ShadingPoint&     shading_point) const;
 #endif
-    
+
+    // Per-thread time breakdown counters, see renderer/utility/cyclecounter.h.
+    CycleCounter& get_shading_cycle_counter() const;
+    CycleCounter& get_direct_lighting_cycle_counter() const;
+
+    // Retrieve performance statistics.
+    foundation::StatisticsVector get_statistics() const;
+
   private:
     const Intersector&          m_intersector;
     Tracer&                     m_tracer;
@@ -102,6 +111,10 @@ class ShadingContext
 #ifdef WITH_OSL
     OSLShaderGroupExec&         m_shadergroup_exec;
 #endif
+
+    mutable CycleCounter        m_shading_cycles;
+    mutable CycleCounter        m_direct_lighting_cycles;
+    mutable CycleCounter        m_osl_cycles;
 };
 
 inline const Intersector& ShadingContext::get_intersector() const
@@ -134,6 +147,16 @@ inline size_t ShadingContext::get_max_iterations() const
     return m_max_iterations;
 }
 
+inline CycleCounter& ShadingContext::get_shading_cycle_counter() const
+{
+    return m_shading_cycles;
+}
+
+inline CycleCounter& ShadingContext::get_direct_lighting_cycle_counter() const
+{
+    return m_direct_lighting_cycles;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_SHADING_SHADINGCONTEXT_H
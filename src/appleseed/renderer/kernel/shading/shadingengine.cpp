@@ -86,6 +86,8 @@ void ShadingEngine::shade_hit_point(
     const ShadingPoint&     shading_point,
     ShadingResult&          shading_result) const
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(shading_context.get_shading_cycle_counter());
+
     // Retrieve the material of the intersected surface.
     const Material* material = shading_point.get_material();
 
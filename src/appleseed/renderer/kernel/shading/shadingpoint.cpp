@@ -146,9 +146,9 @@ void ShadingPoint::fetch_source_geometry() const
     assert(triangle.m_n0 != Triangle::None);
     assert(triangle.m_n1 != Triangle::None);
     assert(triangle.m_n2 != Triangle::None);
-    m_n0 = tess.m_vertex_normals[triangle.m_n0];
-    m_n1 = tess.m_vertex_normals[triangle.m_n1];
-    m_n2 = tess.m_vertex_normals[triangle.m_n2];
+    m_n0 = tess.get_vertex_normal(triangle.m_n0);
+    m_n1 = tess.get_vertex_normal(triangle.m_n1);
+    m_n2 = tess.get_vertex_normal(triangle.m_n2);
     assert(is_normalized(m_n0));
     assert(is_normalized(m_n1));
     assert(is_normalized(m_n2));
@@ -36,11 +36,15 @@
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/octahedral.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/attributeset.h"
 #include "foundation/utility/lazy.h"
-#include "foundation/utility/numerictype.h"
 #include "foundation/utility/poolallocator.h"
 
+// OpenEXR headers.
+#include "OpenEXR/half.h"
+
 // Standard headers.
 #include <cassert>
 #include <cstddef>
@@ -52,6 +56,11 @@ namespace renderer
 //
 // A tessellation as a collection of polygonal primitives.
 //
+// Vertex data is stored as a structure of arrays: each per-vertex feature
+// (positions, normals, UV coordinates, motion poses) lives in its own tightly
+// packed array. Vertex normals can optionally be stored as 32-bit octahedral
+// encodings and UV coordinates as pairs of half-precision floats.
+//
 
 template <typename Primitive>
 class StaticTessellation
@@ -68,7 +77,6 @@ class StaticTessellation
 
     // Primary features.
     VectorArray                 m_vertices;
-    VectorArray                 m_vertex_normals;
     PrimitiveArray              m_primitives;
 
     // Custom attributes.
@@ -79,6 +87,21 @@ class StaticTessellation
     // Constructor.
     StaticTessellation();
 
+    // Choose how vertex normals and UV coordinates are stored.
+    // This method must be called before any vertex normal or UV vertex is inserted.
+    void set_storage_options(
+        const bool      compact_vertex_normals,         // store vertex normals in 32 bits
+        const bool      half_precision_uvs);            // store UV coordinates as half floats
+
+    // Insert and access vertex normals.
+    void reserve_vertex_normals(const size_t count);
+    size_t push_vertex_normal(const GVector3& normal);  // the normal must be unit-length
+    size_t get_vertex_normal_count() const;
+    GVector3 get_vertex_normal(const size_t index) const;
+
+    // Reserve memory for a given number of UV vertices.
+    void reserve_uv_vertices(const size_t count);
+
     // Append a UV vertex to this tessellation.
     size_t push_uv_vertex(const GVector2& uv);
 
@@ -114,18 +137,16 @@ class StaticTessellation
     GAABB3 compute_local_bbox() const;
 
   private:
-    foundation::AttributeSet::ChannelID m_uv_0_cid;         // UV coordinates set #0
-    foundation::AttributeSet::ChannelID m_ms_count_cid;     // motion segment count
-    foundation::AttributeSet::ChannelID m_vp_cid;           // vertex poses
-
-    // Create a vertex attribute to store the UV coordinates set #0.
-    void create_uv_0_attribute();
+    bool                                m_compact_vertex_normals;
+    bool                                m_half_precision_uvs;
 
-    // Create a tessellation attribute to store the number of motion segments used in this tessellation.
-    void create_motion_segment_count_attribute();
+    VectorArray                         m_vertex_normals;           // full precision vertex normals
+    std::vector<foundation::uint32>     m_packed_vertex_normals;    // octahedral-encoded vertex normals
+    std::vector<GVector2>               m_uvs;                      // full precision UV coordinates set #0
+    std::vector<half>                   m_packed_uvs;               // half precision UV coordinates set #0, two per vertex
 
-    // Create a vertex attribute to store vertex poses.
-    void create_vertex_poses_attribute();
+    size_t                              m_motion_segment_count;
+    VectorArray                         m_vertex_poses;             // motion_segment_count poses per vertex
 };
 
 // Specialization of the StaticTessellation class for triangles.
@@ -150,61 +171,118 @@ typedef foundation::AccessCache<
 
 template <typename Primitive>
 inline StaticTessellation<Primitive>::StaticTessellation()
-  : m_uv_0_cid(foundation::AttributeSet::InvalidChannelID)
-  , m_ms_count_cid(foundation::AttributeSet::InvalidChannelID)
-  , m_vp_cid(foundation::AttributeSet::InvalidChannelID)
+  : m_compact_vertex_normals(false)
+  , m_half_precision_uvs(false)
+  , m_motion_segment_count(0)
 {
 }
 
 template <typename Primitive>
-inline size_t StaticTessellation<Primitive>::push_uv_vertex(const GVector2& uv)
+inline void StaticTessellation<Primitive>::set_storage_options(
+    const bool      compact_vertex_normals,
+    const bool      half_precision_uvs)
 {
-    if (m_uv_0_cid == foundation::AttributeSet::InvalidChannelID)
-        create_uv_0_attribute();
+    assert(get_vertex_normal_count() == 0);
+    assert(get_uv_vertex_count() == 0);
 
-    return m_vertex_attributes.push_attribute(m_uv_0_cid, uv);
+    m_compact_vertex_normals = compact_vertex_normals;
+    m_half_precision_uvs = half_precision_uvs;
 }
 
 template <typename Primitive>
-inline size_t StaticTessellation<Primitive>::get_uv_vertex_count() const
+inline void StaticTessellation<Primitive>::reserve_vertex_normals(const size_t count)
 {
-    if (m_uv_0_cid == foundation::AttributeSet::InvalidChannelID)
-        return 0;
+    if (m_compact_vertex_normals)
+        m_packed_vertex_normals.reserve(count);
+    else m_vertex_normals.reserve(count);
+}
+
+template <typename Primitive>
+inline size_t StaticTessellation<Primitive>::push_vertex_normal(const GVector3& normal)
+{
+    const size_t index = get_vertex_normal_count();
 
-    return m_vertex_attributes.get_attribute_count(m_uv_0_cid);
+    if (m_compact_vertex_normals)
+        m_packed_vertex_normals.push_back(foundation::pack_unit_vector_octahedral(normal));
+    else m_vertex_normals.push_back(normal);
+
+    return index;
 }
 
 template <typename Primitive>
-inline GVector2 StaticTessellation<Primitive>::get_uv_vertex(const size_t index) const
+inline size_t StaticTessellation<Primitive>::get_vertex_normal_count() const
 {
-    if (m_uv_0_cid == foundation::AttributeSet::InvalidChannelID)
-        return GVector2(0.0);
+    return
+        m_compact_vertex_normals
+            ? m_packed_vertex_normals.size()
+            : m_vertex_normals.size();
+}
 
-    GVector2 uv;
-    m_vertex_attributes.get_attribute(m_uv_0_cid, index, &uv);
+template <typename Primitive>
+inline GVector3 StaticTessellation<Primitive>::get_vertex_normal(const size_t index) const
+{
+    return
+        m_compact_vertex_normals
+            ? foundation::unpack_unit_vector_octahedral<GScalar>(m_packed_vertex_normals[index])
+            : m_vertex_normals[index];
+}
 
-    return uv;
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::reserve_uv_vertices(const size_t count)
+{
+    if (m_half_precision_uvs)
+        m_packed_uvs.reserve(2 * count);
+    else m_uvs.reserve(count);
 }
 
 template <typename Primitive>
-inline void StaticTessellation<Primitive>::set_motion_segment_count(const size_t count)
+inline size_t StaticTessellation<Primitive>::push_uv_vertex(const GVector2& uv)
 {
-    if (m_ms_count_cid == foundation::AttributeSet::InvalidChannelID)
-        create_motion_segment_count_attribute();
+    const size_t index = get_uv_vertex_count();
+
+    if (m_half_precision_uvs)
+    {
+        m_packed_uvs.push_back(half(static_cast<float>(uv[0])));
+        m_packed_uvs.push_back(half(static_cast<float>(uv[1])));
+    }
+    else m_uvs.push_back(uv);
 
-    m_tessellation_attributes.set_attribute(m_ms_count_cid, 0, static_cast<foundation::uint32>(count));
+    return index;
 }
 
 template <typename Primitive>
-inline size_t StaticTessellation<Primitive>::get_motion_segment_count() const
+inline size_t StaticTessellation<Primitive>::get_uv_vertex_count() const
 {
-    if (m_ms_count_cid == foundation::AttributeSet::InvalidChannelID)
-        return 0;
+    return
+        m_half_precision_uvs
+            ? m_packed_uvs.size() / 2
+            : m_uvs.size();
+}
 
-    foundation::uint32 count;
-    m_tessellation_attributes.get_attribute(m_ms_count_cid, 0, &count);
+template <typename Primitive>
+inline GVector2 StaticTessellation<Primitive>::get_uv_vertex(const size_t index) const
+{
+    if (m_half_precision_uvs)
+    {
+        return
+            GVector2(
+                static_cast<GScalar>(static_cast<float>(m_packed_uvs[2 * index + 0])),
+                static_cast<GScalar>(static_cast<float>(m_packed_uvs[2 * index + 1])));
+    }
+
+    return m_uvs[index];
+}
+
+template <typename Primitive>
+inline void StaticTessellation<Primitive>::set_motion_segment_count(const size_t count)
+{
+    m_motion_segment_count = count;
+}
 
-    return count;
+template <typename Primitive>
+inline size_t StaticTessellation<Primitive>::get_motion_segment_count() const
+{
+    return m_motion_segment_count;
 }
 
 template <typename Primitive>
@@ -213,18 +291,15 @@ inline void StaticTessellation<Primitive>::set_vertex_pose(
     const size_t    motion_segment_index,
     const GVector3& v)
 {
-    const size_t motion_segment_count = get_motion_segment_count();
-
     assert(vertex_index < m_vertices.size());
-    assert(motion_segment_index < motion_segment_count);
+    assert(motion_segment_index < m_motion_segment_count);
 
-    if (m_vp_cid == foundation::AttributeSet::InvalidChannelID)
-        create_vertex_poses_attribute();
+    const size_t pose_count = m_vertices.size() * m_motion_segment_count;
 
-    m_vertex_attributes.set_attribute(
-        m_vp_cid,
-        vertex_index * motion_segment_count + motion_segment_index,
-        v);
+    if (m_vertex_poses.size() != pose_count)
+        m_vertex_poses.resize(pose_count, GVector3(0.0));
+
+    m_vertex_poses[vertex_index * m_motion_segment_count + motion_segment_index] = v;
 }
 
 template <typename Primitive>
@@ -232,31 +307,19 @@ inline GVector3 StaticTessellation<Primitive>::get_vertex_pose(
     const size_t    vertex_index,
     const size_t    motion_segment_index) const
 {
-    const size_t motion_segment_count = get_motion_segment_count();
-
     assert(vertex_index < m_vertices.size());
-    assert(motion_segment_index < motion_segment_count);
+    assert(motion_segment_index < m_motion_segment_count);
 
-    if (m_vp_cid == foundation::AttributeSet::InvalidChannelID)
+    if (m_vertex_poses.empty())
         return GVector3(0.0);
 
-    GVector3 v;
-    m_vertex_attributes.get_attribute(
-        m_vp_cid,
-        vertex_index * motion_segment_count + motion_segment_index,
-        &v);
-
-    return v;
+    return m_vertex_poses[vertex_index * m_motion_segment_count + motion_segment_index];
 }
 
 template <typename Primitive>
 void StaticTessellation<Primitive>::clear_vertex_poses()
 {
-    if (m_vp_cid != foundation::AttributeSet::InvalidChannelID)
-    {
-        m_vertex_attributes.delete_channel(m_vp_cid);
-        m_vp_cid = foundation::AttributeSet::InvalidChannelID;
-    }
+    VectorArray().swap(m_vertex_poses);
 }
 
 template <typename Primitive>
@@ -266,49 +329,16 @@ GAABB3 StaticTessellation<Primitive>::compute_local_bbox() const
     bbox.invalidate();
 
     const size_t vertex_count = m_vertices.size();
-    const size_t motion_segment_count = get_motion_segment_count();
 
     for (size_t i = 0; i < vertex_count; ++i)
-    {
         bbox.insert(m_vertices[i]);
 
-        for (size_t j = 0; j < motion_segment_count; ++j)
-            bbox.insert(get_vertex_pose(i, j));
-    }
+    for (size_t i = 0, e = m_vertex_poses.size(); i < e; ++i)
+        bbox.insert(m_vertex_poses[i]);
 
     return bbox;
 }
 
-template <typename Primitive>
-void StaticTessellation<Primitive>::create_uv_0_attribute()
-{
-    m_uv_0_cid =
-        m_vertex_attributes.create_channel(
-            "uv_0",
-            foundation::NumericType::id<GVector2::ValueType>(),
-            2);
-}
-
-template <typename Primitive>
-void StaticTessellation<Primitive>::create_motion_segment_count_attribute()
-{
-    m_ms_count_cid = 
-        m_tessellation_attributes.create_channel(
-            "motion_segment_count",
-            foundation::NumericTypeUInt32,
-            1);
-}
-
-template <typename Primitive>
-void StaticTessellation<Primitive>::create_vertex_poses_attribute()
-{
-    m_vp_cid =
-        m_vertex_attributes.create_channel(
-            "vertex_poses",
-            foundation::NumericType::id<GVector3::ValueType>(),
-            3);
-}
-
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_KERNEL_TESSELLATION_STATICTESSELLATION_H
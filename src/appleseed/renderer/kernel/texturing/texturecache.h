@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/utility/cyclecounter.h"
 
 // appleseed.foundation headers.
 #include "foundation/core/concepts/noncopyable.h"
@@ -114,6 +115,7 @@ class TextureCache
     TileKeyHasher           m_tile_key_hasher;
     TileRecordSwapper       m_tile_record_swapper;
     TileCache               m_tile_cache;
+    CycleCounter            m_get_cycles;
 };
 
 
@@ -133,16 +135,27 @@ inline foundation::Tile& TextureCache::get(
     const size_t                    tile_x,
     const size_t                    tile_y)
 {
+    RENDERER_CYCLE_COUNTER_SCOPE(m_get_cycles);
+
     const TileKey key(assembly_uid, texture_uid, tile_x, tile_y);
     return *m_tile_cache.get(key)->m_tile;
 }
 
 inline foundation::StatisticsVector TextureCache::get_statistics() const
 {
-    return
-        foundation::StatisticsVector::make(
-            "texture cache statistics",
-            foundation::make_single_stage_cache_stats(m_tile_cache));
+    foundation::StatisticsVector vec;
+
+    vec.insert(
+        "texture cache statistics",
+        foundation::make_single_stage_cache_stats(m_tile_cache));
+
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+    foundation::Statistics time_stats;
+    m_get_cycles.insert_statistics(time_stats, "texture lookup");
+    vec.insert("time breakdown statistics", time_stats);
+#endif
+
+    return vec;
 }
 
 inline foundation::uint64 TextureCache::get_hit_count() const
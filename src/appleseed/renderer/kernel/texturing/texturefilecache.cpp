@@ -0,0 +1,268 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "texturefilecache.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exception.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/exrimagefilewriter.h"
+#include "foundation/image/exrutils.h"
+#include "foundation/image/genericprogressiveimagefilereader.h"
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/hash.h"
+#include "foundation/platform/timer.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+// Standard headers.
+#include <cassert>
+#include <cstdio>
+#include <memory>
+
+using namespace boost;
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// TextureFileCache class implementation.
+//
+
+namespace
+{
+    // Create a floating-point copy of a tile, converted to the linear RGB color space.
+    Tile* create_linear_rgb_tile(const Tile& source_tile, const ColorSpace color_space)
+    {
+        assert(source_tile.get_channel_count() == 3 || source_tile.get_channel_count() == 4);
+
+        const size_t channel_count = source_tile.get_channel_count();
+        const size_t pixel_count = source_tile.get_pixel_count();
+
+        // 8-bit and 16-bit sRGB pixels are linearized with lookup tables.
+        if (color_space == ColorSpaceSRGB &&
+            (source_tile.get_pixel_format() == PixelFormatUInt8 ||
+             source_tile.get_pixel_format() == PixelFormatUInt16))
+        {
+            Tile* tile =
+                new Tile(
+                    source_tile.get_width(),
+                    source_tile.get_height(),
+                    channel_count,
+                    PixelFormatFloat);
+
+            float* output = reinterpret_cast<float*>(tile->get_storage());
+
+            if (source_tile.get_pixel_format() == PixelFormatUInt8)
+                convert_srgb_to_linear_rgb(source_tile.get_storage(), output, pixel_count, channel_count);
+            else
+            {
+                convert_srgb_to_linear_rgb(
+                    reinterpret_cast<const uint16*>(source_tile.get_storage()),
+                    output,
+                    pixel_count,
+                    channel_count);
+            }
+
+            return tile;
+        }
+
+        Tile* tile = new Tile(source_tile, PixelFormatFloat);
+        float* pixels = reinterpret_cast<float*>(tile->get_storage());
+
+        if (color_space == ColorSpaceSRGB)
+            convert_srgb_to_linear_rgb(pixels, pixel_count, channel_count);
+        else if (color_space == ColorSpaceCIEXYZ)
+            convert_ciexyz_to_linear_rgb(pixels, pixel_count, channel_count);
+
+        return tile;
+    }
+}
+
+TextureFileCache::TextureFileCache(
+    const string&           directory,
+    const PixelFormat       pixel_format,
+    const size_t            tile_width,
+    const size_t            tile_height)
+  : m_directory(directory)
+  , m_pixel_format(pixel_format)
+  , m_tile_width(tile_width)
+  , m_tile_height(tile_height)
+{
+    assert(pixel_format == PixelFormatHalf || pixel_format == PixelFormatFloat);
+    assert(tile_width > 0);
+    assert(tile_height > 0);
+}
+
+bool TextureFileCache::needs_conversion(const string& filepath)
+{
+    const string extension = lower_case(filesystem::path(filepath).extension().string());
+
+    if (extension == ".png")
+        return true;
+
+    if (extension == ".exr")
+        return !is_tiled_openexr_file(filepath.c_str());
+
+    return false;
+}
+
+string TextureFileCache::get_cache_file(
+    const string&           filepath,
+    const ColorSpace        color_space) const
+{
+    const string cache_filepath = get_cache_file_path(filepath, color_space);
+
+    if (!filesystem::exists(cache_filepath))
+    {
+        // Write to a temporary file first so that other processes sharing the cache
+        // directory never see a partially written cache file. The name of the temporary
+        // file is randomized so that concurrent conversions never write to the same file.
+        const string temp_filepath =
+            filesystem::unique_path(cache_filepath + ".%%%%-%%%%-%%%%-%%%%.tmp").string();
+
+        try
+        {
+            convert(filepath, color_space, temp_filepath);
+            filesystem::rename(temp_filepath, cache_filepath);
+        }
+        catch (const filesystem::filesystem_error& e)
+        {
+            filesystem::remove(temp_filepath);
+            throw Exception(e.what());
+        }
+        catch (...)
+        {
+            filesystem::remove(temp_filepath);
+            throw;
+        }
+    }
+
+    return cache_filepath;
+}
+
+string TextureFileCache::get_cache_file_path(
+    const string&           filepath,
+    const ColorSpace        color_space) const
+{
+    const filesystem::path source_path = filesystem::absolute(filepath);
+
+    // Hash the path and the modification time of the source file, as well as
+    // all the settings that affect the content of the cache file.
+    uint64 key = static_cast<uint64>(filesystem::last_write_time(source_path));
+    const string source_path_string = source_path.string();
+    for (size_t i = 0; i < source_path_string.size(); ++i)
+        key = mix_uint64(key, static_cast<uint64>(source_path_string[i]));
+    key = mix_uint64(key, color_space, m_pixel_format);
+    key = mix_uint64(key, m_tile_width, m_tile_height);
+
+    char key_string[17];
+    sprintf(key_string, "%016llx", static_cast<unsigned long long>(key));
+
+    const string cache_filename =
+        source_path.stem().string() + "." + key_string + ".tiled.exr";
+
+    return (filesystem::path(m_directory) / cache_filename).string();
+}
+
+void TextureFileCache::convert(
+    const string&           filepath,
+    const ColorSpace        color_space,
+    const string&           cache_filepath) const
+{
+    RENDERER_LOG_INFO(
+        "converting texture file %s to tiled texture file %s...",
+        filepath.c_str(),
+        cache_filepath.c_str());
+
+    Stopwatch<DefaultWallclockTimer> stopwatch;
+    stopwatch.start();
+
+    GenericProgressiveImageFileReader reader(&global_logger());
+    reader.open(filepath.c_str());
+
+    CanvasProperties props;
+    reader.read_canvas_properties(props);
+
+    if (props.m_channel_count != 3 && props.m_channel_count != 4)
+        throw Exception("unsupported number of channels");
+
+    // Read the whole texture in floating-point format and linearize it.
+    Image linear_image(
+        props.m_canvas_width,
+        props.m_canvas_height,
+        props.m_tile_width,
+        props.m_tile_height,
+        props.m_channel_count,
+        PixelFormatFloat);
+
+    for (size_t ty = 0; ty < props.m_tile_count_y; ++ty)
+    {
+        for (size_t tx = 0; tx < props.m_tile_count_x; ++tx)
+        {
+            auto_ptr<Tile> source_tile(reader.read_tile(tx, ty));
+            linear_image.set_tile(tx, ty, create_linear_rgb_tile(*source_tile, color_space));
+        }
+    }
+
+    reader.close();
+
+    // Retile the texture and convert it to the cache's pixel format.
+    const Image cache_image(
+        linear_image,
+        m_tile_width,
+        m_tile_height,
+        m_pixel_format);
+
+    filesystem::create_directories(filesystem::path(cache_filepath).parent_path());
+
+    EXRImageFileWriter writer;
+    writer.write(cache_filepath.c_str(), cache_image);
+
+    stopwatch.measure();
+
+    RENDERER_LOG_INFO(
+        "converted texture file %s in %s.",
+        filepath.c_str(),
+        pretty_time(stopwatch.get_seconds()).c_str());
+}
+
+}   // namespace renderer
@@ -0,0 +1,94 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_KERNEL_TEXTURING_TEXTUREFILECACHE_H
+#define APPLESEED_RENDERER_KERNEL_TEXTURING_TEXTUREFILECACHE_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/image/colorspace.h"
+#include "foundation/image/pixel.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+
+namespace renderer
+{
+
+//
+// A persistent, on-disk cache of tiled texture files.
+//
+// Texture files that can't be read one tile at a time (PNG files, scanline OpenEXR
+// files) are converted on first use to tiled OpenEXR files in the linear RGB color
+// space. Cache files are keyed by the path and the modification time of the source
+// file so that they are rebuilt when the source file changes, and they are reused
+// across renders and processes.
+//
+
+class TextureFileCache
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    TextureFileCache(
+        const std::string&              directory,
+        const foundation::PixelFormat   pixel_format,       // PixelFormatHalf or PixelFormatFloat
+        const size_t                    tile_width,
+        const size_t                    tile_height);
+
+    // Return true if a texture file cannot be read one tile at a time.
+    static bool needs_conversion(const std::string& filepath);
+
+    // Return the path to the cache file of a given texture file, creating the cache
+    // file if it doesn't exist yet. The texture file is assumed to be in the given
+    // color space; the cache file is always in the linear RGB color space.
+    // Throws a foundation::Exception on failure.
+    std::string get_cache_file(
+        const std::string&              filepath,
+        const foundation::ColorSpace    color_space) const;
+
+  private:
+    const std::string                   m_directory;
+    const foundation::PixelFormat       m_pixel_format;
+    const size_t                        m_tile_width;
+    const size_t                        m_tile_height;
+
+    std::string get_cache_file_path(
+        const std::string&              filepath,
+        const foundation::ColorSpace    color_space) const;
+
+    void convert(
+        const std::string&              filepath,
+        const foundation::ColorSpace    color_space,
+        const std::string&              cache_filepath) const;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_KERNEL_TEXTURING_TEXTUREFILECACHE_H
@@ -41,6 +41,7 @@
 #include "foundation/image/color.h"
 #include "foundation/image/colorspace.h"
 #include "foundation/image/tile.h"
+#include "foundation/platform/timer.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/memory.h"
@@ -71,10 +72,65 @@ TextureStore::TextureStore(
 
 StatisticsVector TextureStore::get_statistics() const
 {
+    boost::mutex::scoped_lock lock(m_mutex);
+
     Statistics stats = make_single_stage_cache_stats(m_tile_cache);
     stats.insert_size("peak size", m_tile_swapper.get_peak_memory_size());
 
-    return StatisticsVector::make("texture store statistics", stats);
+    StatisticsVector vec = StatisticsVector::make("texture store statistics", stats);
+    vec.insert("texture loading statistics", m_tile_swapper.get_texture_statistics());
+
+    return vec;
+}
+
+void TextureStore::load_tile(const TileKey& key, TileRecord& record)
+{
+    double load_seconds;
+    Tile* tile;
+
+    try
+    {
+        tile = m_tile_swapper.load_tile(key, load_seconds);
+    }
+    catch (...)
+    {
+        // Let the next thread that needs this tile try to load it again.
+        boost::mutex::scoped_lock lock(m_mutex);
+        record.m_state = TileRecord::Empty;
+        boost_atomic::atomic_dec32(&record.m_owners);
+        m_tile_loaded.notify_all();
+        throw;
+    }
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    record.m_tile = tile;
+    record.m_state = TileRecord::Loaded;
+    m_tile_swapper.on_tile_loaded(key, record, load_seconds);
+
+    m_tile_loaded.notify_all();
+}
+
+void TextureStore::wait_for_tile(const TileKey& key, TileRecord& record)
+{
+    DefaultWallclockTimer timer;
+    const uint64 begin = timer.read();
+
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    while (record.m_state == TileRecord::Loading)
+        m_tile_loaded.wait(lock);
+
+    const uint64 end = timer.read();
+    m_tile_swapper.on_tile_waited(key, static_cast<double>(end - begin) / timer.frequency());
+
+    if (record.m_state == TileRecord::Empty)
+    {
+        // The thread that was loading this tile failed, try loading it ourselves.
+        record.m_state = TileRecord::Loading;
+        lock.unlock();
+        load_tile(key, record);
+    }
 }
 
 
@@ -84,7 +140,7 @@ StatisticsVector TextureStore::get_statistics() const
 
 namespace
 {
-    // Convert a tile from the sRGB color space to the linear RGB color space.
+    // Convert a tile from the sRGB color space to the linear RGB color space, in its own pixel format.
     void convert_tile_srgb_to_linear_rgb(Tile& tile)
     {
         const size_t pixel_count = tile.get_pixel_count();
@@ -113,7 +169,7 @@ namespace
         }
     }
 
-    // Convert a tile from the CIE XYZ color space to the linear RGB color space.
+    // Convert a tile from the CIE XYZ color space to the linear RGB color space, in its own pixel format.
     void convert_tile_ciexyz_to_linear_rgb(Tile& tile)
     {
         const size_t pixel_count = tile.get_pixel_count();
@@ -141,6 +197,93 @@ namespace
             }
         }
     }
+
+    // Convert an 8-bit or 16-bit sRGB tile to a floating-point linear RGB tile using lookup tables.
+    template <typename T>
+    Tile* widen_tile_srgb_to_linear_rgb(const Tile& tile)
+    {
+        Tile* result =
+            new Tile(
+                tile.get_width(),
+                tile.get_height(),
+                tile.get_channel_count(),
+                PixelFormatFloat);
+
+        convert_srgb_to_linear_rgb(
+            reinterpret_cast<const T*>(tile.get_storage()),
+            reinterpret_cast<float*>(result->get_storage()),
+            tile.get_pixel_count(),
+            tile.get_channel_count());
+
+        return result;
+    }
+
+    // Convert a tile to the linear RGB color space. The returned tile may be a new tile,
+    // in which case the input tile has been deleted. 8-bit and 16-bit sRGB tiles are only
+    // widened to floating-point if widen_srgb_tiles is true. Otherwise 8-bit sRGB tiles are
+    // left unchanged and linearized at lookup time, and 16-bit sRGB tiles are converted
+    // in their own pixel format.
+    Tile* convert_tile_to_linear_rgb(
+        Tile*               tile,
+        const ColorSpace    color_space,
+        const bool          widen_srgb_tiles)
+    {
+        switch (color_space)
+        {
+          case ColorSpaceLinearRGB:
+            return tile;
+
+          case ColorSpaceSRGB:
+            switch (tile->get_pixel_format())
+            {
+              case PixelFormatUInt8:
+                if (widen_srgb_tiles)
+                {
+                    Tile* result = widen_tile_srgb_to_linear_rgb<uint8>(*tile);
+                    delete tile;
+                    return result;
+                }
+                return tile;
+
+              case PixelFormatUInt16:
+                if (widen_srgb_tiles)
+                {
+                    Tile* result = widen_tile_srgb_to_linear_rgb<uint16>(*tile);
+                    delete tile;
+                    return result;
+                }
+                convert_tile_srgb_to_linear_rgb(*tile);
+                return tile;
+
+              case PixelFormatFloat:
+                convert_srgb_to_linear_rgb(
+                    reinterpret_cast<float*>(tile->get_storage()),
+                    tile->get_pixel_count(),
+                    tile->get_channel_count());
+                return tile;
+
+              default:
+                convert_tile_srgb_to_linear_rgb(*tile);
+                return tile;
+            }
+
+          case ColorSpaceCIEXYZ:
+            if (tile->get_pixel_format() == PixelFormatFloat)
+            {
+                convert_ciexyz_to_linear_rgb(
+                    reinterpret_cast<float*>(tile->get_storage()),
+                    tile->get_pixel_count(),
+                    tile->get_channel_count());
+            }
+            else convert_tile_ciexyz_to_linear_rgb(*tile);
+            return tile;
+
+          assert_otherwise;
+        }
+
+        // Keep the compiler happy.
+        return tile;
+    }
 }
 
 TextureStore::TileSwapper::TileSwapper(
@@ -156,14 +299,18 @@ TextureStore::TileSwapper::TileSwapper(
 
 void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
 {
-    // Fetch the texture container.
-    const TextureContainer& textures =
-        key.m_assembly_uid == ~0
-            ? m_scene.textures()
-            : m_assemblies[key.m_assembly_uid]->textures();
+    record.m_tile = 0;
+    record.m_owners = 0;
+    record.m_state = TileRecord::Empty;
+}
+
+Tile* TextureStore::TileSwapper::load_tile(const TileKey& key, double& load_seconds) const
+{
+    DefaultWallclockTimer timer;
+    const uint64 begin = timer.read();
 
     // Fetch the texture.
-    Texture* texture = textures.get_by_uid(key.m_texture_uid);
+    Texture* texture = get_texture(key);
 
     if (m_params.m_track_tile_loading)
     {
@@ -176,25 +323,32 @@ void TextureStore::TileSwapper::load(const TileKey& key, TileRecord& record)
     }
 
     // Load the tile.
-    record.m_tile = texture->load_tile(key.get_tile_x(), key.get_tile_y());
-    record.m_owners = 0;
+    Tile* tile = texture->load_tile(key.get_tile_x(), key.get_tile_y());
 
     // Convert the tile to the linear RGB color space.
-    switch (texture->get_color_space())
-    {
-      case ColorSpaceLinearRGB:
-        break;
+    tile =
+        convert_tile_to_linear_rgb(
+            tile,
+            texture->get_color_space(),
+            m_params.m_widen_srgb_tiles);
 
-      case ColorSpaceSRGB:
-        convert_tile_srgb_to_linear_rgb(*record.m_tile);
-        break;
+    const uint64 end = timer.read();
+    load_seconds = static_cast<double>(end - begin) / timer.frequency();
 
-      case ColorSpaceCIEXYZ:
-        convert_tile_ciexyz_to_linear_rgb(*record.m_tile);
-        break;
+    return tile;
+}
 
-      assert_otherwise;
-    }
+void TextureStore::TileSwapper::on_tile_loaded(
+    const TileKey&      key,
+    const TileRecord&   record,
+    const double        load_seconds)
+{
+    // Track per-texture loading statistics.
+    TextureStatistics& texture_stats = m_texture_stats[key.m_texture_uid];
+    if (texture_stats.m_name.empty())
+        texture_stats.m_name = get_texture(key)->get_name();
+    ++texture_stats.m_load_count;
+    texture_stats.m_load_seconds += load_seconds;
 
     // Track the amount of memory used by the tile cache.
     m_memory_size += record.m_tile->get_memory_size();
@@ -227,19 +381,17 @@ bool TextureStore::TileSwapper::unload(const TileKey& key, TileRecord& record)
     if (boost_atomic::atomic_read32(&record.m_owners) > 0)
         return false;
 
+    // Records whose tile failed to load have nothing to unload.
+    if (record.m_tile == 0)
+        return true;
+
     // Track the amount of memory used by the tile cache.
     const size_t tile_memory_size = record.m_tile->get_memory_size();
     assert(m_memory_size >= tile_memory_size);
     m_memory_size -= tile_memory_size;
 
-    // Fetch the texture container.
-    const TextureContainer& textures =
-        key.m_assembly_uid == ~0
-            ? m_scene.textures()
-            : m_assemblies[key.m_assembly_uid]->textures();
-
     // Fetch the texture.
-    Texture* texture = textures.get_by_uid(key.m_texture_uid);
+    Texture* texture = get_texture(key);
 
     if (m_params.m_track_tile_unloading)
     {
@@ -258,6 +410,32 @@ bool TextureStore::TileSwapper::unload(const TileKey& key, TileRecord& record)
     return true;
 }
 
+void TextureStore::TileSwapper::on_tile_waited(
+    const TileKey&      key,
+    const double        wait_seconds)
+{
+    m_texture_stats[key.m_texture_uid].m_wait_seconds += wait_seconds;
+}
+
+Statistics TextureStore::TileSwapper::get_texture_statistics() const
+{
+    Statistics stats;
+
+    for (const_each<TextureStatisticsMap> i = m_texture_stats; i; ++i)
+    {
+        const TextureStatistics& texture_stats = i->second;
+
+        stats.insert(
+            texture_stats.m_name,
+            "loaded " + pretty_uint(texture_stats.m_load_count) + " " +
+            plural(texture_stats.m_load_count, "tile") + " in " +
+            pretty_time(texture_stats.m_load_seconds) + ", waited " +
+            pretty_time(texture_stats.m_wait_seconds));
+    }
+
+    return stats;
+}
+
 void TextureStore::TileSwapper::gather_assemblies(const AssemblyContainer& assemblies)
 {
     for (const_each<AssemblyContainer> i = assemblies; i; ++i)
@@ -268,6 +446,31 @@ void TextureStore::TileSwapper::gather_assemblies(const AssemblyContainer& assem
 }
 
 
+Texture* TextureStore::TileSwapper::get_texture(const TileKey& key) const
+{
+    // Fetch the texture container.
+    const TextureContainer& textures =
+        key.m_assembly_uid == ~0
+            ? m_scene.textures()
+            : m_assemblies.find(key.m_assembly_uid)->second->textures();
+
+    // Fetch the texture.
+    return textures.get_by_uid(key.m_texture_uid);
+}
+
+
+//
+// TextureStore::TileSwapper::TextureStatistics class implementation.
+//
+
+TextureStore::TileSwapper::TextureStatistics::TextureStatistics()
+  : m_load_count(0)
+  , m_load_seconds(0.0)
+  , m_wait_seconds(0.0)
+{
+}
+
+
 //
 // TextureStore::TileSwapper::Parameters class implementation.
 //
@@ -277,6 +480,7 @@ TextureStore::TileSwapper::Parameters::Parameters(const ParamArray& params)
   , m_track_tile_loading(params.get_optional<bool>("track_tile_loading", false))
   , m_track_tile_unloading(params.get_optional<bool>("track_tile_unloading", false))
   , m_track_store_size(params.get_optional<bool>("track_store_size", false))
+  , m_widen_srgb_tiles(params.get_optional<bool>("widen_srgb_tiles", false))
 {
     assert(m_memory_limit > 0);
 }
@@ -42,11 +42,13 @@
 
 // boost headers.
 #include "boost/cstdint.hpp"
+#include "boost/thread/condition_variable.hpp"
 
 // Standard headers.
 #include <cassert>
 #include <cstddef>
 #include <map>
+#include <string>
 
 // Forward declarations.
 namespace foundation    { class Statistics; }
@@ -61,6 +63,15 @@ namespace renderer
 //
 // A shared store for texture tiles (the backend of the thread-local texture cache).
 //
+// Tiles are loaded outside of the store's lock: threads missing on different tiles
+// load them concurrently, while threads missing on a tile that is already being
+// loaded wait for it.
+//
+// Tiles are converted to the linear RGB color space when they are loaded. 8-bit sRGB
+// tiles are stored as is and linearized at lookup time by the texture source. The
+// widen_srgb_tiles parameter instead widens 8-bit and 16-bit sRGB tiles to linear
+// floating-point, which avoids banding at the cost of two to four times the memory.
+//
 
 class TextureStore
   : public foundation::NonCopyable
@@ -102,8 +113,16 @@ class TextureStore
 
     struct TileRecord
     {
+        enum State
+        {
+            Empty,
+            Loading,
+            Loaded
+        };
+
         foundation::Tile*           m_tile;
         volatile boost::uint32_t    m_owners;
+        State                       m_state;            // protected by the store's mutex
     };
 
     // Constructor.
@@ -130,18 +149,36 @@ class TextureStore
             const Scene&        scene,
             const ParamArray&   params);
 
-        // Load a cache line.
+        // Load a cache line. Only creates an empty record: the tile is loaded by load_tile().
         void load(const TileKey& key, TileRecord& record);
 
         // Unload a cache line.
         bool unload(const TileKey& key, TileRecord& record);
 
+        // Load the tile of a record. Thread-safe, called without holding the store's mutex.
+        foundation::Tile* load_tile(const TileKey& key, double& load_seconds) const;
+
+        // Account for a loaded tile. Called while holding the store's mutex.
+        void on_tile_loaded(
+            const TileKey&      key,
+            const TileRecord&   record,
+            const double        load_seconds);
+
+        // Account for time spent waiting for a tile loaded by another thread.
+        // Called while holding the store's mutex.
+        void on_tile_waited(
+            const TileKey&      key,
+            const double        wait_seconds);
+
         // Return true if the cache is full, false otherwise.
         bool is_full(const size_t element_count) const;
 
         // Return the peak memory size in bytes of the tile cache.
         size_t get_peak_memory_size() const;
 
+        // Retrieve per-texture loading statistics.
+        foundation::Statistics get_texture_statistics() const;
+
       private:
         struct Parameters
         {
@@ -149,19 +186,34 @@ class TextureStore
             const bool      m_track_tile_loading;
             const bool      m_track_tile_unloading;
             const bool      m_track_store_size;
+            const bool      m_widen_srgb_tiles;     // convert integer sRGB tiles to floating-point linear RGB
 
             explicit Parameters(const ParamArray& params);
         };
 
+        struct TextureStatistics
+        {
+            std::string     m_name;
+            size_t          m_load_count;
+            double          m_load_seconds;
+            double          m_wait_seconds;
+
+            TextureStatistics();
+        };
+
         typedef std::map<foundation::UniqueID, const Assembly*> AssemblyMap;
+        typedef std::map<foundation::UniqueID, TextureStatistics> TextureStatisticsMap;
 
-        const Scene&        m_scene;
-        const Parameters    m_params;
-        size_t              m_memory_size;
-        size_t              m_peak_memory_size;
-        AssemblyMap         m_assemblies;
+        const Scene&            m_scene;
+        const Parameters        m_params;
+        size_t                  m_memory_size;
+        size_t                  m_peak_memory_size;
+        AssemblyMap             m_assemblies;
+        TextureStatisticsMap    m_texture_stats;
 
         void gather_assemblies(const AssemblyContainer& assemblies);
+
+        Texture* get_texture(const TileKey& key) const;
     };
 
     typedef foundation::LRUCache<
@@ -170,9 +222,16 @@ class TextureStore
         TileSwapper
     > TileCache;
 
-    boost::mutex    m_mutex;
-    TileSwapper     m_tile_swapper;
-    TileCache       m_tile_cache;
+    mutable boost::mutex        m_mutex;
+    boost::condition_variable   m_tile_loaded;
+    TileSwapper                 m_tile_swapper;
+    TileCache                   m_tile_cache;
+
+    // Load the tile of a record created by the tile cache.
+    void load_tile(const TileKey& key, TileRecord& record);
+
+    // Wait until another thread has loaded the tile of a record.
+    void wait_for_tile(const TileKey& key, TileRecord& record);
 };
 
 
@@ -182,13 +241,29 @@ class TextureStore
 
 inline TextureStore::TileRecord& TextureStore::acquire(const TileKey& key)
 {
-    boost::mutex::scoped_lock lock(m_mutex);
+    TileRecord* record;
+    TileRecord::State state;
+
+    {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        record = &m_tile_cache.get(key);
+
+        // Owned records cannot be unloaded, even while their tile is loading.
+        boost_atomic::atomic_inc32(&record->m_owners);
+
+        state = record->m_state;
 
-    TileRecord& record = m_tile_cache.get(key);
+        if (state == TileRecord::Empty)
+            record->m_state = TileRecord::Loading;
+    }
 
-    boost_atomic::atomic_inc32(&record.m_owners);
+    if (state == TileRecord::Empty)
+        load_tile(key, *record);
+    else if (state == TileRecord::Loading)
+        wait_for_tile(key, *record);
 
-    return record;
+    return *record;
 }
 
 inline void TextureStore::release(TileRecord& record) const
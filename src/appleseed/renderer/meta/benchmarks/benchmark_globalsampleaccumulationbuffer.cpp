@@ -0,0 +1,79 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/globalsampleaccumulationbuffer.h"
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/filter.h"
+#include "foundation/math/rng.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+BENCHMARK_SUITE(Renderer_Kernel_Rendering_GlobalSampleAccumulationBuffer)
+{
+    struct Fixture
+    {
+        static const size_t Width = 1280;
+        static const size_t Height = 720;
+        static const size_t SampleCount = 16 * 1024;
+
+        GaussianFilter2<double>         m_filter;
+        GlobalSampleAccumulationBuffer  m_buffer;
+        vector<Sample>                  m_samples;
+
+        Fixture()
+          : m_filter(1.5, 1.5, 8.0)
+          , m_buffer(Width, Height, m_filter)
+          , m_samples(SampleCount)
+        {
+            // Light tracing samples land anywhere on the image.
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < SampleCount; ++i)
+            {
+                m_samples[i].m_position.x = rand_double2(rng);
+                m_samples[i].m_position.y = rand_double2(rng);
+                m_samples[i].m_color.set(1.0f);
+            }
+        }
+    };
+
+    BENCHMARK_CASE_F(StoreSamples_GivenRandomlyDistributedSamples, Fixture)
+    {
+        m_buffer.store_samples(m_samples.size(), &m_samples[0]);
+    }
+}
@@ -0,0 +1,430 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/lighting/lightsampler.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/bsdf/bsdf.h"
+#include "renderer/modeling/camera/camera.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/input/inputevaluator.h"
+#include "renderer/modeling/material/material.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/project/projectfilereader.h"
+#include "renderer/modeling/project-builtin/cornellboxproject.h"
+#include "renderer/modeling/scene/scene.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/basis.h"
+#include "foundation/math/rng.h"
+#include "foundation/math/sampling.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+//
+// These benchmarks measure the main rendering kernels against real scenes.
+// Each benchmark case processes a fixed batch of items (rays, shading points,
+// samples) per iteration: throughputs follow from dividing the batch size by
+// the reported time per iteration.
+//
+
+namespace
+{
+    // The built-in Cornell Box project.
+    struct CornellBoxProject
+    {
+        static auto_release_ptr<Project> load()
+        {
+            return CornellBoxProjectFactory::create();
+        }
+    };
+
+    // Scenes from the test suite (paths are relative to the tests root directory).
+    struct PointLightProject
+    {
+        static auto_release_ptr<Project> load()
+        {
+            ProjectFileReader reader;
+            return
+                reader.read(
+                    "test scenes/lights/01 - point light - drt.appleseed",
+                    "../../../schemas/project.xsd");    // path relative to input file
+        }
+    };
+
+    struct TexturedQuadProject
+    {
+        static auto_release_ptr<Project> load()
+        {
+            ProjectFileReader reader;
+            return
+                reader.read(
+                    "test scenes/texture/04 - textured quad 256x256 tiled.appleseed",
+                    "../../../schemas/project.xsd");    // path relative to input file
+        }
+    };
+
+    template <typename ProjectLoader>
+    struct Fixture
+    {
+        static const size_t RayCount = 1024;
+        static const size_t ShadingPointCount = 256;
+        static const size_t LightSampleCount = 1024;
+
+        auto_release_ptr<Project>   m_project;
+        TextureStore*               m_texture_store;
+        TextureCache*               m_texture_cache;
+        Intersector*                m_intersector;
+        LightSampler*               m_light_sampler;
+        MersenneTwister             m_rng;
+
+        ShadingRay                  m_primary_rays[RayCount];
+        ShadingRay                  m_secondary_rays[RayCount];
+        ShadingPoint                m_shading_points[ShadingPointCount];
+        size_t                      m_shading_point_count;
+        Vector3d                    m_light_samples[LightSampleCount];
+
+        bool                        m_hit;
+        size_t                      m_hit_count;
+        Vector3d                    m_result;
+
+        Fixture()
+          : m_project(ProjectLoader::load())
+          , m_texture_store(0)
+          , m_texture_cache(0)
+          , m_intersector(0)
+          , m_light_sampler(0)
+          , m_shading_point_count(0)
+          , m_hit(false)
+          , m_hit_count(0)
+        {
+            if (m_project.get() == 0)
+                return;
+
+            Scene& scene = *m_project->get_scene();
+
+            InputBinder input_binder;
+            input_binder.bind(scene);
+
+            m_project->update_trace_context();
+
+            m_texture_store = new TextureStore(scene);
+            m_texture_cache = new TextureCache(*m_texture_store);
+            m_intersector = new Intersector(m_project->get_trace_context(), *m_texture_cache);
+            m_light_sampler = new LightSampler(scene);
+
+#ifdef WITH_OSL
+            scene.on_frame_begin(m_project.ref(), 0);
+#else
+            scene.on_frame_begin(m_project.ref());
+#endif
+
+            generate_primary_rays();
+            generate_secondary_rays();
+            generate_shading_points();
+
+            for (size_t i = 0; i < LightSampleCount; ++i)
+            {
+                m_light_samples[i][0] = rand_double2(m_rng);
+                m_light_samples[i][1] = rand_double2(m_rng);
+                m_light_samples[i][2] = rand_double2(m_rng);
+            }
+        }
+
+        ~Fixture()
+        {
+            if (m_project.get() == 0)
+                return;
+
+            m_project->get_scene()->on_frame_end(m_project.ref());
+
+            delete m_light_sampler;
+            delete m_intersector;
+            delete m_texture_cache;
+            delete m_texture_store;
+        }
+
+        bool is_valid() const
+        {
+            return m_project.get() != 0;
+        }
+
+        // Generate camera rays through random points of the film.
+        void generate_primary_rays()
+        {
+            const Camera* camera = m_project->get_scene()->get_camera();
+            SamplingContext sampling_context(m_rng);
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                const Vector2d point(rand_double2(m_rng), rand_double2(m_rng));
+
+                camera->generate_ray(sampling_context, point, m_primary_rays[i]);
+            }
+        }
+
+        // Generate diffuse rays leaving the surfaces hit by the camera rays.
+        // Camera rays that don't hit anything are traced again instead.
+        void generate_secondary_rays()
+        {
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                ShadingPoint shading_point;
+
+                if (!m_intersector->trace(m_primary_rays[i], shading_point))
+                {
+                    m_secondary_rays[i] = m_primary_rays[i];
+                    continue;
+                }
+
+                const Vector2d s(rand_double2(m_rng), rand_double2(m_rng));
+                const Vector3d local_dir = sample_hemisphere_cosine(s);
+                const Vector3d dir = shading_point.get_shading_basis().transform_to_parent(local_dir);
+
+                m_secondary_rays[i] =
+                    ShadingRay(
+                        shading_point.get_offset_point(dir),
+                        dir,
+                        m_primary_rays[i].m_time,
+                        ShadingRay::DiffuseRay,
+                        1);
+            }
+        }
+
+        // Store the shading points of the first camera rays that hit a surface with a BSDF.
+        void generate_shading_points()
+        {
+            for (size_t i = 0; i < RayCount && m_shading_point_count < ShadingPointCount; ++i)
+            {
+                ShadingPoint& shading_point = m_shading_points[m_shading_point_count];
+
+                if (!m_intersector->trace(m_primary_rays[i], shading_point))
+                    continue;
+
+                const Material* material = shading_point.get_material();
+
+                if (material && material->get_bsdf())
+                    ++m_shading_point_count;
+                else shading_point.clear();
+            }
+        }
+
+        void trace(const ShadingRay rays[])
+        {
+            m_hit_count = 0;
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                ShadingPoint shading_point;
+
+                if (m_intersector->trace(rays[i], shading_point))
+                    ++m_hit_count;
+            }
+        }
+
+        void trace_probe(const ShadingRay rays[])
+        {
+            m_hit_count = 0;
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                if (m_intersector->trace_probe(rays[i]))
+                    ++m_hit_count;
+            }
+        }
+
+        // Trace camera rays and compute the shading point attributes used by shading.
+        void trace_and_compute_shading_points()
+        {
+            m_result = Vector3d(0.0);
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                ShadingPoint shading_point;
+
+                if (m_intersector->trace(m_primary_rays[i], shading_point))
+                {
+                    m_result += shading_point.get_point();
+                    m_result += shading_point.get_shading_basis().get_normal();
+                    m_result[0] += shading_point.get_uv(0)[0];
+                }
+            }
+        }
+
+        // Evaluate the BSDF inputs at each stored shading point (this includes texture lookups).
+        void evaluate_bsdf_inputs()
+        {
+            m_hit = false;
+
+            for (size_t i = 0; i < m_shading_point_count; ++i)
+            {
+                const ShadingPoint& shading_point = m_shading_points[i];
+                const BSDF* bsdf = shading_point.get_material()->get_bsdf();
+
+                InputEvaluator input_evaluator(*m_texture_cache);
+                bsdf->evaluate_inputs(input_evaluator, shading_point);
+
+                m_hit ^= input_evaluator.data() != 0;
+            }
+        }
+
+        // Evaluate the BSDF inputs at each stored shading point and sample the BSDF.
+        void sample_bsdfs()
+        {
+            SamplingContext sampling_context(m_rng);
+
+            m_result = Vector3d(0.0);
+
+            for (size_t i = 0; i < m_shading_point_count; ++i)
+            {
+                const ShadingPoint& shading_point = m_shading_points[i];
+                const BSDF* bsdf = shading_point.get_material()->get_bsdf();
+
+                InputEvaluator input_evaluator(*m_texture_cache);
+                bsdf->evaluate_inputs(input_evaluator, shading_point);
+
+                Vector3d incoming;
+                Spectrum value;
+                double probability;
+                bsdf->sample(
+                    sampling_context,
+                    input_evaluator.data(),
+                    false,
+                    true,
+                    shading_point.get_geometric_normal(),
+                    shading_point.get_shading_basis(),
+                    -normalize(shading_point.get_ray().m_dir),
+                    incoming,
+                    value,
+                    probability);
+
+                m_result += incoming;
+            }
+        }
+
+        void sample_lights()
+        {
+            m_result = Vector3d(0.0);
+
+            for (size_t i = 0; i < LightSampleCount; ++i)
+            {
+                LightSample light_sample;
+                m_light_sampler->sample(0.0, m_light_samples[i], light_sample);
+                m_result += light_sample.m_point;
+            }
+        }
+    };
+}
+
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_Intersector_Scenes)
+{
+    BENCHMARK_CASE_F(CornellBox_TraceCameraRays, Fixture<CornellBoxProject>)
+    {
+        trace(m_primary_rays);
+    }
+
+    BENCHMARK_CASE_F(CornellBox_TraceDiffuseRays, Fixture<CornellBoxProject>)
+    {
+        trace(m_secondary_rays);
+    }
+
+    BENCHMARK_CASE_F(CornellBox_TraceProbeDiffuseRays, Fixture<CornellBoxProject>)
+    {
+        trace_probe(m_secondary_rays);
+    }
+
+    BENCHMARK_CASE_F(PointLight_TraceCameraRays, Fixture<PointLightProject>)
+    {
+        if (is_valid())
+            trace(m_primary_rays);
+    }
+
+    BENCHMARK_CASE_F(PointLight_TraceDiffuseRays, Fixture<PointLightProject>)
+    {
+        if (is_valid())
+            trace(m_secondary_rays);
+    }
+}
+
+BENCHMARK_SUITE(Renderer_Kernel_Shading_ShadingPoint_Scenes)
+{
+    BENCHMARK_CASE_F(CornellBox_TraceCameraRaysAndComputeShadingPoints, Fixture<CornellBoxProject>)
+    {
+        trace_and_compute_shading_points();
+    }
+
+    BENCHMARK_CASE_F(TexturedQuad_TraceCameraRaysAndComputeShadingPoints, Fixture<TexturedQuadProject>)
+    {
+        if (is_valid())
+            trace_and_compute_shading_points();
+    }
+}
+
+BENCHMARK_SUITE(Renderer_Modeling_BSDF_Scenes)
+{
+    BENCHMARK_CASE_F(CornellBox_EvaluateInputsAndSample, Fixture<CornellBoxProject>)
+    {
+        sample_bsdfs();
+    }
+
+    BENCHMARK_CASE_F(PointLight_EvaluateInputsAndSample, Fixture<PointLightProject>)
+    {
+        if (is_valid())
+            sample_bsdfs();
+    }
+}
+
+BENCHMARK_SUITE(Renderer_Kernel_Lighting_LightSampler_Scenes)
+{
+    BENCHMARK_CASE_F(CornellBox_Sample, Fixture<CornellBoxProject>)
+    {
+        sample_lights();
+    }
+}
+
+BENCHMARK_SUITE(Renderer_Kernel_Texturing_Scenes)
+{
+    BENCHMARK_CASE_F(TexturedQuad_EvaluateTexturedBSDFInputs, Fixture<TexturedQuadProject>)
+    {
+        if (is_valid())
+            evaluate_bsdf_inputs();
+    }
+}
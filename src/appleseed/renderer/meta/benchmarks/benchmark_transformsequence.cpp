@@ -45,9 +45,11 @@ BENCHMARK_SUITE(Renderer_Utility_TransformSequence)
 {
     struct Fixture
     {
-        const AABB3d        m_bbox;
-        TransformSequence   m_sequence;
-        AABB3d              m_motion_bbox;
+        const AABB3d                    m_bbox;
+        TransformSequence               m_sequence;
+        AABB3d                          m_motion_bbox;
+        TransformSequenceCache<32>      m_cache;
+        Transformd                      m_transform;
 
         Fixture()
           : m_bbox(Vector3d(-20.0, -20.0, -5.0), Vector3d(-10.0, -10.0, 5.0))
@@ -71,4 +73,23 @@ BENCHMARK_SUITE(Renderer_Utility_TransformSequence)
     {
         m_motion_bbox = m_sequence.to_parent(m_bbox);
     }
+
+    BENCHMARK_CASE_F(Evaluate, Fixture)
+    {
+        Transformd tmp;
+        m_transform = m_sequence.evaluate(0.3, tmp);
+    }
+
+    // Repeated evaluations at the same time, as happens along a light path.
+    BENCHMARK_CASE_F(EvaluateThroughCache_SameTime, Fixture)
+    {
+        m_transform = m_cache.evaluate(m_sequence, 0.3);
+    }
+
+    // A different time at each evaluation, the worst case for the cache.
+    BENCHMARK_CASE_F(EvaluateThroughCache_DifferentTimes, Fixture)
+    {
+        const double time = static_cast<double>(m_cache.get_miss_count() % 1000) * 0.001;
+        m_transform = m_cache.evaluate(m_sequence, time);
+    }
 }
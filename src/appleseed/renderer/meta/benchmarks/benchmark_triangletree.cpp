@@ -0,0 +1,339 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/scalar.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/benchmark.h"
+
+// Standard headers.
+#include <cmath>
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+namespace
+{
+    // Create a grid of 2 x 256 x 256 = 131072 triangles spanning [-1, 1] along x and y,
+    // with vertices randomly displaced along z by up to a given height.
+    auto_release_ptr<MeshObject> create_grid(const float max_bump_height = 0.0f)
+    {
+        auto_release_ptr<MeshObject> mesh_object =
+            MeshObjectFactory::create("grid", ParamArray());
+
+        MersenneTwister rng;
+        const size_t n = 256;
+        const float rcp_n = 1.0f / n;
+
+        for (size_t y = 0; y <= n; ++y)
+        {
+            for (size_t x = 0; x <= n; ++x)
+            {
+                mesh_object->push_vertex(
+                    GVector3(
+                        2.0f * x * rcp_n - 1.0f,
+                        2.0f * y * rcp_n - 1.0f,
+                        max_bump_height * rand_float1(rng)));
+            }
+        }
+
+        mesh_object->push_vertex_normal(GVector3(0.0f, 0.0f, -1.0f));
+        mesh_object->push_material_slot("material");
+
+        for (size_t y = 0; y < n; ++y)
+        {
+            for (size_t x = 0; x < n; ++x)
+            {
+                const size_t v0 = y * (n + 1) + x;
+                const size_t v1 = v0 + 1;
+                const size_t v2 = v1 + n + 1;
+                const size_t v3 = v0 + n + 1;
+                mesh_object->push_triangle(Triangle(v0, v1, v2, 0, 0, 0, 0));
+                mesh_object->push_triangle(Triangle(v2, v3, v0, 0, 0, 0, 0));
+            }
+        }
+
+        return mesh_object;
+    }
+
+    // Each grid vertex moves to the mirrored position along x over the shutter interval:
+    // every triangle sweeps across the grid, the worst case for a tree built at a single time.
+    struct MirroredGrid
+    {
+        static auto_release_ptr<MeshObject> create()
+        {
+            auto_release_ptr<MeshObject> mesh_object = create_grid();
+            mesh_object->set_motion_segment_count(1);
+
+            const size_t vertex_count = mesh_object->get_vertex_count();
+            for (size_t i = 0; i < vertex_count; ++i)
+            {
+                const GVector3& v = mesh_object->get_vertex(i);
+                mesh_object->set_vertex_pose(i, 0, GVector3(-v.x, v.y, v.z));
+            }
+
+            return mesh_object;
+        }
+    };
+
+    // Each grid vertex moves along a wave of small amplitude, as cloth would.
+    struct WavingGrid
+    {
+        static auto_release_ptr<MeshObject> create()
+        {
+            auto_release_ptr<MeshObject> mesh_object = create_grid();
+            mesh_object->set_motion_segment_count(1);
+
+            const size_t vertex_count = mesh_object->get_vertex_count();
+            for (size_t i = 0; i < vertex_count; ++i)
+            {
+                const GVector3& v = mesh_object->get_vertex(i);
+                const float dz = 0.05f * std::sin(static_cast<float>(TwoPi) * 4.0f * v.x);
+                mesh_object->set_vertex_pose(i, 0, GVector3(v.x, v.y, v.z + dz));
+            }
+
+            return mesh_object;
+        }
+    };
+
+    // A static grid with random bumps, as a tessellated terrain would be.
+    struct BumpyGrid
+    {
+        static auto_release_ptr<MeshObject> create()
+        {
+            return create_grid(0.02f);
+        }
+    };
+
+    template <typename Mesh>
+    struct Fixture
+    {
+        static const size_t RayCount = 1024;
+
+        auto_release_ptr<Scene>     m_scene;
+        TraceContext*               m_trace_context;
+        TextureStore*               m_texture_store;
+        TextureCache*               m_texture_cache;
+        Intersector*                m_intersector;
+        ShadingRay                  m_rays[RayCount];
+        size_t                      m_hit_count;
+
+        explicit Fixture(const ParamArray& acceleration_structure_params)
+          : m_scene(SceneFactory::create())
+          , m_hit_count(0)
+        {
+            ParamArray assembly_params;
+            assembly_params.push("acceleration_structure").merge(acceleration_structure_params);
+
+            auto_release_ptr<Assembly> assembly(
+                AssemblyFactory::create("assembly", assembly_params));
+
+            assembly->objects().insert(auto_release_ptr<Object>(Mesh::create().release()));
+            assembly->object_instances().insert(
+                ObjectInstanceFactory::create(
+                    "grid_inst",
+                    ParamArray(),
+                    "grid",
+                    Transformd::identity(),
+                    StringDictionary()));
+
+            m_scene->assemblies().insert(assembly);
+            m_scene->assembly_instances().insert(
+                AssemblyInstanceFactory::create("assembly_inst", ParamArray(), "assembly"));
+
+            InputBinder input_binder;
+            input_binder.bind(m_scene.ref());
+
+            m_trace_context = new TraceContext(m_scene.ref());
+            m_texture_store = new TextureStore(m_scene.ref());
+            m_texture_cache = new TextureCache(*m_texture_store);
+            m_intersector = new Intersector(*m_trace_context, *m_texture_cache);
+
+            generate_rays();
+        }
+
+        ~Fixture()
+        {
+            delete m_intersector;
+            delete m_texture_cache;
+            delete m_texture_store;
+            delete m_trace_context;
+        }
+
+        // Generate rays toward random points of the grid, at random times.
+        void generate_rays()
+        {
+            MersenneTwister rng;
+
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                const Vector3d org(
+                    rand_double2(rng, -1.0, 1.0),
+                    rand_double2(rng, -1.0, 1.0),
+                    -2.0);
+                const Vector3d target(
+                    rand_double2(rng, -1.0, 1.0),
+                    rand_double2(rng, -1.0, 1.0),
+                    0.0);
+
+                m_rays[i] =
+                    ShadingRay(
+                        org,
+                        normalize(target - org),
+                        rand_double2(rng),
+                        ShadingRay::CameraRay);
+            }
+        }
+
+        void trace()
+        {
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                ShadingPoint shading_point;
+                if (m_intersector->trace(m_rays[i], shading_point))
+                    ++m_hit_count;
+            }
+        }
+    };
+
+    template <typename Mesh, size_t TemporalSplitDepth>
+    struct TemporalSplitFixture
+      : public Fixture<Mesh>
+    {
+        TemporalSplitFixture()
+          : Fixture<Mesh>(ParamArray().insert("temporal_split_depth", TemporalSplitDepth))
+        {
+        }
+    };
+
+    template <size_t MaxLeafSize, bool TriangleBatches>
+    struct LeafSizeFixture
+      : public Fixture<BumpyGrid>
+    {
+        LeafSizeFixture()
+          : Fixture<BumpyGrid>(
+                ParamArray()
+                    .insert("max_leaf_size", MaxLeafSize)
+                    .insert("triangle_batches", TriangleBatches))
+        {
+        }
+    };
+
+    typedef TemporalSplitFixture<MirroredGrid, 0> MirroredGridFixture;
+    typedef TemporalSplitFixture<MirroredGrid, 2> MirroredGridWithTemporalSplitsFixture;
+    typedef TemporalSplitFixture<WavingGrid, 0> WavingGridFixture;
+    typedef TemporalSplitFixture<WavingGrid, 2> WavingGridWithTemporalSplitsFixture;
+
+    typedef LeafSizeFixture<2, true> MaxLeafSize2Fixture;
+    typedef LeafSizeFixture<4, false> MaxLeafSize4Fixture;
+    typedef LeafSizeFixture<4, true> MaxLeafSize4WithTriangleBatchesFixture;
+    typedef LeafSizeFixture<8, false> MaxLeafSize8Fixture;
+    typedef LeafSizeFixture<8, true> MaxLeafSize8WithTriangleBatchesFixture;
+}
+
+//
+// Each benchmark case traces 1024 rays at random times toward a grid of 131072 triangles.
+//
+
+// Deforming grids, with and without temporal splits.
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_TriangleTree_TemporalSplits)
+{
+    BENCHMARK_CASE_F(MirroredGrid_TraceRays, MirroredGridFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(MirroredGrid_TraceRaysWithTemporalSplits, MirroredGridWithTemporalSplitsFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(WavingGrid_TraceRays, WavingGridFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(WavingGrid_TraceRaysWithTemporalSplits, WavingGridWithTemporalSplitsFixture)
+    {
+        trace();
+    }
+}
+
+// A static bumpy grid, with various maximum leaf sizes, with and without triangle batches.
+BENCHMARK_SUITE(Renderer_Kernel_Intersection_TriangleTree_LeafSize)
+{
+    BENCHMARK_CASE_F(MaxLeafSize2_TraceRays, MaxLeafSize2Fixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(MaxLeafSize4_TraceRays, MaxLeafSize4Fixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(MaxLeafSize4_TraceRaysWithTriangleBatches, MaxLeafSize4WithTriangleBatchesFixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(MaxLeafSize8_TraceRays, MaxLeafSize8Fixture)
+    {
+        trace();
+    }
+
+    BENCHMARK_CASE_F(MaxLeafSize8_TraceRaysWithTriangleBatches, MaxLeafSize8WithTriangleBatchesFixture)
+    {
+        trace();
+    }
+}
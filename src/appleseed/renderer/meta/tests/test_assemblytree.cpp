@@ -0,0 +1,269 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
+#include "renderer/utility/testutils.h"
+#include "renderer/utility/transformsequence.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/matrix.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <string>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Intersection_AssemblyTree)
+{
+    struct TestScene
+    {
+        auto_release_ptr<Scene> m_scene;
+
+        TestScene()
+          : m_scene(SceneFactory::create())
+        {
+            auto_release_ptr<Assembly> assembly(
+                AssemblyFactory::create("assembly", ParamArray()));
+
+            // A unit square in the x = 0 plane, centered on the origin.
+            auto_release_ptr<MeshObject> mesh_object =
+                MeshObjectFactory::create("plane", ParamArray());
+            mesh_object->push_vertex(GVector3(0.0f, -0.5f, -0.5f));
+            mesh_object->push_vertex(GVector3(0.0f, +0.5f, -0.5f));
+            mesh_object->push_vertex(GVector3(0.0f, +0.5f, +0.5f));
+            mesh_object->push_vertex(GVector3(0.0f, -0.5f, +0.5f));
+            mesh_object->push_vertex_normal(GVector3(-1.0f, 0.0f, 0.0f));
+            mesh_object->push_triangle(Triangle(0, 1, 2, 0, 0, 0, 0));
+            mesh_object->push_triangle(Triangle(2, 3, 0, 0, 0, 0, 0));
+            assembly->objects().insert(auto_release_ptr<Object>(mesh_object.release()));
+
+            assembly->object_instances().insert(
+                ObjectInstanceFactory::create(
+                    "plane_inst",
+                    ParamArray(),
+                    "plane",
+                    Transformd::identity(),
+                    StringDictionary()));
+
+            m_scene->assemblies().insert(assembly);
+
+            insert_assembly_instance("assembly_inst1", Vector3d(0.0, 0.0, 0.0));
+            insert_assembly_instance("assembly_inst2", Vector3d(0.0, 2.0, 0.0));
+        }
+
+        void insert_assembly_instance(const char* name, const Vector3d& position)
+        {
+            auto_release_ptr<AssemblyInstance> assembly_instance(
+                AssemblyInstanceFactory::create(name, ParamArray(), "assembly"));
+
+            assembly_instance->transform_sequence().set_transform(
+                0.0,
+                Transformd::from_local_to_parent(Matrix4d::translation(position)));
+
+            m_scene->assembly_instances().insert(assembly_instance);
+
+            InputBinder input_binder;
+            input_binder.bind(m_scene.ref());
+        }
+
+        void move_assembly_instance(const char* name, const Vector3d& position)
+        {
+            TransformSequence& transform_sequence =
+                m_scene->assembly_instances().get_by_name(name)->transform_sequence();
+
+            transform_sequence.clear();
+            transform_sequence.set_transform(
+                0.0,
+                Transformd::from_local_to_parent(Matrix4d::translation(position)));
+        }
+
+        void move_assembly_instance(
+            const char*         name,
+            const Vector3d&     position_at_time_0,
+            const Vector3d&     position_at_time_1)
+        {
+            TransformSequence& transform_sequence =
+                m_scene->assembly_instances().get_by_name(name)->transform_sequence();
+
+            transform_sequence.clear();
+            transform_sequence.set_transform(
+                0.0,
+                Transformd::from_local_to_parent(Matrix4d::translation(position_at_time_0)));
+            transform_sequence.set_transform(
+                1.0,
+                Transformd::from_local_to_parent(Matrix4d::translation(position_at_time_1)));
+        }
+
+        void remove_assembly_instance(const char* name)
+        {
+            AssemblyInstanceContainer& assembly_instances = m_scene->assembly_instances();
+            assembly_instances.remove(assembly_instances.get_by_name(name)->get_uid());
+        }
+    };
+
+    struct Fixture
+      : public BindInputs<TestScene>
+    {
+        TraceContext    m_trace_context;
+        TextureStore    m_texture_store;
+
+        Fixture()
+          : m_trace_context(m_scene.ref())
+          , m_texture_store(m_scene.ref())
+        {
+        }
+
+        // Trace a ray parallel to the x axis, toward the x = 0 plane, and return the
+        // name of the assembly instance that was hit, or an empty string on a miss.
+        string trace(const double y, const double z)
+        {
+            TextureCache texture_cache(m_texture_store);
+            Intersector intersector(m_trace_context, texture_cache);
+
+            return trace(intersector, y, z);
+        }
+
+        static string trace(const Intersector& intersector, const double y, const double z)
+        {
+            const ShadingRay ray(
+                Vector3d(-1.0, y, z),
+                Vector3d(1.0, 0.0, 0.0),
+                0.0,
+                ShadingRay::CameraRay);
+
+            ShadingPoint shading_point;
+            if (!intersector.trace(ray, shading_point))
+                return string();
+
+            return shading_point.get_assembly_instance().get_name();
+        }
+    };
+
+    TEST_CASE_F(Constructor_RaysHitAssemblyInstances, Fixture)
+    {
+        EXPECT_EQ("assembly_inst1", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst2", trace(2.0, 0.0));
+        EXPECT_EQ("", trace(1.0, 0.0));
+    }
+
+    TEST_CASE_F(Update_GivenMovedAssemblyInstance_RaysHitAssemblyInstanceAtNewPosition, Fixture)
+    {
+        move_assembly_instance("assembly_inst1", Vector3d(0.0, 0.0, 4.0));
+        m_trace_context.update();
+
+        EXPECT_EQ("", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst1", trace(0.0, 4.0));
+        EXPECT_EQ("assembly_inst2", trace(2.0, 0.0));
+    }
+
+    TEST_CASE_F(Update_GivenMovedAssemblyInstance_IntersectorCreatedBeforeUpdateHitsAssemblyInstanceAtNewPosition, Fixture)
+    {
+        // Only transform sequences with several transforms are cached.
+        move_assembly_instance("assembly_inst1", Vector3d(0.0, 0.0, 0.0), Vector3d(0.0, 0.0, 0.0));
+        m_trace_context.update();
+
+        TextureCache texture_cache(m_texture_store);
+        Intersector intersector(m_trace_context, texture_cache);
+
+        // Fill the assembly transform cache of the intersector.
+        EXPECT_EQ("assembly_inst1", trace(intersector, 0.0, 0.0));
+
+        move_assembly_instance("assembly_inst1", Vector3d(0.0, 0.0, 4.0), Vector3d(0.0, 0.0, 4.0));
+        m_trace_context.update();
+
+        EXPECT_EQ("", trace(intersector, 0.0, 0.0));
+        EXPECT_EQ("assembly_inst1", trace(intersector, 0.0, 4.0));
+    }
+
+    TEST_CASE_F(Update_GivenMovedAssemblyInstances_RaysHitAssemblyInstancesAtNewPositions, Fixture)
+    {
+        // Swap the two assembly instances.
+        move_assembly_instance("assembly_inst1", Vector3d(0.0, 2.0, 0.0));
+        move_assembly_instance("assembly_inst2", Vector3d(0.0, 0.0, 0.0));
+        m_trace_context.update();
+
+        EXPECT_EQ("assembly_inst2", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst1", trace(2.0, 0.0));
+    }
+
+    TEST_CASE_F(Update_GivenAddedAssemblyInstance_RebuildsTree, Fixture)
+    {
+        insert_assembly_instance("assembly_inst3", Vector3d(0.0, -2.0, 0.0));
+        m_trace_context.update();
+
+        // Refitting would leave the new assembly instance out of the tree.
+        EXPECT_EQ("assembly_inst3", trace(-2.0, 0.0));
+        EXPECT_EQ("assembly_inst1", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst2", trace(2.0, 0.0));
+    }
+
+    TEST_CASE_F(Update_GivenRemovedAssemblyInstance_RebuildsTree, Fixture)
+    {
+        remove_assembly_instance("assembly_inst1");
+        m_trace_context.update();
+
+        // Refitting would keep a reference to the deleted assembly instance.
+        EXPECT_EQ("", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst2", trace(2.0, 0.0));
+    }
+
+    TEST_CASE_F(Update_GivenAssemblyInstanceReplacedByAnother_RaysHitNewAssemblyInstance, Fixture)
+    {
+        remove_assembly_instance("assembly_inst1");
+        insert_assembly_instance("assembly_inst3", Vector3d(0.0, 0.0, 4.0));
+        m_trace_context.update();
+
+        EXPECT_EQ("", trace(0.0, 0.0));
+        EXPECT_EQ("assembly_inst3", trace(0.0, 4.0));
+        EXPECT_EQ("assembly_inst2", trace(2.0, 0.0));
+    }
+}
@@ -0,0 +1,155 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/progressive/convergencemap.h"
+#include "renderer/kernel/rendering/sample.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Progressive_ConvergenceMap)
+{
+    const size_t Width = 16;
+    const size_t Height = 8;
+    const size_t BlockSize = 8;
+
+    // Generate one sample at the center of every pixel of the left half of the canvas.
+    void make_left_half_samples(const float value, vector<Sample>& samples)
+    {
+        for (size_t y = 0; y < Height; ++y)
+        {
+            for (size_t x = 0; x < Width / 2; ++x)
+            {
+                Sample sample;
+                sample.m_position = Vector2d((x + 0.5) / Width, (y + 0.5) / Height);
+                sample.m_color = Color4f(value, value, value, 1.0f);
+                samples.push_back(sample);
+            }
+        }
+    }
+
+    struct Fixture
+    {
+        ConvergenceMap m_map;
+
+        Fixture()
+          : m_map(
+                Width,
+                Height,
+                AABB2u(Vector2u(0, 0), Vector2u(Width - 1, Height - 1)),
+                BlockSize,
+                0.05f,      // noise threshold
+                4)          // min samples per pixel
+        {
+        }
+
+        void store_left_half(const float value)
+        {
+            vector<Sample> samples;
+            make_left_half_samples(value, samples);
+            m_map.store_samples(samples.size(), &samples[0]);
+        }
+    };
+
+    TEST_CASE_F(IsConverged_GivenNoSamples_ReturnsFalse, Fixture)
+    {
+        EXPECT_EQ(2, m_map.get_block_count());
+        EXPECT_EQ(0, m_map.get_converged_block_count());
+        EXPECT_FALSE(m_map.is_converged());
+    }
+
+    TEST_CASE_F(IsConverged_GivenTooFewSamples_ReturnsFalse, Fixture)
+    {
+        for (size_t i = 0; i < 3; ++i)
+            store_left_half(1.0f);
+
+        EXPECT_FALSE(m_map.is_converged(Vector2d(0.25, 0.5)));
+    }
+
+    TEST_CASE_F(IsConverged_GivenEnoughNoiselessSamples_ReturnsTrueForThatBlockOnly, Fixture)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            store_left_half(1.0f);
+
+        EXPECT_TRUE(m_map.is_converged(Vector2d(0.25, 0.5)));
+        EXPECT_FALSE(m_map.is_converged(Vector2d(0.75, 0.5)));
+        EXPECT_EQ(1, m_map.get_converged_block_count());
+        EXPECT_FALSE(m_map.is_converged());
+    }
+
+    TEST_CASE_F(IsConverged_GivenNoisySamples_ReturnsFalse, Fixture)
+    {
+        for (size_t i = 0; i < 8; ++i)
+            store_left_half(i % 2 == 0 ? 0.5f : 1.5f);
+
+        EXPECT_FALSE(m_map.is_converged(Vector2d(0.25, 0.5)));
+    }
+
+    TEST_CASE_F(Clear_GivenConvergedBlock_ResetsConvergence, Fixture)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            store_left_half(1.0f);
+
+        m_map.clear();
+
+        EXPECT_FALSE(m_map.is_converged(Vector2d(0.25, 0.5)));
+        EXPECT_EQ(0, m_map.get_converged_block_count());
+    }
+
+    TEST_CASE(IsConverged_GivenBlocksOutsideCropWindow_IgnoresThem)
+    {
+        ConvergenceMap map(
+            Width,
+            Height,
+            AABB2u(Vector2u(0, 0), Vector2u(Width / 2 - 1, Height - 1)),
+            BlockSize,
+            0.05f,
+            4);
+
+        vector<Sample> samples;
+        make_left_half_samples(1.0f, samples);
+
+        for (size_t i = 0; i < 4; ++i)
+            map.store_samples(samples.size(), &samples[0]);
+
+        EXPECT_EQ(1, map.get_block_count());
+        EXPECT_TRUE(map.is_converged());
+    }
+}
@@ -0,0 +1,93 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/utility/cyclecounter.h"
+
+// appleseed.foundation headers.
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Utility_CycleCounter)
+{
+    TEST_CASE(Constructor_InitializesCountersToZero)
+    {
+        const CycleCounter counter;
+
+        EXPECT_EQ(0, counter.get_ticks());
+        EXPECT_EQ(0, counter.get_call_count());
+    }
+
+    TEST_CASE(ScopedCycleCount_CountsOneCallPerScope)
+    {
+        CycleCounter counter;
+
+        {
+            ScopedCycleCount scope(counter);
+        }
+
+        {
+            ScopedCycleCount scope(counter);
+        }
+
+        EXPECT_EQ(2, counter.get_call_count());
+    }
+
+    TEST_CASE(ScopedCycleCount_GivenNestedScopes_CountsOutermostScopeOnly)
+    {
+        CycleCounter counter;
+
+        {
+            ScopedCycleCount outer_scope(counter);
+
+            {
+                ScopedCycleCount inner_scope(counter);
+            }
+
+            EXPECT_EQ(0, counter.get_call_count());
+        }
+
+        EXPECT_EQ(1, counter.get_call_count());
+    }
+
+    TEST_CASE(Clear_ResetsCounters)
+    {
+        CycleCounter counter;
+
+        {
+            ScopedCycleCount scope(counter);
+        }
+
+        counter.clear();
+
+        EXPECT_EQ(0, counter.get_ticks());
+        EXPECT_EQ(0, counter.get_call_count());
+    }
+}
@@ -0,0 +1,135 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/modeling/entity/entity.h"
+#include "renderer/modeling/entity/entitypreparation.h"
+#include "renderer/modeling/entity/entityvector.h"
+#include "renderer/utility/testutils.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/job/jobmanager.h"
+#include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/string.h"
+#include "foundation/utility/test.h"
+
+// boost headers.
+#include "boost/cstdint.hpp"
+
+// Standard headers.
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Modeling_Entity_EntityPreparation)
+{
+    class CountingPrepareFunc
+    {
+      public:
+        CountingPrepareFunc(
+            volatile boost::uint32_t*   counter,
+            const char*                 failing_entity_name = "")
+          : m_counter(counter)
+          , m_failing_entity_name(failing_entity_name)
+        {
+        }
+
+        bool operator()(Entity& entity) const
+        {
+            boost_atomic::atomic_inc32(m_counter);
+            return strcmp(entity.get_name(), m_failing_entity_name) != 0;
+        }
+
+      private:
+        volatile boost::uint32_t*       m_counter;
+        const char*                     m_failing_entity_name;
+    };
+
+    struct Fixture
+    {
+        TypedEntityVector<Entity>   m_entities;
+        JobQueue                    m_job_queue;
+        JobManager                  m_job_manager;
+
+        Fixture()
+          : m_job_manager(
+                global_logger(),
+                m_job_queue,
+                4,
+                JobManager::KeepRunningOnEmptyQueue | JobManager::KeepRunningOnJobFailure)
+        {
+            for (size_t i = 0; i < 20; ++i)
+            {
+                const string name = "entity" + to_string(i);
+                m_entities.insert(auto_release_ptr<Entity>(DummyEntityFactory::create(name.c_str())));
+            }
+
+            m_job_manager.start();
+        }
+    };
+
+    TEST_CASE_F(PrepareEntities_GivenJobQueue_PreparesAllEntities, Fixture)
+    {
+        volatile boost::uint32_t counter = 0;
+
+        const bool success =
+            prepare_entities(m_entities, CountingPrepareFunc(&counter), &m_job_queue, 0);
+
+        EXPECT_TRUE(success);
+        EXPECT_EQ(20, counter);
+    }
+
+    TEST_CASE_F(PrepareEntities_GivenJobQueueAndFailingEntity_PreparesAllEntitiesAndReturnsFalse, Fixture)
+    {
+        volatile boost::uint32_t counter = 0;
+
+        const bool success =
+            prepare_entities(m_entities, CountingPrepareFunc(&counter, "entity7"), &m_job_queue, 0);
+
+        EXPECT_FALSE(success);
+        EXPECT_EQ(20, counter);
+    }
+
+    TEST_CASE_F(PrepareEntities_GivenNoJobQueueAndFailingEntity_StopsAtFailingEntity, Fixture)
+    {
+        volatile boost::uint32_t counter = 0;
+
+        const bool success =
+            prepare_entities(m_entities, CountingPrepareFunc(&counter, "entity7"), 0, 0);
+
+        EXPECT_FALSE(success);
+        EXPECT_EQ(8, counter);
+    }
+}
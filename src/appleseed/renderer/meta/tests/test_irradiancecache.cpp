@@ -0,0 +1,121 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/drt/irradiancecache.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Lighting_DRT_IrradianceCache)
+{
+    struct Fixture
+    {
+        IrradianceCache m_cache;
+
+        Fixture()
+          : m_cache(
+                GAABB3(GVector3(-10.0f), GVector3(10.0f)),
+                0.5,        // max error
+                0.01,       // min spacing
+                1.0)        // max spacing
+        {
+        }
+    };
+
+    TEST_CASE_F(Lookup_GivenEmptyCache_ReturnsFalse, Fixture)
+    {
+        Spectrum irradiance;
+        const bool found =
+            m_cache.lookup(Vector3d(0.0), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE_F(Lookup_GivenRecordAtLookupPoint_ReturnsRecordIrradiance, Fixture)
+    {
+        m_cache.insert(Vector3d(1.0, 2.0, 3.0), Vector3d(0.0, 1.0, 0.0), Spectrum(0.5f), 1.0);
+
+        Spectrum irradiance;
+        const bool found =
+            m_cache.lookup(Vector3d(1.0, 2.0, 3.0), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        ASSERT_TRUE(found);
+        EXPECT_FEQ(Spectrum(0.5f), irradiance);
+    }
+
+    TEST_CASE_F(Lookup_GivenRecordOutsideRadiusOfValidity_ReturnsFalse, Fixture)
+    {
+        m_cache.insert(Vector3d(1.0, 2.0, 3.0), Vector3d(0.0, 1.0, 0.0), Spectrum(0.5f), 1.0);
+
+        Spectrum irradiance;
+        const bool found =
+            m_cache.lookup(Vector3d(2.0, 2.0, 3.0), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE_F(Lookup_GivenRecordWithOppositeNormal_ReturnsFalse, Fixture)
+    {
+        m_cache.insert(Vector3d(1.0, 2.0, 3.0), Vector3d(0.0, 1.0, 0.0), Spectrum(0.5f), 1.0);
+
+        Spectrum irradiance;
+        const bool found =
+            m_cache.lookup(Vector3d(1.0, 2.0, 3.0), Vector3d(0.0, -1.0, 0.0), irradiance);
+
+        EXPECT_FALSE(found);
+    }
+
+    TEST_CASE_F(Lookup_GivenTwoRecordsAtSameDistance_ReturnsAverageIrradiance, Fixture)
+    {
+        m_cache.insert(Vector3d(-0.1, 0.0, 0.0), Vector3d(0.0, 1.0, 0.0), Spectrum(1.0f), 1.0);
+        m_cache.insert(Vector3d(+0.1, 0.0, 0.0), Vector3d(0.0, 1.0, 0.0), Spectrum(3.0f), 1.0);
+
+        Spectrum irradiance;
+        const bool found =
+            m_cache.lookup(Vector3d(0.0), Vector3d(0.0, 1.0, 0.0), irradiance);
+
+        ASSERT_TRUE(found);
+        EXPECT_FEQ(Spectrum(2.0f), irradiance);
+    }
+
+    TEST_CASE_F(Clear_RemovesAllRecords, Fixture)
+    {
+        m_cache.insert(Vector3d(0.0), Vector3d(0.0, 1.0, 0.0), Spectrum(1.0f), 1.0);
+
+        m_cache.clear();
+
+        EXPECT_EQ(0, m_cache.size());
+    }
+}
@@ -0,0 +1,115 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/permanentshadingresultframebufferfactory.h"
+#include "renderer/kernel/rendering/shadingresultframebuffer.h"
+#include "renderer/kernel/shading/shadingresult.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/aabb.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Rendering_PermanentShadingResultFrameBufferFactory)
+{
+    struct Fixture
+    {
+        auto_release_ptr<Frame> m_frame;
+
+        Fixture()
+          : m_frame(
+                FrameFactory::create(
+                    "frame",
+                    ParamArray()
+                        .insert("resolution", "4 4")
+                        .insert("tile_size", "4 4")
+                        .insert("pixel_format", "float")))
+        {
+        }
+
+        // Accumulate the same sample into the framebuffer of the only tile over many
+        // passes, then return the value of the red channel of the pixel under the sample.
+        float accumulate_passes(const char* storage, const size_t pass_count)
+        {
+            PermanentShadingResultFrameBufferFactory factory(
+                m_frame.ref(),
+                ParamArray().insert("storage", storage));
+
+            const AABB2u tile_bbox(Vector2u(0, 0), Vector2u(3, 3));
+
+            ShadingResult sample;
+            sample.set_main_to_linear_rgba(Color4f(0.3f, 0.3f, 0.3f, 1.0f));
+
+            for (size_t i = 0; i < pass_count; ++i)
+            {
+                ShadingResultFrameBuffer* framebuffer =
+                    factory.create(m_frame.ref(), 0, 0, tile_bbox);
+                framebuffer->add(2.5, 2.5, sample);
+                factory.destroy(framebuffer);
+            }
+
+            ShadingResultFrameBuffer* framebuffer =
+                factory.create(m_frame.ref(), 0, 0, tile_bbox);
+            const float* values = framebuffer->pixel(2, 2);
+            const float weight = values[0];
+            const float red = values[1] / weight;
+            factory.destroy(framebuffer);
+
+            return red;
+        }
+    };
+
+    // Enough passes for the accumulated weight to exceed the range where halfs can
+    // represent the contribution of a single pass.
+    const size_t PassCount = 5000;
+
+    TEST_CASE_F(Create_GivenHalfStorage_PreservesValueAccumulatedOverManyPasses, Fixture)
+    {
+        const float red = accumulate_passes("half", PassCount);
+
+        EXPECT_FEQ_EPS(0.3f, red, 1.0e-3f);
+    }
+
+    TEST_CASE_F(Create_GivenCompressedStorage_PreservesValueAccumulatedOverManyPasses, Fixture)
+    {
+        const float red = accumulate_passes("compressed", PassCount);
+
+        EXPECT_FEQ_EPS(0.3f, red, 1.0e-6f);
+    }
+}
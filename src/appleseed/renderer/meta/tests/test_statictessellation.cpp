@@ -0,0 +1,104 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/tessellation/statictessellation.h"
+
+// appleseed.foundation headers.
+#include "foundation/math/vector.h"
+#include "foundation/utility/iostreamop.h"
+#include "foundation/utility/test.h"
+
+using namespace foundation;
+using namespace renderer;
+
+TEST_SUITE(Renderer_Kernel_Tessellation_StaticTessellation)
+{
+    TEST_CASE(GetVertexNormal_FullPrecisionStorage_ReturnsInsertedNormal)
+    {
+        StaticTriangleTess tess;
+        const GVector3 n = normalize(GVector3(1.0f, 2.0f, -3.0f));
+
+        tess.push_vertex_normal(n);
+
+        EXPECT_EQ(1, tess.get_vertex_normal_count());
+        EXPECT_EQ(n, tess.get_vertex_normal(0));
+    }
+
+    TEST_CASE(GetVertexNormal_CompactStorage_ReturnsUnitNormalCloseToInsertedNormal)
+    {
+        StaticTriangleTess tess;
+        tess.set_storage_options(true, false);
+        const GVector3 n = normalize(GVector3(1.0f, 2.0f, -3.0f));
+
+        tess.push_vertex_normal(n);
+
+        EXPECT_EQ(1, tess.get_vertex_normal_count());
+        EXPECT_FEQ_EPS(n, tess.get_vertex_normal(0), 1.0e-4f);
+        EXPECT_FEQ_EPS(1.0f, norm(tess.get_vertex_normal(0)), 1.0e-5f);
+    }
+
+    TEST_CASE(GetUVVertex_HalfPrecisionStorage_ReturnsUVCloseToInsertedUV)
+    {
+        StaticTriangleTess tess;
+        tess.set_storage_options(false, true);
+
+        tess.push_uv_vertex(GVector2(0.25f, 0.7f));
+        tess.push_uv_vertex(GVector2(1.0f, 0.0f));
+
+        EXPECT_EQ(2, tess.get_uv_vertex_count());
+        EXPECT_FEQ_EPS(GVector2(0.25f, 0.7f), tess.get_uv_vertex(0), 1.0e-3f);
+        EXPECT_EQ(GVector2(1.0f, 0.0f), tess.get_uv_vertex(1));
+    }
+
+    TEST_CASE(GetVertexPose_GivenPoseWasSet_ReturnsPose)
+    {
+        StaticTriangleTess tess;
+        tess.m_vertices.push_back(GVector3(0.0f));
+        tess.m_vertices.push_back(GVector3(1.0f));
+        tess.set_motion_segment_count(2);
+
+        tess.set_vertex_pose(1, 1, GVector3(2.0f, 3.0f, 4.0f));
+
+        EXPECT_EQ(GVector3(0.0f), tess.get_vertex_pose(0, 0));
+        EXPECT_EQ(GVector3(2.0f, 3.0f, 4.0f), tess.get_vertex_pose(1, 1));
+    }
+
+    TEST_CASE(ComputeLocalBBox_GivenVertexPoses_IncludesPoses)
+    {
+        StaticTriangleTess tess;
+        tess.m_vertices.push_back(GVector3(1.0f));
+        tess.set_motion_segment_count(1);
+        tess.set_vertex_pose(0, 0, GVector3(2.0f));
+
+        const GAABB3 bbox = tess.compute_local_bbox();
+
+        EXPECT_EQ(GAABB3(GVector3(1.0f), GVector3(2.0f)), bbox);
+    }
+}
@@ -0,0 +1,90 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/texturing/texturefilecache.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/colorspace.h"
+#include "foundation/image/exrutils.h"
+#include "foundation/image/pixel.h"
+#include "foundation/utility/test.h"
+
+// boost headers.
+#include "boost/filesystem/operations.hpp"
+
+// Standard headers.
+#include <string>
+
+using namespace boost;
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Texturing_TextureFileCache)
+{
+    const char* InputFilePath = "unit tests/inputs/test_projectfilewriter_texture.png";
+    const char* CacheDirectory = "unit tests/outputs/test_texturefilecache";
+
+    TEST_CASE(NeedsConversion_GivenPNGFile_ReturnsTrue)
+    {
+        EXPECT_TRUE(TextureFileCache::needs_conversion(InputFilePath));
+    }
+
+    TEST_CASE(GetCacheFile_GivenPNGFile_WritesTiledOpenEXRFile)
+    {
+        const TextureFileCache cache(CacheDirectory, PixelFormatHalf, 16, 16);
+
+        const string cache_filepath = cache.get_cache_file(InputFilePath, ColorSpaceSRGB);
+
+        ASSERT_TRUE(filesystem::exists(cache_filepath));
+        EXPECT_TRUE(is_tiled_openexr_file(cache_filepath.c_str()));
+        EXPECT_FALSE(TextureFileCache::needs_conversion(cache_filepath));
+    }
+
+    TEST_CASE(GetCacheFile_CalledTwice_ReturnsSameCacheFile)
+    {
+        const TextureFileCache cache(CacheDirectory, PixelFormatFloat, 16, 16);
+
+        const string cache_filepath1 = cache.get_cache_file(InputFilePath, ColorSpaceSRGB);
+        const string cache_filepath2 = cache.get_cache_file(InputFilePath, ColorSpaceSRGB);
+
+        EXPECT_EQ(cache_filepath1, cache_filepath2);
+    }
+
+    TEST_CASE(GetCacheFile_GivenDifferentSettings_ReturnsDifferentCacheFiles)
+    {
+        const TextureFileCache half_cache(CacheDirectory, PixelFormatHalf, 16, 16);
+        const TextureFileCache float_cache(CacheDirectory, PixelFormatFloat, 16, 16);
+
+        const string half_cache_filepath = half_cache.get_cache_file(InputFilePath, ColorSpaceSRGB);
+        const string float_cache_filepath = float_cache.get_cache_file(InputFilePath, ColorSpaceSRGB);
+
+        EXPECT_NEQ(half_cache_filepath, float_cache_filepath);
+    }
+}
@@ -0,0 +1,386 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/kernel/rendering/generic/tilejob.h"
+#include "renderer/kernel/rendering/generic/tilejobfactory.h"
+#include "renderer/kernel/rendering/itilecallback.h"
+#include "renderer/kernel/rendering/itilerenderer.h"
+#include "renderer/modeling/frame/frame.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/image.h"
+#include "foundation/image/tile.h"
+#include "foundation/math/aabb.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/statistics.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Rendering_Generic_TileJobFactory)
+{
+    struct RenderedRegion
+    {
+        size_t  m_tile_index;
+        AABB2u  m_region;
+    };
+
+    class RecordingTileRenderer
+      : public ITileRenderer
+    {
+      public:
+        vector<RenderedRegion>  m_rendered_regions;
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual void render_tile(
+            const Frame&                frame,
+            const size_t                tile_x,
+            const size_t                tile_y,
+            const AABB2u&               tile_region,
+            const size_t                pass_hash,
+            AbortSwitch&                abort_switch) OVERRIDE
+        {
+            // Make sure the rendering time of the job is measurable.
+            foundation::sleep(5);
+
+            RenderedRegion rendered_region;
+            rendered_region.m_tile_index = tile_y * frame.image().properties().m_tile_count_x + tile_x;
+            rendered_region.m_region = tile_region;
+            m_rendered_regions.push_back(rendered_region);
+        }
+
+        virtual StatisticsVector get_statistics() const OVERRIDE
+        {
+            return StatisticsVector();
+        }
+    };
+
+    class RecordingTileCallback
+      : public ITileCallback
+    {
+      public:
+        const vector<RenderedRegion>&   m_rendered_regions;
+        vector<size_t>                  m_post_render_tile_calls;   // tile index and number of rendered regions at each call
+
+        explicit RecordingTileCallback(const vector<RenderedRegion>& rendered_regions)
+          : m_rendered_regions(rendered_regions)
+        {
+        }
+
+        virtual void release() OVERRIDE
+        {
+            delete this;
+        }
+
+        virtual void pre_render(
+            const size_t    x,
+            const size_t    y,
+            const size_t    width,
+            const size_t    height) OVERRIDE
+        {
+        }
+
+        virtual void post_render_tile(
+            const Frame*    frame,
+            const size_t    tile_x,
+            const size_t    tile_y) OVERRIDE
+        {
+            m_post_render_tile_calls.push_back(tile_y * frame->image().properties().m_tile_count_x + tile_x);
+            m_post_render_tile_calls.push_back(m_rendered_regions.size());
+        }
+
+        virtual void post_render(const Frame* frame) OVERRIDE
+        {
+        }
+    };
+
+    struct Fixture
+    {
+        auto_release_ptr<Frame>             m_frame;
+        RecordingTileRenderer*              m_tile_renderer;
+        TileJob::TileRendererVector         m_tile_renderers;
+        TileJob::TileCallbackVector         m_tile_callbacks;
+        AbortSwitch                         m_abort_switch;
+        TileJobFactory                      m_factory;
+
+        // 7x5 pixels with 4x4 tiles: tiles are 4x4, 3x4, 4x1 and 3x1 pixels.
+        Fixture()
+          : m_frame(
+                FrameFactory::create(
+                    "frame",
+                    ParamArray()
+                        .insert("resolution", "7 5")
+                        .insert("tile_size", "4 4")))
+          , m_tile_renderer(new RecordingTileRenderer())
+        {
+            m_tile_renderers.push_back(m_tile_renderer);
+        }
+
+        ~Fixture()
+        {
+            for (size_t i = 0; i < m_tile_callbacks.size(); ++i)
+                m_tile_callbacks[i]->release();
+
+            m_tile_renderer->release();
+        }
+
+        void create_jobs(
+            const bool                      cost_driven_scheduling,
+            const size_t                    split_tile_count,
+            TileJobFactory::TileJobVector&  tile_jobs)
+        {
+            m_factory.create(
+                m_frame.ref(),
+                TileJobFactory::LinearOrdering,
+                cost_driven_scheduling,
+                split_tile_count,
+                m_tile_renderers,
+                m_tile_callbacks,
+                0,
+                tile_jobs,
+                m_abort_switch);
+        }
+
+        // Execute the jobs in order on a single thread, delete them and
+        // return the regions they rendered, in rendering order.
+        vector<RenderedRegion> execute_jobs(TileJobFactory::TileJobVector& tile_jobs)
+        {
+            m_tile_renderer->m_rendered_regions.clear();
+
+            for (size_t i = 0; i < tile_jobs.size(); ++i)
+            {
+                tile_jobs[i]->execute(0);
+                delete tile_jobs[i];
+            }
+
+            tile_jobs.clear();
+
+            return m_tile_renderer->m_rendered_regions;
+        }
+
+        vector<RenderedRegion> render(
+            const bool                      cost_driven_scheduling,
+            const size_t                    split_tile_count)
+        {
+            TileJobFactory::TileJobVector tile_jobs;
+            create_jobs(cost_driven_scheduling, split_tile_count, tile_jobs);
+            return execute_jobs(tile_jobs);
+        }
+
+        // Record a cost for the given tile only; the cost of other tiles is exactly 0.
+        // Without recorded costs and without splitting, job i renders tile i.
+        void record_single_tile_cost(const size_t tile_index)
+        {
+            TileJobFactory::TileJobVector tile_jobs;
+            create_jobs(false, 0, tile_jobs);
+
+            tile_jobs[tile_index]->execute(0);
+
+            for (size_t i = 0; i < tile_jobs.size(); ++i)
+                delete tile_jobs[i];
+
+            m_factory.record_tile_costs();
+        }
+
+        // Return the number of times each pixel of a tile is covered by the given regions.
+        vector<size_t> compute_coverage(
+            const vector<RenderedRegion>&   regions,
+            const size_t                    tile_index) const
+        {
+            const Image& image = m_frame->image();
+            const size_t tile_count_x = image.properties().m_tile_count_x;
+            const Tile& tile = image.tile(tile_index % tile_count_x, tile_index / tile_count_x);
+
+            vector<size_t> coverage(tile.get_pixel_count(), 0);
+
+            for (size_t i = 0; i < regions.size(); ++i)
+            {
+                if (regions[i].m_tile_index != tile_index)
+                    continue;
+
+                const AABB2u& r = regions[i].m_region;
+
+                for (size_t y = r.min.y; y <= r.max.y; ++y)
+                {
+                    for (size_t x = r.min.x; x <= r.max.x; ++x)
+                    {
+                        if (x < tile.get_width() && y < tile.get_height())
+                            ++coverage[y * tile.get_width() + x];
+                    }
+                }
+            }
+
+            return coverage;
+        }
+
+        bool is_covered_once(
+            const vector<RenderedRegion>&   regions,
+            const size_t                    tile_index) const
+        {
+            const vector<size_t> coverage = compute_coverage(regions, tile_index);
+
+            for (size_t i = 0; i < coverage.size(); ++i)
+            {
+                if (coverage[i] != 1)
+                    return false;
+            }
+
+            return true;
+        }
+    };
+
+    size_t count_jobs(const vector<RenderedRegion>& regions, const size_t tile_index)
+    {
+        size_t count = 0;
+
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            if (regions[i].m_tile_index == tile_index)
+                ++count;
+        }
+
+        return count;
+    }
+
+    bool is_inside_tile(const vector<RenderedRegion>& regions, const Image& image)
+    {
+        const size_t tile_count_x = image.properties().m_tile_count_x;
+
+        for (size_t i = 0; i < regions.size(); ++i)
+        {
+            const size_t tile_index = regions[i].m_tile_index;
+            const Tile& tile = image.tile(tile_index % tile_count_x, tile_index / tile_count_x);
+            const AABB2u& r = regions[i].m_region;
+
+            if (r.max.x >= tile.get_width() || r.max.y >= tile.get_height())
+                return false;
+        }
+
+        return true;
+    }
+
+    TEST_CASE_F(Create_GivenNoRecordedCosts_UsesTileOrdering, Fixture)
+    {
+        const vector<RenderedRegion> regions = render(true, 0);
+
+        ASSERT_EQ(4, regions.size());
+        EXPECT_EQ(0, regions[0].m_tile_index);
+        EXPECT_EQ(1, regions[1].m_tile_index);
+        EXPECT_EQ(2, regions[2].m_tile_index);
+        EXPECT_EQ(3, regions[3].m_tile_index);
+    }
+
+    TEST_CASE_F(Create_GivenRecordedCosts_SchedulesCostliestTileFirstAndKeepsTileOrderingForTies, Fixture)
+    {
+        record_single_tile_cost(2);
+
+        const vector<RenderedRegion> regions = render(true, 0);
+
+        ASSERT_EQ(4, regions.size());
+        EXPECT_EQ(2, regions[0].m_tile_index);
+        EXPECT_EQ(0, regions[1].m_tile_index);
+        EXPECT_EQ(1, regions[2].m_tile_index);
+        EXPECT_EQ(3, regions[3].m_tile_index);
+    }
+
+    TEST_CASE_F(Create_GivenRecordedCostsAndCostDrivenSchedulingDisabled_UsesTileOrdering, Fixture)
+    {
+        record_single_tile_cost(2);
+
+        const vector<RenderedRegion> regions = render(false, 0);
+
+        ASSERT_EQ(4, regions.size());
+        EXPECT_EQ(0, regions[0].m_tile_index);
+        EXPECT_EQ(1, regions[1].m_tile_index);
+        EXPECT_EQ(2, regions[2].m_tile_index);
+        EXPECT_EQ(3, regions[3].m_tile_index);
+    }
+
+    TEST_CASE_F(Create_GivenAllTilesSplit_CoversEachPixelOfEachTileExactlyOnce, Fixture)
+    {
+        const vector<RenderedRegion> regions = render(false, 4);
+
+        // Tiles of one pixel in height are only split horizontally.
+        EXPECT_EQ(4, count_jobs(regions, 0));
+        EXPECT_EQ(4, count_jobs(regions, 1));
+        EXPECT_EQ(2, count_jobs(regions, 2));
+        EXPECT_EQ(2, count_jobs(regions, 3));
+
+        EXPECT_TRUE(is_inside_tile(regions, m_frame->image()));
+
+        for (size_t i = 0; i < 4; ++i)
+            EXPECT_TRUE(is_covered_once(regions, i));
+    }
+
+    TEST_CASE_F(Create_GivenOneSplitTile_OnlySplitsLastTile, Fixture)
+    {
+        const vector<RenderedRegion> regions = render(false, 1);
+
+        EXPECT_EQ(1, count_jobs(regions, 0));
+        EXPECT_EQ(1, count_jobs(regions, 1));
+        EXPECT_EQ(1, count_jobs(regions, 2));
+        EXPECT_EQ(2, count_jobs(regions, 3));
+
+        for (size_t i = 0; i < 4; ++i)
+            EXPECT_TRUE(is_covered_once(regions, i));
+    }
+
+    TEST_CASE_F(Execute_GivenSplitTiles_CallsPostRenderTileCallbackOncePerTileAfterItsLastRegion, Fixture)
+    {
+        RecordingTileCallback* tile_callback =
+            new RecordingTileCallback(m_tile_renderer->m_rendered_regions);
+        m_tile_callbacks.push_back(tile_callback);
+
+        render(false, 2);
+
+        // Tiles 0 and 1 are rendered in one region, tiles 2 and 3 in two regions each.
+        ASSERT_EQ(8, tile_callback->m_post_render_tile_calls.size());
+        EXPECT_EQ(0, tile_callback->m_post_render_tile_calls[0]);
+        EXPECT_EQ(1, tile_callback->m_post_render_tile_calls[1]);
+        EXPECT_EQ(1, tile_callback->m_post_render_tile_calls[2]);
+        EXPECT_EQ(2, tile_callback->m_post_render_tile_calls[3]);
+        EXPECT_EQ(2, tile_callback->m_post_render_tile_calls[4]);
+        EXPECT_EQ(4, tile_callback->m_post_render_tile_calls[5]);
+        EXPECT_EQ(3, tile_callback->m_post_render_tile_calls[6]);
+        EXPECT_EQ(6, tile_callback->m_post_render_tile_calls[7]);
+    }
+}
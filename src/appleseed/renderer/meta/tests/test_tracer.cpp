@@ -661,6 +661,52 @@ TEST_SUITE(Renderer_Kernel_Lighting_Tracer)
         EXPECT_FEQ(0.5, transmission);
     }
 
+    TEST_CASE_F(TraceOpaqueProbe_GivenSingleOpaqueOccluder_ReturnsHit, Fixture<SceneWithSingleOpaqueOccluder>)
+    {
+        const ShadingRay ray(
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 0.0, 0.0),
+            0.0,
+            ShadingRay::ShadowRay,
+            0);
+
+        bool hit_transparent;
+        const bool hit = m_intersector.trace_opaque_probe(ray, hit_transparent);
+
+        EXPECT_TRUE(hit);
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenSingleTransparentOccluder_ReportsTransparentHitOnly, Fixture<SceneWithSingleTransparentOccluder>)
+    {
+        const ShadingRay ray(
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 0.0, 0.0),
+            0.0,
+            ShadingRay::ShadowRay,
+            0);
+
+        bool hit_transparent;
+        const bool hit = m_intersector.trace_opaque_probe(ray, hit_transparent);
+
+        EXPECT_FALSE(hit);
+        EXPECT_TRUE(hit_transparent);
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenTransparentThenOpaqueOccluders_ReturnsHit, Fixture<SceneWithTransparentThenOpaqueOccluders>)
+    {
+        const ShadingRay ray(
+            Vector3d(0.0, 0.0, 0.0),
+            Vector3d(1.0, 0.0, 0.0),
+            0.0,
+            ShadingRay::ShadowRay,
+            0);
+
+        bool hit_transparent;
+        const bool hit = m_intersector.trace_opaque_probe(ray, hit_transparent);
+
+        EXPECT_TRUE(hit);
+    }
+
     struct SceneWithTwoOpaqueOccluders
       : public SceneBase
     {
@@ -870,3 +870,51 @@ TEST_SUITE(Renderer_Utility_TransformSequence)
             bbox);
     }
 }
+
+TEST_SUITE(Renderer_Utility_TransformSequenceCache)
+{
+    struct Fixture
+    {
+        TransformSequence           m_sequence;
+        TransformSequenceCache<4>   m_cache;
+
+        Fixture()
+        {
+            m_sequence.set_transform(
+                0.0,
+                Transformd::from_local_to_parent(
+                    Matrix4d::translation(Vector3d(1.0, 2.0, 3.0))));
+            m_sequence.set_transform(
+                1.0,
+                Transformd::from_local_to_parent(
+                    Matrix4d::translation(Vector3d(4.0, 5.0, 6.0))));
+            m_sequence.prepare();
+        }
+    };
+
+    TEST_CASE_F(Evaluate_ReturnsSameTransformAsSequence, Fixture)
+    {
+        const Transformd& transform = m_cache.evaluate(m_sequence, 0.3);
+
+        EXPECT_FEQ(m_sequence.evaluate(0.3).get_local_to_parent(), transform.get_local_to_parent());
+        EXPECT_FEQ(m_sequence.evaluate(0.3).get_parent_to_local(), transform.get_parent_to_local());
+    }
+
+    TEST_CASE_F(Evaluate_GivenSameTimeTwice_HitsCache, Fixture)
+    {
+        m_cache.evaluate(m_sequence, 0.3);
+        m_cache.evaluate(m_sequence, 0.3);
+
+        EXPECT_EQ(1, m_cache.get_hit_count());
+        EXPECT_EQ(1, m_cache.get_miss_count());
+    }
+
+    TEST_CASE_F(Evaluate_GivenDifferentTimes_ReturnsTransformAtEachTime, Fixture)
+    {
+        m_cache.evaluate(m_sequence, 0.3);
+        const Transformd& transform = m_cache.evaluate(m_sequence, 0.6);
+
+        EXPECT_EQ(0, m_cache.get_hit_count());
+        EXPECT_FEQ(m_sequence.evaluate(0.6).get_local_to_parent(), transform.get_local_to_parent());
+    }
+}
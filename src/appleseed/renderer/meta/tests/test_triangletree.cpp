@@ -0,0 +1,371 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/intersection/intersector.h"
+#include "renderer/kernel/intersection/tracecontext.h"
+#include "renderer/kernel/shading/shadingpoint.h"
+#include "renderer/kernel/shading/shadingray.h"
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/color/colorentity.h"
+#include "renderer/modeling/input/inputbinder.h"
+#include "renderer/modeling/material/genericmaterial.h"
+#include "renderer/modeling/object/meshobject.h"
+#include "renderer/modeling/object/object.h"
+#include "renderer/modeling/object/triangle.h"
+#include "renderer/modeling/scene/assembly.h"
+#include "renderer/modeling/scene/assemblyinstance.h"
+#include "renderer/modeling/scene/containers.h"
+#include "renderer/modeling/scene/objectinstance.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/modeling/surfaceshader/constantsurfaceshader.h"
+#include "renderer/modeling/surfaceshader/surfaceshader.h"
+#include "renderer/utility/paramarray.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/color.h"
+#include "foundation/math/rng/distribution.h"
+#include "foundation/math/rng/mersennetwister.h"
+#include "foundation/math/transform.h"
+#include "foundation/math/vector.h"
+#include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/autoreleaseptr.h"
+#include "foundation/utility/test.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+
+using namespace foundation;
+using namespace renderer;
+using namespace std;
+
+TEST_SUITE(Renderer_Kernel_Intersection_TriangleTree)
+{
+    // Material slots of the test meshes.
+    enum MaterialSlot
+    {
+        OpaqueSlot,                 // opaque material
+        CutoutSlot,                 // fully transparent alpha map: hits are rejected by an intersection filter
+        TranslucentSlot             // partially transparent alpha map: surfaces may be transparent
+    };
+
+    // A scene made of a single mesh, in an assembly whose triangle tree has large leaves.
+    // Leaves of at least four static triangles contain triangle batches unless they are disabled.
+    class TestScene
+    {
+      public:
+        TestScene(auto_release_ptr<MeshObject> mesh_object, const bool triangle_batches)
+          : m_scene(SceneFactory::create())
+        {
+            ParamArray assembly_params;
+            assembly_params.insert_path("acceleration_structure.max_leaf_size", 8);
+            assembly_params.insert_path("acceleration_structure.triangle_batches", triangle_batches);
+
+            auto_release_ptr<Assembly> assembly(
+                AssemblyFactory::create("assembly", assembly_params));
+
+            const Color4f white(1.0f);
+            assembly->colors().insert(
+                ColorEntityFactory::create(
+                    "white",
+                    ParamArray().insert("color_space", "linear_rgb"),
+                    ColorValueArray(3, &white[0]),
+                    ColorValueArray(1, &white[3])));
+
+            assembly->surface_shaders().insert(
+                ConstantSurfaceShaderFactory().create(
+                    "surface_shader",
+                    ParamArray().insert("color", "white")));
+
+            insert_material(assembly.ref(), "opaque_material", 1.0f);
+            insert_material(assembly.ref(), "cutout_material", 0.0f);
+            insert_material(assembly.ref(), "translucent_material", 0.5f);
+
+            mesh_object->push_material_slot("opaque");
+            mesh_object->push_material_slot("cutout");
+            mesh_object->push_material_slot("translucent");
+            assembly->objects().insert(auto_release_ptr<Object>(mesh_object.release()));
+
+            assembly->object_instances().insert(
+                ObjectInstanceFactory::create(
+                    "mesh_inst",
+                    ParamArray(),
+                    "mesh",
+                    Transformd::identity(),
+                    StringDictionary()
+                        .insert("opaque", "opaque_material")
+                        .insert("cutout", "cutout_material")
+                        .insert("translucent", "translucent_material")));
+
+            m_scene->assemblies().insert(assembly);
+            m_scene->assembly_instances().insert(
+                AssemblyInstanceFactory::create("assembly_inst", ParamArray(), "assembly"));
+
+            InputBinder input_binder;
+            input_binder.bind(m_scene.ref());
+
+            m_trace_context.reset(new TraceContext(m_scene.ref()));
+            m_texture_store.reset(new TextureStore(m_scene.ref()));
+            m_texture_cache.reset(new TextureCache(*m_texture_store));
+            m_intersector.reset(new Intersector(*m_trace_context, *m_texture_cache));
+        }
+
+        const Intersector& get_intersector() const
+        {
+            return *m_intersector;
+        }
+
+      private:
+        auto_release_ptr<Scene>     m_scene;
+        auto_ptr<TraceContext>      m_trace_context;
+        auto_ptr<TextureStore>      m_texture_store;
+        auto_ptr<TextureCache>      m_texture_cache;
+        auto_ptr<Intersector>       m_intersector;
+
+        static void insert_material(Assembly& assembly, const char* name, const float alpha)
+        {
+            ParamArray params;
+            params.insert("surface_shader", "surface_shader");
+            params.insert("alpha_map", alpha);
+
+            assembly.materials().insert(GenericMaterialFactory().create(name, params));
+        }
+    };
+
+    // Six triangles in the planes x = 0 to x = 5, all covering the x axis. They fit
+    // in a single leaf: one triangle batch followed by two individual triangles.
+    auto_release_ptr<MeshObject> create_stack()
+    {
+        static const MaterialSlot Slots[] =
+        {
+            OpaqueSlot,
+            CutoutSlot,
+            TranslucentSlot,
+            OpaqueSlot,
+            TranslucentSlot,
+            CutoutSlot
+        };
+
+        auto_release_ptr<MeshObject> mesh_object =
+            MeshObjectFactory::create("mesh", ParamArray());
+
+        mesh_object->push_vertex_normal(GVector3(-1.0f, 0.0f, 0.0f));
+
+        for (size_t i = 0; i < 6; ++i)
+        {
+            const float x = static_cast<float>(i);
+            const size_t v = mesh_object->push_vertex(GVector3(x, -1.0f, -1.0f));
+            mesh_object->push_vertex(GVector3(x, +1.0f, -1.0f));
+            mesh_object->push_vertex(GVector3(x, 0.0f, +1.0f));
+            mesh_object->push_triangle(Triangle(v, v + 1, v + 2, 0, 0, 0, Slots[i]));
+        }
+
+        return mesh_object;
+    }
+
+    // Small random triangles in the unit cube, with all three materials.
+    auto_release_ptr<MeshObject> create_soup()
+    {
+        auto_release_ptr<MeshObject> mesh_object =
+            MeshObjectFactory::create("mesh", ParamArray());
+
+        mesh_object->push_vertex_normal(GVector3(0.0f, 0.0f, 1.0f));
+
+        MersenneTwister rng;
+
+        for (size_t i = 0; i < 256; ++i)
+        {
+            const GVector3 center(rand_float1(rng), rand_float1(rng), rand_float1(rng));
+
+            const size_t v = mesh_object->get_vertex_count();
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                const GVector3 offset(
+                    rand_float1(rng, -0.1f, 0.1f),
+                    rand_float1(rng, -0.1f, 0.1f),
+                    rand_float1(rng, -0.1f, 0.1f));
+                mesh_object->push_vertex(center + offset);
+            }
+
+            mesh_object->push_triangle(Triangle(v, v + 1, v + 2, 0, 0, 0, i % 3));
+        }
+
+        return mesh_object;
+    }
+
+    struct StackFixture
+    {
+        TestScene   m_batched_scene;
+        TestScene   m_unbatched_scene;
+
+        StackFixture()
+          : m_batched_scene(create_stack(), true)
+          , m_unbatched_scene(create_stack(), false)
+        {
+        }
+    };
+
+    const ShadingRay RayFromFront(Vector3d(-1.0, 0.0, 0.0), Vector3d(+1.0, 0.0, 0.0), 0.0, ShadingRay::CameraRay);
+    const ShadingRay RayFromBack(Vector3d(6.0, 0.0, 0.0), Vector3d(-1.0, 0.0, 0.0), 0.0, ShadingRay::CameraRay);
+
+    // Only crosses the triangles in the planes x = 5 and x = 4.
+    const ShadingRay ShortRayFromBack(Vector3d(6.0, 0.0, 0.0), Vector3d(-1.0, 0.0, 0.0), 0.0, 2.5, 0.0, ShadingRay::CameraRay);
+
+    TEST_CASE_F(Trace_GivenRayFromFront_ReturnsFirstTriangle, StackFixture)
+    {
+        ShadingPoint batched_shading_point;
+        ASSERT_TRUE(m_batched_scene.get_intersector().trace(RayFromFront, batched_shading_point));
+
+        ShadingPoint unbatched_shading_point;
+        ASSERT_TRUE(m_unbatched_scene.get_intersector().trace(RayFromFront, unbatched_shading_point));
+
+        EXPECT_EQ(0, batched_shading_point.get_triangle_index());
+        EXPECT_EQ(0, unbatched_shading_point.get_triangle_index());
+        EXPECT_FEQ(1.0, batched_shading_point.get_distance());
+        EXPECT_FEQ(unbatched_shading_point.get_bary(), batched_shading_point.get_bary());
+    }
+
+    TEST_CASE_F(Trace_GivenRayFromBack_SkipsFilteredTriangleAndReturnsFifthTriangle, StackFixture)
+    {
+        ShadingPoint batched_shading_point;
+        ASSERT_TRUE(m_batched_scene.get_intersector().trace(RayFromBack, batched_shading_point));
+
+        ShadingPoint unbatched_shading_point;
+        ASSERT_TRUE(m_unbatched_scene.get_intersector().trace(RayFromBack, unbatched_shading_point));
+
+        EXPECT_EQ(4, batched_shading_point.get_triangle_index());
+        EXPECT_EQ(4, unbatched_shading_point.get_triangle_index());
+        EXPECT_FEQ(2.0, batched_shading_point.get_distance());
+        EXPECT_FEQ(unbatched_shading_point.get_bary(), batched_shading_point.get_bary());
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenRayFromFront_HitsOpaqueTriangle, StackFixture)
+    {
+        bool batched_hit_transparent, unbatched_hit_transparent;
+
+        EXPECT_TRUE(m_batched_scene.get_intersector().trace_opaque_probe(RayFromFront, batched_hit_transparent));
+        EXPECT_TRUE(m_unbatched_scene.get_intersector().trace_opaque_probe(RayFromFront, unbatched_hit_transparent));
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenRayFromBack_SkipsTransparentTrianglesAndHitsOpaqueTriangle, StackFixture)
+    {
+        bool batched_hit_transparent, unbatched_hit_transparent;
+
+        EXPECT_TRUE(m_batched_scene.get_intersector().trace_opaque_probe(RayFromBack, batched_hit_transparent));
+        EXPECT_TRUE(m_unbatched_scene.get_intersector().trace_opaque_probe(RayFromBack, unbatched_hit_transparent));
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenRayCrossingOnlyTransparentTriangles_ReturnsFalse, StackFixture)
+    {
+        bool batched_hit_transparent = false;
+        EXPECT_FALSE(m_batched_scene.get_intersector().trace_opaque_probe(ShortRayFromBack, batched_hit_transparent));
+        EXPECT_TRUE(batched_hit_transparent);
+
+        bool unbatched_hit_transparent = false;
+        EXPECT_FALSE(m_unbatched_scene.get_intersector().trace_opaque_probe(ShortRayFromBack, unbatched_hit_transparent));
+        EXPECT_TRUE(unbatched_hit_transparent);
+    }
+
+    struct SoupFixture
+    {
+        static const size_t RayCount = 1000;
+
+        TestScene   m_batched_scene;
+        TestScene   m_unbatched_scene;
+        ShadingRay  m_rays[RayCount];
+
+        SoupFixture()
+          : m_batched_scene(create_soup(), true)
+          , m_unbatched_scene(create_soup(), false)
+        {
+            MersenneTwister rng;
+
+            // Rays from random points around the unit cube toward random points inside it.
+            for (size_t i = 0; i < RayCount; ++i)
+            {
+                const Vector3d org(
+                    rand_double2(rng, -1.0, 2.0),
+                    rand_double2(rng, -1.0, 2.0),
+                    -1.0);
+                const Vector3d target(
+                    rand_double2(rng),
+                    rand_double2(rng),
+                    rand_double2(rng));
+
+                m_rays[i] = ShadingRay(org, normalize(target - org), 0.0, ShadingRay::CameraRay);
+            }
+        }
+    };
+
+    TEST_CASE_F(Trace_GivenTriangleSoup_BatchedAndUnbatchedTreesReturnSameHits, SoupFixture)
+    {
+        size_t hit_count = 0;
+
+        for (size_t i = 0; i < RayCount; ++i)
+        {
+            ShadingPoint batched_shading_point;
+            const bool batched_hit = m_batched_scene.get_intersector().trace(m_rays[i], batched_shading_point);
+
+            ShadingPoint unbatched_shading_point;
+            const bool unbatched_hit = m_unbatched_scene.get_intersector().trace(m_rays[i], unbatched_shading_point);
+
+            ASSERT_EQ(unbatched_hit, batched_hit);
+
+            if (batched_hit)
+            {
+                EXPECT_EQ(unbatched_shading_point.get_triangle_index(), batched_shading_point.get_triangle_index());
+                EXPECT_FEQ(unbatched_shading_point.get_distance(), batched_shading_point.get_distance());
+                EXPECT_FEQ(unbatched_shading_point.get_bary(), batched_shading_point.get_bary());
+                ++hit_count;
+            }
+        }
+
+        EXPECT_GT(RayCount / 4, hit_count);
+    }
+
+    TEST_CASE_F(TraceOpaqueProbe_GivenTriangleSoup_BatchedAndUnbatchedTreesReturnSameResults, SoupFixture)
+    {
+        for (size_t i = 0; i < RayCount; ++i)
+        {
+            bool batched_hit_transparent = false;
+            const bool batched_hit =
+                m_batched_scene.get_intersector().trace_opaque_probe(m_rays[i], batched_hit_transparent);
+
+            bool unbatched_hit_transparent = false;
+            const bool unbatched_hit =
+                m_unbatched_scene.get_intersector().trace_opaque_probe(m_rays[i], unbatched_hit_transparent);
+
+            ASSERT_EQ(unbatched_hit, batched_hit);
+            ASSERT_EQ(unbatched_hit_transparent, batched_hit_transparent);
+        }
+    }
+}
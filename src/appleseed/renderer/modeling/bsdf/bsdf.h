@@ -138,6 +138,7 @@ class DLLSYMBOL BSDF
     bool is_purely_glossy_or_specular() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other BSDFs of the scene.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
         const Project&              project,
@@ -90,6 +90,7 @@ class DLLSYMBOL EDF
     double get_uncached_importance_multiplier() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other EDFs of the scene.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
         const Project&              project,
@@ -51,6 +51,11 @@ namespace renderer
 //
 // Base class for all entities in the scene.
 //
+// Entities of a given kind are prepared concurrently before rendering each frame:
+// their on_frame_begin() method may run on several threads at the same time, each
+// thread preparing a different entity. It must not modify state shared with other
+// entities without synchronization.
+//
 
 class DLLSYMBOL Entity
   : public foundation::Identifiable
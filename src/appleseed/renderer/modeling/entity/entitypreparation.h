@@ -0,0 +1,264 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_ENTITY_ENTITYPREPARATION_H
+#define APPLESEED_RENDERER_MODELING_ENTITY_ENTITYPREPARATION_H
+
+// appleseed.foundation headers.
+#include "foundation/platform/thread.h"
+#include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/job/ijob.h"
+#include "foundation/utility/job/jobqueue.h"
+#include "foundation/utility/foreach.h"
+
+// boost headers.
+#include "boost/cstdint.hpp"
+
+// OSL headers.
+#ifdef WITH_OSL
+#include <OSL/oslexec.h>
+#endif
+
+// Standard headers.
+#include <cstddef>
+
+// Forward declarations.
+namespace renderer      { class Assembly; }
+namespace renderer      { class Project; }
+
+namespace renderer
+{
+
+//
+// Invoke a preparation function (typically a call to on_frame_begin()) on all the
+// entities of a collection and return true if all preparations succeeded.
+//
+// If a job queue is provided, entities are prepared concurrently, one job per entity,
+// and the function returns once all jobs are completed. The job queue must be serviced
+// by a running job manager. Otherwise entities are prepared sequentially and the first
+// failure stops the preparation.
+//
+// The preparation function is a functor with the following signature:
+//
+//   bool operator()(Entity& entity) const;
+//
+
+template <typename EntityCollection, typename PrepareFunc>
+bool prepare_entities(
+    EntityCollection&               entities,
+    const PrepareFunc&              prepare_func,
+    foundation::JobQueue*           job_queue,
+    foundation::AbortSwitch*        abort_switch);
+
+
+//
+// Preparation functions invoking on_frame_begin() on scene entities, assembly entities
+// and assemblies.
+//
+
+class InvokeOnFrameBegin
+{
+  public:
+    InvokeOnFrameBegin(
+        const Project&                  project,
+        foundation::AbortSwitch*        abort_switch)
+      : m_project(project)
+      , m_abort_switch(abort_switch)
+    {
+    }
+
+    template <typename Entity>
+    bool operator()(Entity& entity) const
+    {
+        return entity.on_frame_begin(m_project, m_abort_switch);
+    }
+
+  private:
+    const Project&                      m_project;
+    foundation::AbortSwitch*            m_abort_switch;
+};
+
+class InvokeAssemblyEntityOnFrameBegin
+{
+  public:
+    InvokeAssemblyEntityOnFrameBegin(
+        const Project&                  project,
+        const Assembly&                 assembly,
+        foundation::AbortSwitch*        abort_switch)
+      : m_project(project)
+      , m_assembly(assembly)
+      , m_abort_switch(abort_switch)
+    {
+    }
+
+    template <typename Entity>
+    bool operator()(Entity& entity) const
+    {
+        return entity.on_frame_begin(m_project, m_assembly, m_abort_switch);
+    }
+
+  private:
+    const Project&                      m_project;
+    const Assembly&                     m_assembly;
+    foundation::AbortSwitch*            m_abort_switch;
+};
+
+class InvokeAssemblyOnFrameBegin
+{
+  public:
+    InvokeAssemblyOnFrameBegin(
+        const Project&                  project,
+#ifdef WITH_OSL
+        OSL::ShadingSystem*             shading_system,
+#endif
+        foundation::AbortSwitch*        abort_switch,
+        foundation::JobQueue*           job_queue)
+      : m_project(project)
+#ifdef WITH_OSL
+      , m_shading_system(shading_system)
+#endif
+      , m_abort_switch(abort_switch)
+      , m_job_queue(job_queue)
+    {
+    }
+
+    template <typename Entity>
+    bool operator()(Entity& assembly) const
+    {
+        return
+            assembly.on_frame_begin(
+                m_project,
+#ifdef WITH_OSL
+                m_shading_system,
+#endif
+                m_abort_switch,
+                m_job_queue);
+    }
+
+  private:
+    const Project&                      m_project;
+#ifdef WITH_OSL
+    OSL::ShadingSystem*                 m_shading_system;
+#endif
+    foundation::AbortSwitch*            m_abort_switch;
+    foundation::JobQueue*               m_job_queue;
+};
+
+
+//
+// Implementation.
+//
+
+namespace entity_preparation_impl
+{
+    template <typename Entity, typename PrepareFunc>
+    class PrepareEntityJob
+      : public foundation::IJob
+    {
+      public:
+        PrepareEntityJob(
+            Entity&                     entity,
+            const PrepareFunc&          prepare_func,
+            foundation::AbortSwitch*    abort_switch,
+            volatile boost::uint32_t*   failed)
+          : m_entity(entity)
+          , m_prepare_func(prepare_func)
+          , m_abort_switch(abort_switch)
+          , m_failed(failed)
+        {
+        }
+
+        virtual void execute(const size_t thread_index)
+        {
+            if (foundation::is_aborted(m_abort_switch))
+                return;
+
+            try
+            {
+                if (!m_prepare_func(m_entity))
+                    boost_atomic::atomic_write32(m_failed, 1);
+            }
+            catch (...)
+            {
+                boost_atomic::atomic_write32(m_failed, 1);
+                throw;
+            }
+        }
+
+      private:
+        Entity&                         m_entity;
+        const PrepareFunc&              m_prepare_func;
+        foundation::AbortSwitch*        m_abort_switch;
+        volatile boost::uint32_t*       m_failed;
+    };
+}
+
+template <typename EntityCollection, typename PrepareFunc>
+bool prepare_entities(
+    EntityCollection&               entities,
+    const PrepareFunc&              prepare_func,
+    foundation::JobQueue*           job_queue,
+    foundation::AbortSwitch*        abort_switch)
+{
+    typedef typename EntityCollection::value_type EntityType;
+
+    if (job_queue == 0 || entities.size() < 2)
+    {
+        bool success = true;
+
+        for (foundation::each<EntityCollection> i = entities; i; ++i)
+        {
+            if (foundation::is_aborted(abort_switch))
+                break;
+
+            success = success && prepare_func(*i);
+        }
+
+        return success;
+    }
+
+    volatile boost::uint32_t failed = 0;
+
+    for (foundation::each<EntityCollection> i = entities; i; ++i)
+    {
+        job_queue->schedule(
+            new entity_preparation_impl::PrepareEntityJob<EntityType, PrepareFunc>(
+                *i,
+                prepare_func,
+                abort_switch,
+                &failed));
+    }
+
+    job_queue->wait_until_completion();
+
+    return boost_atomic::atomic_read32(&failed) == 0;
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_ENTITY_ENTITYPREPARATION_H
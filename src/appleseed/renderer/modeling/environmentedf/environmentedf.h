@@ -74,6 +74,7 @@ class DLLSYMBOL EnvironmentEDF
     virtual const char* get_model() const = 0;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other environment EDFs of the scene.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
         const Project&              project,
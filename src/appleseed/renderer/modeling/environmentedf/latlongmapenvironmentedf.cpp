@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/kernel/lighting/imageimportancesampler.h"
 #include "renderer/kernel/texturing/texturecache.h"
@@ -349,7 +350,10 @@ namespace
                 m_importance_map_height,
                 get_name());
 
-            m_importance_sampler->rebuild(sampler, abort_switch);
+            {
+                ScopedProfile profile(global_profiler(), "environment importance map build");
+                m_importance_sampler->rebuild(sampler, abort_switch);
+            }
 
             if (is_aborted(abort_switch))
                 m_importance_sampler.reset();
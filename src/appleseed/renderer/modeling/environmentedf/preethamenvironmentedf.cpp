@@ -31,12 +31,18 @@
 #include "preethamenvironmentedf.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/environmentedf/tabulatedsky.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/inputevaluator.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/scene.h"
+#include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/color.h"
@@ -46,11 +52,16 @@
 #include "foundation/math/scalar.h"
 #include "foundation/math/vector.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
 #include "foundation/utility/containers/dictionary.h"
+#include "foundation/utility/job/abortswitch.h"
 
 // Standard headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <memory>
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
@@ -99,6 +110,9 @@ namespace
             m_inputs.declare("luminance_gamma", InputFormatScalar, "1.0");
             m_inputs.declare("saturation_multiplier", InputFormatScalar, "1.0");
             m_inputs.declare("horizon_shift", InputFormatScalar, "0.0");
+
+            m_tabulate = m_params.get_optional<bool>("tabulate", false);
+            m_table_resolution = max(m_params.get_optional<size_t>("table_resolution", 512), size_t(2));
         }
 
         virtual void release() OVERRIDE
@@ -146,9 +160,21 @@ namespace
                 m_uniform_Y_zenith = compute_zenith_Y(m_uniform_values.m_turbidity, m_sun_theta);
             }
 
+            // Bake the sky into an importance-sampled table.
+            m_table.reset();
+            if (m_tabulate)
+                build_table(project, abort_switch);
+
             return true;
         }
 
+        virtual void on_frame_end(const Project& project) OVERRIDE
+        {
+            m_table.reset();
+
+            EnvironmentEDF::on_frame_end(project);
+        }
+
         virtual void sample(
             InputEvaluator&     input_evaluator,
             const Vector2d&     s,
@@ -156,12 +182,14 @@ namespace
             Spectrum&           value,
             double&             probability) const OVERRIDE
         {
-            outgoing = sample_hemisphere_cosine(s);
+            if (m_table.get())
+            {
+                m_table->sample(s, outgoing, value, probability);
+                return;
+            }
 
-            const Vector3d shifted_outgoing = shift(outgoing);
-            if (shifted_outgoing.y > 0.0)
-                compute_sky_radiance(input_evaluator, shifted_outgoing, value);
-            else value.set(0.0f);
+            outgoing = sample_hemisphere_cosine(s);
+            evaluate_analytic(input_evaluator, outgoing, value);
 
             probability = outgoing.y * RcpPi;
         }
@@ -173,10 +201,13 @@ namespace
         {
             assert(is_normalized(outgoing));
 
-            const Vector3d shifted_outgoing = shift(outgoing);
-            if (shifted_outgoing.y > 0.0)
-                compute_sky_radiance(input_evaluator, shifted_outgoing, value);
-            else value.set(0.0f);
+            if (m_table.get())
+            {
+                m_table->evaluate(outgoing, value);
+                return;
+            }
+
+            evaluate_analytic(input_evaluator, outgoing, value);
         }
 
         virtual void evaluate(
@@ -187,10 +218,13 @@ namespace
         {
             assert(is_normalized(outgoing));
 
-            const Vector3d shifted_outgoing = shift(outgoing);
-            if (shifted_outgoing.y > 0.0)
-                compute_sky_radiance(input_evaluator, shifted_outgoing, value);
-            else value.set(0.0f);
+            if (m_table.get())
+            {
+                m_table->evaluate(outgoing, value, probability);
+                return;
+            }
+
+            evaluate_analytic(input_evaluator, outgoing, value);
 
             probability = outgoing.y > 0.0 ? outgoing.y * RcpPi : 0.0;
         }
@@ -201,6 +235,9 @@ namespace
         {
             assert(is_normalized(outgoing));
 
+            if (m_table.get())
+                return m_table->evaluate_pdf(outgoing);
+
             return outgoing.y > 0.0 ? outgoing.y * RcpPi : 0.0;
         }
 
@@ -234,6 +271,68 @@ namespace
         double                      m_uniform_y_zenith;
         double                      m_uniform_Y_zenith;
 
+        bool                        m_tabulate;
+        size_t                      m_table_resolution;
+        auto_ptr<TabulatedSky>      m_table;
+
+        // Sky radiance function used to fill the table.
+        class SkyRadianceFunction
+          : public TabulatedSky::IRadianceFunction
+        {
+          public:
+            explicit SkyRadianceFunction(const PreethamEnvironmentEDF& edf)
+              : m_edf(edf)
+            {
+            }
+
+            virtual void evaluate(
+                InputEvaluator&     input_evaluator,
+                const Vector3d&     outgoing,
+                Spectrum&           value) const OVERRIDE
+            {
+                m_edf.evaluate_analytic(input_evaluator, outgoing, value);
+            }
+
+          private:
+            const PreethamEnvironmentEDF& m_edf;
+        };
+
+        void build_table(const Project& project, AbortSwitch* abort_switch)
+        {
+            const size_t width = m_table_resolution;
+            const size_t height = m_table_resolution / 2;
+
+            RENDERER_LOG_INFO(
+                "building " FMT_SIZE_T "x" FMT_SIZE_T " sky table "
+                "for environment edf \"%s\"...",
+                width,
+                height,
+                get_name());
+
+            auto_ptr<TabulatedSky> table(new TabulatedSky(width, height));
+
+            bool success;
+
+            {
+                ScopedProfile profile(global_profiler(), "sky table build");
+                success =
+                    table->build(
+                        *project.get_scene(),
+                        SkyRadianceFunction(*this),
+                        project.get_rendering_thread_count(),
+                        abort_switch);
+            }
+
+            if (success)
+            {
+                m_table = table;
+
+                RENDERER_LOG_INFO(
+                    "built sky table for environment edf \"%s\".",
+                    get_name());
+            }
+        }
+
         // Compute the coefficients of the luminance distribution function.
         static void compute_Y_coefficients(
             const double        turbidity,
@@ -415,6 +514,18 @@ namespace
                 * static_cast<float>(RcpPi);                // convert irradiance to radiance
         }
 
+        // Evaluate the sky model along a given direction.
+        void evaluate_analytic(
+            InputEvaluator&     input_evaluator,
+            const Vector3d&     outgoing,
+            Spectrum&           value) const
+        {
+            const Vector3d shifted_outgoing = shift(outgoing);
+            if (shifted_outgoing.y > 0.0)
+                compute_sky_radiance(input_evaluator, shifted_outgoing, value);
+            else value.set(0.0f);
+        }
+
         Vector3d shift(Vector3d v) const
         {
             v.y -= m_uniform_values.m_horizon_shift;
@@ -520,6 +631,24 @@ DictionaryArray PreethamEnvironmentEDFFactory::get_input_metadata() const
             .insert("use", "optional")
             .insert("default", "0.0"));
 
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "tabulate")
+            .insert("label", "Tabulate And Importance Sample")
+            .insert("type", "boolean")
+            .insert("use", "optional")
+            .insert("default", "false"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "table_resolution")
+            .insert("label", "Table Resolution")
+            .insert("type", "numeric")
+            .insert("min_value", "2")
+            .insert("max_value", "4096")
+            .insert("use", "optional")
+            .insert("default", "512"));
+
     return metadata;
 }
 
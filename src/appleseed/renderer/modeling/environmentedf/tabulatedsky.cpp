@@ -0,0 +1,315 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "tabulatedsky.h"
+
+// appleseed.renderer headers.
+#include "renderer/kernel/texturing/texturecache.h"
+#include "renderer/kernel/texturing/texturestore.h"
+#include "renderer/modeling/environmentedf/sphericalcoordinates.h"
+#include "renderer/modeling/input/inputevaluator.h"
+
+// appleseed.foundation headers.
+#include "foundation/image/colorspace.h"
+#include "foundation/math/scalar.h"
+#include "foundation/platform/thread.h"
+#include "foundation/utility/job/abortswitch.h"
+
+// boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// TabulatedSky::RowJob class implementation.
+//
+// Evaluates one out of every row_step rows of the table, starting at row first_row.
+//
+
+class TabulatedSky::RowJob
+{
+  public:
+    RowJob()
+      : m_texture_store(0)
+      , m_radiance_function(0)
+      , m_abort_switch(0)
+      , m_table(0)
+    {
+    }
+
+    void initialize(
+        TextureStore&               texture_store,
+        const IRadianceFunction&    radiance_function,
+        AbortSwitch*                abort_switch,
+        TabulatedSky&               table,
+        const size_t                first_row,
+        const size_t                row_step)
+    {
+        m_texture_store = &texture_store;
+        m_radiance_function = &radiance_function;
+        m_abort_switch = abort_switch;
+        m_table = &table;
+        m_first_row = first_row;
+        m_row_step = row_step;
+    }
+
+    void operator()()
+    {
+        TextureCache texture_cache(*m_texture_store);
+        InputEvaluator input_evaluator(texture_cache);
+
+        const size_t width = m_table->m_width;
+        const size_t height = m_table->m_height;
+
+        for (size_t y = m_first_row; y < height; y += m_row_step)
+        {
+            if (is_aborted(m_abort_switch))
+                break;
+
+            for (size_t x = 0; x < width; ++x)
+            {
+                double theta, phi;
+                unit_square_to_angles(
+                    (x + 0.5) * m_table->m_rcp_width,
+                    (y + 0.5) * m_table->m_rcp_height,
+                    theta,
+                    phi);
+
+                m_radiance_function->evaluate(
+                    input_evaluator,
+                    Vector3d::unit_vector(theta, phi),
+                    m_table->m_table[y * width + x]);
+            }
+        }
+    }
+
+  private:
+    TextureStore*                   m_texture_store;
+    const IRadianceFunction*        m_radiance_function;
+    AbortSwitch*                    m_abort_switch;
+    TabulatedSky*                   m_table;
+    size_t                          m_first_row;
+    size_t                          m_row_step;
+};
+
+
+//
+// TabulatedSky::TableSampler class implementation.
+//
+// Feeds the importance sampler with the luminance of the table, weighted by the
+// solid angle covered by each texel.
+//
+
+class TabulatedSky::TableSampler
+{
+  public:
+    explicit TableSampler(const TabulatedSky& table)
+      : m_table(table)
+    {
+    }
+
+    void sample(const size_t x, const size_t y, Payload& payload, double& importance)
+    {
+        payload.m_x = static_cast<uint32>(x);
+
+        const Spectrum& value = m_table.m_table[y * m_table.m_width + x];
+        const double theta = Pi * (y + 0.5) * m_table.m_rcp_height;
+
+        importance =
+              max(static_cast<double>(sum_value(value * XYZCMFCIE19312Deg[1])), 0.0)
+            * sin(theta);
+    }
+
+  private:
+    const TabulatedSky& m_table;
+};
+
+
+//
+// TabulatedSky class implementation.
+//
+
+TabulatedSky::TabulatedSky(
+    const size_t                    width,
+    const size_t                    height)
+  : m_width(width)
+  , m_height(height)
+  , m_rcp_width(1.0 / width)
+  , m_rcp_height(1.0 / height)
+  , m_probability_scale((width * height) / (2.0 * Pi * Pi))
+  , m_table(width * height)
+  , m_importance_sampler(width, height)
+{
+    assert(width > 0);
+    assert(height > 0);
+}
+
+bool TabulatedSky::build(
+    const Scene&                    scene,
+    const IRadianceFunction&        radiance_function,
+    const size_t                    thread_count,
+    AbortSwitch*                    abort_switch)
+{
+    // Evaluate the radiance function at the center of every texel.
+    {
+        TextureStore texture_store(scene);
+
+        const size_t job_count = max<size_t>(min(thread_count, m_height), 1);
+
+        vector<RowJob> jobs(job_count);
+        boost::thread_group threads;
+
+        for (size_t i = 0; i < job_count; ++i)
+        {
+            jobs[i].initialize(
+                texture_store,
+                radiance_function,
+                abort_switch,
+                *this,
+                i,
+                job_count);
+
+            threads.create_thread(ThreadFunctionWrapper<RowJob>(&jobs[i]));
+        }
+
+        threads.join_all();
+    }
+
+    if (is_aborted(abort_switch))
+        return false;
+
+    // Build the importance sampler.
+    TableSampler sampler(*this);
+    m_importance_sampler.rebuild(sampler, abort_switch);
+
+    return !is_aborted(abort_switch);
+}
+
+void TabulatedSky::sample(
+    const Vector2d&                 s,
+    Vector3d&                       outgoing,
+    Spectrum&                       value,
+    double&                         probability) const
+{
+    // Sample the importance map.
+    Payload payload;
+    size_t y;
+    double prob_xy;
+    m_importance_sampler.sample(s, payload, y, prob_xy);
+
+    // Compute the world space emission direction through the center of the texel.
+    double theta, phi;
+    unit_square_to_angles(
+        (payload.m_x + 0.5) * m_rcp_width,
+        (y + 0.5) * m_rcp_height,
+        theta,
+        phi);
+    outgoing = Vector3d::unit_vector(theta, phi);
+
+    value = m_table[y * m_width + payload.m_x];
+
+    // Compute the probability density of this direction.
+    probability = prob_xy * m_probability_scale / sin(theta);
+}
+
+void TabulatedSky::evaluate(
+    const Vector3d&                 outgoing,
+    Spectrum&                       value) const
+{
+    size_t x, y;
+    double theta;
+    direction_to_texel(outgoing, x, y, theta);
+
+    value = m_table[y * m_width + x];
+}
+
+void TabulatedSky::evaluate(
+    const Vector3d&                 outgoing,
+    Spectrum&                       value,
+    double&                         probability) const
+{
+    size_t x, y;
+    double theta;
+    direction_to_texel(outgoing, x, y, theta);
+
+    value = m_table[y * m_width + x];
+    probability = compute_pdf(x, y, theta);
+}
+
+double TabulatedSky::evaluate_pdf(const Vector3d& outgoing) const
+{
+    size_t x, y;
+    double theta;
+    direction_to_texel(outgoing, x, y, theta);
+
+    return compute_pdf(x, y, theta);
+}
+
+void TabulatedSky::direction_to_texel(
+    const Vector3d&                 outgoing,
+    size_t&                         x,
+    size_t&                         y,
+    double&                         theta) const
+{
+    assert(is_normalized(outgoing));
+
+    double phi;
+    unit_vector_to_angles(outgoing, theta, phi);
+
+    double u, v;
+    angles_to_unit_square(theta, phi, u, v);
+
+    x = min(truncate<size_t>(m_width * u), m_width - 1);
+    y = min(truncate<size_t>(m_height * v), m_height - 1);
+}
+
+double TabulatedSky::compute_pdf(
+    const size_t                    x,
+    const size_t                    y,
+    const double                    theta) const
+{
+    const double sin_theta = sin(theta);
+
+    if (sin_theta <= 0.0)
+        return 0.0;
+
+    // Compute the probability density of the emission direction.
+    return m_importance_sampler.get_pdf(x, y) * m_probability_scale / sin_theta;
+}
+
+}   // namespace renderer
@@ -0,0 +1,150 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
+#define APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
+
+// appleseed.renderer headers.
+#include "renderer/global/globaltypes.h"
+#include "renderer/kernel/lighting/imageimportancesampler.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/math/vector.h"
+#include "foundation/platform/types.h"
+
+// Standard headers.
+#include <cstddef>
+#include <vector>
+
+// Forward declarations.
+namespace foundation    { class AbortSwitch; }
+namespace renderer      { class InputEvaluator; }
+namespace renderer      { class Scene; }
+
+namespace renderer
+{
+
+//
+// A sky baked into a latitude-longitude table of radiance values, along with
+// an importance sampler built from the luminance of the table.
+//
+// The table covers the whole sphere of directions. The sky is treated as
+// piecewise constant over the texels of the table: lookups return the value
+// of the texel containing a given direction, and sampling returns directions
+// through the centers of texels, as in the latitude-longitude environment map EDF.
+//
+
+class TabulatedSky
+  : public foundation::NonCopyable
+{
+  public:
+    // Interface of the function computing the radiance of the sky along a given direction.
+    class IRadianceFunction
+    {
+      public:
+        // Destructor.
+        virtual ~IRadianceFunction() {}
+
+        // Compute the sky radiance along a given direction. Must be thread-safe.
+        virtual void evaluate(
+            InputEvaluator&             input_evaluator,
+            const foundation::Vector3d& outgoing,           // world space direction, unit-length
+            Spectrum&                   value) const = 0;
+    };
+
+    // Constructor.
+    TabulatedSky(
+        const size_t                    width,
+        const size_t                    height);
+
+    // Evaluate the sky radiance function at the center of every texel and build the
+    // importance sampler. Rows of the table are evaluated in parallel by thread_count
+    // threads. Returns false if the operation was aborted, in which case the table must
+    // not be used.
+    bool build(
+        const Scene&                    scene,
+        const IRadianceFunction&        radiance_function,
+        const size_t                    thread_count,
+        foundation::AbortSwitch*        abort_switch = 0);
+
+    // Sample the table and compute the emission direction, its probability
+    // density (with respect to solid angle) and the radiance along that direction.
+    void sample(
+        const foundation::Vector2d&     s,
+        foundation::Vector3d&           outgoing,
+        Spectrum&                       value,
+        double&                         probability) const;
+
+    // Look up the radiance along a given direction.
+    void evaluate(
+        const foundation::Vector3d&     outgoing,
+        Spectrum&                       value) const;
+    void evaluate(
+        const foundation::Vector3d&     outgoing,
+        Spectrum&                       value,
+        double&                         probability) const;
+
+    // Evaluate the probability density (with respect to solid angle) of a given direction.
+    double evaluate_pdf(const foundation::Vector3d& outgoing) const;
+
+  private:
+    class RowJob;
+    class TableSampler;
+
+    struct Payload
+    {
+        foundation::uint32              m_x;
+    };
+
+    typedef ImageImportanceSampler<Payload, double> ImageImportanceSamplerType;
+
+    const size_t                        m_width;
+    const size_t                        m_height;
+    const double                        m_rcp_width;
+    const double                        m_rcp_height;
+    const double                        m_probability_scale;
+
+    std::vector<Spectrum>               m_table;
+    ImageImportanceSamplerType          m_importance_sampler;
+
+    void direction_to_texel(
+        const foundation::Vector3d&     outgoing,
+        size_t&                         x,
+        size_t&                         y,
+        double&                         theta) const;
+
+    double compute_pdf(
+        const size_t                    x,
+        const size_t                    y,
+        const double                    theta) const;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_ENVIRONMENTEDF_TABULATEDSKY_H
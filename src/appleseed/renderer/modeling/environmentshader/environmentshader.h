@@ -70,6 +70,7 @@ class DLLSYMBOL EnvironmentShader
     virtual const char* get_model() const = 0;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other environment shaders of the scene.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
         const Project&              project,
@@ -0,0 +1,285 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "asyncframewriter.h"
+
+// appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/kernel/aov/imagestack.h"
+#include "renderer/modeling/frame/frame.h"
+
+// appleseed.foundation headers.
+#include "foundation/core/exceptions/exception.h"
+#include "foundation/core/exceptions/exceptionioerror.h"
+#include "foundation/image/canvasproperties.h"
+#include "foundation/image/exceptionunsupportedimageformat.h"
+#include "foundation/image/image.h"
+#include "foundation/image/imageattributes.h"
+#include "foundation/image/multilayerexrimagefilewriter.h"
+#include "foundation/image/pixel.h"
+#include "foundation/image/tile.h"
+#include "foundation/platform/system.h"
+#include "foundation/platform/thread.h"
+#include "foundation/platform/timer.h"
+#include "foundation/utility/job.h"
+#include "foundation/utility/stopwatch.h"
+#include "foundation/utility/string.h"
+
+// boost headers.
+#include "boost/thread/thread.hpp"
+
+// Standard headers.
+#include <cassert>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace boost;
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// AsyncFrameWriter class implementation.
+//
+
+namespace
+{
+    class TransformTileJob
+      : public IJob
+    {
+      public:
+        TransformTileJob(
+            const Frame&            frame,
+            Tile&                   tile)
+          : m_frame(frame)
+          , m_tile(tile)
+        {
+        }
+
+        virtual void execute(const size_t thread_index)
+        {
+            m_frame.transform_to_output_color_space(m_tile);
+        }
+
+      private:
+        const Frame&                m_frame;
+        Tile&                       m_tile;
+    };
+
+    class WriteFunc
+      : public NonCopyable
+    {
+      public:
+        WriteFunc(
+            const string&           file_path,
+            const Frame&            frame,
+            JobQueue&               job_queue)
+          : m_file_path(file_path)
+          , m_image_attributes(ImageAttributes::create_default_attributes())
+          , m_success(false)
+        {
+            // Snapshot the main image and transform its tiles to the output color space in parallel.
+            m_main_image.reset(new Image(frame.image()));
+            const CanvasProperties& main_props = m_main_image->properties();
+            for (size_t ty = 0; ty < main_props.m_tile_count_y; ++ty)
+            {
+                for (size_t tx = 0; tx < main_props.m_tile_count_x; ++tx)
+                    job_queue.schedule(new TransformTileJob(frame, m_main_image->tile(tx, ty)));
+            }
+            job_queue.wait_until_completion();
+
+            // OpenEXR only supports 32-bit integers, half and float pixels.
+            if (!is_supported_pixel_format(m_main_image->properties().m_pixel_format))
+            {
+                const CanvasProperties& props = m_main_image->properties();
+                m_main_image.reset(
+                    new Image(
+                        *m_main_image,
+                        props.m_tile_width,
+                        props.m_tile_height,
+                        PixelFormatHalf));
+            }
+
+            // Snapshot the AOV images. Note: AOVs are always in the linear color space.
+            const ImageStack& aov_images = frame.aov_images();
+            for (size_t i = 0; i < aov_images.size(); ++i)
+            {
+                m_aov_names.push_back(aov_images.get_name(i));
+                m_aov_images.push_back(new Image(aov_images.get_image(i)));
+            }
+        }
+
+        ~WriteFunc()
+        {
+            for (size_t i = 0; i < m_aov_images.size(); ++i)
+                delete m_aov_images[i];
+        }
+
+        void operator()()
+        {
+            Stopwatch<DefaultWallclockTimer> stopwatch;
+            stopwatch.start();
+
+            try
+            {
+                MultiLayerEXRImageFileWriter writer;
+                writer.append_layer("", *m_main_image);
+
+                for (size_t i = 0; i < m_aov_images.size(); ++i)
+                    writer.append_layer(m_aov_names[i].c_str(), *m_aov_images[i]);
+
+                writer.write(m_file_path.c_str(), m_image_attributes);
+            }
+            catch (const ExceptionUnsupportedImageFormat&)
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to write image file %s: unsupported image format.",
+                    m_file_path.c_str());
+                return;
+            }
+            catch (const ExceptionIOError&)
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to write image file %s: i/o error.",
+                    m_file_path.c_str());
+                return;
+            }
+            catch (const Exception& e)
+            {
+                RENDERER_LOG_ERROR(
+                    "failed to write image file %s: %s.",
+                    m_file_path.c_str(),
+                    e.what());
+                return;
+            }
+
+            stopwatch.measure();
+
+            RENDERER_LOG_INFO(
+                "wrote image file %s (%s %s) in %s.",
+                m_file_path.c_str(),
+                pretty_uint(m_aov_images.size() + 1).c_str(),
+                plural(m_aov_images.size() + 1, "layer").c_str(),
+                pretty_time(stopwatch.get_seconds()).c_str());
+
+            m_success = true;
+        }
+
+        bool is_successful() const
+        {
+            return m_success;
+        }
+
+      private:
+        const string                m_file_path;
+        const ImageAttributes       m_image_attributes;
+        auto_ptr<Image>             m_main_image;
+        vector<string>              m_aov_names;
+        vector<Image*>              m_aov_images;
+        bool                        m_success;
+
+        static bool is_supported_pixel_format(const PixelFormat pixel_format)
+        {
+            return
+                pixel_format == PixelFormatUInt32 ||
+                pixel_format == PixelFormatHalf ||
+                pixel_format == PixelFormatFloat;
+        }
+    };
+}
+
+struct AsyncFrameWriter::Impl
+{
+    JobQueue                m_job_queue;
+    JobManager              m_job_manager;
+    auto_ptr<WriteFunc>     m_write_func;
+    auto_ptr<thread>        m_write_thread;
+    bool                    m_last_success;
+
+    Impl()
+      : m_job_manager(
+            global_logger(),
+            m_job_queue,
+            System::get_logical_cpu_core_count(),
+            JobManager::KeepRunningOnEmptyQueue)
+      , m_last_success(true)
+    {
+        m_job_manager.start();
+    }
+};
+
+AsyncFrameWriter::AsyncFrameWriter()
+  : impl(new Impl())
+{
+}
+
+AsyncFrameWriter::~AsyncFrameWriter()
+{
+    wait();
+
+    delete impl;
+}
+
+void AsyncFrameWriter::write(
+    const Frame&    frame,
+    const char*     file_path)
+{
+    assert(file_path);
+
+    wait();
+
+    impl->m_write_func.reset(new WriteFunc(file_path, frame, impl->m_job_queue));
+
+    ThreadFunctionWrapper<WriteFunc> wrapper(impl->m_write_func.get());
+    impl->m_write_thread.reset(new thread(wrapper));
+}
+
+bool AsyncFrameWriter::is_writing() const
+{
+    return impl->m_write_thread.get() != 0;
+}
+
+bool AsyncFrameWriter::wait()
+{
+    if (impl->m_write_thread.get())
+    {
+        impl->m_write_thread->join();
+        impl->m_write_thread.reset();
+
+        impl->m_last_success = impl->m_write_func->is_successful();
+        impl->m_write_func.reset();
+    }
+
+    return impl->m_last_success;
+}
+
+}   // namespace renderer
@@ -0,0 +1,83 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_MODELING_FRAME_ASYNCFRAMEWRITER_H
+#define APPLESEED_RENDERER_MODELING_FRAME_ASYNCFRAMEWRITER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+
+// appleseed.main headers.
+#include "main/dllsymbol.h"
+
+// Forward declarations.
+namespace renderer  { class Frame; }
+
+namespace renderer
+{
+
+//
+// Writes the main image and the AOV images of a frame as the layers of a single
+// OpenEXR file, on a background thread.
+//
+// write() takes a snapshot of the frame (the main image is transformed to the output
+// color space at that point, in parallel, by worker threads owned by the writer) and
+// returns immediately, so the frame can be cleared and rendered again while the file
+// is being written. Keep the writer alive across frames to reuse its worker threads.
+//
+
+class DLLSYMBOL AsyncFrameWriter
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    AsyncFrameWriter();
+
+    // Destructor, waits for the pending write, if any.
+    ~AsyncFrameWriter();
+
+    // Start writing a frame. Waits for the pending write, if any.
+    void write(
+        const Frame&    frame,
+        const char*     file_path);
+
+    // Return true if a write is in progress.
+    bool is_writing() const;
+
+    // Wait until the pending write, if any, is complete.
+    // Return true if the last write was successful, false otherwise.
+    bool wait();
+
+  private:
+    struct Impl;
+    Impl* impl;
+};
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_MODELING_FRAME_ASYNCFRAMEWRITER_H
@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
 #include "renderer/kernel/aov/imagestack.h"
+#include "renderer/modeling/frame/asyncframewriter.h"
 #include "renderer/utility/paramarray.h"
 
 // appleseed.foundation headers.
@@ -500,6 +501,16 @@ bool Frame::write_aov_images(const char* file_path) const
     return result;
 }
 
+bool Frame::write_main_and_aov_images(const char* file_path) const
+{
+    assert(file_path);
+
+    AsyncFrameWriter writer;
+    writer.write(*this, file_path);
+
+    return writer.wait();
+}
+
 bool Frame::archive(
     const char*         directory,
     char**              output_path) const
@@ -133,6 +133,11 @@ class DLLSYMBOL Frame
     bool write_main_image(const char* file_path) const;
     bool write_aov_images(const char* file_path) const;
 
+    // Write the main image and all AOV images as the layers of a single OpenEXR file.
+    // Use renderer::AsyncFrameWriter to write them on a background thread instead.
+    // Return true if successful, false otherwise.
+    bool write_main_and_aov_images(const char* file_path) const;
+
     // Archive the frame to a given directory on disk. If output_path is provided,
     // the full path to the output file will be returned. The returned string must
     // be freed using foundation::free_string().
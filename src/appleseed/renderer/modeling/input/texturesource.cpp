@@ -35,6 +35,8 @@
 #include "renderer/modeling/texture/texture.h"
 
 // appleseed.foundation headers.
+#include "foundation/image/colorspace.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
 #include "foundation/math/hash.h"
 #include "foundation/math/scalar.h"
@@ -135,11 +137,44 @@ namespace
                 static_cast<size_t>(iy));
     }
 
+    // Fetch a pixel of a tile as a linear RGBA color. The texture store keeps 8-bit
+    // tiles of sRGB textures in the sRGB color space unless widen_srgb_tiles is set.
+    inline void get_tile_pixel(
+        const Tile&                 tile,
+        const bool                  srgb_texture,
+        const size_t                pixel_x,
+        const size_t                pixel_y,
+        Color4f&                    sample)
+    {
+        if (srgb_texture && tile.get_pixel_format() == PixelFormatUInt8)
+        {
+            const uint8* pixel = tile.pixel(pixel_x, pixel_y);
+            sample[0] = srgb_uint8_to_linear_rgb(pixel[0]);
+            sample[1] = srgb_uint8_to_linear_rgb(pixel[1]);
+            sample[2] = srgb_uint8_to_linear_rgb(pixel[2]);
+            sample[3] =
+                tile.get_channel_count() == 4
+                    ? static_cast<float>(pixel[3]) * (1.0f / 255.0f)
+                    : 1.0f;
+        }
+        else if (tile.get_channel_count() == 3)
+        {
+            Color3f rgb;
+            tile.get_pixel(pixel_x, pixel_y, rgb);
+            sample[0] = rgb[0];
+            sample[1] = rgb[1];
+            sample[2] = rgb[2];
+            sample[3] = 1.0f;
+        }
+        else tile.get_pixel(pixel_x, pixel_y, sample);
+    }
+
     // Utility function to sample a tile.
     inline void sample_tile(
         TextureCache&               texture_cache,
         const UniqueID              assembly_uid,
         const UniqueID              texture_uid,
+        const bool                  srgb_texture,
         const size_t                tile_x,
         const size_t                tile_y,
         const size_t                pixel_x,
@@ -155,16 +190,7 @@ namespace
                 tile_y);
 
         // Sample the tile.
-        if (tile.get_channel_count() == 3)
-        {
-            Color3f rgb;
-            tile.get_pixel(pixel_x, pixel_y, rgb);
-            sample[0] = rgb[0];
-            sample[1] = rgb[1];
-            sample[2] = rgb[2];
-            sample[3] = 1.0f;
-        }
-        else tile.get_pixel(pixel_x, pixel_y, sample);
+        get_tile_pixel(tile, srgb_texture, pixel_x, pixel_y, sample);
     }
 }
 
@@ -176,6 +202,7 @@ TextureSource::TextureSource(
   , m_assembly_uid(assembly_uid)
   , m_texture_instance(texture_instance)
   , m_texture_uid(texture_instance.get_texture().get_uid())
+  , m_srgb_texture(texture_instance.get_texture().get_color_space() == ColorSpaceSRGB)
   , m_texture_props(texture_instance.get_texture().properties())
   , m_texture_transform(texture_instance.get_transform())
   , m_input_format(input_format)
@@ -238,6 +265,7 @@ Color4f TextureSource::get_texel(
         texture_cache,
         m_assembly_uid,
         m_texture_uid,
+        m_srgb_texture,
         tile_x,
         tile_y,
         pixel_x,
@@ -298,6 +326,7 @@ void TextureSource::get_texels_2x2(
             texture_cache,
             m_assembly_uid,
             m_texture_uid,
+            m_srgb_texture,
             tile_x_00,
             tile_y_00,
             pixel_x_00,
@@ -307,6 +336,7 @@ void TextureSource::get_texels_2x2(
             texture_cache,
             m_assembly_uid,
             m_texture_uid,
+            m_srgb_texture,
             tile_x_11,
             tile_y_00,
             pixel_x_11,
@@ -316,6 +346,7 @@ void TextureSource::get_texels_2x2(
             texture_cache,
             m_assembly_uid,
             m_texture_uid,
+            m_srgb_texture,
             tile_x_00,
             tile_y_11,
             pixel_x_00,
@@ -325,6 +356,7 @@ void TextureSource::get_texels_2x2(
             texture_cache,
             m_assembly_uid,
             m_texture_uid,
+            m_srgb_texture,
             tile_x_11,
             tile_y_11,
             pixel_x_11,
@@ -350,41 +382,10 @@ void TextureSource::get_texels_2x2(
                 tile_y_00);
 
         // Sample the tile.
-        if (tile.get_channel_count() == 3)
-        {
-            Color3f rgb;
-
-            tile.get_pixel(pixel_x_00, pixel_y_00, rgb);
-            t00[0] = rgb[0];
-            t00[1] = rgb[1];
-            t00[2] = rgb[2];
-            t00[3] = 1.0f;
-
-            tile.get_pixel(pixel_x_11, pixel_y_00, rgb);
-            t10[0] = rgb[0];
-            t10[1] = rgb[1];
-            t10[2] = rgb[2];
-            t10[3] = 1.0f;
-
-            tile.get_pixel(pixel_x_00, pixel_y_11, rgb);
-            t01[0] = rgb[0];
-            t01[1] = rgb[1];
-            t01[2] = rgb[2];
-            t01[3] = 1.0f;
-
-            tile.get_pixel(pixel_x_11, pixel_y_11, rgb);
-            t11[0] = rgb[0];
-            t11[1] = rgb[1];
-            t11[2] = rgb[2];
-            t11[3] = 1.0f;
-        }
-        else
-        {
-            tile.get_pixel(pixel_x_00, pixel_y_00, t00);
-            tile.get_pixel(pixel_x_11, pixel_y_00, t10);
-            tile.get_pixel(pixel_x_00, pixel_y_11, t01);
-            tile.get_pixel(pixel_x_11, pixel_y_11, t11);
-        }
+        get_tile_pixel(tile, m_srgb_texture, pixel_x_00, pixel_y_00, t00);
+        get_tile_pixel(tile, m_srgb_texture, pixel_x_11, pixel_y_00, t10);
+        get_tile_pixel(tile, m_srgb_texture, pixel_x_00, pixel_y_11, t01);
+        get_tile_pixel(tile, m_srgb_texture, pixel_x_11, pixel_y_11, t11);
     }
 }
 
@@ -103,6 +103,7 @@ class TextureSource
     const foundation::UniqueID              m_assembly_uid;
     const TextureInstance&                  m_texture_instance;
     const foundation::UniqueID              m_texture_uid;
+    const bool                              m_srgb_texture;
     const foundation::CanvasProperties      m_texture_props;
     const foundation::Transformd            m_texture_transform;
     const InputFormat                       m_input_format;
@@ -92,6 +92,7 @@ class DLLSYMBOL Light
     const foundation::Transformd& get_transform() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other lights of the scene.
     // Returns true on success, false otherwise.
     virtual bool on_frame_begin(
         const Project&                  project,
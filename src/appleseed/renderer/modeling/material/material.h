@@ -90,6 +90,7 @@ class DLLSYMBOL Material
     const char* get_edf_name() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other materials of the scene.
     // Returns true on success, false otherwise.
     bool on_frame_begin(
         const Project&              project,
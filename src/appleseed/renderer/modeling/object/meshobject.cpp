@@ -104,6 +104,9 @@ MeshObject::MeshObject(
   : Object(name, params)
   , impl(new Impl())
 {
+    impl->m_tess.set_storage_options(
+        m_params.get_optional<bool>("compact_vertex_normals", false),
+        m_params.get_optional<bool>("half_precision_tex_coords", false));
 }
 
 MeshObject::~MeshObject()
@@ -155,26 +158,29 @@ const GVector3& MeshObject::get_vertex(const size_t index) const
 
 void MeshObject::reserve_vertex_normals(const size_t count)
 {
-    impl->m_tess.m_vertex_normals.reserve(count);
+    impl->m_tess.reserve_vertex_normals(count);
 }
 
 size_t MeshObject::push_vertex_normal(const GVector3& normal)
 {
     assert(is_normalized(normal));
 
-    const size_t index = impl->m_tess.m_vertex_normals.size();
-    impl->m_tess.m_vertex_normals.push_back(normal);
-    return index;
+    return impl->m_tess.push_vertex_normal(normal);
 }
 
 size_t MeshObject::get_vertex_normal_count() const
 {
-    return impl->m_tess.m_vertex_normals.size();
+    return impl->m_tess.get_vertex_normal_count();
+}
+
+GVector3 MeshObject::get_vertex_normal(const size_t index) const
+{
+    return impl->m_tess.get_vertex_normal(index);
 }
 
-const GVector3& MeshObject::get_vertex_normal(const size_t index) const
+void MeshObject::reserve_tex_coords(const size_t count)
 {
-    return impl->m_tess.m_vertex_normals[index];
+    impl->m_tess.reserve_uv_vertices(count);
 }
 
 size_t MeshObject::push_tex_coords(const GVector2& tex_coords)
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/global/globaltypes.h"
 #include "renderer/modeling/object/meshobject.h"
 #include "renderer/modeling/object/triangle.h"
@@ -443,6 +444,8 @@ namespace
 
         MeshObjectBuilder builder(params, base_object_name);
 
+        ScopedProfile profile(global_profiler(), "mesh file reading");
+
         Stopwatch<DefaultWallclockTimer> stopwatch;
         stopwatch.start();
 
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/kernel/aov/aovsettings.h"
 #include "renderer/kernel/aov/imagestack.h"
 #include "renderer/kernel/intersection/tracecontext.h"
@@ -57,6 +58,7 @@
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/image.h"
 #include "foundation/image/pixel.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/types.h"
 #include "foundation/utility/foreach.h"
 #include "foundation/utility/searchpaths.h"
@@ -98,6 +100,7 @@ namespace
 struct Project::Impl
 {
     size_t                      m_format_revision;
+    size_t                      m_rendering_thread_count;
     string                      m_path;
     auto_release_ptr<Scene>     m_scene;
     auto_release_ptr<Frame>     m_frame;
@@ -108,6 +111,7 @@ struct Project::Impl
 
     Impl()
       : m_format_revision(ProjectFormatRevision)
+      , m_rendering_thread_count(System::get_logical_cpu_core_count())
     {
     }
 };
@@ -411,6 +415,17 @@ void Project::create_aov_images()
     apply_render_layers.apply(impl->m_render_layer_rules);
 }
 
+void Project::set_rendering_thread_count(const size_t thread_count)
+{
+    assert(thread_count > 0);
+    impl->m_rendering_thread_count = thread_count;
+}
+
+size_t Project::get_rendering_thread_count() const
+{
+    return impl->m_rendering_thread_count;
+}
+
 bool Project::has_trace_context() const
 {
     return impl->m_trace_context.get() != 0;
@@ -429,6 +444,8 @@ const TraceContext& Project::get_trace_context() const
 
 void Project::update_trace_context()
 {
+    ScopedProfile profile(global_profiler(), "trace context update");
+
     if (impl->m_trace_context.get())
         impl->m_trace_context->update();
 }
@@ -112,6 +112,12 @@ class DLLSYMBOL Project
     // Create the AOV images in the frame.
     void create_aov_images();
 
+    // Set/get the number of threads that entities may use to prepare themselves for rendering.
+    // By default, this is the number of logical CPU cores. The master renderer sets it to the
+    // number of rendering threads before the scene is prepared.
+    void set_rendering_thread_count(const size_t thread_count);
+    size_t get_rendering_thread_count() const;
+
     // Return true if the trace context has already been built.
     bool has_trace_context() const;
 
@@ -31,6 +31,7 @@
 #include "projectfilereader.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalprofiler.h"
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/bsdf/bsdffactoryregistrar.h"
 #include "renderer/modeling/bsdf/ibsdffactory.h"
@@ -2884,6 +2885,8 @@ auto_release_ptr<Project> ProjectFileReader::read(
     if (!xerces_context.is_initialized())
         return auto_release_ptr<Project>(0);
 
+    ScopedProfile profile(global_profiler(), "project file reading");
+
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
@@ -2914,6 +2917,8 @@ auto_release_ptr<Project> ProjectFileReader::load_builtin(
 {
     assert(project_name);
 
+    ScopedProfile profile(global_profiler(), "builtin project construction");
+
     Stopwatch<DefaultWallclockTimer> stopwatch;
     stopwatch.start();
 
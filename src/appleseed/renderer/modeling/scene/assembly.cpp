@@ -33,6 +33,7 @@
 // appleseed.renderer headers.
 #include "renderer/modeling/bsdf/bsdf.h"
 #include "renderer/modeling/edf/edf.h"
+#include "renderer/modeling/entity/entitypreparation.h"
 #include "renderer/modeling/light/light.h"
 #include "renderer/modeling/material/material.h"
 #include "renderer/modeling/scene/assemblyinstance.h"
@@ -186,89 +187,54 @@ GAABB3 Assembly::compute_non_hierarchical_local_bbox() const
 
 namespace
 {
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        EntityCollection&       entities,
-        AbortSwitch*            abort_switch)
-    {
-        bool success = true;
+#ifdef WITH_OSL
 
-        for (each<EntityCollection> i = entities; i; ++i)
+    class InvokeShaderGroupOnFrameBegin
+    {
+      public:
+        InvokeShaderGroupOnFrameBegin(
+            const Project&          project,
+            const Assembly&         assembly,
+            OSL::ShadingSystem*     shading_system,
+            AbortSwitch*            abort_switch)
+          : m_project(project)
+          , m_assembly(assembly)
+          , m_shading_system(shading_system)
+          , m_abort_switch(abort_switch)
         {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, abort_switch);
         }
 
-        return success;
-    }
-
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        const Assembly&         assembly,
-        EntityCollection&       entities,
-        AbortSwitch*            abort_switch)
-    {
-        bool success = true;
-
-        for (each<EntityCollection> i = entities; i; ++i)
+        bool operator()(ShaderGroup& shader_group) const
         {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, assembly, abort_switch);
+            return shader_group.on_frame_begin(m_project, m_assembly, m_shading_system, m_abort_switch);
         }
 
-        return success;
-    }
+      private:
+        const Project&              m_project;
+        const Assembly&             m_assembly;
+        OSL::ShadingSystem*         m_shading_system;
+        AbortSwitch*                m_abort_switch;
+    };
 
-#ifdef WITH_OSL
-    
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        EntityCollection&       entities,
-        OSL::ShadingSystem*     shading_system,
-        AbortSwitch*            abort_switch)
+    class OptimizeShaderGroup
     {
-        bool success = true;
-
-        for (each<EntityCollection> i = entities; i; ++i)
+      public:
+        explicit OptimizeShaderGroup(OSL::ShadingSystem* shading_system)
+          : m_shading_system(shading_system)
         {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, shading_system, abort_switch);
         }
 
-        return success;
-    }
-
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        const Assembly&         assembly,
-        OSL::ShadingSystem*     shading_system,
-        EntityCollection&       entities,
-        AbortSwitch*            abort_switch)
-    {
-        bool success = true;
-
-        for (each<EntityCollection> i = entities; i; ++i)
+        bool operator()(ShaderGroup& shader_group) const
         {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, assembly, shading_system, abort_switch);
+            return shader_group.optimize(*m_shading_system);
         }
 
-        return success;
-    }
+      private:
+        OSL::ShadingSystem*         m_shading_system;
+    };
+
 #endif
-    
+
     template <typename EntityCollection>
     void invoke_on_frame_end(
         const Project&          project,
@@ -294,29 +260,56 @@ bool Assembly::on_frame_begin(
 #ifdef WITH_OSL
     OSL::ShadingSystem* shading_system,
 #endif
-    AbortSwitch*        abort_switch)
+    AbortSwitch*        abort_switch,
+    JobQueue*           job_queue)
 {
+    // Entities of a given kind are prepared concurrently, but all entities of a kind
+    // are prepared before the next kind since, for instance, materials refer to BSDFs.
+    // Surface shaders are prepared one after the other since some of them (e.g. the
+    // fast ambient occlusion shader) use the rendering threads to prepare themselves.
+    const InvokeOnFrameBegin invoke(project, abort_switch);
+    const InvokeAssemblyEntityOnFrameBegin invoke_in_assembly(project, *this, abort_switch);
+
     bool success = true;
 
-    success = success && invoke_on_frame_begin(project, texture_instances(), abort_switch);
-    success = success && invoke_on_frame_begin(project, *this, surface_shaders(), abort_switch);
-    success = success && invoke_on_frame_begin(project, *this, bsdfs(), abort_switch);
-    success = success && invoke_on_frame_begin(project, *this, edfs(), abort_switch);
-    
+    success = success && prepare_entities(texture_instances(), invoke, job_queue, abort_switch);
+    success = success && prepare_entities(surface_shaders(), invoke_in_assembly, 0, abort_switch);
+    success = success && prepare_entities(bsdfs(), invoke_in_assembly, job_queue, abort_switch);
+    success = success && prepare_entities(edfs(), invoke_in_assembly, job_queue, abort_switch);
+
 #ifdef WITH_OSL
-    success = success && invoke_on_frame_begin(project, *this, shading_system, shader_groups(), abort_switch);
+    // Shader groups are built sequentially since the OSL shading system only supports
+    // building one shader group at a time, but they are then optimized and JIT-compiled
+    // concurrently, instead of lazily by the first render thread that executes them.
+    success = success && prepare_entities(
+        shader_groups(),
+        InvokeShaderGroupOnFrameBegin(project, *this, shading_system, abort_switch),
+        0,
+        abort_switch);
+    success = success && prepare_entities(
+        shader_groups(),
+        OptimizeShaderGroup(shading_system),
+        job_queue,
+        abort_switch);
 #endif
-    
-    success = success && invoke_on_frame_begin(project, *this, materials(), abort_switch);
-    success = success && invoke_on_frame_begin(project, *this, lights(), abort_switch);
 
+    success = success && prepare_entities(materials(), invoke_in_assembly, job_queue, abort_switch);
+    success = success && prepare_entities(lights(), invoke_in_assembly, job_queue, abort_switch);
+
+    // Child assemblies are prepared one after the other, each using the job queue.
+    success = success && prepare_entities(
+        assemblies(),
+        InvokeAssemblyOnFrameBegin(
+            project,
 #ifdef WITH_OSL
-    success = success && invoke_on_frame_begin(project, assemblies(), shading_system, abort_switch);
-#else
-    success = success && invoke_on_frame_begin(project, assemblies(), abort_switch);
+            shading_system,
 #endif
-    
-    success = success && invoke_on_frame_begin(project, assembly_instances(), abort_switch);
+            abort_switch,
+            job_queue),
+        0,
+        abort_switch);
+
+    success = success && prepare_entities(assembly_instances(), invoke, job_queue, abort_switch);
 
     return success;
 }
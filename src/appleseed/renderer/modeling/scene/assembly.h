@@ -51,6 +51,7 @@
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
+namespace foundation    { class JobQueue; }
 namespace renderer      { class ParamArray; }
 namespace renderer      { class Project; }
 
@@ -111,13 +112,15 @@ class DLLSYMBOL Assembly
     GAABB3 compute_non_hierarchical_local_bbox() const;
 
     // Perform pre-frame rendering actions.
+    // If a job queue is provided, entities are prepared concurrently using this queue.
     // Returns true on success, false otherwise.
     bool on_frame_begin(
         const Project&              project,
 #ifdef WITH_OSL
         OSL::ShadingSystem*         shading_system,
 #endif
-        foundation::AbortSwitch*    abort_switch = 0);
+        foundation::AbortSwitch*    abort_switch = 0,
+        foundation::JobQueue*       job_queue = 0);
 
     // Perform post-frame rendering actions.
     void on_frame_end(const Project& project);
@@ -92,6 +92,7 @@ class DLLSYMBOL AssemblyInstance
     Assembly& get_assembly() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other assembly instances of the scene.
     // Returns true on success, false otherwise.
     bool on_frame_begin(
         const Project&              project,
@@ -31,6 +31,8 @@
 #include "scene.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globalprofiler.h"
+#include "renderer/modeling/entity/entitypreparation.h"
 #include "renderer/modeling/environmentedf/environmentedf.h"
 #include "renderer/modeling/environmentshader/environmentshader.h"
 #include "renderer/modeling/scene/assembly.h"
@@ -164,25 +166,6 @@ double Scene::compute_radius() const
 
 namespace
 {
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        EntityCollection&       entities,
-        AbortSwitch*            abort_switch)
-    {
-        bool success = true;
-
-        for (each<EntityCollection> i = entities; i; ++i)
-        {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, abort_switch);
-        }
-
-        return success;
-    }
-
     template <typename EntityCollection>
     void invoke_on_frame_end(
         const Project&          project,
@@ -191,30 +174,6 @@ namespace
         for (each<EntityCollection> i = entities; i; ++i)
             i->on_frame_end(project);
     }
-    
-#ifdef WITH_OSL
-
-    template <typename EntityCollection>
-    bool invoke_on_frame_begin(
-        const Project&          project,
-        EntityCollection&       entities,
-        OSL::ShadingSystem*     shading_system,
-        AbortSwitch*            abort_switch)
-    {
-        bool success = true;
-
-        for (each<EntityCollection> i = entities; i; ++i)
-        {
-            if (is_aborted(abort_switch))
-                break;
-
-            success = success && i->on_frame_begin(project, shading_system, abort_switch);
-        }
-
-        return success;
-    }
-
-#endif
 }
 
 bool Scene::on_frame_begin(
@@ -222,16 +181,23 @@ bool Scene::on_frame_begin(
 #ifdef WITH_OSL
     OSL::ShadingSystem*     shading_system,
 #endif            
-    AbortSwitch*            abort_switch)
+    AbortSwitch*            abort_switch,
+    JobQueue*               job_queue)
 {
+    ScopedProfile profile(global_profiler(), "scene preparation");
+
+    const InvokeOnFrameBegin invoke(project, abort_switch);
+
     bool success = true;
 
     if (impl->m_camera.get())
         success = success && impl->m_camera->on_frame_begin(project, abort_switch);
 
-    success = success && invoke_on_frame_begin(project, texture_instances(), abort_switch);
-    success = success && invoke_on_frame_begin(project, environment_edfs(), abort_switch);
-    success = success && invoke_on_frame_begin(project, environment_shaders(), abort_switch);
+    success = success && prepare_entities(texture_instances(), invoke, job_queue, abort_switch);
+    // Environment EDFs are prepared one after the other since some of them (e.g. the
+    // sky models) use the rendering threads to bake their radiance tables.
+    success = success && prepare_entities(environment_edfs(), invoke, 0, abort_switch);
+    success = success && prepare_entities(environment_shaders(), invoke, job_queue, abort_switch);
 
     if (is_aborted(abort_switch))
         return success;
@@ -239,13 +205,20 @@ bool Scene::on_frame_begin(
     if (impl->m_environment.get())
         success = success && impl->m_environment->on_frame_begin(project, abort_switch);
 
+    // Assemblies are prepared one after the other, each using the job queue.
+    success = success && prepare_entities(
+        assemblies(),
+        InvokeAssemblyOnFrameBegin(
+            project,
 #ifdef WITH_OSL
-    success = success && invoke_on_frame_begin(project, assemblies(), shading_system, abort_switch);
-#else
-    success = success && invoke_on_frame_begin(project, assemblies(), abort_switch);
+            shading_system,
 #endif
+            abort_switch,
+            job_queue),
+        0,
+        abort_switch);
 
-    success = success && invoke_on_frame_begin(project, assembly_instances(), abort_switch);
+    success = success && prepare_entities(assembly_instances(), invoke, job_queue, abort_switch);
 
     return success;
 }
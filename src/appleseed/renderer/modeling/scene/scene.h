@@ -53,6 +53,7 @@
 
 // Forward declarations.
 namespace foundation    { class AbortSwitch; }
+namespace foundation    { class JobQueue; }
 namespace renderer      { class Project; }
 
 namespace renderer
@@ -100,13 +101,16 @@ class DLLSYMBOL Scene
     double compute_radius() const;
 
     // Perform pre-frame rendering actions.
+    // If a job queue is provided, entities are prepared concurrently using this queue;
+    // the queue must be serviced by a running job manager.
     // Returns true on success, false otherwise.
     bool on_frame_begin(
         const Project&              project,
 #ifdef WITH_OSL
         OSL::ShadingSystem*         shading_system,
 #endif
-        foundation::AbortSwitch*    abort_switch = 0);
+        foundation::AbortSwitch*    abort_switch = 0,
+        foundation::JobQueue*       job_queue = 0);
 
     // Perform post-frame rendering actions.
     void on_frame_end(const Project& project);
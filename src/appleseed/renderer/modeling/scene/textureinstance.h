@@ -131,6 +131,7 @@ class DLLSYMBOL TextureInstance
     TextureAlphaMode get_effective_alpha_mode() const;
 
     // This method is called once before rendering each frame.
+    // It may be called concurrently on other texture instances of the scene.
     // Returns true on success, false otherwise.
     bool on_frame_begin(
         const Project&              project,
@@ -62,6 +62,7 @@ ShaderGroup::ShaderGroup(const char* name)
   : ConnectableEntity(g_class_uid, ParamArray())
   , m_has_emission(false)
   , m_has_transparency(false)
+  , m_has_shader_info(false)
 {
     set_name(name);
 }
@@ -179,6 +180,8 @@ bool ShaderGroup::on_frame_begin(
                 return false;
             }
 
+            m_has_shader_info = true;
+
             if (m_has_emission)
                 RENDERER_LOG_INFO("shader group %s has emission closures.", get_name());
             else
@@ -199,6 +202,25 @@ bool ShaderGroup::on_frame_begin(
     }
 }
 
+bool ShaderGroup::optimize(OSL::ShadingSystem& shading_system) const
+{
+    if (!valid())
+        return false;
+
+    RENDERER_LOG_DEBUG("optimizing shader group %s.", get_name());
+
+    try
+    {
+        shading_system.optimize_group(m_shadergroup_ref.get());
+        return true;
+    }
+    catch (const exception& e)
+    {
+        RENDERER_LOG_ERROR("shader group optimization exception: what = %s.", e.what());
+        return false;
+    }
+}
+
 void ShaderGroup::on_frame_end(
     const Project&      project,
     const Assembly&     assembly)
@@ -93,6 +93,11 @@ class DLLSYMBOL ShaderGroup
         OSL::ShadingSystem*         shading_system,
         foundation::AbortSwitch*    abort_switch = 0);
 
+    // Optimize and JIT-compile the shader group. Must be called after on_frame_begin().
+    // Different shader groups may be optimized concurrently.
+    // Returns true on success, false otherwise.
+    bool optimize(OSL::ShadingSystem& shading_system) const;
+
     // This method is called once after rendering each frame.
     void on_frame_end(
         const Project&              project,
@@ -112,6 +117,10 @@ class DLLSYMBOL ShaderGroup
 
     // Returns true if the shader group contains at least one transparency closure.
     bool has_transparency() const;
+
+    // Returns true if has_emission() and has_transparency() are meaningful,
+    // i.e. if on_frame_begin() was successfully called at least once.
+    bool has_shader_info() const;
     
     // Return a reference-counted (but opaque) reference to the OSL shader.
     OSL::ShaderGroupRef& shadergroup_ref() const;
@@ -124,6 +133,7 @@ class DLLSYMBOL ShaderGroup
     mutable OSL::ShaderGroupRef  m_shadergroup_ref;
     bool                         m_has_emission;
     bool                         m_has_transparency;
+    bool                         m_has_shader_info;
 
     // Constructor.
     explicit ShaderGroup(const char* name);
@@ -179,6 +189,11 @@ inline bool ShaderGroup::has_transparency() const
     return m_has_transparency;
 }
 
+inline bool ShaderGroup::has_shader_info() const
+{
+    return m_has_shader_info;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_MODELING_SHADERGROUP_SHADERGROUP_H
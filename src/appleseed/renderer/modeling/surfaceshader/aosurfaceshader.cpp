@@ -31,19 +31,32 @@
 #include "aosurfaceshader.h"
 
 // appleseed.renderer headers.
+#include "renderer/global/globallogger.h"
+#include "renderer/global/globalprofiler.h"
 #include "renderer/kernel/shading/ambientocclusion.h"
+#include "renderer/kernel/shading/fastambientocclusion.h"
 #include "renderer/kernel/shading/shadingcontext.h"
 #include "renderer/kernel/shading/shadingpoint.h"
 #include "renderer/kernel/shading/shadingresult.h"
 #include "renderer/modeling/input/inputarray.h"
 #include "renderer/modeling/input/source.h"
+#include "renderer/modeling/project/project.h"
+#include "renderer/modeling/scene/scene.h"
 #include "renderer/modeling/surfaceshader/surfaceshader.h"
 
 // appleseed.foundation headers.
 #include "foundation/image/colorspace.h"
 #include "foundation/utility/containers/specializedarrays.h"
+#include "foundation/utility/job/abortswitch.h"
+#include "foundation/utility/statistics.h"
+
+// Standard headers.
+#include <cstddef>
+#include <memory>
+#include <string>
 
 // Forward declarations.
+namespace renderer  { class Assembly; }
 namespace renderer  { class PixelContext; }
 
 using namespace foundation;
@@ -85,6 +98,31 @@ namespace
                     sampling_method.c_str());
                 m_sampling_method = UniformSampling;
             }
+
+            const string mode = m_params.get_optional<string>("mode", "accurate");
+
+            if (mode == "accurate")
+                m_mode = AccurateMode;
+            else if (mode == "fast")
+                m_mode = FastMode;
+            else
+            {
+                RENDERER_LOG_ERROR(
+                    "invalid value \"%s\" for parameter \"mode\", "
+                    "using default value \"accurate\".",
+                    mode.c_str());
+                m_mode = AccurateMode;
+            }
+
+            m_max_voxel_extent = m_params.get_optional<GScalar>("max_voxel_extent", GScalar(0.01));
+
+            if (m_max_voxel_extent <= GScalar(0.0))
+            {
+                RENDERER_LOG_ERROR(
+                    "invalid value for parameter \"max_voxel_extent\", "
+                    "using default value \"0.01\".");
+                m_max_voxel_extent = GScalar(0.01);
+            }
         }
 
         virtual void release() OVERRIDE
@@ -97,6 +135,30 @@ namespace
             return Model;
         }
 
+        virtual bool on_frame_begin(
+            const Project&          project,
+            const Assembly&         assembly,
+            AbortSwitch*            abort_switch) OVERRIDE
+        {
+            if (!SurfaceShader::on_frame_begin(project, assembly, abort_switch))
+                return false;
+
+            if (m_mode == FastMode)
+                build_voxel_tree(project, abort_switch);
+
+            return true;
+        }
+
+        virtual void on_frame_end(
+            const Project&          project,
+            const Assembly&         assembly) OVERRIDE
+        {
+            m_voxel_tree_intersector.reset();
+            m_voxel_tree.reset();
+
+            SurfaceShader::on_frame_end(project, assembly);
+        }
+
         virtual void evaluate(
             SamplingContext&        sampling_context,
             const PixelContext&     pixel_context,
@@ -106,7 +168,21 @@ namespace
         {
             double occlusion;
 
-            if (m_sampling_method == UniformSampling)
+            if (m_voxel_tree_intersector.get())
+            {
+                double min_distance;
+                occlusion =
+                    compute_fast_ambient_occlusion(
+                        sampling_context,
+                        *m_voxel_tree_intersector,
+                        shading_point.get_point(),
+                        shading_point.get_geometric_normal(),
+                        shading_point.get_shading_basis(),
+                        m_max_distance,
+                        m_samples,
+                        min_distance);
+            }
+            else if (m_sampling_method == UniformSampling)
             {
                 occlusion =
                     compute_ambient_occlusion(
@@ -141,9 +217,49 @@ namespace
             CosineWeightedSampling
         };
 
-        const size_t    m_samples;
-        const double    m_max_distance;
-        SamplingMethod  m_sampling_method;
+        enum Mode
+        {
+            AccurateMode,
+            FastMode
+        };
+
+        const size_t                        m_samples;
+        const double                        m_max_distance;
+        SamplingMethod                      m_sampling_method;
+        Mode                                m_mode;
+        GScalar                             m_max_voxel_extent;
+
+        auto_ptr<AOVoxelTree>               m_voxel_tree;
+        auto_ptr<AOVoxelTreeIntersector>    m_voxel_tree_intersector;
+
+        void build_voxel_tree(const Project& project, AbortSwitch* abort_switch)
+        {
+            m_voxel_tree_intersector.reset();
+
+            {
+                ScopedProfile profile(global_profiler(), "ambient occlusion voxel tree build");
+                m_voxel_tree.reset(
+                    new AOVoxelTree(
+                        *project.get_scene(),
+                        m_max_voxel_extent,
+                        project.get_rendering_thread_count(),
+                        abort_switch));
+            }
+
+            if (m_voxel_tree->empty())
+            {
+                // Fall back to accurate ambient occlusion.
+                m_voxel_tree.reset();
+                return;
+            }
+
+            RENDERER_LOG_INFO("%s",
+                StatisticsVector::make(
+                    "ambient occlusion voxel tree statistics for surface shader \"" + string(get_name()) + "\"",
+                    m_voxel_tree->get_statistics()).to_string().c_str());
+
+            m_voxel_tree_intersector.reset(new AOVoxelTreeIntersector(*m_voxel_tree));
+        }
     };
 }
 
@@ -194,6 +310,26 @@ DictionaryArray AOSurfaceShaderFactory::get_input_metadata() const
             .insert("use", "required")
             .insert("default", "1.0"));
 
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "mode")
+            .insert("label", "Mode")
+            .insert("type", "enumeration")
+            .insert("items",
+                Dictionary()
+                    .insert("Accurate", "accurate")
+                    .insert("Fast (Voxelized Scene)", "fast"))
+            .insert("use", "optional")
+            .insert("default", "accurate"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "max_voxel_extent")
+            .insert("label", "Maximum Voxel Extent (Fraction of Scene Size)")
+            .insert("type", "text")
+            .insert("use", "optional")
+            .insert("default", "0.01"));
+
     return metadata;
 }
 
@@ -32,6 +32,7 @@
 
 // appleseed.renderer headers.
 #include "renderer/global/globallogger.h"
+#include "renderer/kernel/texturing/texturefilecache.h"
 #include "renderer/modeling/texture/texture.h"
 #include "renderer/utility/messagecontext.h"
 #include "renderer/utility/paramarray.h"
@@ -39,17 +40,26 @@
 // appleseed.foundation headers.
 #include "foundation/image/canvasproperties.h"
 #include "foundation/image/colorspace.h"
+#include "foundation/core/exceptions/exception.h"
 #include "foundation/image/genericprogressiveimagefilereader.h"
+#include "foundation/image/pixel.h"
 #include "foundation/image/tile.h"
+#include "foundation/platform/system.h"
 #include "foundation/platform/thread.h"
 #include "foundation/utility/containers/dictionary.h"
 #include "foundation/utility/containers/specializedarrays.h"
 #include "foundation/utility/makevector.h"
 #include "foundation/utility/searchpaths.h"
 
+// boost headers.
+#include "boost/filesystem/path.hpp"
+#include "boost/thread/condition_variable.hpp"
+
 // Standard headers.
 #include <cstddef>
+#include <memory>
 #include <string>
+#include <vector>
 
 using namespace foundation;
 using namespace std;
@@ -62,6 +72,13 @@ namespace
     //
     // 2D disk texture.
     //
+    // When a tile cache directory is specified, texture files that cannot be read one
+    // tile at a time (PNG, scanline OpenEXR) are converted on first use to tiled, linear
+    // RGB OpenEXR files in that directory, and tiles are then loaded from these files.
+    //
+    // Tiles of tiled files are read concurrently using a small pool of file readers.
+    // Other files keep a single reader since each reader holds the whole image.
+    //
 
     const char* Model = "disk_texture_2d";
 
@@ -74,11 +91,17 @@ namespace
             const ParamArray&   params,
             const SearchPaths&  search_paths)
           : Texture(name, params)
-          , m_reader(&global_logger())
+          , m_max_reader_count(1)
         {
             extract_parameters(search_paths);
         }
 
+        ~DiskTexture2d()
+        {
+            for (size_t i = 0; i < m_readers.size(); ++i)
+                delete m_readers[i];
+        }
+
         virtual void release() OVERRIDE
         {
             delete this;
@@ -91,7 +114,10 @@ namespace
 
         virtual ColorSpace get_color_space() const OVERRIDE
         {
-            return m_color_space;
+            // The color space of the tiles depends on the file they are read from.
+            boost::mutex::scoped_lock lock(m_mutex);
+            const_cast<DiskTexture2d*>(this)->open_image_file();
+            return m_tile_color_space;
         }
 
         virtual const CanvasProperties& properties() OVERRIDE
@@ -105,9 +131,22 @@ namespace
             const size_t        tile_x,
             const size_t        tile_y) OVERRIDE
         {
-            boost::mutex::scoped_lock lock(m_mutex);
-            open_image_file();
-            return m_reader.read_tile(tile_x, tile_y);
+            GenericProgressiveImageFileReader* reader = acquire_reader();
+            Tile* tile;
+
+            try
+            {
+                tile = reader->read_tile(tile_x, tile_y);
+            }
+            catch (...)
+            {
+                release_reader(reader);
+                throw;
+            }
+
+            release_reader(reader);
+
+            return tile;
         }
 
         virtual void unload_tile(
@@ -120,10 +159,18 @@ namespace
 
       private:
         string                              m_filepath;
-        ColorSpace                          m_color_space;
+        ColorSpace                          m_color_space;      // color space of the texture file
+        auto_ptr<TextureFileCache>          m_file_cache;
+
+        typedef vector<GenericProgressiveImageFileReader*> ReaderVector;
 
         mutable boost::mutex                m_mutex;
-        GenericProgressiveImageFileReader   m_reader;
+        boost::condition_variable           m_reader_released;
+        string                              m_tile_filepath;
+        ColorSpace                          m_tile_color_space; // color space of the tiles
+        size_t                              m_max_reader_count;
+        ReaderVector                        m_readers;          // all readers
+        ReaderVector                        m_idle_readers;     // readers not currently reading a tile
         CanvasProperties                    m_props;
 
         void extract_parameters(const SearchPaths& search_paths)
@@ -145,20 +192,120 @@ namespace
             else if (color_space == "srgb")
                 m_color_space = ColorSpaceSRGB;
             else m_color_space = ColorSpaceCIEXYZ;
+
+            // Retrieve the tile cache settings.
+            string cache_directory = m_params.get_optional<string>("tile_cache_directory", "");
+            if (!cache_directory.empty())
+            {
+                if (search_paths.has_root_path() && boost::filesystem::path(cache_directory).is_relative())
+                    cache_directory = (boost::filesystem::path(search_paths.get_root_path()) / cache_directory).string();
+
+                const string cache_pixel_format =
+                    m_params.get_optional<string>(
+                        "tile_cache_pixel_format",
+                        "float",
+                        make_vector("half", "float"),
+                        message_context);
+
+                const size_t cache_tile_size = m_params.get_optional<size_t>("tile_cache_tile_size", 64);
+
+                m_file_cache.reset(
+                    new TextureFileCache(
+                        cache_directory,
+                        cache_pixel_format == "half" ? PixelFormatHalf : PixelFormatFloat,
+                        cache_tile_size,
+                        cache_tile_size));
+            }
         }
 
+        // Return the path to the file tiles should be read from.
+        string get_tile_file_path() const
+        {
+            if (m_file_cache.get() && TextureFileCache::needs_conversion(m_filepath))
+            {
+                try
+                {
+                    return m_file_cache->get_cache_file(m_filepath, m_color_space);
+                }
+                catch (const Exception& e)
+                {
+                    RENDERER_LOG_WARNING(
+                        "failed to convert texture file %s to a tiled texture file (%s), "
+                        "reading it directly.",
+                        m_filepath.c_str(),
+                        e.what());
+                }
+            }
+
+            return m_filepath;
+        }
+
+        // Must be called while holding m_mutex.
         void open_image_file()
         {
-            if (!m_reader.is_open())
+            if (m_readers.empty())
             {
+                m_tile_filepath = get_tile_file_path();
+
+                // Cache files are always in the linear RGB color space.
+                m_tile_color_space =
+                    m_tile_filepath == m_filepath
+                        ? m_color_space
+                        : ColorSpaceLinearRGB;
+
                 RENDERER_LOG_INFO(
                     "opening texture file %s and reading metadata...",
-                    m_filepath.c_str());
+                    m_tile_filepath.c_str());
 
-                m_reader.open(m_filepath.c_str());
-                m_reader.read_canvas_properties(m_props);
+                auto_ptr<GenericProgressiveImageFileReader> reader(
+                    new GenericProgressiveImageFileReader(&global_logger()));
+                reader->open(m_tile_filepath.c_str());
+                reader->read_canvas_properties(m_props);
+
+                m_readers.push_back(reader.get());
+                m_idle_readers.push_back(reader.release());
+
+                m_max_reader_count =
+                    TextureFileCache::needs_conversion(m_tile_filepath)
+                        ? 1
+                        : System::get_logical_cpu_core_count();
             }
         }
+
+        GenericProgressiveImageFileReader* acquire_reader()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            open_image_file();
+
+            while (m_idle_readers.empty())
+            {
+                if (m_readers.size() < m_max_reader_count)
+                {
+                    auto_ptr<GenericProgressiveImageFileReader> reader(
+                        new GenericProgressiveImageFileReader(&global_logger()));
+                    reader->open(m_tile_filepath.c_str());
+
+                    m_readers.push_back(reader.get());
+                    return reader.release();
+                }
+
+                m_reader_released.wait(lock);
+            }
+
+            GenericProgressiveImageFileReader* reader = m_idle_readers.back();
+            m_idle_readers.pop_back();
+
+            return reader;
+        }
+
+        void release_reader(GenericProgressiveImageFileReader* reader)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+
+            m_idle_readers.push_back(reader);
+            m_reader_released.notify_one();
+        }
     };
 }
 
@@ -204,6 +351,36 @@ DictionaryArray DiskTexture2dFactory::get_input_metadata() const
             .insert("use", "required")
             .insert("default", "srgb"));
 
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "tile_cache_directory")
+            .insert("label", "Tile Cache Directory")
+            .insert("type", "text")
+            .insert("default", "")
+            .insert("use", "optional"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "tile_cache_pixel_format")
+            .insert("label", "Tile Cache Pixel Format")
+            .insert("type", "enumeration")
+            .insert("items",
+                Dictionary()
+                    .insert("Half", "half")
+                    .insert("Float", "float"))
+            .insert("use", "optional")
+            .insert("default", "float"));
+
+    metadata.push_back(
+        Dictionary()
+            .insert("name", "tile_cache_tile_size")
+            .insert("label", "Tile Cache Tile Size")
+            .insert("type", "numeric")
+            .insert("min_value", "1")
+            .insert("max_value", "4096")
+            .insert("use", "optional")
+            .insert("default", "64"));
+
     return metadata;
 }
 
@@ -0,0 +1,136 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+// Interface header.
+#include "cyclecounter.h"
+
+// appleseed.foundation headers.
+#include "foundation/platform/compiler.h"
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+#if defined __i386__ || defined __x86_64__ || defined _M_IX86 || defined _M_X64
+#include "foundation/platform/x86timer.h"
+#define RENDERER_CYCLE_COUNTER_USE_X86_TIMER
+#else
+#include "foundation/platform/defaulttimers.h"
+#endif
+#endif
+#include "foundation/utility/string.h"
+
+// Standard headers.
+#include <memory>
+
+using namespace foundation;
+using namespace std;
+
+namespace renderer
+{
+
+//
+// CycleCounter class implementation.
+//
+
+namespace
+{
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+
+    // The timer is shared by all threads: it is calibrated once, and reading it has no side effect.
+#ifdef RENDERER_CYCLE_COUNTER_USE_X86_TIMER
+    X86Timer g_timer;
+#else
+    DefaultWallclockTimer g_timer;
+#endif
+
+#endif
+
+    struct CycleCounterStatisticsEntry
+      : public Statistics::Entry
+    {
+        double  m_seconds;
+        uint64  m_call_count;
+
+        CycleCounterStatisticsEntry(
+            const string&   name,
+            const double    seconds,
+            const uint64    call_count)
+          : Entry(name)
+          , m_seconds(seconds)
+          , m_call_count(call_count)
+        {
+        }
+
+        virtual auto_ptr<Entry> clone() const OVERRIDE
+        {
+            return auto_ptr<Entry>(new CycleCounterStatisticsEntry(*this));
+        }
+
+        virtual void merge(const Entry* other) OVERRIDE
+        {
+            const CycleCounterStatisticsEntry* typed_other =
+                cast<CycleCounterStatisticsEntry>(other);
+
+            m_seconds += typed_other->m_seconds;
+            m_call_count += typed_other->m_call_count;
+        }
+
+        virtual string to_string() const OVERRIDE
+        {
+            return pretty_time(m_seconds) + " (" + pretty_uint(m_call_count) + " calls)";
+        }
+    };
+}
+
+void CycleCounter::insert_statistics(
+    Statistics&         stats,
+    const string&       name) const
+{
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+    if (m_call_count == 0)
+        return;
+
+    const double seconds =
+        static_cast<double>(m_ticks) / static_cast<double>(g_timer.frequency());
+
+    stats.insert(
+        auto_ptr<CycleCounterStatisticsEntry>(
+            new CycleCounterStatisticsEntry(
+                name,
+                seconds,
+                m_call_count)));
+#endif
+}
+
+uint64 CycleCounter::read_timer()
+{
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+    return g_timer.read();
+#else
+    return 0;
+#endif
+}
+
+}   // namespace renderer
@@ -0,0 +1,164 @@
+
+//
+// This source file is part of appleseed.
+// Visit http://appleseedhq.net/ for additional information and resources.
+//
+// This software is released under the MIT license.
+//
+// Copyright (c) 2014 Francois Beaune, The appleseedhq Organization
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef APPLESEED_RENDERER_UTILITY_CYCLECOUNTER_H
+#define APPLESEED_RENDERER_UTILITY_CYCLECOUNTER_H
+
+// appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
+#include "foundation/platform/types.h"
+#include "foundation/utility/statistics.h"
+
+// Standard headers.
+#include <cstddef>
+#include <string>
+
+// Enable or disable the per-thread render time breakdown counters.
+#undef RENDERER_ENABLE_CYCLE_COUNTERS
+
+#ifdef RENDERER_ENABLE_CYCLE_COUNTERS
+#define RENDERER_CYCLE_COUNTER_SCOPE(counter) renderer::ScopedCycleCount cycle_count_scope(counter)
+#else
+#define RENDERER_CYCLE_COUNTER_SCOPE(counter)
+#endif
+
+namespace renderer
+{
+
+//
+// Accumulates the time spent in a given function by a single thread.
+//
+// Time is measured with foundation::X86Timer on x86 processors and with
+// foundation::DefaultWallclockTimer elsewhere. Nested or recursive scopes
+// on the same counter are only measured once, so reported times are inclusive.
+//
+
+class CycleCounter
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    CycleCounter();
+
+    // Reset the counter.
+    void clear();
+
+    // Return the number of timer ticks and the number of measured calls.
+    foundation::uint64 get_ticks() const;
+    foundation::uint64 get_call_count() const;
+
+    // Insert the total time and call count into a statistics object.
+    // Nothing is inserted if no call was measured.
+    void insert_statistics(
+        foundation::Statistics&     stats,
+        const std::string&          name) const;
+
+    // Read the current value of the underlying timer.
+    // Always returns 0 when cycle counters are disabled.
+    static foundation::uint64 read_timer();
+
+  private:
+    friend class ScopedCycleCount;
+
+    foundation::uint64  m_ticks;
+    foundation::uint64  m_call_count;
+    size_t              m_depth;
+};
+
+
+//
+// Measures the lifetime of a scope into a cycle counter.
+//
+
+class ScopedCycleCount
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor, starts measuring.
+    explicit ScopedCycleCount(CycleCounter& counter);
+
+    // Destructor, stops measuring.
+    ~ScopedCycleCount();
+
+  private:
+    CycleCounter&       m_counter;
+    foundation::uint64  m_begin;
+};
+
+
+//
+// CycleCounter class implementation.
+//
+
+inline CycleCounter::CycleCounter()
+{
+    clear();
+}
+
+inline void CycleCounter::clear()
+{
+    m_ticks = 0;
+    m_call_count = 0;
+    m_depth = 0;
+}
+
+inline foundation::uint64 CycleCounter::get_ticks() const
+{
+    return m_ticks;
+}
+
+inline foundation::uint64 CycleCounter::get_call_count() const
+{
+    return m_call_count;
+}
+
+
+//
+// ScopedCycleCount class implementation.
+//
+
+inline ScopedCycleCount::ScopedCycleCount(CycleCounter& counter)
+  : m_counter(counter)
+  , m_begin(0)
+{
+    if (m_counter.m_depth++ == 0)
+        m_begin = CycleCounter::read_timer();
+}
+
+inline ScopedCycleCount::~ScopedCycleCount()
+{
+    if (--m_counter.m_depth == 0)
+    {
+        m_counter.m_ticks += CycleCounter::read_timer() - m_begin;
+        ++m_counter.m_call_count;
+    }
+}
+
+}       // namespace renderer
+
+#endif  // !APPLESEED_RENDERER_UTILITY_CYCLECOUNTER_H
@@ -31,9 +31,12 @@
 #define APPLESEED_RENDERER_UTILITY_TRANSFORMSEQUENCE_H
 
 // appleseed.foundation headers.
+#include "foundation/core/concepts/noncopyable.h"
 #include "foundation/math/aabb.h"
+#include "foundation/math/hash.h"
 #include "foundation/math/transform.h"
 #include "foundation/platform/compiler.h"
+#include "foundation/platform/types.h"
 
 // appleseed.main headers.
 #include "main/dllsymbol.h"
@@ -143,6 +146,54 @@ class DLLSYMBOL TransformSequence
 };
 
 
+//
+// A small direct-mapped cache of transforms evaluated from transform sequences,
+// indexed by the address of the sequence and by time.
+//
+// All rays of a given light path share the same time, so the transforms of the
+// motion-blurred instances that these rays visit only need to be interpolated
+// once per path. Sequences with fewer than two transforms bypass the cache.
+//
+// Cached entries refer to sequences by address: the cache must be cleared when
+// sequences are destroyed or modified. This class is not thread-safe.
+//
+
+template <size_t Lines>
+class TransformSequenceCache
+  : public foundation::NonCopyable
+{
+  public:
+    // Constructor.
+    TransformSequenceCache();
+
+    // Invalidate all cache lines.
+    void clear();
+
+    // Return the transform of a given sequence at a given time.
+    // The returned reference remains valid until the next call to evaluate() or clear().
+    const foundation::Transformd& evaluate(
+        const TransformSequence&        sequence,
+        const double                    time);
+
+    // Return performance statistics.
+    foundation::uint64 get_hit_count() const;
+    foundation::uint64 get_miss_count() const;
+
+  private:
+    struct Line
+    {
+        const TransformSequence*        m_sequence;
+        double                          m_time;
+        const foundation::Transformd*   m_result;       // points to m_transform or into the sequence
+        foundation::Transformd          m_transform;
+    };
+
+    Line                                m_lines[Lines];
+    foundation::uint64                  m_hit_count;
+    foundation::uint64                  m_miss_count;
+};
+
+
 //
 // TransformSequence class implementation.
 //
@@ -216,6 +267,67 @@ foundation::AABB<T, 3> TransformSequence::to_parent(const foundation::AABB<T, 3>
     return result;
 }
 
+
+//
+// TransformSequenceCache class implementation.
+//
+
+template <size_t Lines>
+TransformSequenceCache<Lines>::TransformSequenceCache()
+{
+    clear();
+}
+
+template <size_t Lines>
+void TransformSequenceCache<Lines>::clear()
+{
+    for (size_t i = 0; i < Lines; ++i)
+        m_lines[i].m_sequence = 0;
+
+    m_hit_count = 0;
+    m_miss_count = 0;
+}
+
+template <size_t Lines>
+FORCE_INLINE const foundation::Transformd& TransformSequenceCache<Lines>::evaluate(
+    const TransformSequence&    sequence,
+    const double                time)
+{
+    if (sequence.size() < 2)
+        return sequence.get_earliest_transform();
+
+    const size_t index =
+        foundation::hash_uint64_to_uint32(
+            static_cast<foundation::uint64>(reinterpret_cast<uintptr_t>(&sequence))) % Lines;
+    Line& line = m_lines[index];
+
+    if (line.m_sequence == &sequence && line.m_time == time)
+    {
+        ++m_hit_count;
+        return *line.m_result;
+    }
+
+    ++m_miss_count;
+
+    line.m_sequence = &sequence;
+    line.m_time = time;
+    line.m_result = &sequence.evaluate(time, line.m_transform);
+
+    return *line.m_result;
+}
+
+template <size_t Lines>
+inline foundation::uint64 TransformSequenceCache<Lines>::get_hit_count() const
+{
+    return m_hit_count;
+}
+
+template <size_t Lines>
+inline foundation::uint64 TransformSequenceCache<Lines>::get_miss_count() const
+{
+    return m_miss_count;
+}
+
 }       // namespace renderer
 
 #endif  // !APPLESEED_RENDERER_UTILITY_TRANSFORMSEQUENCE_H